@@ -11,746 +11,769 @@
  * - Operações atômicas para contadores
  * - Simulação de carga de trabalho concorrente
  * - Logging e análise de performance
+ * - Logging assíncrono com buffers circulares por thread (lock-free)
+ * - Saldos em ponto fixo atualizados com CAS (motor livre de locks)
+ * - Transferências atômicas com aquisição ordenada de locks (sem deadlock)
+ * - Write-ahead log binário com group commit e recuperação na carga
+ * - Arquivo binário de contas mapeado em memória e carga de texto em paralelo
+ * - Pool de threads persistente com roubo de tarefas (work stealing)
+ * - Gerador de carga com sementes por fluxo, acesso Zipf/hotspot e mixes nomeados
+ * - Histogramas de latência por tipo de operação (p50 a p99.9 e máximo)
+ * - Modo de ciclo aberto com taxa de chegada constante ou de Poisson
+ * - Modelo de tempo de serviço configurável (nenhum, giro, sono, exponencial)
+ * - Controle de admissão justo por conta (fila limitada, tempo limite)
+ * - Combinação de escritas (flat combining) ligada sozinha em contas disputadas
+ * - Snapshots consistentes por época (MVCC de duas versões) e auditor contínuo
+ * - Contadores distribuídos por thread e contas alinhadas em linhas de cache
+ * - Varredura de parâmetros com aquecimento, repetições e intervalos de confiança
+ * - Políticas de trava plugáveis em tempo de compilação (TTAS, ticket, MCS, seqlock...)
+ * - Servidor por socket Unix (epoll, protocolo binário com pipelining) e clientes multiprocesso
+ * - Checkpoint incremental em segundo plano (só contas alteradas, dois slots alternados) que recorta o WAL
+ * - Captura de trace e reprodução em paralelo preservando a ordem por conta
+ * - Banco particionado (shared-nothing): workers fixados em CPUs, donos das suas contas, com filas SPSC
+ * - Clientes em corrotinas C++20 (100 mil clientes em poucos workers, suspensos na pausa e no commit)
+ * - Perfil de disputa por conta: espera, posse e aquisições disputadas por modo da trava
+ * - Telemetria em série temporal: vazão, falhas, consultas ativas e percentis a cada intervalo
+ * - Operações em massa paralelas (juros, tarifa, conciliação) concorrentes com as operações online
+ * - Índice hash de contas com busca sem lock, abertura/encerramento online e reclamação por épocas
+ *
+ * COMPILAÇÃO:
+ *   g++ -std=c++17 -O2 -pthread 4.cpp -o banco
+ *   (--corrotinas e --bench-corrotinas exigem -std=c++20)
+ *   Os headers ao lado deste arquivo incluem cada um o anterior:
+ *   suporte.hpp -> motores.hpp (travas e contas) e wal.hpp (WAL,
+ *   armazenamento e checkpoint) -> banco.hpp -> simulador.hpp ->
+ *   servidor.hpp -> sistema.hpp (SistemaBancario e autotestes) ->
+ *   benchmarks.hpp. Todos só com inline/templates: outro .cpp pode
+ *   incluir qualquer um deles para testar um componente.
+ *
+ * USO:
+ *   ./banco [--log=nenhum|escritas|todas] [--motor=MOTOR[,MOTOR...]|todos]
+ *           [--mix=padrao|transferencias|leitura|escrita|rotatividade|C:D:Q:T:L[:A:E]]
+ *           [--distribuicao=uniforme|zipf[:THETA]|hotspot[:FRACAO:PROB]]
+ *           [--semente=N] [--chegada=fechado|constante:TAXA|poisson:TAXA]
+ *           [--wal=desligado|LOTE:LATENCIA_US] [--bench-saturacao[=WORKERS]]
+ *           [--servico=legado|nenhum|giro[,ETAPA=MODO:US]...]
+ *           [--admissao=desligada|LEITORES:FILA:TIMEOUT_US]
+ *           [--combinacao=auto|desligada|sempre] [--bench-combinacao]
+ *           [--auditoria=desligada|continua|MS] [--bench-auditoria]
+ *           [--checkpoint=desligado|MS[:completo][,ARQUIVO]] [--bench-checkpoint[=N]]
+ *           [--capturar=ARQUIVO] [--reproduzir=ARQUIVO[,RAIAS]]
+ *           [--bench-particionado[=N]] [--corrotinas=N] [--bench-corrotinas[=MAX]]
+ *           [--perfil-travas[=ARQUIVO]] [--telemetria[=MS[,ARQUIVO]]]
+ *           [--massa=desligada|juros[:TAXA]|tarifa[:VALOR]|conciliacao[,MS[,THREADS]]]
+ *           [--bench-massa[=N]] [--bench-indice[=N]]
+ *           [--arranjo=heap|compacto|alinhado] [--bench-coerencia]
+ *           [--bench-varredura] [--varrer-EIXO=V1,V2,...]
+ *           [--servidor=CAMINHO[,LACOS]] [--cliente=CAMINHO[,PROC[,OPS[,JANELA]]]]
+ *           [--bench-socket[=PROCESSOS]]
+ *           [--bench-wal] [--bench-carga[=N]] [--converter=ENTRADA,SAIDA]
+ *           [--verificar-wal[=N]] [--verificar-concorrencia[=N]]
+ *
+ *   --log    Nível de verbosidade do log de operações (padrão: todas).
+ *            "nenhum" desliga o log por completo, útil em benchmarks.
+ *   --motor  Motor(es) de contas simulados (padrão: rwlock,atomico). Além do
+ *            atômico (CAS), cada política de trava é um motor compilado à
+ *            parte: rwlock (shared_mutex), mutex, ttas, ticket, mcs, seqlock
+ *            e rwgiro (leitores/escritor com espera ativa). "todos" compara
+ *            os oito; o nome da trava vai para a coluna Trava do CSV.
+ *   --mix    Mix de operações; "transferencias" gera carga dominada por
+ *            transferências e lotes atômicos entre contas, "leitura" é
+ *            95% consultas e "escrita" 90% créditos/débitos. Pesos livres
+ *            em C:D:Q:T:L (crédito:débito:consulta:transferência:lote).
+ *            "rotatividade" (ou C:D:Q:T:L:A:E) também abre e encerra
+ *            contas durante a simulação: a abertura usa o ID sorteado e
+ *            falha se ele já está aberto; o encerramento retira o saldo,
+ *            que volta com o ID quando ele é reaberto. No fim, as
+ *            encerradas são reabertas, então o arquivo não perde contas
+ *            nem dinheiro de uma execução para a outra.
+ *            Não vale com --capturar, --cliente, --bench-socket nem
+ *            --bench-particionado.
+ *   --distribuicao  Escolha das contas: uniforme (padrão), zipf (theta
+ *            padrão 0.99) ou hotspot (padrão 1% das contas com 90% dos acessos).
+ *   --semente  Semente da carga; repetir a semente repete as operações
+ *            sorteadas (padrão: nova semente a cada simulação, gravada no CSV).
+ *   --chegada  Ciclo fechado (padrão: cada worker espera a operação anterior)
+ *            ou aberto, com TAXA operações/s em intervalos fixos ou de Poisson.
+ *            No ciclo aberto a latência é medida desde o instante planejado.
+ *   --bench-saturacao  Dobra a taxa de chegada (Poisson, se --chegada não
+ *            for dada) até o banco saturar e mostra a maior taxa sustentada
+ *            por motor, com WORKERS workers (padrão: 16).
+ *   --servico  Tempo de serviço simulado. Presets: legado (padrão: sleeps
+ *            de 10/10/5 ms e 1 ms entre operações), nenhum (mede só o motor)
+ *            e giro (CPU ocupada por poucos us). Cada etapa (credito, debito,
+ *            consulta, multiconta, pausa) pode ser trocada por nenhum,
+ *            giro:US, sono:US ou exp:US (sleep exponencial com média US).
+ *   --admissao  Fila justa (FIFO entre leitores e escritores) na frente do
+ *            lock de cada conta do motor rwlock (padrão: 5:64:50000, ou seja,
+ *            até 5 consultas simultâneas, 64 pedidos na fila e 50 ms de espera).
+ *            Recusas são contadas à parte das falhas de negócio.
+ *   --combinacao  Flat combining das escritas no motor rwlock (padrão: auto,
+ *            ligado por conta quando ao menos 25% das escritas encontram
+ *            o lock ocupado; sempre/desligada fixam o caminho).
+ *   --bench-combinacao  Compara os modos de combinação com escritas
+ *            concentradas em poucas contas (use com --servico=giro).
+ *   --auditoria  Thread auditora que tira snapshots consistentes (corte de
+ *            época, sem travar contas) a cada MS ms, ou sem pausa com
+ *            "continua", e confere o total com o inicial + créditos - débitos.
+ *   --bench-auditoria  Mede a perda de vazão causada pelos snapshots.
+ *   --checkpoint  Thread que grava a cada MS ms só as contas alteradas desde
+ *            o checkpoint anterior (época da última escrita de cada conta),
+ *            sem travar contas nem o mapa de contas, alternando entre
+ *            ARQUIVO.0 e ARQUIVO.1 (padrão: checkpoint.bin; formato binário,
+ *            lido por --converter), e recorta do WAL o que ele já cobre.
+ *            ":completo" regrava todas as contas a cada vez. Vale para as
+ *            simulações e o modo servidor; ContaCorrente.txt continua
+ *            sendo salvo ao final. Depois de um crash, a carga parte do
+ *            checkpoint íntegro mais novo (mesmo sem --checkpoint, desde
+ *            que ARQUIVO seja o mesmo), aplica o resto do WAL e salva.
+ *   --bench-checkpoint  Mesma carga sobre N contas sintéticas (padrão:
+ *            100000) sem checkpoint, completo e incremental: vazão, p99,
+ *            bytes e duração por checkpoint. Use --servico=nenhum.
+ *   --capturar  Grava cada operação (simulações ou modo servidor) num trace
+ *            binário de 24 bytes por operação, na ordem em que cada conta
+ *            as viu, com o saldo de partida e o final das contas; com
+ *            várias simulações fica o trace da última.
+ *   --reproduzir  Reproduz o trace com cada --motor, em sequência e em
+ *            RAIAS raias (padrão: uma por CPU; cada conta fica numa raia
+ *            e operações entre raias esperam todas as suas raias), e
+ *            confere se todas terminam nos saldos finais da captura, com
+ *            o mesmo resultado de cada operação. Valores em centavos.
+ *            Use --servico=nenhum.
+ *   --bench-particionado  Compara, com 1, 2, 4... workers sobre N contas
+ *            sintéticas (padrão: 100000), cada --motor com o banco
+ *            particionado: cada worker fixado numa CPU é o único dono das
+ *            suas contas (sem travas) e pede as operações nas contas dos
+ *            outros por filas SPSC; transferências entre partições
+ *            reservam na origem e depois creditam nos destinos. Use
+ *            --servico=nenhum --log=nenhum.
+ *   --corrotinas  Cada simulação roda N clientes em corrotinas sobre os
+ *            seus workers (o número de threads), cada cliente com as
+ *            operações por thread. A pausa entre operações e a espera
+ *            pelo commit do WAL suspendem o cliente em vez de prender a
+ *            thread; a resposta (operação + commit) vai para Resposta*.
+ *   --bench-corrotinas  Uma thread por cliente (até 1000) contra
+ *            corrotinas em um worker por CPU, de W até MAX clientes
+ *            (padrão: 100000). Para um cliente que pensa entre as
+ *            operações use algo como --servico=nenhum,pausa=sono:1000.
+ *   --perfil-travas  Mede, por conta e por modo (compartilhado/exclusivo),
+ *            as aquisições da trava, quantas foram disputadas, a espera e
+ *            o tempo de posse, em buffers por thread. Cada simulação com
+ *            relatório imprime as 10 contas com mais espera e grava uma
+ *            linha por conta em ARQUIVO (padrão: perfil_travas.csv,
+ *            recriado a cada execução; o graficos.py desenha o mapa de
+ *            calor conta x threads). O motor atomico e as leituras
+ *            otimistas do seqlock não travam e não aparecem.
+ *   --telemetria  Uma thread amostra cada simulação a cada MS ms (padrão:
+ *            100): vazão e taxa de falhas do intervalo, consultas em
+ *            andamento e percentis de latência das operações terminadas
+ *            no intervalo. Uma linha por amostra em ARQUIVO (padrão:
+ *            telemetria.csv, recriado a cada execução); o graficos.py
+ *            desenha a vazão e o p99 ao longo do tempo.
+ *   --massa  Durante cada simulação, repete a cada MS ms (padrão: 0,
+ *            sem pausa) uma passada sobre todas as contas dividida entre
+ *            THREADS threads (padrão: 2), em blocos de 64 contas
+ *            travadas juntas: juros sobre saldos positivos (TAXA por
+ *            passada, padrão 0.0001), tarifa de VALOR reais (padrão 1.50)
+ *            nas contas com saldo suficiente, ou conciliação (soma,
+ *            mínimo e máximo num snapshot, sem travar, conferidos com o
+ *            total esperado).
+ *   --bench-massa  Mesma carga sobre N contas sintéticas (padrão: 100000)
+ *            sem massa e com cada trabalho: vazão e p99 online relativos
+ *            à rodada sem massa e contas por segundo das passadas.
+ *   --bench-indice  Buscas por ID entre N contas sintéticas (padrão:
+ *            100000) com 1, 2, 4... threads: map com mutex global (busca
+ *            antiga), índice hash sem lock e índice com uma thread
+ *            encerrando e reabrindo contas durante a medição.
+ *   --arranjo  Layout das contas na memória: heap (padrão, um new por
+ *            conta), compacto (bloco contíguo) ou alinhado (bloco contíguo,
+ *            cada conta nas suas próprias linhas de cache).
+ *   --bench-coerencia  Microbenchmark de false sharing: contadores
+ *            (atomic único, vizinhos, distribuído) e contas por arranjo.
+ *   --bench-varredura  Varre o produto dos eixos threads (padrão 1,4,16),
+ *            contas (0 = arquivo, N = N contas sintéticas; padrão 0), mix
+ *            (leitura,padrao,escrita), distribuicao (uniforme,zipf:0.99),
+ *            ops por thread (1000) e os motores de --motor. Cada configuração
+ *            roda --varrer-aquecimento=N rodadas descartadas (padrão 1) e
+ *            --varrer-repeticoes=N medidas (padrão 5), cada uma sobre uma
+ *            cópia nova das contas em memória (o arquivo não é alterado).
+ *            Grava varredura.csv (uma linha por rodada) e
+ *            varredura_resumo.csv (média e IC de 95% por configuração).
+ *            Para medir os motores use --servico=nenhum e --log=nenhum.
+ *   --servidor  Atende pedidos binários de 24 bytes (crédito, débito,
+ *            consulta, transferência; contas por índice na ordem dos IDs)
+ *            num socket Unix, com LACOS laços epoll (padrão: um por CPU),
+ *            até Ctrl+C; então salva as contas. Usa o primeiro --motor.
+ *            Cada laço espera o commit do WAL de cada pedido antes do
+ *            próximo; para vazão use mais laços ou --wal=desligado.
+ *   --cliente  Cria PROCESSOS processos (padrão 4) que enviam OPS pedidos
+ *            cada (padrão 10000) sorteados com --mix/--distribuicao,
+ *            mantendo até JANELA pedidos em trânsito (padrão 1).
+ *   --bench-socket  Compara as mesmas operações chamadas diretamente por
+ *            threads e enviadas por PROCESSOS processos (padrão 4) pelo
+ *            socket com janelas de 1 a 256: o custo de sair do processo e
+ *            quanto o pipelining recupera. Use --servico=nenhum --log=nenhum.
+ *   --wal    Group commit do write-ahead log (padrão: 64:2000, ou seja,
+ *            até 64 operações por fdatasync ou no máximo 2000 us de espera).
+ *            Se um write ou fdatasync do WAL falhar, o log para: nenhuma
+ *            escrita é confirmada depois disso (responde FALHA).
+ *   --bench-wal  Compara configurações de group commit por número de threads.
+ *   --bench-carga  Mede a carga de N contas (padrão: 1000000) em texto e binário.
+ *   --converter    Converte entre texto (ID|SALDO) e binário (.bin) e termina.
+ *   --verificar-wal  Autoteste determinístico da recuperação: N operações
+ *            (padrão: 400) com o WAL ligado em cada --motor; o WAL é cortado
+ *            em cada fronteira (e no meio) de registro e cada corte
+ *            recuperado tem que ser o estado de uma operação terminada, com
+ *            o total esperado e nenhum saldo negativo. Sai com erro se não.
+ *            Use --servico=nenhum.
+ *   --verificar-concorrencia  Autoteste das travas seqlock, ticket e mcs:
+ *            N operações (padrão: 20000) em 4 threads sobre 8 contas, com
+ *            snapshots durante a carga; todo snapshot fecha o total e
+ *            nenhum saldo fica negativo. Cada carga é capturada e
+ *            reproduzida contra os saldos finais da captura, e o banco
+ *            particionado roda com 1, 2 e 4 partições. Sai com erro se
+ *            algo divergir. Use --servico=nenhum --log=nenhum.
  */
 
+#include "sistema.hpp"
+#include "benchmarks.hpp"
 
-
- 
-#include <iostream>          // Para entrada/saída (cout, cin)
-#include <fstream>           // Para manipulação de arquivos
-#include <thread>            // Para criação e gerenciamento de threads
-#include <mutex>             // Para sincronização básica (exclusão mútua)
-#include <condition_variable> // Para sincronização avançada (não usado neste código)
-#include <shared_mutex>      // Para Reader-Writer locks
-#include <vector>            // Para arrays dinâmicos
-#include <map>               // Para mapeamento chave-valor
-#include <random>            // Para geração de números aleatórios
-#include <chrono>            // Para medição de tempo
-#include <string>            // Para manipulação de strings
-#include <sstream>           // Para conversão string-stream
-#include <atomic>            // Para operações atômicas (thread-safe)
-#include <iomanip>           // Para formatação de saída
-
-// ===================================
-// Classe ContaCorrente
-// ===================================
-class ContaCorrente {
-private:
-    std::string identificador;              // ID único da conta
-    double saldo;                          // Saldo atual da conta
-    
-    /*
-     * SINCRONIZAÇÃO READER-WRITER:
-     * - shared_mutex permite múltiplos leitores OU um escritor
-     * - Consultas (leitura) podem acontecer simultaneamente
-     * - Débitos/créditos (escrita) são exclusivos
-     */
-    mutable std::shared_mutex rwMutex;     // Mutex para Reader-Writer pattern
-    
-    /*
-     * CONTADOR ATÔMICO:
-     * - atomic<int> garante que operações de incremento/decremento sejam thread-safe
-     * - Usado para limitar o número de consultas simultâneas
-     */
-    mutable std::atomic<int> leitoresAtivos{0};  // Conta quantos threads estão lendo
-
-public:
-    /*
-     * CONSTRUTOR:
-     * Inicializa a conta com ID e saldo inicial
-     */
-    ContaCorrente(const std::string& id, double saldoInicial) 
-        : identificador(id), saldo(saldoInicial) {}
-
-    /*
-     * GETTER SIMPLES:
-     * Retorna o ID da conta (operação rápida, não precisa de sincronização)
-     */
-    std::string getId() const { return identificador; }
-
-    /*
-     * OPERAÇÃO DE CRÉDITO (ESCRITA):
-     * Adiciona dinheiro à conta de forma thread-safe
-     */
-    bool creditar(double valor) {
-        /*
-         * UNIQUE_LOCK:
-         * - Bloqueia EXCLUSIVAMENTE o shared_mutex
-         * - Nenhuma outra thread pode ler ou escrever enquanto isso
-         * - Garante que apenas uma thread modifique o saldo por vez
-         */
-        std::unique_lock<std::shared_mutex> lock(rwMutex);
-        
-        // Validação: valor deve ser positivo
-        if (valor <= 0) return false;
-        
-        // Operação crítica: modificação do saldo
-        saldo += valor;
-        
-        // Log da operação (formatação com 2 casas decimais)
-        std::cout << "[CRÉDITO] Conta " << identificador 
-                  << " - Valor: R$ " << std::fixed << std::setprecision(2) << valor
-                  << " - Novo saldo: R$ " << saldo << std::endl;
-        
-        /*
-         * SIMULAÇÃO DE PROCESSAMENTO:
-         * Sleep simula o tempo que uma operação bancária real levaria
-         * (acesso ao banco de dados, validações, etc.)
-         */
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        
-        return true;  // Operação bem-sucedida
-    }
-
-    /*
-     * OPERAÇÃO DE DÉBITO (ESCRITA):
-     * Remove dinheiro da conta de forma thread-safe
-     */
-    bool debitar(double valor) {
-        // Mesmo padrão do crédito: lock exclusivo
-        std::unique_lock<std::shared_mutex> lock(rwMutex);
-        
-        // Validação: valor positivo e saldo suficiente
-        if (valor <= 0 || saldo < valor) return false;
-        
-        // Operação crítica: modificação do saldo
-        saldo -= valor;
-        
-        // Log da operação
-        std::cout << "[DÉBITO] Conta " << identificador 
-                  << " - Valor: R$ " << std::fixed << std::setprecision(2) << valor
-                  << " - Novo saldo: R$ " << saldo << std::endl;
-        
-        // Simulação de processamento
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
-        
-        return true;
-    }
-
-    /*
-     * CONSULTA DE SALDO (LEITURA):
-     * Permite múltiplas threads lerem simultaneamente
-     */
-    double consultarSaldo() const {
-        /*
-         * SHARED_LOCK:
-         * - Permite que múltiplas threads leiam ao mesmo tempo
-         * - Bloqueia apenas se houver um escritor ativo
-         * - Mais eficiente que unique_lock para operações de leitura
-         */
-        std::shared_lock<std::shared_mutex> lock(rwMutex);
-        
-        /*
-         * CONTROLE DE CONCORRÊNCIA:
-         * Limita a 5 leitores simultâneos para evitar sobrecarga
-         * load() é uma operação atômica que lê o valor atual
-         */
-        if (leitoresAtivos.load() >= 5) return -1;  // Muitos leitores ativos
-        
-        /*
-         * INCREMENTO ATÔMICO:
-         * ++ em atomic<int> é thread-safe (não precisa de mutex adicional)
-         */
-        leitoresAtivos++;
-        
-        // Log da consulta
-        std::cout << "[CONSULTA] Conta " << identificador 
-                  << " - Saldo: R$ " << std::fixed << std::setprecision(2) << saldo
-                  << " - Leitores ativos: " << leitoresAtivos.load() << std::endl;
-        
-        // Simulação de processamento (mais rápida que escrita)
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-        
-        // Cópia do saldo para retorno
-        double saldoAtual = saldo;
-        
-        /*
-         * DECREMENTO ATÔMICO:
-         * Remove este thread da contagem de leitores ativos
-         */
-        leitoresAtivos--;
-        
-        return saldoAtual;
-    }
-
-    /*
-     * ACESSO DIRETO (SEM SINCRONIZAÇÃO):
-     * Usado apenas quando já há garantia de exclusão mútua
-     * (ex: quando o banco já está com lock)
-     */
-    double getSaldoUnsafe() const {
-        return saldo;
-    }
-};
-
-// ===================================
-// Classe Banco
-// ===================================
-class Banco {
-private:
-    /*
-     * COLEÇÃO DE CONTAS:
-     * - map<string, unique_ptr<ContaCorrente>>: mapeia ID -> ponteiro para conta
-     * - unique_ptr garante gerenciamento automático de memória
-     * - map mantém as contas ordenadas por ID
-     */
-    std::map<std::string, std::unique_ptr<ContaCorrente>> contas;
-    
-    /*
-     * MUTEX PARA PROTEÇÃO DO MAP:
-     * Protege a estrutura do map contra modificações concorrentes
-     * (adição/remoção de contas)
-     */
-    std::mutex contasMutex;
-    
-    /*
-     * CONTADORES ATÔMICOS:
-     * Mantêm estatísticas globais sem necessidade de sincronização
-     */
-    std::atomic<int> operacoesRealizadas{0};   // Contador de operações bem-sucedidas
-    std::atomic<int> operacoesFalhas{0};       // Contador de operações falhadas
-
-public:
-    /*
-     * CARREGAMENTO DE CONTAS DO ARQUIVO:
-     * Lê o arquivo e popula o map de contas
-     */
-    void carregarContas(const std::string& arquivo) {
-        std::ifstream file(arquivo);
-        if (!file.is_open()) {
-            throw std::runtime_error("Arquivo ContaCorrente.txt não encontrado.");
-        }
-
-        std::string linha;
+// ================================================================================================
+// FUNÇÃO PRINCIPAL
+// ================================================================================================
+/*
+ * Ponto de entrada do programa.
+ * Coordena a execução completa do sistema.
+ */
+int main(int argc, char* argv[]) {
+    try {
         /*
-         * LEITURA LINHA POR LINHA:
-         * Cada linha tem formato: ID|SALDO
-         */
-        while (std::getline(file, linha)) {
-            std::stringstream ss(linha);
-            std::string id;
-            double saldo;
-            
-            /*
-             * PARSING DA LINHA:
-             * - getline(ss, id, '|'): lê até encontrar '|'
-             * - ss >> saldo: lê o valor numérico
-             */
-            if (std::getline(ss, id, '|') && ss >> saldo) {
-                /*
-                 * PROTEÇÃO DO MAP:
-                 * Lock exclusivo para modificar a coleção de contas
-                 */
-                std::lock_guard<std::mutex> lock(contasMutex);
-                
-                /*
-                 * CRIAÇÃO DA CONTA:
-                 * make_unique cria um novo objeto ContaCorrente
-                 * e retorna um unique_ptr para ele
-                 */
-                contas[id] = std::make_unique<ContaCorrente>(id, saldo);
+         * ARGUMENTOS DE LINHA DE COMANDO:
+         * --log=nenhum|escritas|todas define a verbosidade do log de operações
+         * --motor=MOTOR[,MOTOR...]|todos escolhe o(s) motor(es) de contas
+         * --mix=padrao|transferencias|leitura|escrita|rotatividade|C:D:Q:T:L[:A:E] escolhe o mix de operações
+         * --distribuicao=uniforme|zipf[:THETA]|hotspot[:FRACAO:PROB] escolhe as contas
+         * --semente=N fixa a semente da carga
+         * --chegada=fechado|constante:TAXA|poisson:TAXA escolhe ciclo fechado ou aberto
+         * --bench-saturacao[=WORKERS] procura a taxa de saturação
+         * --servico=PRESET[,ETAPA=MODO:US]... configura o tempo de serviço
+         * --admissao=desligada|LEITORES:FILA:TIMEOUT_US configura o controle de admissão
+         * --combinacao=auto|desligada|sempre configura o flat combining
+         * --bench-combinacao compara os modos de combinação
+         * --auditoria=desligada|continua|MS liga o auditor de snapshots
+         * --bench-auditoria mede o custo dos snapshots
+         * --checkpoint=desligado|MS[:completo][,ARQUIVO] liga o checkpoint em segundo plano
+         * --bench-checkpoint[=N] mede o custo do checkpoint sobre N contas
+         * --capturar=ARQUIVO grava o trace das operações
+         * --reproduzir=ARQUIVO[,RAIAS] reproduz um trace e termina
+         * --bench-particionado[=N] compara o banco compartilhado com o particionado
+         * --corrotinas=N roda N clientes em corrotinas em cada simulação
+         * --bench-corrotinas[=MAX] compara uma thread por cliente com corrotinas
+         * --perfil-travas[=ARQUIVO] mede a disputa das travas de cada conta
+         * --telemetria[=MS[,ARQUIVO]] grava a série temporal de cada simulação
+         * --massa=TIPO[:PARAMETRO][,MS[,THREADS]] roda um trabalho em massa junto com a simulação
+         * --bench-massa[=N] mede quanto o trabalho em massa atrasa as operações online
+         * --bench-indice[=N] mede as buscas de contas no índice sem lock, com e sem rotatividade
+         * --arranjo=heap|compacto|alinhado escolhe o layout das contas
+         * --bench-coerencia mede o tráfego de coerência e termina
+         * --bench-varredura varre threads, contas, mix, distribuição, motor e duração
+         * --varrer-EIXO=V1,V2,... define os valores de um eixo da varredura
+         * --servidor=CAMINHO[,LACOS] atende pedidos por um socket Unix
+         * --cliente=CAMINHO[,PROCESSOS[,OPS[,JANELA]]] gera carga contra o servidor
+         * --bench-socket[=PROCESSOS] compara chamadas diretas e pelo socket
+         * --wal=desligado|LOTE:LATENCIA_US configura o group commit
+         * --bench-wal executa a comparação de configurações do WAL
+         * --bench-carga[=N] mede o tempo de carga de N contas
+         * --converter=ENTRADA,SAIDA converte o arquivo de contas e termina
+         * --verificar-wal[=N] confere a recuperação em cada corte do WAL e termina
+         * --verificar-concorrencia[=N] confere travas, trace e banco particionado e termina
+         */
+        std::vector<MotorConta> motores = {MotorConta::RWLOCK, MotorConta::ATOMICO};
+        MixOperacoes mix = MixOperacoes::padrao();
+        ConfigCarga configCarga;
+        ConfigChegada chegada;
+        ConfigAdmissao configAdmissao;
+        ModoCombinacao modoCombinacao = ModoCombinacao::AUTO;
+        ConfigWAL configWAL;
+        int benchSaturacao = 0;
+        bool benchCombinacao = false;
+        ConfigAuditoria configAuditoria;
+        bool benchAuditoria = false;
+        ConfigCheckpoint configCheckpoint;
+        size_t benchCheckpoint = 0;
+        size_t benchParticionado = 0;
+        size_t numCorrotinas = 0;
+        size_t benchCorrotinas = 0;
+        std::string arquivoCaptura;
+        std::string arquivoPerfilTravas;
+        int intervaloTelemetria = 0;                 // 0 = telemetria desligada
+        ConfigMassa configMassa;
+        size_t benchMassa = 0;
+        size_t benchIndice = 0;
+        std::string arquivoTelemetria = "telemetria.csv";
+        std::string reproduzirArquivo;
+        unsigned reproduzirRaias = threadsDisponiveis();
+        ArranjoContas arranjo = ArranjoContas::HEAP;
+        bool benchCoerencia = false;
+        ConfigVarredura varredura;
+        bool benchVarredura = false;
+        std::string servidorCaminho;
+        unsigned servidorLacos = threadsDisponiveis();
+        std::string clienteCaminho;
+        int clienteProcessos = 4, clienteOperacoes = 10000, clienteJanela = 1;
+        bool clienteBinario = false;
+        int benchSocket = 0;
+        bool benchWAL = false;
+        size_t benchCarga = 0;
+        size_t verificarWAL = 0;
+        size_t verificarConcorrencia = 0;
+        std::string converterEntrada, converterSaida;
+        for (int i = 1; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.rfind("--log=", 0) == 0) {
+                NivelLog nivel;
+                if (!interpretarNivelLog(arg.substr(6), nivel)) {
+                    std::cerr << "Nível de log inválido: " << arg.substr(6)
+                              << " (use nenhum, escritas ou todas)" << std::endl;
+                    return 1;
+                }
+                LoggerOperacoes::instancia().configurarNivel(nivel);
+            } else if (arg.rfind("--motor=", 0) == 0) {
+                if (!interpretarMotores(arg.substr(8), motores)) {
+                    std::cerr << "Motor inválido: " << arg.substr(8)
+                              << " (use rwlock, atomico, mutex, ttas, ticket, mcs, seqlock,"
+                              << " rwgiro, uma lista separada por vírgulas ou todos)" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--mix=", 0) == 0) {
+                if (!interpretarMix(arg.substr(6), mix)) {
+                    std::cerr << "Mix inválido: " << arg.substr(6)
+                              << " (use padrao, transferencias, leitura, escrita ou C:D:Q:T:L)"
+                              << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--distribuicao=", 0) == 0) {
+                if (!interpretarDistribuicao(arg.substr(15), configCarga)) {
+                    std::cerr << "Distribuição inválida: " << arg.substr(15)
+                              << " (use uniforme, zipf[:THETA] ou hotspot[:FRACAO:PROB])"
+                              << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--semente=", 0) == 0) {
+                try {
+                    configCarga.semente = std::stoull(arg.substr(10));
+                } catch (const std::exception&) {
+                    configCarga.semente = 0;
+                }
+                if (configCarga.semente == 0) {
+                    std::cerr << "Semente inválida: " << arg.substr(10)
+                              << " (use um inteiro positivo)" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--chegada=", 0) == 0) {
+                if (!interpretarChegada(arg.substr(10), chegada)) {
+                    std::cerr << "Chegada inválida: " << arg.substr(10)
+                              << " (use fechado, constante:TAXA ou poisson:TAXA)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-saturacao") {
+                benchSaturacao = 16;
+            } else if (arg.rfind("--bench-saturacao=", 0) == 0) {
+                try {
+                    benchSaturacao = std::stoi(arg.substr(18));
+                } catch (const std::exception&) {
+                    benchSaturacao = 0;
+                }
+                if (benchSaturacao <= 0) {
+                    std::cerr << "Número de workers inválido: " << arg.substr(18) << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--servico=", 0) == 0) {
+                if (!ModeloServico::instancia().configurar(arg.substr(10))) {
+                    std::cerr << "Modelo de serviço inválido: " << arg.substr(10)
+                              << " (use legado, nenhum ou giro, seguido de ETAPA=MODO:US;"
+                              << " modos nenhum, giro, sono, exp)" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--admissao=", 0) == 0) {
+                if (!interpretarConfigAdmissao(arg.substr(11), configAdmissao)) {
+                    std::cerr << "Admissão inválida: " << arg.substr(11)
+                              << " (use desligada ou LEITORES:FILA:TIMEOUT_US)" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--combinacao=", 0) == 0) {
+                if (!interpretarModoCombinacao(arg.substr(13), modoCombinacao)) {
+                    std::cerr << "Combinação inválida: " << arg.substr(13)
+                              << " (use auto, desligada ou sempre)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-combinacao") {
+                benchCombinacao = true;
+            } else if (arg.rfind("--auditoria=", 0) == 0) {
+                if (!interpretarConfigAuditoria(arg.substr(12), configAuditoria)) {
+                    std::cerr << "Auditoria inválida: " << arg.substr(12)
+                              << " (use desligada, continua ou o intervalo em ms)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-auditoria") {
+                benchAuditoria = true;
+            } else if (arg.rfind("--checkpoint=", 0) == 0) {
+                if (!interpretarConfigCheckpoint(arg.substr(13), configCheckpoint)) {
+                    std::cerr << "Checkpoint inválido: " << arg.substr(13)
+                              << " (use desligado ou MS[:completo][,ARQUIVO])" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--massa=", 0) == 0) {
+                if (!interpretarConfigMassa(arg.substr(8), configMassa)) {
+                    std::cerr << "Trabalho em massa inválido: " << arg.substr(8)
+                              << " (use desligada ou juros[:TAXA]|tarifa[:VALOR]|conciliacao[,MS[,THREADS]])"
+                              << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-massa") {
+                benchMassa = 100000;
+            } else if (arg.rfind("--bench-massa=", 0) == 0) {
+                try {
+                    benchMassa = static_cast<size_t>(std::stoull(arg.substr(14)));
+                } catch (const std::exception&) {
+                    benchMassa = 0;
+                }
+                if (benchMassa == 0) {
+                    std::cerr << "Quantidade de contas inválida: " << arg.substr(14) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-indice") {
+                benchIndice = 100000;
+            } else if (arg.rfind("--bench-indice=", 0) == 0) {
+                try {
+                    benchIndice = static_cast<size_t>(std::stoull(arg.substr(15)));
+                } catch (const std::exception&) {
+                    benchIndice = 0;
+                }
+                if (benchIndice == 0) {
+                    std::cerr << "Quantidade de contas inválida: " << arg.substr(15) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--telemetria") {
+                intervaloTelemetria = 100;
+            } else if (arg.rfind("--telemetria=", 0) == 0) {
+                std::string valor = arg.substr(13);
+                size_t virgula = valor.find(',');
+                if (virgula != std::string::npos) {
+                    arquivoTelemetria = valor.substr(virgula + 1);
+                    valor = valor.substr(0, virgula);
+                }
+                char sobra;
+                if (std::sscanf(valor.c_str(), "%d%c", &intervaloTelemetria, &sobra) != 1 ||
+                    intervaloTelemetria <= 0 || arquivoTelemetria.empty()) {
+                    std::cerr << "Use --telemetria[=MS[,ARQUIVO]]" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--perfil-travas") {
+                arquivoPerfilTravas = "perfil_travas.csv";
+            } else if (arg.rfind("--perfil-travas=", 0) == 0) {
+                arquivoPerfilTravas = arg.substr(16);
+                if (arquivoPerfilTravas.empty()) {
+                    std::cerr << "Use --perfil-travas[=ARQUIVO]" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--capturar=", 0) == 0) {
+                arquivoCaptura = arg.substr(11);
+                if (arquivoCaptura.empty()) {
+                    std::cerr << "Use --capturar=ARQUIVO" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--reproduzir=", 0) == 0) {
+                std::string valor = arg.substr(13);
+                size_t virgula = valor.find(',');
+                reproduzirArquivo = valor.substr(0, virgula);
+                if (virgula != std::string::npos) {
+                    char sobra;
+                    int raias = 0;
+                    if (std::sscanf(valor.c_str() + virgula + 1, "%d%c", &raias, &sobra) != 1 || raias <= 0) {
+                        std::cerr << "Use --reproduzir=ARQUIVO[,RAIAS]" << std::endl;
+                        return 1;
+                    }
+                    reproduzirRaias = static_cast<unsigned>(raias);
+                }
+                if (reproduzirArquivo.empty()) {
+                    std::cerr << "Use --reproduzir=ARQUIVO[,RAIAS]" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-checkpoint") {
+                benchCheckpoint = 100000;
+            } else if (arg.rfind("--bench-checkpoint=", 0) == 0) {
+                try {
+                    benchCheckpoint = static_cast<size_t>(std::stoull(arg.substr(19)));
+                } catch (const std::exception&) {
+                    benchCheckpoint = 0;
+                }
+                if (benchCheckpoint == 0) {
+                    std::cerr << "Quantidade de contas inválida: " << arg.substr(19) << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--corrotinas=", 0) == 0) {
+                try {
+                    numCorrotinas = static_cast<size_t>(std::stoull(arg.substr(13)));
+                } catch (const std::exception&) {
+                    numCorrotinas = 0;
+                }
+                if (numCorrotinas == 0) {
+                    std::cerr << "Quantidade de clientes inválida: " << arg.substr(13) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-corrotinas") {
+                benchCorrotinas = 100000;
+            } else if (arg.rfind("--bench-corrotinas=", 0) == 0) {
+                try {
+                    benchCorrotinas = static_cast<size_t>(std::stoull(arg.substr(19)));
+                } catch (const std::exception&) {
+                    benchCorrotinas = 0;
+                }
+                if (benchCorrotinas == 0) {
+                    std::cerr << "Quantidade de clientes inválida: " << arg.substr(19) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-particionado") {
+                benchParticionado = 100000;
+            } else if (arg.rfind("--bench-particionado=", 0) == 0) {
+                try {
+                    benchParticionado = static_cast<size_t>(std::stoull(arg.substr(21)));
+                } catch (const std::exception&) {
+                    benchParticionado = 0;
+                }
+                if (benchParticionado == 0) {
+                    std::cerr << "Quantidade de contas inválida: " << arg.substr(21) << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--arranjo=", 0) == 0) {
+                if (!interpretarArranjo(arg.substr(10), arranjo)) {
+                    std::cerr << "Arranjo inválido: " << arg.substr(10)
+                              << " (use heap, compacto ou alinhado)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-coerencia") {
+                benchCoerencia = true;
+            } else if (arg == "--bench-varredura") {
+                benchVarredura = true;
+            } else if (arg.rfind("--servidor=", 0) == 0) {
+                std::string valor = arg.substr(11);
+                size_t virgula = valor.find(',');
+                servidorCaminho = valor.substr(0, virgula);
+                if (virgula != std::string::npos) {
+                    char sobra;
+                    int lacos = 0;
+                    if (std::sscanf(valor.c_str() + virgula + 1, "%d%c", &lacos, &sobra) != 1 || lacos <= 0) {
+                        std::cerr << "Use --servidor=CAMINHO[,LACOS]" << std::endl;
+                        return 1;
+                    }
+                    servidorLacos = static_cast<unsigned>(lacos);
+                }
+            } else if (arg.rfind("--cliente=", 0) == 0) {
+                std::string valor = arg.substr(10);
+                size_t virgula = valor.find(',');
+                clienteCaminho = valor.substr(0, virgula);
+                if (virgula != std::string::npos) {
+                    std::string numeros = valor.substr(virgula + 1);
+                    int lidos = std::sscanf(numeros.c_str(), "%d,%d,%d", &clienteProcessos,
+                                            &clienteOperacoes, &clienteJanela);
+                    if (lidos < 1 || clienteProcessos <= 0 || clienteOperacoes <= 0 || clienteJanela <= 0) {
+                        std::cerr << "Use --cliente=CAMINHO[,PROCESSOS[,OPS[,JANELA]]]" << std::endl;
+                        return 1;
+                    }
+                }
+            } else if (arg == "--cliente-binario") {
+                clienteBinario = true;
+            } else if (arg == "--bench-socket") {
+                benchSocket = 4;
+            } else if (arg.rfind("--bench-socket=", 0) == 0) {
+                try {
+                    benchSocket = std::stoi(arg.substr(15));
+                } catch (const std::exception&) {
+                    benchSocket = 0;
+                }
+                if (benchSocket <= 0) {
+                    std::cerr << "Número de processos inválido: " << arg.substr(15) << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--varrer-", 0) == 0) {
+                size_t igual = arg.find('=');
+                std::string eixo = arg.substr(9, igual == std::string::npos ? std::string::npos : igual - 9);
+                if (igual == std::string::npos ||
+                    !interpretarEixoVarredura(eixo, arg.substr(igual + 1), varredura)) {
+                    std::cerr << "Eixo de varredura inválido: " << arg.substr(9)
+                              << " (use threads, contas, mix, distribuicao ou ops com uma lista"
+                              << " separada por vírgulas, ou aquecimento/repeticoes=N)" << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--wal=", 0) == 0) {
+                if (!interpretarConfigWAL(arg.substr(6), configWAL)) {
+                    std::cerr << "WAL inválido: " << arg.substr(6)
+                              << " (use desligado ou LOTE:LATENCIA_US)" << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--bench-wal") {
+                benchWAL = true;
+            } else if (arg == "--bench-carga") {
+                benchCarga = 1000000;
+            } else if (arg.rfind("--bench-carga=", 0) == 0) {
+                try {
+                    benchCarga = static_cast<size_t>(std::stoull(arg.substr(14)));
+                } catch (const std::exception&) {
+                    benchCarga = 0;
+                }
+                if (benchCarga == 0) {
+                    std::cerr << "Quantidade de contas inválida: " << arg.substr(14) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--verificar-wal") {
+                verificarWAL = 400;
+            } else if (arg.rfind("--verificar-wal=", 0) == 0) {
+                try {
+                    verificarWAL = static_cast<size_t>(std::stoull(arg.substr(16)));
+                } catch (const std::exception&) {
+                    verificarWAL = 0;
+                }
+                if (verificarWAL == 0) {
+                    std::cerr << "Quantidade de operações inválida: " << arg.substr(16) << std::endl;
+                    return 1;
+                }
+            } else if (arg == "--verificar-concorrencia") {
+                verificarConcorrencia = 20000;
+            } else if (arg.rfind("--verificar-concorrencia=", 0) == 0) {
+                try {
+                    verificarConcorrencia = static_cast<size_t>(std::stoull(arg.substr(25)));
+                } catch (const std::exception&) {
+                    verificarConcorrencia = 0;
+                }
+                if (verificarConcorrencia == 0) {
+                    std::cerr << "Quantidade de operações inválida: " << arg.substr(25) << std::endl;
+                    return 1;
+                }
+            } else if (arg.rfind("--converter=", 0) == 0) {
+                std::string valor = arg.substr(12);
+                size_t virgula = valor.find(',');
+                if (virgula == std::string::npos) {
+                    std::cerr << "Use --converter=ENTRADA,SAIDA" << std::endl;
+                    return 1;
+                }
+                converterEntrada = valor.substr(0, virgula);
+                converterSaida = valor.substr(virgula + 1);
+            } else {
+                std::cerr << "Argumento desconhecido: " << arg << std::endl;
+                return 1;
             }
         }
 
-        std::cout << "Carregadas " << contas.size() << " contas do arquivo." << std::endl;
-    }
-
-    /*
-     * SALVAMENTO DE CONTAS NO ARQUIVO:
-     * Escreve o estado atual de todas as contas
-     */
-    void salvarContas(const std::string& arquivo) {
-        std::ofstream file(arquivo);
-        if (!file.is_open()) {
-            std::cerr << "Erro ao salvar no arquivo: " << arquivo << std::endl;
-            return;
-        }
-
-        /*
-         * PROTEÇÃO PARA LEITURA:
-         * Lock durante a iteração para evitar modificações concorrentes
-         */
-        std::lock_guard<std::mutex> lock(contasMutex);
-        
         /*
-         * ITERAÇÃO ESTRUTURADA (C++17):
-         * for (const auto& [id, conta] : contas)
-         * Desempacota automaticamente o par<string, unique_ptr>
+         * ROTATIVIDADE DE CONTAS:
+         * Só o simulador abre e encerra contas; trace, clientes de socket e
+         * banco particionado trabalham com um conjunto fixo de contas
          */
-        for (const auto& [id, conta] : contas) {
-            file << id << "|" << std::fixed << std::setprecision(2) 
-                 << conta->getSaldoUnsafe() << std::endl;
-        }
-
-        std::cout << "Contas salvas no arquivo: " << arquivo << std::endl;
-    }
-
-    /*
-     * OBTENÇÃO DE PONTEIRO PARA CONTA:
-     * Retorna ponteiro raw para a conta (ou nullptr se não encontrar)
-     */
-    ContaCorrente* obterConta(const std::string& id) {
-        std::lock_guard<std::mutex> lock(contasMutex);
-        auto it = contas.find(id);
-        return (it != contas.end()) ? it->second.get() : nullptr;
-    }
-
-    /*
-     * LISTAGEM DE IDs:
-     * Retorna vetor com todos os IDs das contas
-     */
-    std::vector<std::string> listarContas() {
-        std::lock_guard<std::mutex> lock(contasMutex);
-        std::vector<std::string> ids;
-        for (const auto& [id, conta] : contas) {
-            ids.push_back(id);
+        if (mix.temRotatividade() &&
+            (!arquivoCaptura.empty() || !clienteCaminho.empty() || benchSocket > 0 || benchParticionado > 0)) {
+            std::cerr << "Mix com rotatividade não vale com --capturar, --cliente, --bench-socket "
+                      << "nem --bench-particionado" << std::endl;
+            return 1;
         }
-        return ids;
-    }
 
-    /*
-     * MÉTODOS PARA ESTATÍSTICAS:
-     * Operações atômicas - não precisam de mutex
-     */
-    void incrementarOperacoes() { operacoesRealizadas++; }
-    void incrementarFalhas() { operacoesFalhas++; }
-
-    int getOperacoesRealizadas() const { return operacoesRealizadas.load(); }
-    int getOperacoesFalhas() const { return operacoesFalhas.load(); }
-
-    /*
-     * RESET DE ESTATÍSTICAS:
-     * store() é uma operação atômica para definir novo valor
-     */
-    void resetarEstatisticas() {
-        operacoesRealizadas.store(0);
-        operacoesFalhas.store(0);
-    }
-
-    /*
-     * RELATÓRIO DE ESTATÍSTICAS:
-     * Mostra resultados da simulação
-     */
-    void imprimirEstatisticas() {
-        std::cout << "\n=== ESTATÍSTICAS FINAIS ===" << std::endl;
-        std::cout << "Operações realizadas: " << operacoesRealizadas.load() << std::endl;
-        std::cout << "Operações com falha: " << operacoesFalhas.load() << std::endl;
-        std::cout << "Total de tentativas: " << (operacoesRealizadas + operacoesFalhas) << std::endl;
-
-        std::cout << "\n=== SALDOS FINAIS ===" << std::endl;
-        std::lock_guard<std::mutex> lock(contasMutex);
-        for (const auto& [id, conta] : contas) {
-            std::cout << "Conta " << id << ": R$ " << std::fixed << std::setprecision(2) 
-                      << conta->getSaldoUnsafe() << std::endl;
-        }
-    }
-};
-
-// ===================================
-// Classe Simulador de Operações
-// ===================================
-class SimuladorOperacoes {
-private:
-    Banco& banco;                                    // Referência ao banco
-    std::mt19937 rng;                               // Gerador de números aleatórios
-    std::uniform_int_distribution<> operacaoDist;   // Distribuição para tipo de operação (0-2)
-    std::uniform_real_distribution<> valorDist;     // Distribuição para valores (10-500)
-    std::atomic<bool> executando{true};             // Flag para parar execução
-
-public:
-    /*
-     * CONSTRUTOR:
-     * Inicializa o gerador aleatório e as distribuições
-     */
-    SimuladorOperacoes(Banco& b) : banco(b), 
-                                   rng(std::random_device{}()),      // Seed aleatória
-                                   operacaoDist(0, 2),              // 0=crédito, 1=débito, 2=consulta
-                                   valorDist(10.0, 500.0) {}        // Valores entre R$ 10 e R$ 500
-
-    /*
-     * EXECUÇÃO DE OPERAÇÕES POR THREAD:
-     * Cada thread executa um número determinado de operações aleatórias
-     */
-    void executarOperacoes(int threadId, int numOperacoes) {
         /*
-         * OBTENÇÃO DA LISTA DE CONTAS:
-         * Cada thread obtém uma cópia da lista de IDs
+         * MODO CLIENTE:
+         * Antes de criar o sistema (e qualquer thread), porque os processos
+         * clientes são criados com fork
          */
-        auto contas = banco.listarContas();
-        if (contas.empty()) return;
-
-        /*
-         * DISTRIBUIÇÃO PARA SELEÇÃO DE CONTA:
-         * Gera índices aleatórios para selecionar contas
-         */
-        std::uniform_int_distribution<> contaDist(0, contas.size() - 1);
-
-        /*
-         * LOOP PRINCIPAL DE OPERAÇÕES:
-         * Cada thread executa o número especificado de operações
-         */
-        for (int i = 0; i < numOperacoes && executando; ++i) {
-            /*
-             * SELEÇÃO ALEATÓRIA DE CONTA:
-             */
-            std::string contaId = contas[contaDist(rng)];
-            ContaCorrente* conta = banco.obterConta(contaId);
-            
-            if (!conta) {
-                banco.incrementarFalhas();
-                continue;
+        if (!clienteCaminho.empty()) {
+            ResultadoCliente r = executarClientesCarga(clienteCaminho, clienteProcessos, clienteOperacoes,
+                                                       clienteJanela, mix, configCarga);
+            if (clienteBinario) {
+                // Resultado para o benchmark de socket, que lê a saída padrão
+                return escreverTudo(STDOUT_FILENO, &r, sizeof(r)) && r.operacoes > 0 ? 0 : 1;
             }
+            std::cout << "=== CLIENTES DE CARGA (" << clienteProcessos << " processos, janela "
+                      << clienteJanela << ") ===" << std::endl;
+            std::cout << "Operações: " << r.operacoes << " (" << r.sucessos << " sucessos, " << r.falhas
+                      << " falhas, " << r.rejeicoes << " recusadas, " << r.invalidos << " inválidas)"
+                      << std::endl;
+            std::cout << "Vazão: " << std::fixed << std::setprecision(0) << r.opsPorSegundo() << " ops/s"
+                      << std::endl;
+            std::cout << "Latência (us): p50 " << std::setprecision(1) << r.latencia.percentilUs(50.0)
+                      << ", p99 " << r.latencia.percentilUs(99.0) << ", p99.9 "
+                      << r.latencia.percentilUs(99.9) << ", máx " << r.latencia.getMaximoNs() / 1000.0
+                      << std::endl;
+            std::cout << "Pedidos por write: " << std::setprecision(2)
+                      << (r.escritas ? static_cast<double>(r.operacoes) / r.escritas : 0) << std::endl;
+            return r.operacoes > 0 ? 0 : 1;
+        }
 
-            /*
-             * SELEÇÃO ALEATÓRIA DE OPERAÇÃO:
-             * 0 = crédito, 1 = débito, 2 = consulta
-             */
-            int operacao = operacaoDist(rng);
-            double valor = valorDist(rng);
-            bool sucesso = false;
-
-            /*
-             * EXECUÇÃO DA OPERAÇÃO:
-             * Switch baseado no tipo de operação sorteado
-             */
-            switch (operacao) {
-                case 0: sucesso = conta->creditar(valor); break;
-                case 1: sucesso = conta->debitar(valor); break;
-                case 2: sucesso = (conta->consultarSaldo() >= 0); break;
+        if (numCorrotinas > 0 || benchCorrotinas > 0) {
+            if (!BANCO_CORROTINAS) {
+                std::cerr << "Clientes em corrotinas exigem compilar com -std=c++20" << std::endl;
+                return 1;
+            }
+            if (chegada.aberto()) {
+                std::cerr << "Clientes em corrotinas usam ciclo fechado (sem --chegada)" << std::endl;
+                return 1;
             }
-
-            /*
-             * ATUALIZAÇÃO DE ESTATÍSTICAS:
-             * Incrementa contador apropriado baseado no resultado
-             */
-            sucesso ? banco.incrementarOperacoes() : banco.incrementarFalhas();
-            
-            /*
-             * PAUSA ENTRE OPERAÇÕES:
-             * Simula tempo de processamento entre operações
-             */
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
         }
 
-        std::cout << "Thread " << threadId << " finalizou suas operações.\n";
-    }
-
-    /*
-     * PARADA SEGURA:
-     * Sinaliza para todas as threads pararem
-     */
-    void pararExecucao() {
-        executando.store(false);
-    }
-};
-
-// ================================================================================================
-// CLASSE LOGGER PARA SIMULAÇÕES
-// ================================================================================================
-/*
- * Responsável por registrar os resultados das simulações em arquivo CSV
- * para análise posterior de performance.
- */
-class LoggerSimulacao {
-private:
-    std::mutex logMutex;        // Proteção para escrita no arquivo
-    std::string nomeArquivo;    // Nome do arquivo de log
-    bool headerEscrito;         // Flag para controle do cabeçalho
-
-public:
-    LoggerSimulacao(const std::string& arquivo) : nomeArquivo(arquivo), headerEscrito(false) {}
-
-    /*
-     * REGISTRO DE LOG DE SIMULAÇÃO:
-     * Salva métricas da simulação em formato CSV
-     */
-    void registrarLogSimulacao(int numThreads, int operacoesPorThread, 
-                              long long tempoExecucao, int operacoesSucesso, 
-                              int operacoesFalhas) {
-        std::lock_guard<std::mutex> lock(logMutex);
-        
         /*
-         * VERIFICAÇÃO DE ARQUIVO EXISTENTE:
-         * Determina se precisa escrever o cabeçalho CSV
+         * INICIALIZAÇÃO:
+         * Cria e inicializa o sistema bancário
          */
-        std::ifstream teste(nomeArquivo);
-        bool arquivoExiste = teste.good();
-        teste.close();
-        
+        SistemaBancario sistema;
+
         /*
-         * ABERTURA EM MODO APPEND:
-         * Adiciona ao final do arquivo sem sobrescrever
+         * MODOS QUE NÃO EXECUTAM SIMULAÇÕES
          */
-        std::ofstream arquivo(nomeArquivo, std::ios::app);
-        if (!arquivo.is_open()) {
-            std::cerr << "Erro ao abrir arquivo de log: " << nomeArquivo << std::endl;
-            return;
+        if (!converterEntrada.empty()) {
+            sistema.converterContas(converterEntrada, converterSaida);
+            return 0;
         }
-        
-        /*
-         * ESCRITA DO CABEÇALHO:
-         * Apenas se o arquivo não existe
-         */
-        if (!arquivoExiste) {
-            arquivo << "NumThreads,OperacoesPorThread,TotalOperacoes,TempoExecucao_ms,"
-                   << "OperacoesSucesso,OperacoesFalhas,TaxaSucesso,Throughput_ops_ms,"
-                   << "Timestamp\n";
+        if (benchCarga > 0) {
+            sistema.executarBenchmarkCarga(benchCarga);
+            return 0;
         }
-        
-        /*
-         * CÁLCULO DE MÉTRICAS DERIVADAS:
-         */
-        int totalOperacoes = numThreads * operacoesPorThread;
-        double taxaSucesso = (totalOperacoes > 0) ? 
-                           (static_cast<double>(operacoesSucesso) / totalOperacoes) * 100 : 0;
-        double throughput = (tempoExecucao > 0) ? 
-                          static_cast<double>(operacoesSucesso) / tempoExecucao : 0;
-        
-        /*
-         * GERAÇÃO DE TIMESTAMP:
-         * Marca temporal para cada simulação
-         */
-        auto agora = std::chrono::system_clock::now();
-        auto tempo_t = std::chrono::system_clock::to_time_t(agora);
-        std::stringstream ss;
-        ss << std::put_time(std::localtime(&tempo_t), "%Y-%m-%d %H:%M:%S");
-        
-        /*
-         * ESCRITA DOS DADOS:
-         * Formato CSV com vírgula como separador
-         */
-        arquivo << numThreads << ","
-                << operacoesPorThread << ","
-                << totalOperacoes << ","
-                << tempoExecucao << ","
-                << operacoesSucesso << ","
-                << operacoesFalhas << ","
-                << std::fixed << std::setprecision(2) << taxaSucesso << ","
-                << std::fixed << std::setprecision(4) << throughput << ","
-                << ss.str() << "\n";
-        
-        arquivo.close();
-        
-        std::cout << "Log registrado: " << numThreads << " threads, " 
-                  << tempoExecucao << "ms, " << operacoesSucesso << " sucessos, "
-                  << operacoesFalhas << " falhas" << std::endl;
-    }
-    
-    /*
-     * LIMPEZA DE LOGS:
-     * Remove o conteúdo do arquivo de log
-     */
-    void limparLogs() {
-        std::lock_guard<std::mutex> lock(logMutex);
-        std::ofstream arquivo(nomeArquivo, std::ios::trunc);
-        arquivo.close();
-        headerEscrito = false;
-        std::cout << "Logs limpos do arquivo: " << nomeArquivo << std::endl;
-    }
-};
-
-// ===================================
-// Classe principal Sistema Bancário
-// ===================================
-class SistemaBancario {
-private:
-    std::unique_ptr<Banco> banco;                    // Instância do banco
-    std::unique_ptr<SimuladorOperacoes> simulador;   // Simulador de operações
-    std::unique_ptr<LoggerSimulacao> logger;         // Logger para CSV
-
-public:
-    /*
-     * CONSTRUTOR:
-     * Inicializa apenas o logger (banco será criado na inicialização)
-     */
-    SistemaBancario() : logger(std::make_unique<LoggerSimulacao>("simulacao_logs.csv")) {}
-
-    /*
-     * INICIALIZAÇÃO DO SISTEMA:
-     * Cria instâncias e carrega dados iniciais
-     */
-    void inicializar() {
-        std::cout << "=== INICIALIZANDO SISTEMA BANCÁRIO ===" << std::endl;
-        
-        /*
-         * CRIAÇÃO DE INSTÂNCIAS:
-         * make_unique cria objetos e retorna unique_ptr
-         */
-        banco = std::make_unique<Banco>();
-        simulador = std::make_unique<SimuladorOperacoes>(*banco);
-        
-        /*
-         * CARREGAMENTO DE DADOS:
-         * Lê contas do arquivo texto
-         */
-        banco->carregarContas("ContaCorrente.txt");
-    }
-
-    /*
-     * EXECUÇÃO DE SIMULAÇÃO ÚNICA:
-     * Executa uma simulação com parâmetros específicos
-     */
-    void executarSimulacao(int numThreads, int operacoesPorThread) {
-        std::cout << "\n=== INICIANDO SIMULAÇÃO ===" << std::endl;
-        std::cout << "Threads: " << numThreads << std::endl;
-        std::cout << "Operações por thread: " << operacoesPorThread << std::endl;
-
-        /*
-         * RESET DE ESTATÍSTICAS:
-         * Limpa contadores antes de começar
-         */
-        banco->resetarEstatisticas();
-
-        /*
-         * MEDIÇÃO DE TEMPO:
-         * Marca o início da simulação
-         */
-        auto inicio = std::chrono::high_resolution_clock::now();
-
-        /*
-         * CRIAÇÃO E EXECUÇÃO DE THREADS:
-         * Cada thread executa o número especificado de operações
-         */
-        std::vector<std::thread> threads;
-
-        // Cria threads
-        for (int i = 0; i < numThreads; ++i) {
-            threads.emplace_back(&SimuladorOperacoes::executarOperacoes,
-                                 simulador.get(), i, operacoesPorThread);
+        if (benchCoerencia) {
+            sistema.executarBenchmarkCoerencia();
+            return 0;
         }
 
-        /*
-         * SINCRONIZAÇÃO:
-         * Espera todas as threads terminarem
-         */
-        for (auto& t : threads) {
-            t.join();
+        sistema.configurarMotores(motores);
+        sistema.configurarMix(mix);
+        sistema.configurarCarga(configCarga);
+        sistema.configurarChegada(chegada);
+        sistema.configurarAdmissao(configAdmissao);
+        sistema.configurarCombinacao(modoCombinacao);
+        sistema.configurarAuditoria(configAuditoria);
+        sistema.configurarArranjo(arranjo);
+        sistema.configurarWAL(configWAL);
+        sistema.configurarCheckpoint(configCheckpoint);
+        sistema.configurarCaptura(arquivoCaptura);
+        sistema.configurarMassa(configMassa);
+        sistema.configurarClientes(numCorrotinas);
+        if (!arquivoPerfilTravas.empty() && !sistema.configurarPerfilTravas(arquivoPerfilTravas)) return 1;
+        if (intervaloTelemetria > 0 && !sistema.configurarTelemetria(intervaloTelemetria, arquivoTelemetria)) {
+            return 1;
         }
 
-        /*
-         * MEDIÇÃO FINAL:
-         * Calcula tempo total de execução
-         */
-        auto fim = std::chrono::high_resolution_clock::now();
-        auto duracao = std::chrono::duration_cast<std::chrono::milliseconds>(fim - inicio);
-
-        /*
-         * COLETA DE RESULTADOS:
-         * Obtém estatísticas finais
-         */
-        int operacoesSucesso = banco->getOperacoesRealizadas();
-        int operacoesFalhas = banco->getOperacoesFalhas();
-
-        std::cout << "\n=== SIMULAÇÃO CONCLUÍDA ===" << std::endl;
-        std::cout << "Tempo de execução: " << duracao.count() << " ms" << std::endl;
-
-        /*
-         * REGISTRO DE LOG:
-         * Salva resultados no arquivo CSV
-         */
-        logger->registrarLogSimulacao(numThreads, operacoesPorThread, 
-                                     duracao.count(), operacoesSucesso, 
-                                     operacoesFalhas);
-
-        /*
-         * RELATÓRIOS E PERSISTÊNCIA:
-         * Mostra estatísticas e salva estado final
-         */
-        banco->imprimirEstatisticas();
-        banco->salvarContas("ContaCorrente.txt");
-    }
-
-    /*
-     * MÚLTIPLAS SIMULAÇÕES:
-     * Executa simulações com diferentes números de threads
-     */
-    void executarMultiplasSimulacoes() {
-        /*
-         * CONFIGURAÇÃO DE TESTE:
-         * Array com diferentes números de threads para testar
-         */
-        std::vector<int> numThreads = {2, 4, 7, 12, 13};
-        int operacoesPorThread = 50;
-
-        std::cout << "=== INICIANDO MÚLTIPLAS SIMULAÇÕES ===" << std::endl;
-        std::cout << "Será gerado arquivo: simulacao_logs.csv" << std::endl;
+        if (!reproduzirArquivo.empty()) {
+            return sistema.executarReproducao(reproduzirArquivo, reproduzirRaias) ? 0 : 1;
+        }
+        if (verificarWAL > 0) return sistema.verificarRecuperacaoWAL(verificarWAL) ? 0 : 1;
+        if (verificarConcorrencia > 0) return sistema.verificarConcorrencia(verificarConcorrencia) ? 0 : 1;
 
         /*
-         * LOOP DE SIMULAÇÕES:
-         * Para cada configuração de threads
+         * MODOS COM SOCKET (não gravam o CSV de simulações)
          */
-        for (int threads : numThreads) {
-            std::cout << "\n" << std::string(50, '=') << "\n";
-            std::cout << "SIMULAÇÃO COM " << threads << " THREADS\n";
-            std::cout << std::string(50, '=') << "\n";
-
-            /*
-             * RECREAÇÃO DE OBJETOS:
-             * Garante estado limpo para cada simulação
-             */
-            banco = std::make_unique<Banco>();
-            banco->carregarContas("ContaCorrente.txt");
-            simulador = std::make_unique<SimuladorOperacoes>(*banco);
-
-            /*
-             * EXECUÇÃO DA SIMULAÇÃO:
-             */
-            executarSimulacao(threads, operacoesPorThread);
-            
-            /*
-             * PAUSA ENTRE SIMULAÇÕES:
-             * Evita sobrecarga do sistema
-             */
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        if (!servidorCaminho.empty()) {
+            sistema.executarServidor(servidorCaminho, servidorLacos);
+            return 0;
         }
-    }
-
-    /*
-     * SIMULAÇÃO PERSONALIZADA:
-     * Permite especificar configurações customizadas
-     */
-    void executarSimulacaoPersonalizada(const std::vector<int>& threads, 
-                                       int operacoesPorThread) {
-        std::cout << "=== SIMULAÇÃO PERSONALIZADA ===" << std::endl;
-        
-        for (int numThreads : threads) {
-            std::cout << "\n" << std::string(50, '=') << "\n";
-            std::cout << "SIMULAÇÃO COM " << numThreads << " THREADS\n";
-            std::cout << std::string(50, '=') << "\n";
-
-            // Mesmo padrão: recria objetos para estado limpo
-            banco = std::make_unique<Banco>();
-            banco->carregarContas("ContaCorrente.txt");
-            simulador = std::make_unique<SimuladorOperacoes>(*banco);
-
-            executarSimulacao(numThreads, operacoesPorThread);
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        if (benchSocket > 0) {
+            sistema.executarBenchmarkSocket(benchSocket);
+            return 0;
         }
-    }
-
-    /*
-     * LIMPEZA DE LOGS:
-     * Remove logs anteriores
-     */
-    void limparLogs() {
-        logger->limparLogs();
-    }
-};
 
-// ================================================================================================
-// FUNÇÃO PRINCIPAL
-// ================================================================================================
-/*
- * Ponto de entrada do programa.
- * Coordena a execução completa do sistema.
- */
-int main() {
-    try {
-        /*
-         * INICIALIZAÇÃO:
-         * Cria e inicializa o sistema bancário
-         */
-        SistemaBancario sistema;
         sistema.inicializar();
         std::cout << "Sistema bancario inicializado com sucesso" << std::endl;
         
@@ -765,7 +788,29 @@ int main() {
          * Roda simulações com diferentes números de threads
          * Os resultados são salvos automaticamente em CSV
          */
-        sistema.executarMultiplasSimulacoes();
+        if (benchWAL) {
+            sistema.executarBenchmarkWAL();
+        } else if (benchAuditoria) {
+            sistema.executarBenchmarkAuditoria();
+        } else if (benchCheckpoint > 0) {
+            sistema.executarBenchmarkCheckpoint(benchCheckpoint);
+        } else if (benchMassa > 0) {
+            sistema.executarBenchmarkMassa(benchMassa);
+        } else if (benchIndice > 0) {
+            sistema.executarBenchmarkIndice(benchIndice);
+        } else if (benchParticionado > 0) {
+            sistema.executarBenchmarkParticionado(benchParticionado);
+        } else if (benchCorrotinas > 0) {
+            sistema.executarBenchmarkCorrotinas(benchCorrotinas);
+        } else if (benchCombinacao) {
+            sistema.executarBenchmarkCombinacao();
+        } else if (benchSaturacao > 0) {
+            sistema.executarBenchmarkSaturacao(benchSaturacao);
+        } else if (benchVarredura) {
+            sistema.executarVarredura(varredura);
+        } else {
+            sistema.executarMultiplasSimulacoes();
+        }
         
         /*
          * FINALIZAÇÃO:
@@ -0,0 +1,2565 @@
+/*
+ * BANCO
+ * Trace de operações, lotes, histogramas de latência, arena e índice de
+ * contas e a classe Banco sobre um motor de conta
+ */
+#ifndef BANCO_BANCO_HPP
+#define BANCO_BANCO_HPP
+
+#include "motores.hpp"
+#include "wal.hpp"
+
+// ===================================
+// Trace de operações
+// ===================================
+/*
+ * FORMATO DO TRACE (binário, little-endian):
+ * - Cabeçalho com mágica, versão, tamanho do registro e quantidades
+ * - Tabela de contas: um RegistroContaBin por índice global, com o ID e
+ *   o saldo no início da captura. O trace carrega o estado de partida,
+ *   então é reproduzido sem depender do arquivo de contas da época
+ * - Registros de 24 bytes na ordem em que as operações aplicaram (ou
+ *   recusaram) cada conta, com as contas pelo índice na tabela e o
+ *   resultado visto na captura
+ * - Ao fechar, a tabela com o saldo final de cada índice (versão 2),
+ *   que a reprodução confere
+ * - As operações de um lote são registros seguidos com a flag LOTE;
+ *   todos menos o último têm também CONTINUA
+ * 24 bytes por operação, contra 64 de um registro do WAL (que guarda
+ * os IDs por extenso).
+ */
+struct CabecalhoTrace {
+    char magica[8];          // "BANCOTRC"
+    uint32_t versao;
+    uint32_t tamanhoRegistro;
+    uint64_t numContas;
+    uint64_t numRegistros;   // Gravado ao fechar (0 = captura interrompida; vale o tamanho do arquivo)
+};
+
+struct RegistroTrace {
+    uint8_t tipo;            // TipoRegistro (crédito, débito, consulta, transferência)
+    uint8_t flags;           // GravadorTrace::LOTE | GravadorTrace::CONTINUA
+    uint8_t status;          // StatusOperacao observado na captura
+    uint8_t reservado;
+    uint32_t conta;          // Índice na tabela (SEM_CONTA = conta inexistente)
+    uint32_t destino;        // Só transferências
+    uint32_t reservado2;
+    int64_t valorCentavos;
+};
+
+static_assert(sizeof(CabecalhoTrace) == 32, "CabecalhoTrace deve ter 32 bytes");
+static_assert(sizeof(RegistroTrace) == 24, "RegistroTrace deve ter 24 bytes");
+
+/*
+ * GRAVAÇÃO DO TRACE:
+ * - Cada operação reserva a sua posição (reservar) com as contas ainda
+ *   travadas, como o LSN do WAL, e registra depois de soltá-las
+ * - registrar() põe no buffer só a sequência contígua a partir da
+ *   próxima posição; registros adiantados esperam num map as posições
+ *   anteriores (de operações que ainda não registraram)
+ * - O buffer cheio é trocado por um vazio e gravado fora do bufferMutex;
+ *   arquivoMutex é adquirido antes de soltar bufferMutex, então os
+ *   buffers chegam ao arquivo na ordem em que foram trocados
+ * Assim o arquivo fica na ordem das posições, não na ordem em que as
+ * operações terminaram.
+ */
+class GravadorTrace {
+public:
+    static constexpr uint32_t VERSAO = 2;
+    static constexpr uint32_t SEM_CONTA = 0xFFFFFFFFu;
+    static constexpr uint64_t SEM_POSICAO = ~0ULL;
+    static constexpr uint8_t LOTE = 1;
+    static constexpr uint8_t CONTINUA = 2;
+
+private:
+    static constexpr size_t TAMANHO_BUFFER = 4096;      // Registros por write
+
+    int fd = -1;
+    uint64_t numContas = 0;
+    std::atomic<uint64_t> proximaPosicao{0};
+    std::mutex bufferMutex;
+    std::vector<RegistroTrace> buffer;
+    uint64_t posicaoBuffer = 0;                          // Próxima posição do buffer (bufferMutex)
+    std::map<uint64_t, RegistroTrace> adiantados;        // Posição -> registro (bufferMutex)
+    std::mutex arquivoMutex;
+    uint64_t gravados = 0;                               // Protegido por arquivoMutex
+    bool erro = false;                                   // Protegido por arquivoMutex
+
+    void gravar(const std::vector<RegistroTrace>& registros) {
+        if (erro || registros.empty()) return;
+        erro = !escreverTudo(fd, registros.data(), registros.size() * sizeof(RegistroTrace));
+        if (!erro) gravados += registros.size();
+    }
+
+public:
+    // 'contas' por índice global; ID vazio = índice sem conta
+    GravadorTrace(const std::string& arquivo, const std::vector<ContaLida>& contas)
+        : numContas(contas.size()) {
+        fd = ::open(arquivo.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) return;
+        CabecalhoTrace cab{};
+        std::memcpy(cab.magica, "BANCOTRC", 8);
+        cab.versao = VERSAO;
+        cab.tamanhoRegistro = sizeof(RegistroTrace);
+        cab.numContas = numContas;
+        std::vector<RegistroContaBin> tabela(contas.size());
+        for (size_t i = 0; i < contas.size(); ++i) {
+            if (!contas[i].id.empty()) {
+                tabela[i] = ArmazenamentoContas::registroBinario(contas[i].id, contas[i].saldo);
+            }
+        }
+        erro = !escreverTudo(fd, &cab, sizeof(cab)) ||
+               !escreverTudo(fd, tabela.data(), tabela.size() * sizeof(RegistroContaBin));
+        buffer.reserve(TAMANHO_BUFFER);
+    }
+
+    ~GravadorTrace() { fechar(); }
+
+    GravadorTrace(const GravadorTrace&) = delete;
+    GravadorTrace& operator=(const GravadorTrace&) = delete;
+
+    bool aberto() const { return fd >= 0; }
+
+    // Posição dos próximos 'quantidade' registros (chamada com as contas travadas)
+    uint64_t reservar(size_t quantidade) {
+        return proximaPosicao.fetch_add(quantidade, std::memory_order_relaxed);
+    }
+
+    // Sem posição reservada (operação que não chegou a travar contas), reserva agora
+    void registrar(const RegistroTrace* registros, size_t quantidade, uint64_t posicao = SEM_POSICAO) {
+        if (quantidade == 0) return;
+        if (posicao == SEM_POSICAO) posicao = reservar(quantidade);
+        std::unique_lock<std::mutex> lock(bufferMutex);
+        if (posicao != posicaoBuffer) {
+            for (size_t i = 0; i < quantidade; ++i) adiantados.emplace(posicao + i, registros[i]);
+            return;
+        }
+        buffer.insert(buffer.end(), registros, registros + quantidade);
+        posicaoBuffer += quantidade;
+        for (auto it = adiantados.begin(); it != adiantados.end() && it->first == posicaoBuffer;
+             it = adiantados.erase(it)) {
+            buffer.push_back(it->second);
+            posicaoBuffer++;
+        }
+        if (buffer.size() < TAMANHO_BUFFER) return;
+        std::vector<RegistroTrace> cheio;
+        cheio.reserve(TAMANHO_BUFFER);
+        cheio.swap(buffer);
+        std::lock_guard<std::mutex> lockArquivo(arquivoMutex);
+        lock.unlock();
+        gravar(cheio);
+    }
+
+    /*
+     * FECHAMENTO:
+     * Chamado sem operações em andamento: grava o que sobrou no buffer
+     * (e algum adiantado cuja posição anterior nunca foi registrada), a
+     * tabela de saldos finais e o total de registros no cabeçalho.
+     * Retorna quantos registros foram gravados.
+     */
+    uint64_t fechar(const std::vector<ContaLida>& finais = {}) {
+        std::lock_guard<std::mutex> lockBuffer(bufferMutex);
+        std::lock_guard<std::mutex> lockArquivo(arquivoMutex);
+        if (fd < 0) return gravados;
+        for (const auto& [posicao, r] : adiantados) buffer.push_back(r);
+        adiantados.clear();
+        gravar(buffer);
+        buffer.clear();
+        uint64_t total = gravados;
+        std::vector<RegistroContaBin> tabela(numContas);
+        for (size_t i = 0; i < finais.size() && i < tabela.size(); ++i) {
+            if (!finais[i].id.empty()) tabela[i] = ArmazenamentoContas::registroBinario(finais[i].id, finais[i].saldo);
+        }
+        if (!erro && total > 0) {
+            erro = !escreverTudo(fd, tabela.data(), tabela.size() * sizeof(RegistroContaBin));
+        }
+        if (!erro) {
+            erro = !escreverTudo(fd, &total, sizeof(total), offsetof(CabecalhoTrace, numRegistros)) ||
+                   ::fdatasync(fd) != 0;
+        }
+        if (erro) std::cerr << "Erro ao gravar o trace de operações" << std::endl;
+        ::close(fd);
+        fd = -1;
+        return gravados;
+    }
+};
+
+/*
+ * LEITURA DO TRACE:
+ * Valida o cabeçalho e devolve a tabela de contas (por índice, ID vazio
+ * nos índices sem conta), os registros e, se a captura foi fechada por
+ * uma versão que a grava, a tabela de saldos finais. Uma captura
+ * interrompida (numRegistros = 0) é lida até o último registro completo.
+ */
+struct TraceOperacoes {
+    std::vector<ContaLida> contas;
+    std::vector<RegistroTrace> registros;
+    std::vector<ContaLida> finais;          // Vazio: trace sem saldos finais
+};
+
+inline TraceOperacoes lerTrace(const std::string& arquivo) {
+    ArquivoMapeado mapa(arquivo);
+    if (!mapa.aberto()) throw std::runtime_error("Trace não encontrado: " + arquivo);
+    CabecalhoTrace cab;
+    if (mapa.size() < sizeof(cab)) throw std::runtime_error("Trace sem cabeçalho: " + arquivo);
+    std::memcpy(&cab, mapa.data(), sizeof(cab));
+    if (std::memcmp(cab.magica, "BANCOTRC", 8) != 0 || cab.versao < 1 || cab.versao > GravadorTrace::VERSAO ||
+        cab.tamanhoRegistro != sizeof(RegistroTrace)) {
+        throw std::runtime_error("Trace com cabeçalho inválido ou versão não suportada: " + arquivo);
+    }
+    size_t inicioRegistros = sizeof(cab) + cab.numContas * sizeof(RegistroContaBin);
+    if (mapa.size() < inicioRegistros) throw std::runtime_error("Trace truncado na tabela de contas.");
+    size_t disponiveis = (mapa.size() - inicioRegistros) / sizeof(RegistroTrace);
+    if (cab.numRegistros > disponiveis) throw std::runtime_error("Trace truncado nos registros.");
+
+    auto lerTabela = [&](size_t inicio) {
+        std::vector<ContaLida> tabela(cab.numContas);
+        for (size_t i = 0; i < cab.numContas; ++i) {
+            RegistroContaBin r;
+            std::memcpy(&r, mapa.data() + inicio + i * sizeof(r), sizeof(r));
+            r.id[sizeof(r.id) - 1] = '\0';
+            tabela[i] = {r.id, static_cast<double>(r.saldoCentavos) / 100.0};
+        }
+        return tabela;
+    };
+
+    TraceOperacoes trace;
+    trace.contas = lerTabela(sizeof(cab));
+    trace.registros.resize(cab.numRegistros ? cab.numRegistros : disponiveis);
+    if (!trace.registros.empty()) {
+        std::memcpy(trace.registros.data(), mapa.data() + inicioRegistros,
+                    trace.registros.size() * sizeof(RegistroTrace));
+    }
+    size_t inicioFinais = inicioRegistros + cab.numRegistros * sizeof(RegistroTrace);
+    if (cab.versao >= 2 && cab.numRegistros > 0 &&
+        mapa.size() >= inicioFinais + cab.numContas * sizeof(RegistroContaBin)) {
+        trace.finais = lerTabela(inicioFinais);
+        bool algum = std::any_of(trace.finais.begin(), trace.finais.end(),
+                                 [](const ContaLida& c) { return !c.id.empty(); });
+        if (!algum) trace.finais.clear();
+    }
+    return trace;
+}
+
+// ===================================
+// Operações em lote
+// ===================================
+/*
+ * OPERAÇÃO DE UM LOTE:
+ * Um lote é executado de forma atômica: ou todas as operações
+ * são aplicadas ou nenhuma (o lote é abortado e desfeito)
+ */
+enum class TipoOperacaoLote { CREDITO, DEBITO, TRANSFERENCIA };
+
+struct OperacaoLote {
+    TipoOperacaoLote tipo;
+    std::string conta;      // Conta afetada (origem, nas transferências)
+    std::string destino;    // Conta de destino (apenas transferências)
+    double valor;
+};
+
+/*
+ * PAR DE CONTAS MAIS DISPUTADO:
+ * Usado no relatório de contenção das transferências
+ */
+struct ParContencao {
+    std::string contaA;
+    std::string contaB;
+    int transferencias = 0;
+    int abortos = 0;
+    long long esperaNs = 0;
+};
+
+// ===================================
+// Histogramas de latência (estilo HDR)
+// ===================================
+/*
+ * BALDES LOG-LINEARES:
+ * - Valores até 127 ns têm um balde cada
+ * - Acima disso, cada potência de 2 é dividida em 64 baldes,
+ *   então o erro relativo de qualquer valor fica abaixo de 1,6%
+ * - Registrar é só um cálculo de índice e um incremento, sem alocação
+ *
+ * Cada histograma tem um único escritor (a thread dona); a junção dos
+ * histogramas das threads é feita depois que a execução termina.
+ */
+class HistogramaLatencia {
+public:
+    static constexpr int BITS_SUBBALDE = 7;
+    static constexpr int MEIO_SUBBALDES = 1 << (BITS_SUBBALDE - 1);
+    static constexpr int MAIOR_EXPOENTE = 40;     // 2^40 ns ~ 18 minutos (valores maiores saturam)
+    static constexpr int NUM_BALDES = (MAIOR_EXPOENTE - BITS_SUBBALDE + 3) * MEIO_SUBBALDES;
+
+private:
+    std::array<uint64_t, NUM_BALDES> contagens{};
+    uint64_t total = 0;
+    uint64_t maximo = 0;
+    long double soma = 0;
+
+    static size_t indice(uint64_t valor) {
+        if (valor < (1u << BITS_SUBBALDE)) return static_cast<size_t>(valor);
+        int expoente = 63 - __builtin_clzll(valor);
+        if (expoente > MAIOR_EXPOENTE) return NUM_BALDES - 1;
+        int deslocamento = expoente - (BITS_SUBBALDE - 1);
+        return static_cast<size_t>(deslocamento) * MEIO_SUBBALDES +
+               static_cast<size_t>(valor >> deslocamento);
+    }
+
+    // Maior valor que cai no mesmo balde (como o HdrHistogram reporta)
+    static uint64_t valorDoBalde(size_t i) {
+        if (i < (1u << BITS_SUBBALDE)) return i;
+        int deslocamento = static_cast<int>(i / MEIO_SUBBALDES) - 1;
+        uint64_t sub = i - static_cast<size_t>(deslocamento) * MEIO_SUBBALDES;
+        return ((sub + 1) << deslocamento) - 1;
+    }
+
+public:
+    void registrar(uint64_t valorNs) {
+        contagens[indice(valorNs)]++;
+        total++;
+        soma += valorNs;
+        if (valorNs > maximo) maximo = valorNs;
+    }
+
+    // Para janelas com contagens próprias por balde (JanelaLatencia)
+    static size_t balde(uint64_t valorNs) { return indice(valorNs); }
+    void registrarBalde(size_t i, uint64_t quantidade) {
+        uint64_t valor = valorDoBalde(i);
+        contagens[i] += quantidade;
+        total += quantidade;
+        soma += static_cast<long double>(valor) * quantidade;
+        if (valor > maximo) maximo = valor;
+    }
+
+    void juntar(const HistogramaLatencia& outro) {
+        for (int i = 0; i < NUM_BALDES; ++i) contagens[i] += outro.contagens[i];
+        total += outro.total;
+        soma += outro.soma;
+        maximo = std::max(maximo, outro.maximo);
+    }
+
+    void zerar() { *this = HistogramaLatencia(); }
+
+    uint64_t getTotal() const { return total; }
+    uint64_t getMaximoNs() const { return maximo; }
+    double getMediaNs() const { return total ? static_cast<double>(soma / total) : 0; }
+
+    /*
+     * PERCENTIL (em nanossegundos):
+     * Percorre os baldes até acumular a fração pedida das amostras
+     */
+    uint64_t percentilNs(double percentil) const {
+        if (total == 0) return 0;
+        uint64_t alvo = static_cast<uint64_t>(std::ceil(percentil / 100.0 * total));
+        alvo = std::max<uint64_t>(1, std::min(alvo, total));
+        uint64_t acumulado = 0;
+        for (int i = 0; i < NUM_BALDES; ++i) {
+            acumulado += contagens[i];
+            if (acumulado >= alvo) return std::min(valorDoBalde(i), maximo);
+        }
+        return maximo;
+    }
+
+    double percentilUs(double percentil) const { return percentilNs(percentil) / 1000.0; }
+};
+
+/*
+ * JANELA DE LATÊNCIA (telemetria):
+ * Mesmos baldes, mas contados com atomics para que o amostrador possa
+ * esvaziar a janela de outra thread enquanto a dona continua
+ * registrando. Cada thread tem a sua, então o fetch_add nunca disputa
+ * a linha com outro núcleo; o máximo sai com a precisão do balde.
+ */
+class JanelaLatencia {
+private:
+    std::array<std::atomic<uint64_t>, HistogramaLatencia::NUM_BALDES> contagens{};
+
+public:
+    void registrar(uint64_t valorNs) {
+        contagens[HistogramaLatencia::balde(valorNs)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Move as contagens desde a última drenagem para 'destino'
+    void drenar(HistogramaLatencia& destino) {
+        for (size_t i = 0; i < contagens.size(); ++i) {
+            if (contagens[i].load(std::memory_order_relaxed) == 0) continue;
+            uint64_t quantidade = contagens[i].exchange(0, std::memory_order_relaxed);
+            if (quantidade > 0) destino.registrarBalde(i, quantidade);
+        }
+    }
+};
+
+/*
+ * TIPOS DE OPERAÇÃO MEDIDOS:
+ * Operações que falham vão para FALHA, qualquer que seja o tipo,
+ * para que o caminho de erro não distorça a cauda do caminho normal.
+ * FILA não é uma operação: é a espera no controle de admissão, e fica
+ * fora do agregado das operações (os NUM_TIPOS_OPERACAO primeiros).
+ */
+enum class TipoLatencia { CREDITO, DEBITO, CONSULTA, TRANSFERENCIA, LOTE, FALHA, FILA };
+constexpr size_t NUM_TIPOS_OPERACAO = 6;
+constexpr size_t NUM_TIPOS_LATENCIA = 7;
+
+inline const char* nomeTipoLatencia(size_t tipo) {
+    static const char* nomes[NUM_TIPOS_LATENCIA] = {
+        "Credito", "Debito", "Consulta", "Transferencia", "Lote", "Falha", "Fila"};
+    return nomes[tipo];
+}
+
+/*
+ * RESULTADO DE UMA OPERAÇÃO SIMPLES VIA BANCO:
+ * REJEITADA = recusada pelo controle de admissão (carga), separada de
+ * FALHA = regra de negócio (saldo insuficiente, valor inválido)
+ */
+enum class StatusOperacao { SUCESSO, FALHA, REJEITADA };
+
+inline StatusOperacao statusDe(bool sucesso) {
+    return sucesso ? StatusOperacao::SUCESSO : StatusOperacao::FALHA;
+}
+
+/*
+ * COMBINAÇÃO DE ESCRITAS (motores que a suportam):
+ * - DESLIGADA: cada escritor disputa o lock da conta
+ * - AUTO: cada conta liga a combinação sozinha quando vê disputa
+ * - SEMPRE: todas as escritas simples são combinadas
+ */
+enum class ModoCombinacao { DESLIGADA, AUTO, SEMPRE };
+
+inline const char* nomeModoCombinacao(ModoCombinacao modo) {
+    switch (modo) {
+        case ModoCombinacao::DESLIGADA: return "desligada";
+        case ModoCombinacao::SEMPRE: return "sempre";
+        default: return "auto";
+    }
+}
+
+inline bool interpretarModoCombinacao(const std::string& texto, ModoCombinacao& modo) {
+    if (texto == "desligada") modo = ModoCombinacao::DESLIGADA;
+    else if (texto == "auto") modo = ModoCombinacao::AUTO;
+    else if (texto == "sempre") modo = ModoCombinacao::SEMPRE;
+    else return false;
+    return true;
+}
+
+using HistogramasPorTipo = std::array<HistogramaLatencia, NUM_TIPOS_LATENCIA>;
+
+// ===================================
+// Arena de contas (layout em memória)
+// ===================================
+/*
+ * ONDE FICAM OS OBJETOS DAS CONTAS:
+ * - HEAP: um new por conta (comportamento original). O alocador põe as
+ *   contas em sequência, com os seus cabeçalhos no meio, sem respeitar
+ *   linhas de cache: o fim de uma conta divide linha com a próxima
+ * - COMPACTO: um bloco contíguo por carga, contas coladas umas nas
+ *   outras. Menos memória e varreduras (snapshot, salvamento) mais
+ *   rápidas, mas contas vizinhas disputam linhas de cache
+ * - ALINHADO: bloco contíguo em que cada conta começa numa linha e
+ *   ocupa um número inteiro de linhas. Escritas em contas diferentes
+ *   nunca invalidam a linha uma da outra
+ */
+enum class ArranjoContas { HEAP, COMPACTO, ALINHADO };
+
+inline const char* nomeArranjo(ArranjoContas arranjo) {
+    switch (arranjo) {
+        case ArranjoContas::HEAP: return "heap";
+        case ArranjoContas::COMPACTO: return "compacto";
+        case ArranjoContas::ALINHADO: return "alinhado";
+    }
+    return "?";
+}
+
+inline bool interpretarArranjo(const std::string& texto, ArranjoContas& arranjo) {
+    if (texto == "heap") arranjo = ArranjoContas::HEAP;
+    else if (texto == "compacto") arranjo = ArranjoContas::COMPACTO;
+    else if (texto == "alinhado") arranjo = ArranjoContas::ALINHADO;
+    else return false;
+    return true;
+}
+
+/*
+ * DONA DA MEMÓRIA DAS CONTAS:
+ * O Banco guarda só ponteiros no map; a arena constrói e destrói.
+ * Cada carga reserva um bloco, e posições diferentes do bloco podem ser
+ * construídas por threads diferentes (carga em paralelo).
+ */
+template <typename Conta>
+class ArenaContas {
+private:
+    struct Bloco {
+        void* memoria = nullptr;                        // Nulo no arranjo HEAP
+        size_t passo = 0;                               // Distância entre contas
+        size_t alinhamento = 0;
+        size_t quantidade = 0;
+        std::vector<std::unique_ptr<Conta>> avulsas;    // Arranjo HEAP
+        std::vector<bool> destruidas;                   // Contas encerradas (vazio = nenhuma)
+        size_t numDestruidas = 0;
+
+        Conta* posicao(size_t i) const {
+            return reinterpret_cast<Conta*>(static_cast<char*>(memoria) + i * passo);
+        }
+
+        ~Bloco() {
+            if (!memoria) return;
+            for (size_t i = 0; i < quantidade; ++i) {
+                if (destruidas.empty() || !destruidas[i]) posicao(i)->~Conta();
+            }
+            ::operator delete(memoria, std::align_val_t(alinhamento));
+        }
+    };
+
+    ArranjoContas arranjo = ArranjoContas::HEAP;
+    std::vector<std::unique_ptr<Bloco>> blocos;
+
+public:
+    // Vale para os próximos blocos (configurar antes da carga)
+    void configurar(ArranjoContas novo) { arranjo = novo; }
+    ArranjoContas getArranjo() const { return arranjo; }
+
+    /*
+     * RESERVA DE UM BLOCO:
+     * Todas as posições devem ser construídas antes do fim da arena
+     */
+    size_t reservar(size_t quantidade) {
+        auto bloco = std::make_unique<Bloco>();
+        bloco->quantidade = quantidade;
+        if (arranjo == ArranjoContas::HEAP) {
+            bloco->avulsas.resize(quantidade);
+        } else {
+            bool alinhado = arranjo == ArranjoContas::ALINHADO;
+            bloco->alinhamento = alinhado ? std::max(alignof(Conta), TAMANHO_LINHA_CACHE) : alignof(Conta);
+            bloco->passo = alinhado
+                ? (sizeof(Conta) + TAMANHO_LINHA_CACHE - 1) / TAMANHO_LINHA_CACHE * TAMANHO_LINHA_CACHE
+                : sizeof(Conta);
+            bloco->memoria = ::operator new(std::max<size_t>(1, bloco->passo * quantidade),
+                                            std::align_val_t(bloco->alinhamento));
+        }
+        blocos.push_back(std::move(bloco));
+        return blocos.size() - 1;
+    }
+
+    template <typename... Argumentos>
+    Conta* construir(size_t numBloco, size_t i, Argumentos&&... argumentos) {
+        Bloco& bloco = *blocos[numBloco];
+        if (!bloco.memoria) {
+            bloco.avulsas[i] = std::make_unique<Conta>(std::forward<Argumentos>(argumentos)...);
+            return bloco.avulsas[i].get();
+        }
+        return new (bloco.posicao(i)) Conta(std::forward<Argumentos>(argumentos)...);
+    }
+
+    /*
+     * DESTRUIÇÃO DE UMA CONTA ENCERRADA:
+     * Quem chama garante que ninguém mais alcança a conta. A memória de
+     * um bloco volta quando a última conta dele é destruída.
+     */
+    void destruir(size_t numBloco, size_t i) {
+        Bloco& bloco = *blocos[numBloco];
+        if (!bloco.memoria) {
+            bloco.avulsas[i].reset();
+        } else {
+            bloco.posicao(i)->~Conta();
+            bloco.destruidas.resize(bloco.quantidade, false);
+            bloco.destruidas[i] = true;
+        }
+        if (++bloco.numDestruidas == bloco.quantidade) blocos[numBloco].reset();
+    }
+};
+
+// ===================================
+// Índice concorrente de contas
+// ===================================
+/*
+ * ID -> CONTA SEM LOCK NA BUSCA:
+ * Tabela hash com encadeamento (número de baldes potência de dois) em que
+ * baldes e elos são ponteiros atômicos. A busca só lê: roda dentro de uma
+ * ReclamacaoEpocas::Protecao e nunca espera por ninguém.
+ * As alterações (abrir e encerrar contas) são raras e vêm serializadas
+ * por quem chama:
+ * - inserir publica o nó novo na cabeça do balde com uma única escrita
+ * - remover desliga o nó do elo anterior; o nó continua apontando para o
+ *   seguinte, então uma busca parada nele segue adiante normalmente, e
+ *   ele só é liberado quando a reclamação garante que ninguém o vê
+ * - crescer monta uma tabela nova com cópias dos nós e troca o ponteiro
+ *   da tabela; a velha (com os nós dela) é aposentada inteira
+ */
+template <typename Conta>
+class IndiceContas {
+private:
+    struct No {
+        std::string id;
+        Conta* conta;
+        std::atomic<No*> proximo;
+
+        No(const std::string& i, Conta* c, No* p) : id(i), conta(c), proximo(p) {}
+    };
+
+    struct Tabela {
+        size_t mascara;
+        std::unique_ptr<std::atomic<No*>[]> baldes;
+
+        explicit Tabela(size_t numBaldes) : mascara(numBaldes - 1), baldes(new std::atomic<No*>[numBaldes]) {
+            for (size_t b = 0; b < numBaldes; ++b) baldes[b].store(nullptr, std::memory_order_relaxed);
+        }
+
+        // Libera a tabela e os nós (quando ninguém mais a alcança)
+        static void liberar(Tabela* tabela) {
+            for (size_t b = 0; b <= tabela->mascara; ++b) {
+                No* no = tabela->baldes[b].load(std::memory_order_relaxed);
+                while (no) {
+                    No* proximo = no->proximo.load(std::memory_order_relaxed);
+                    delete no;
+                    no = proximo;
+                }
+            }
+            delete tabela;
+        }
+    };
+
+    static constexpr size_t BALDES_INICIAIS = 16;
+    static constexpr size_t CARGA_MAXIMA = 2;      // Nós por balde antes de dobrar a tabela
+
+    ReclamacaoEpocas& reclamacao;
+    std::atomic<Tabela*> tabela;
+    size_t quantidade = 0;                         // Só os escritores mexem
+
+    static size_t hashId(const std::string& id) { return std::hash<std::string>{}(id); }
+
+    void crescer(size_t numBaldes) {
+        Tabela* velha = tabela.load(std::memory_order_relaxed);
+        Tabela* nova = new Tabela(numBaldes);
+        for (size_t b = 0; b <= velha->mascara; ++b) {
+            for (No* no = velha->baldes[b].load(std::memory_order_relaxed); no;
+                 no = no->proximo.load(std::memory_order_relaxed)) {
+                std::atomic<No*>& balde = nova->baldes[hashId(no->id) & nova->mascara];
+                balde.store(new No(no->id, no->conta, balde.load(std::memory_order_relaxed)),
+                            std::memory_order_relaxed);
+            }
+        }
+        tabela.store(nova, std::memory_order_release);
+        reclamacao.aposentar([velha] { Tabela::liberar(velha); });
+    }
+
+public:
+    explicit IndiceContas(ReclamacaoEpocas& r) : reclamacao(r), tabela(new Tabela(BALDES_INICIAIS)) {}
+
+    ~IndiceContas() { Tabela::liberar(tabela.load()); }
+
+    IndiceContas(const IndiceContas&) = delete;
+    IndiceContas& operator=(const IndiceContas&) = delete;
+
+    /*
+     * BUSCA (dentro de uma Protecao, ou por um escritor):
+     * O ponteiro devolvido vale enquanto a proteção durar
+     */
+    Conta* buscar(const std::string& id) const {
+        const Tabela* t = tabela.load(std::memory_order_acquire);
+        for (const No* no = t->baldes[hashId(id) & t->mascara].load(std::memory_order_acquire); no;
+             no = no->proximo.load(std::memory_order_acquire)) {
+            if (no->id == id) return no->conta;
+        }
+        return nullptr;
+    }
+
+    // Prepara a tabela para 'total' contas (carga em massa, sem dobras no meio)
+    void reservar(size_t total) {
+        size_t numBaldes = tabela.load(std::memory_order_relaxed)->mascara + 1;
+        size_t necessarios = numBaldes;
+        while (total > necessarios * CARGA_MAXIMA) necessarios *= 2;
+        if (necessarios != numBaldes) crescer(necessarios);
+    }
+
+    // Retorna false se o ID já está no índice
+    bool inserir(const std::string& id, Conta* conta) {
+        if (buscar(id)) return false;
+        reservar(quantidade + 1);
+        Tabela* t = tabela.load(std::memory_order_relaxed);
+        std::atomic<No*>& balde = t->baldes[hashId(id) & t->mascara];
+        balde.store(new No(id, conta, balde.load(std::memory_order_relaxed)), std::memory_order_release);
+        quantidade++;
+        return true;
+    }
+
+    // Retorna a conta desligada (nullptr se o ID não estava no índice)
+    Conta* remover(const std::string& id) {
+        Tabela* t = tabela.load(std::memory_order_relaxed);
+        std::atomic<No*>* elo = &t->baldes[hashId(id) & t->mascara];
+        for (No* no = elo->load(std::memory_order_relaxed); no; no = elo->load(std::memory_order_relaxed)) {
+            if (no->id == id) {
+                elo->store(no->proximo.load(std::memory_order_relaxed), std::memory_order_release);
+                quantidade--;
+                Conta* conta = no->conta;
+                reclamacao.aposentar([no] { delete no; });
+                return conta;
+            }
+            elo = &no->proximo;
+        }
+        return nullptr;
+    }
+
+    size_t tamanho() const { return quantidade; }
+    size_t getBaldes() const { return tabela.load(std::memory_order_relaxed)->mascara + 1; }
+};
+
+// ===================================
+// Classe Banco
+// ===================================
+/*
+ * PARAMETRIZADO PELO TIPO DE CONTA:
+ * Conta pode ser ContaComTrava<Trava> (uma por política de trava,
+ * ContaCorrente = shared_mutex) ou ContaCorrenteAtomica.
+ * A escolha é feita em tempo de compilação, então não há despacho
+ * virtual no caminho quente das operações.
+ */
+template <typename Conta>
+class Banco {
+private:
+    /*
+     * COLEÇÃO DE CONTAS:
+     * - map<string, Conta*>: mapeia ID -> ponteiro para conta
+     * - a arena é dona dos objetos (um new por conta ou blocos contíguos)
+     * - map mantém as contas ordenadas por ID
+     */
+    ArenaContas<Conta> arena;
+    std::map<std::string, Conta*> contas;
+    
+    /*
+     * MUTEX PARA PROTEÇÃO DO MAP:
+     * Protege a estrutura do map contra modificações concorrentes
+     * (adição/remoção de contas)
+     */
+    std::mutex contasMutex;
+
+    /*
+     * ÍNDICE DAS BUSCAS (sem lock):
+     * obterConta não toca contasMutex; o map continua sendo o diretório
+     * ordenado (listagem, snapshots, salvamento). Durante a execução, quem
+     * altera o índice ou a arena (abrir e encerrar contas) segura
+     * aberturaMutex. A reclamação vem antes do índice: as liberações que
+     * ficarem pendentes rodam depois que ele for destruído.
+     */
+    ReclamacaoEpocas reclamacao;
+    IndiceContas<Conta> indice{reclamacao};
+    std::mutex aberturaMutex;
+    std::vector<std::pair<size_t, size_t>> posicaoNaArena;   // Bloco e posição de cada índice (aberturaMutex)
+    std::vector<size_t> indicesLivres;                        // Deixados por contas encerradas (aberturaMutex)
+    std::vector<std::string> idsEncerrados;                   // Finalizadas e não reabertas (contasMutex)
+    std::map<std::string, double> saldosRetidos;              // Retirado no encerramento, por ID (contasMutex)
+    ContadorDistribuido aberturasRealizadas;
+    ContadorDistribuido encerramentosRealizados;
+    
+    /*
+     * CONTADORES DISTRIBUÍDOS:
+     * Mantêm estatísticas globais sem sincronização e sem que todas as
+     * threads escrevam na mesma linha de cache (somados só na leitura)
+     */
+    ContadorDistribuido operacoesRealizadas;   // Contador de operações bem-sucedidas
+    ContadorDistribuido operacoesFalhas;       // Contador de operações falhadas
+
+    /*
+     * ESTATÍSTICAS DE OPERAÇÕES COM VÁRIAS CONTAS:
+     * - abortos: transferências/lotes recusados (saldo insuficiente, conta inválida)
+     * - esperaLockNs: tempo gasto adquirindo os locks das contas envolvidas
+     */
+    ContadorDistribuido transferenciasRealizadas;
+    ContadorDistribuido transferenciasAbortadas;
+    ContadorDistribuido lotesRealizados;
+    ContadorDistribuido lotesAbortados;
+    ContadorDistribuido esperaLockNs;
+
+    /*
+     * CONTROLE DE ADMISSÃO:
+     * Configuração comum a todas as contas e recusas da execução atual
+     */
+    ConfigAdmissao configAdmissao;
+    ModoCombinacao modoCombinacao = ModoCombinacao::AUTO;
+    ContadorDistribuido rejeicoesFilaCheia;
+    ContadorDistribuido rejeicoesTempoEsgotado;
+    ContadorDistribuido esperaFilaNs;
+
+    /*
+     * SNAPSHOTS E AUDITORIA:
+     * Toda alteração de saldo acontece dentro de uma DominioEpocas::Escrita.
+     * saldoInicial é o total carregado; o auditor compara cada snapshot
+     * com saldoInicial + fluxo (créditos - débitos) até a época dele.
+     */
+    DominioEpocas epocas;
+    double saldoInicial = 0;
+    static constexpr double TOLERANCIA_AUDITORIA = 0.005;   // Meio centavo
+
+    std::thread auditor;
+    std::mutex auditorMutex;
+    std::condition_variable auditorCv;
+    bool auditando = false;                    // Protegido por auditorMutex
+    std::atomic<int> snapshotsAuditados{0};
+    std::atomic<int> divergenciasAuditoria{0};
+    std::atomic<long long> tempoSnapshotsNs{0};
+
+    void executarAuditoria(int intervaloMs) {
+        std::unique_lock<std::mutex> lock(auditorMutex);
+        while (auditando) {
+            lock.unlock();
+            Snapshot foto = tirarSnapshot();
+            snapshotsAuditados++;
+            tempoSnapshotsNs.fetch_add(foto.duracaoNs, std::memory_order_relaxed);
+            if (!foto.consistente()) {
+                if (divergenciasAuditoria++ == 0) {
+                    std::cerr << "AUDITORIA: total " << std::fixed << std::setprecision(2)
+                              << foto.total << " != esperado " << foto.esperado
+                              << " (época " << foto.epoca << ")" << std::endl;
+                }
+            }
+            lock.lock();
+            auditorCv.wait_for(lock, std::chrono::milliseconds(intervaloMs), [this] { return !auditando; });
+        }
+    }
+
+    /*
+     * CHECKPOINT INCREMENTAL:
+     * A época da última escrita de cada conta (getVersao) é a marca de
+     * sujeira: depois de um checkpoint na época S, só contas com versão
+     * maior que S mudaram. Cada checkpoint abre um snapshot, copia os
+     * saldos das contas sujas (na época dele) para a imagem do arquivo e
+     * fecha o snapshot antes da E/S, que acontece sem nenhum lock do
+     * banco. As operações nunca esperam pelo checkpoint; só o auditor
+     * disputa com ele a vez de abrir um snapshot.
+     * A thread usa uma cópia de contasPorIndice, renovada dentro do
+     * snapshot quando a geração muda (carga, abertura ou encerramento de
+     * contas), para não segurar contasMutex durante a varredura.
+     * Os saldos vão para a imagem dos dois slots, mas só um é gravado por
+     * vez; gravado o checkpoint, o WAL é recortado no corte dele (o slot
+     * seguinte pode falhar no meio sem que este deixe de valer).
+     */
+    std::vector<Conta*> contasPorIndice;       // Protegido por contasMutex; nullptr = ID substituído ou encerrado
+    std::vector<Conta*> contasEncerrando;      // Protegido por contasMutex: fora do índice, ainda com saldo
+    std::atomic<uint64_t> geracaoContas{0};    // Muda a cada carga, abertura e encerramento
+
+    ConfigCheckpoint configCheckpoint;
+    std::array<ArquivoCheckpoint, 2> slotsCheckpoint;
+    size_t slotCheckpoint = 0;                 // Próximo slot a gravar (o outro tem o último checkpoint)
+    uint64_t sequenciaCheckpoint = 0;          // Sequência do último checkpoint gravado
+    std::vector<Conta*> contasCheckpoint;      // Cópia usada só pela thread de checkpoint
+    uint64_t geracaoCheckpoint = 0;
+    uint64_t epocaCheckpoint = 0;              // Época do último checkpoint gravado
+    bool checkpointBase = false;               // Todas as contas já estão nas imagens
+
+    std::thread checkpointer;
+    std::mutex checkpointMutex;
+    std::condition_variable checkpointCv;
+    bool checkpointando = false;               // Protegido por checkpointMutex
+    std::atomic<int> checkpointsGravados{0};
+    std::atomic<long long> registrosCheckpoint{0};
+    std::atomic<long long> bytesCheckpoint{0};
+    std::atomic<int> falhasCheckpoint{0};
+    HistogramaLatencia duracaoCheckpoints;     // Lido só depois de pararCheckpoints
+
+    void gravarCheckpoint() {
+        auto inicio = std::chrono::steady_clock::now();
+        // A cópia é conferida com o snapshot aberto: o conjunto de contas não muda no meio
+        double fluxo = 0;
+        uint64_t lsnInicio = wal ? wal->getUltimoLsn() : 0;
+        uint64_t epoca = epocas.abrirSnapshot(fluxo);
+        uint64_t lsnFim = wal ? wal->getUltimoLsn() : 0;
+        if (geracaoContas.load(std::memory_order_acquire) != geracaoCheckpoint) {
+            contasCheckpoint = copiarContasPorIndice(true);
+            geracaoCheckpoint = geracaoContas.load();
+            checkpointBase = false;            // Índices novos, substituídos ou encerrados: regrava tudo
+        }
+        bool completo = configCheckpoint.completo || !checkpointBase;
+        for (ArquivoCheckpoint& slot : slotsCheckpoint) slot.redimensionar(contasCheckpoint.size());
+
+        for (size_t i = 0; i < contasCheckpoint.size(); ++i) {
+            const Conta* conta = contasCheckpoint[i];
+            if (!conta) {
+                if (completo) {
+                    for (ArquivoCheckpoint& slot : slotsCheckpoint) slot.atualizar(i, RegistroContaBin{}, false);
+                }
+            } else if (completo || conta->getVersao() > epocaCheckpoint) {
+                RegistroContaBin registro =
+                    ArmazenamentoContas::registroBinario(conta->getId(), conta->saldoNaEpoca(epoca));
+                for (ArquivoCheckpoint& slot : slotsCheckpoint) {
+                    slot.atualizar(i, registro, configCheckpoint.completo);
+                }
+            }
+        }
+        epocas.fecharSnapshot();
+        epocaCheckpoint = epoca;
+        checkpointBase = true;
+
+        ArquivoCheckpoint& arquivo = slotsCheckpoint[slotCheckpoint];
+        size_t registros = arquivo.getPendentes();
+        CabecalhoCheckpoint cab{};
+        cab.sequencia = sequenciaCheckpoint + 1;
+        cab.idLog = wal ? wal->getIdLog() : 0;
+        cab.lsnInicio = lsnInicio;
+        cab.lsnFim = lsnFim;
+        cab.epocaSeguinte = static_cast<uint32_t>(epoca + 1);
+        long long bytes = 0;
+        if (!arquivo.gravar(cab, bytes)) {
+            if (falhasCheckpoint++ == 0) {
+                std::cerr << "Erro ao gravar checkpoint: "
+                          << ArquivoCheckpoint::caminhoSlot(configCheckpoint.arquivo, slotCheckpoint) << std::endl;
+            }
+            return;
+        }
+        if (bytes > 0) {
+            sequenciaCheckpoint = cab.sequencia;
+            slotCheckpoint ^= 1;
+            if (wal) wal->recortar(lsnInicio);
+        }
+        checkpointsGravados++;
+        registrosCheckpoint.fetch_add(static_cast<long long>(registros), std::memory_order_relaxed);
+        bytesCheckpoint.fetch_add(bytes, std::memory_order_relaxed);
+        duracaoCheckpoints.registrar(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count()));
+    }
+
+    void executarCheckpoints(int intervaloMs) {
+        std::unique_lock<std::mutex> lock(checkpointMutex);
+        while (checkpointando) {
+            checkpointCv.wait_for(lock, std::chrono::milliseconds(intervaloMs),
+                                  [this] { return !checkpointando; });
+            if (!checkpointando) break;
+            lock.unlock();
+            gravarCheckpoint();
+            lock.lock();
+        }
+    }
+
+    /*
+     * ADMISSÃO DE UMA OPERAÇÃO SIMPLES:
+     * Só motores com lock (USA_ADMISSAO) passam pelo portão; a espera
+     * vai para o histograma FILA, admitida ou não
+     */
+    bool admitir(Conta* conta, bool escrita) {
+        if constexpr (!Conta::USA_ADMISSAO) {
+            return true;
+        } else {
+            if (!configAdmissao.ativa) return true;
+            long long espera = 0;
+            ResultadoAdmissao r = conta->getAdmissao().admitir(escrita, configAdmissao, espera);
+            if (espera > 0) {
+                if constexpr (Conta::SUPORTA_COMBINACAO) {
+                    if (escrita) conta->registrarDisputa();
+                }
+                esperaFilaNs.adicionar(espera);
+                histogramasLocais()[static_cast<size_t>(TipoLatencia::FILA)]
+                    .registrar(static_cast<uint64_t>(espera));
+            }
+            if (r == ResultadoAdmissao::FILA_CHEIA) rejeicoesFilaCheia.adicionar();
+            if (r == ResultadoAdmissao::TEMPO_ESGOTADO) rejeicoesTempoEsgotado.adicionar();
+            return r == ResultadoAdmissao::ADMITIDA;
+        }
+    }
+
+    void liberar(Conta* conta, bool escrita) {
+        if constexpr (Conta::USA_ADMISSAO) {
+            if (configAdmissao.ativa) conta->getAdmissao().liberar(escrita, configAdmissao);
+        }
+    }
+
+    /*
+     * CAMINHO DE UMA ESCRITA SIMPLES:
+     * Contas combinando publicam o pedido e dispensam o portão de
+     * admissão (a lista de publicação já é atendida em ordem e ninguém
+     * fica sem vez); as demais passam pela admissão e pelo lock.
+     */
+    bool usarCombinacao(Conta* conta) const {
+        if constexpr (!Conta::SUPORTA_COMBINACAO) {
+            (void)conta;
+            return false;
+        } else {
+            return modoCombinacao == ModoCombinacao::SEMPRE ||
+                   (modoCombinacao == ModoCombinacao::AUTO && conta->combinando());
+        }
+    }
+
+    StatusOperacao escreverSimples(Conta* conta, bool debito, double valor, uint64_t& posicaoTrace) {
+        auto inicio = std::chrono::steady_clock::now();
+        if (walFalhou()) {
+            registrarLatencia(TipoLatencia::FALHA, inicio);
+            return StatusOperacao::FALHA;
+        }
+        bool sucesso = false;
+        double fluxo = debito ? -Conta::valorEfetivo(valor) : Conta::valorEfetivo(valor);
+
+        /*
+         * Com WAL ou trace, o LSN (se a escrita valeu) e a posição no trace
+         * são reservados pela própria conta, ainda travada (talvez por um
+         * combinador). No motor atomico isso leva a escrita ao bit de trava
+         */
+        uint64_t lsn = 0;
+        uint64_t epocaEscrita = 0;
+        AcaoSobTrava reservarLsn;
+        if (wal || trace) {
+            reservarLsn = [&](bool aplicada) {
+                if (aplicada && wal) {
+                    lsn = anexarNoWAL(debito ? TipoRegistroWAL::DEBITO : TipoRegistroWAL::CREDITO,
+                                      conta->getId(), "", valor, epocaEscrita);
+                }
+                posicaoTrace = reservarNoTrace(1);
+            };
+        }
+        if (usarCombinacao(conta)) {
+            DominioEpocas::Escrita escrita(epocas);
+            epocaEscrita = DominioEpocas::epocaDaThread();
+            if constexpr (Conta::SUPORTA_COMBINACAO) sucesso = conta->escreverCombinado(debito, valor, reservarLsn);
+            if (sucesso) escrita.registrarFluxo(fluxo);
+        } else {
+            if (!admitir(conta, true)) return StatusOperacao::REJEITADA;
+            {
+                DominioEpocas::Escrita escrita(epocas);
+                sucesso = debito ? conta->debitar(valor, reservarLsn) : conta->creditar(valor, reservarLsn);
+                if (sucesso) escrita.registrarFluxo(fluxo);
+            }
+            liberar(conta, true);
+        }
+        if (sucesso) sucesso = aguardarNoWAL(lsn);
+        TipoLatencia tipo = debito ? TipoLatencia::DEBITO : TipoLatencia::CREDITO;
+        registrarLatencia(sucesso ? tipo : TipoLatencia::FALHA, inicio);
+        return statusDe(sucesso);
+    }
+
+    /*
+     * LATÊNCIA POR TIPO DE OPERAÇÃO:
+     * Cada thread escreve no seu próprio conjunto de histogramas (sem
+     * atomics nem locks no caminho quente); latencias() junta todos.
+     */
+    PorThread<HistogramasPorTipo> histogramasThreads;
+
+    HistogramasPorTipo& histogramasLocais() { return histogramasThreads.local(); }
+
+    /*
+     * TELEMETRIA:
+     * Com o amostrador ligado, cada operação também entra na janela da
+     * thread (esvaziada a cada amostra) e as consultas em andamento são
+     * contadas; desligado, o custo é ler a flag
+     */
+    std::atomic<bool> telemetriaAtiva{false};
+    PorThread<JanelaLatencia> janelasThreads;
+    ContadorDistribuido consultasAtivas;
+
+    JanelaLatencia& janelaLocal() { return janelasThreads.local(); }
+
+    void registrarLatencia(TipoLatencia tipo, std::chrono::steady_clock::time_point inicio) {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      std::chrono::steady_clock::now() - inicio).count();
+        histogramasLocais()[static_cast<size_t>(tipo)].registrar(static_cast<uint64_t>(ns));
+        if (telemetriaAtiva.load(std::memory_order_relaxed) &&
+            static_cast<size_t>(tipo) < NUM_TIPOS_OPERACAO) {
+            janelaLocal().registrar(static_cast<uint64_t>(ns));
+        }
+    }
+
+    /*
+     * CONTENÇÃO POR PAR DE CONTAS:
+     * Matriz triangular (par não ordenado) indexada pelo índice global.
+     * Só é mantida para bancos pequenos, onde pares "quentes" fazem sentido.
+     */
+    struct EstatisticaPar {
+        std::atomic<int> transferencias{0};
+        std::atomic<int> abortos{0};
+        std::atomic<long long> esperaNs{0};
+    };
+    static constexpr size_t LIMITE_CONTAS_PARES = 256;
+    std::unique_ptr<EstatisticaPar[]> pares;
+    size_t numContasPares = 0;
+    size_t proximoIndice = 0;                  // Próximo índice global livre
+
+    /*
+     * DURABILIDADE:
+     * Cada operação bem-sucedida é anexada ao WAL e só é confirmada
+     * depois do group commit que a torna durável
+     */
+    ConfigWAL configWAL;
+    std::unique_ptr<WriteAheadLog> wal;
+
+    static std::string caminhoWAL(const std::string& arquivo) { return arquivo + ".wal"; }
+
+    /*
+     * CARGA:
+     * Threads usadas no parsing e tempos da última carga
+     */
+    unsigned threadsCarga = threadsDisponiveis();
+    double tempoLeituraMs = 0;     // Mapeamento, validação, parsing e WAL
+    double tempoCargaMs = 0;       // Tempo total, incluindo montagem do map
+
+    /*
+     * REGISTRO NO WAL EM DUAS ETAPAS:
+     * - anexarNoWAL reserva o LSN e é chamada com as contas ainda
+     *   travadas: a ordem do log é a ordem em que cada conta mudou, então
+     *   qualquer prefixo durável do WAL é um estado que existiu
+     * - aguardarNoWAL espera o commit depois de soltar as contas; false
+     *   se o WAL falhou antes: a escrita ficou na memória mas não é
+     *   confirmada (a operação retorna FALHA). Com o WAL já parado, as
+     *   escritas nem começam (walFalhou)
+     * anexarNoWAL retorna 0 sem WAL (nada a esperar). Os registros levam
+     * a época da escrita: a desta thread, a do pedido (quando aplicado por
+     * um combinador) ou, com snapshots barrados (semSnapshot), a atual.
+     */
+    uint64_t anexarNoWAL(RegistroWAL* registros, size_t quantidade, uint64_t epoca = 0) {
+        if (!wal || quantidade == 0) return 0;
+        if (epoca == 0) epoca = DominioEpocas::epocaDaThread();
+        if (epoca == 0) epoca = epocas.getEpoca();
+        return wal->anexar(registros, quantidade, epoca);
+    }
+
+    uint64_t anexarNoWAL(TipoRegistroWAL tipo, const std::string& conta,
+                         const std::string& destino, double valor, uint64_t epoca = 0) {
+        if (!wal) return 0;
+        RegistroWAL r = WriteAheadLog::criarRegistro(tipo, conta, destino,
+                                                     std::llround(valor * 100.0));
+        return anexarNoWAL(&r, 1, epoca);
+    }
+
+    /*
+     * VALORES EM CENTAVOS:
+     * Todo valor que entra pelo Banco é arredondado uma única vez para o
+     * centavo, em qualquer motor: a memória, a auditoria e o WAL (que
+     * guarda centavos) aplicam exatamente a mesma quantia
+     */
+    static double emCentavos(double valor) { return static_cast<double>(std::llround(valor * 100.0)) / 100.0; }
+
+    // Com a espera adiada quem confere o commit é o chamador (corrotina, laço do servidor)
+    bool aguardarNoWAL(uint64_t lsn) {
+        if (!wal || lsn == 0) return true;
+        WriteAheadLog::EsperaAdiada& adiada = WriteAheadLog::esperaAdiadaDaThread();
+        if (!adiada.ativa) return wal->aguardarDuravel(lsn);
+        adiada.lsn = std::max(adiada.lsn, lsn);
+        return true;
+    }
+
+    bool walFalhou() const { return wal && wal->falhou(); }
+
+    /*
+     * TRACE DE OPERAÇÕES:
+     * Ligado por iniciarCaptura. Cada operação terminada (inclusive as que
+     * falharam ou foram recusadas) vira um registro com o índice global
+     * das contas, na posição reservada com as contas travadas (ver
+     * GravadorTrace); desligado, o custo é testar um ponteiro.
+     */
+    std::unique_ptr<GravadorTrace> trace;
+
+    static RegistroTrace registroTrace(TipoRegistro tipo, const Conta* conta, const Conta* destino,
+                                       double valor, StatusOperacao status, uint8_t flags = 0) {
+        RegistroTrace r{};
+        r.tipo = static_cast<uint8_t>(tipo);
+        r.flags = flags;
+        r.status = static_cast<uint8_t>(status);
+        r.conta = conta ? static_cast<uint32_t>(conta->getIndice()) : GravadorTrace::SEM_CONTA;
+        r.destino = destino ? static_cast<uint32_t>(destino->getIndice()) : GravadorTrace::SEM_CONTA;
+        r.valorCentavos = std::llround(valor * 100.0);
+        return r;
+    }
+
+    // Com as contas travadas; sem trace, SEM_POSICAO
+    uint64_t reservarNoTrace(size_t quantidade) {
+        return trace ? trace->reservar(quantidade) : GravadorTrace::SEM_POSICAO;
+    }
+
+    void registrarNoTrace(TipoRegistro tipo, const Conta* conta, const Conta* destino, double valor,
+                          StatusOperacao status, uint64_t posicao = GravadorTrace::SEM_POSICAO) {
+        if (!trace) return;
+        RegistroTrace r = registroTrace(tipo, conta, destino, valor, status);
+        trace->registrar(&r, 1, posicao);
+    }
+
+    // Um registro por operação do lote, todos com o resultado do lote inteiro
+    void registrarLoteNoTrace(const std::vector<OperacaoLote>& lote, const std::vector<Conta*>& origens,
+                              const std::vector<Conta*>& destinos, bool sucesso,
+                              uint64_t posicao = GravadorTrace::SEM_POSICAO) {
+        if (!trace || lote.empty()) return;
+        std::vector<RegistroTrace> registros;
+        registros.reserve(lote.size());
+        for (size_t i = 0; i < lote.size(); ++i) {
+            TipoRegistro tipo = lote[i].tipo == TipoOperacaoLote::CREDITO ? TipoRegistro::CREDITO
+                              : lote[i].tipo == TipoOperacaoLote::DEBITO  ? TipoRegistro::DEBITO
+                                                                          : TipoRegistro::TRANSFERENCIA;
+            uint8_t flags = GravadorTrace::LOTE | (i + 1 < lote.size() ? GravadorTrace::CONTINUA : 0);
+            registros.push_back(registroTrace(tipo, origens[i], destinos[i], lote[i].valor,
+                                              statusDe(sucesso), flags));
+        }
+        trace->registrar(registros.data(), registros.size(), posicao);
+    }
+
+    EstatisticaPar* estatisticaPar(const Conta* a, const Conta* b) {
+        if (!pares) return nullptr;
+        size_t i = std::min(a->getIndice(), b->getIndice());
+        size_t j = std::max(a->getIndice(), b->getIndice());
+        if (j >= numContasPares) return nullptr;
+        return &pares[i * numContasPares + j];
+    }
+
+    void prepararEstatisticasPares() {
+        numContasPares = proximoIndice;
+        if (numContasPares > 0 && numContasPares <= LIMITE_CONTAS_PARES) {
+            pares = std::make_unique<EstatisticaPar[]>(numContasPares * numContasPares);
+        } else {
+            pares.reset();
+        }
+    }
+
+    /*
+     * AQUISIÇÃO ORDENADA DE LOCKS:
+     * Todas as operações com várias contas travam em ordem crescente de
+     * índice global. Como nenhuma thread espera por uma conta de índice
+     * menor do que uma que já possui, não existe ciclo de espera (deadlock).
+     * Retorna o tempo gasto esperando, em nanossegundos.
+     */
+    static long long travarEmOrdem(std::vector<Conta*>& envolvidas) {
+        std::sort(envolvidas.begin(), envolvidas.end(),
+                  [](const Conta* a, const Conta* b) { return a->getIndice() < b->getIndice(); });
+        envolvidas.erase(std::unique(envolvidas.begin(), envolvidas.end()), envolvidas.end());
+
+        auto inicio = std::chrono::steady_clock::now();
+        for (Conta* conta : envolvidas) conta->travarEscrita();
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    static void destravarTodas(const std::vector<Conta*>& envolvidas) {
+        for (auto it = envolvidas.rbegin(); it != envolvidas.rend(); ++it) {
+            (*it)->destravarEscrita();
+        }
+    }
+
+    /*
+     * PROCESSAMENTO SIMULADO DE UMA OPERAÇÃO COM VÁRIAS CONTAS
+     */
+    static void simularProcessamento() {
+        ModeloServico::instancia().executar(EtapaServico::MULTICONTA);
+    }
+
+    /*
+     * CÓPIA DAS CONTAS PARA AS PASSADAS:
+     * Um único lock do mapa por passada. Quem só lê dentro de um snapshot
+     * (checkpoint, conciliação) inclui as contas em encerramento, que
+     * ainda têm saldo, cada uma na posição do seu índice; quem altera
+     * saldos usa só as contas abertas e segura uma Protecao durante a
+     * passada, então nenhuma conta da cópia é finalizada antes do fim.
+     */
+    std::vector<Conta*> copiarContasPorIndice(bool comEncerrando = false) {
+        std::vector<Conta*> todas;
+        std::lock_guard<std::mutex> lock(contasMutex);
+        if (comEncerrando) {
+            todas = contasPorIndice;
+            for (Conta* conta : contasEncerrando) todas[conta->getIndice()] = conta;
+            return todas;
+        }
+        todas.reserve(contasPorIndice.size());
+        for (Conta* conta : contasPorIndice) {
+            if (conta) todas.push_back(conta);
+        }
+        return todas;
+    }
+
+    /*
+     * FINALIZAÇÃO DE UM ENCERRAMENTO (fase 2, rodada pela reclamação):
+     * Ninguém mais escreve na conta. O saldo sai como débito registrado
+     * no fluxo, a conta deixa o map com o snapshot bloqueado e o objeto
+     * é destruído depois, fora de contasMutex (quem percorre o map lê as
+     * contas com o mutex na mão). O índice global volta a ficar livre.
+     * O ENCERRAMENTO entra no WAL junto com a saída do map: uma reabertura
+     * do mesmo ID (que só passa depois dela) fica depois dele no log.
+     */
+    void finalizarEncerramento(Conta* conta) {
+        std::string id = conta->getId();
+        double retirado = 0;
+        uint64_t lsn = 0;
+        epocas.semSnapshot([&] {
+            {
+                DominioEpocas::Escrita escrita(epocas);
+                conta->travarEscrita();
+                double saldo = conta->getSaldoUnsafe();
+                if (saldo > 0 && conta->debitarTravado(saldo)) {
+                    retirado = Conta::valorEfetivo(saldo);
+                    escrita.registrarFluxo(-retirado);
+                }
+                conta->destravarEscrita();
+            }
+            std::lock_guard<std::mutex> lock(contasMutex);
+            auto it = contas.find(id);
+            if (it != contas.end() && it->second == conta) contas.erase(it);
+            contasEncerrando.erase(std::find(contasEncerrando.begin(), contasEncerrando.end(), conta));
+            idsEncerrados.push_back(id);
+            if (retirado > 0) saldosRetidos[id] += retirado;
+            lsn = anexarNoWAL(TipoRegistroWAL::ENCERRAMENTO, id, "", retirado);
+            geracaoContas++;
+        });
+        aguardarNoWAL(lsn);
+
+        std::lock_guard<std::mutex> lockAbertura(aberturaMutex);
+        size_t indiceConta = conta->getIndice();
+        arena.destruir(posicaoNaArena[indiceConta].first, posicaoNaArena[indiceConta].second);
+        indicesLivres.push_back(indiceConta);
+    }
+
+    // Faixa [inicio, fim) da thread t entre numThreads
+    static std::pair<size_t, size_t> faixaDaThread(size_t total, unsigned t, unsigned numThreads) {
+        return {total * t / numThreads, total * (t + 1) / numThreads};
+    }
+
+    /*
+     * TRABALHO EM MASSA EM SEGUNDO PLANO:
+     * Mesmo ciclo de vida do auditor (iniciar antes das operações,
+     * parar depois); parar interrompe a passada em andamento no próximo
+     * bloco, e ela não entra na contagem de passadas nem no tempo médio
+     */
+    std::thread trabalhoMassa;
+    std::mutex massaMutex;
+    std::condition_variable massaCv;
+    bool rodandoMassa = false;                 // Protegido por massaMutex
+    std::atomic<int> passadasMassa{0};
+    std::atomic<long long> contasMassa{0};
+    std::atomic<long long> tempoMassaNs{0};
+    std::atomic<int> divergenciasMassa{0};
+    std::atomic<bool> interromperMassa{false};  // Corta a passada em andamento ao parar
+
+    void executarTrabalhoMassa(ConfigMassa config) {
+        std::unique_lock<std::mutex> lock(massaMutex);
+        while (rodandoMassa) {
+            lock.unlock();
+            auto inicio = std::chrono::steady_clock::now();
+            bool completa = true;
+            size_t contas = executarPassadaMassa(config, completa);
+            contasMassa.fetch_add(static_cast<long long>(contas));
+            if (completa) {
+                tempoMassaNs.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           std::chrono::steady_clock::now() - inicio).count());
+                passadasMassa++;
+            }
+            lock.lock();
+            if (config.intervaloMs > 0) {
+                massaCv.wait_for(lock, std::chrono::milliseconds(config.intervaloMs),
+                                 [this] { return !rodandoMassa; });
+            }
+        }
+    }
+
+public:
+    /*
+     * CONFIGURAÇÃO DO WAL:
+     * Deve ser chamada antes de carregarContas
+     */
+    void configurarWAL(const ConfigWAL& config) { configWAL = config; }
+
+    /*
+     * ARQUIVO DE CHECKPOINT:
+     * carregarContas procura nele um checkpoint do WAL a recuperar, mesmo
+     * com os checkpoints desligados nesta execução
+     */
+    void configurarCheckpoint(const ConfigCheckpoint& config) { configCheckpoint = config; }
+
+    /*
+     * WAL SEM CARGA:
+     * Para bancos montados com adicionarContas (benchmarks): começa um log
+     * novo em 'arquivo', com a configuração atual, para que as escritas
+     * paguem o commit como num banco carregado do arquivo
+     */
+    void iniciarWAL(const std::string& arquivo) {
+        if (configWAL.ativo) wal = std::make_unique<WriteAheadLog>(arquivo, configWAL, 0);
+    }
+
+    /*
+     * THREADS USADAS NA CARGA (parsing e checksum)
+     */
+    void configurarThreadsCarga(unsigned numThreads) { threadsCarga = std::max(1u, numThreads); }
+
+    /*
+     * CARREGAMENTO DE CONTAS DO ARQUIVO:
+     * Mapeia o arquivo em memória, converte em paralelo (texto ID|SALDO
+     * ou formato binário, detectado pelo cabeçalho), aplica o WAL
+     * (recuperação após crash) e popula o map de contas
+     */
+    void carregarContas(const std::string& arquivo) {
+        ArquivoMapeado mapa(arquivo);
+        if (!mapa.aberto()) {
+            throw std::runtime_error("Arquivo ContaCorrente.txt não encontrado.");
+        }
+
+        auto inicio = std::chrono::steady_clock::now();
+
+        /*
+         * HASH DO SNAPSHOT:
+         * Identifica qual WAL pode ser aplicado sobre este arquivo
+         */
+        uint64_t hashSnapshot = hashBlocos(mapa.data(), mapa.size(), threadsCarga);
+        std::vector<ContaLida> lidas = ArmazenamentoContas::ler(mapa.data(), mapa.size(), threadsCarga);
+
+        /*
+         * RECUPERAÇÃO PELO WAL:
+         * Parte do checkpoint mais novo gravado sobre este log, se houver
+         * (senão, do snapshot) e soma as variações das operações
+         * confirmadas depois dele
+         */
+        RecuperacaoWAL recuperado;
+        bool doCheckpoint = false;
+        if (configWAL.ativo) {
+            CabecalhoWAL cabWAL{};
+            CabecalhoCheckpoint cabCheckpoint{};
+            std::vector<ContaLida> contasCheckpoint;
+            doCheckpoint = WriteAheadLog::lerCabecalho(caminhoWAL(arquivo), hashSnapshot, cabWAL) &&
+                           ArquivoCheckpoint::lerMaisNovo(configCheckpoint.arquivo, cabWAL.idLog, threadsCarga,
+                                                          cabCheckpoint, contasCheckpoint);
+            CorteWAL corte{cabCheckpoint.lsnInicio, cabCheckpoint.lsnFim, cabCheckpoint.epocaSeguinte};
+            recuperado = WriteAheadLog::recuperar(caminhoWAL(arquivo), hashSnapshot,
+                                                  doCheckpoint ? &corte : nullptr);
+
+            // Um log recortado só se completa com um checkpoint posterior ao recorte
+            uint64_t coberto = doCheckpoint ? corte.lsnInicio : recuperado.lsnSnapshot;
+            if (recuperado.valido && recuperado.lsnBase > coberto) {
+                throw std::runtime_error("WAL " + caminhoWAL(arquivo) + " recortado até o LSN " +
+                                         std::to_string(recuperado.lsnBase) +
+                                         ", sem checkpoint íntegro que o cubra em " + configCheckpoint.arquivo +
+                                         ".{0,1}");
+            }
+            if (doCheckpoint) {
+                lidas = std::move(contasCheckpoint);
+                std::cout << "Recuperado o checkpoint " << cabCheckpoint.sequencia << " (LSN "
+                          << corte.lsnInicio << ") de " << configCheckpoint.arquivo << std::endl;
+            }
+            if (recuperado.valido && recuperado.registrosAplicados > 0) {
+                aplicarRecuperacao(lidas, recuperado);
+                std::cout << "Recuperadas " << recuperado.registrosAplicados << " operações do WAL: "
+                          << caminhoWAL(arquivo) << std::endl;
+            }
+        }
+        auto fimLeitura = std::chrono::steady_clock::now();
+
+        adicionarContas(lidas);
+
+        /*
+         * ABERTURA DO WAL:
+         * Continua o log recuperado ou começa um novo para este snapshot.
+         * Recuperado de um checkpoint, o estado vira o novo snapshot e o
+         * log recomeça: o arquivo de contas deixa de depender dos slots.
+         */
+        if (configWAL.ativo) {
+            wal = std::make_unique<WriteAheadLog>(caminhoWAL(arquivo), configWAL, hashSnapshot, recuperado);
+            if (doCheckpoint) salvarContas(arquivo);
+        }
+
+        auto fim = std::chrono::steady_clock::now();
+        tempoLeituraMs = std::chrono::duration<double, std::milli>(fimLeitura - inicio).count();
+        tempoCargaMs = std::chrono::duration<double, std::milli>(fim - inicio).count();
+
+        std::cout << "Carregadas " << contas.size() << " contas do arquivo." << std::endl;
+    }
+
+    /*
+     * CRIAÇÃO DE CONTAS EM PARALELO:
+     * Os objetos são construídos pelas threads dentro de um bloco da arena
+     * (no arranjo configurado); o map é montado depois numa única
+     * passada, com um único lock. Usada pela carga e pelos benchmarks.
+     */
+    void adicionarContas(const std::vector<ContaLida>& lidas) {
+        std::vector<Conta*> novas(lidas.size());
+        size_t bloco = arena.reservar(lidas.size());
+        size_t base = proximoIndice;
+        unsigned numThreads = static_cast<unsigned>(
+            std::max<size_t>(1, std::min<size_t>(threadsCarga, lidas.size())));
+        executarEmParalelo(numThreads, [&](unsigned t) {
+            size_t ini = lidas.size() * t / numThreads;
+            size_t fim = lidas.size() * (t + 1) / numThreads;
+            for (size_t i = ini; i < fim; ++i) {
+                novas[i] = arena.construir(bloco, i, lidas[i].id, lidas[i].saldo, base + i);
+            }
+        });
+        proximoIndice += lidas.size();
+        for (const Conta* conta : novas) saldoInicial += conta->getSaldoUnsafe();
+
+        {
+            /*
+             * PROTEÇÃO DO MAP:
+             * Lock exclusivo uma única vez para toda a carga.
+             * Arquivos gravados por salvarContas já estão ordenados por ID,
+             * então a dica emplace_hint(end) torna cada inserção O(1)
+             */
+            std::lock_guard<std::mutex> lock(contasMutex);
+            contasPorIndice.resize(proximoIndice, nullptr);
+            posicaoNaArena.resize(proximoIndice);
+            indice.reservar(contas.size() + novas.size());
+            for (size_t i = 0; i < novas.size(); ++i) {
+                Conta* conta = novas[i];
+                std::string id = conta->getId();
+                contasPorIndice[conta->getIndice()] = conta;
+                posicaoNaArena[conta->getIndice()] = {bloco, i};
+                auto it = contas.lower_bound(id);
+                if (it != contas.end() && it->first == id) {
+                    saldoInicial -= it->second->getSaldoUnsafe();
+                    contasPorIndice[it->second->getIndice()] = nullptr;
+                    indice.remover(id);
+                    it->second = conta;                 // ID repetido: vale o último
+                } else {
+                    contas.emplace_hint(it, id, conta);
+                }
+                indice.inserir(id, conta);
+            }
+            geracaoContas++;
+        }
+
+        prepararEstatisticasPares();
+    }
+
+    /*
+     * ARRANJO DAS CONTAS NA MEMÓRIA:
+     * Deve ser configurado antes de carregarContas
+     */
+    void configurarArranjo(ArranjoContas arranjo) { arena.configurar(arranjo); }
+    ArranjoContas getArranjo() const { return arena.getArranjo(); }
+
+    double getTempoLeituraMs() const { return tempoLeituraMs; }
+    double getTempoCargaMs() const { return tempoCargaMs; }
+
+    /*
+     * SALVAMENTO DE CONTAS NO ARQUIVO (CHECKPOINT):
+     * 1. Serializa o estado atual (texto, ou binário se o nome termina em .bin)
+     * 2. Grava num arquivo temporário, sincroniza e substitui com rename (atômico)
+     * 3. Reinicia o WAL apontando para o novo snapshot
+     * Um crash em qualquer ponto deixa snapshot + WAL consistentes: o WAL
+     * antigo guarda o hash do snapshot antigo e é ignorado sobre o novo.
+     */
+    void salvarContas(const std::string& arquivo) {
+        /*
+         * ESTADO CONSISTENTE:
+         * O snapshot é um corte de época, então o arquivo nunca guarda
+         * metade de uma transferência mesmo com operações em andamento
+         */
+        Snapshot foto = tirarSnapshot();
+
+        std::string conteudo = ArmazenamentoContas::serializar(arquivo, foto.saldos);
+        if (!ArmazenamentoContas::gravarAtomicamente(arquivo, conteudo)) {
+            std::cerr << "Erro ao salvar no arquivo: " << arquivo << std::endl;
+            return;
+        }
+
+        if (wal) wal->reiniciar(hashBlocos(conteudo.data(), conteudo.size(), threadsCarga));
+
+        std::cout << "Contas salvas no arquivo: " << arquivo << std::endl;
+    }
+
+    /*
+     * SNAPSHOT CONSISTENTE:
+     * Saldos de todas as contas ao fim de uma mesma época, lidos sem
+     * travar contas; as operações continuam rodando durante a leitura
+     * (só esperam por ela as escritas que já estavam em andamento)
+     */
+    struct Snapshot {
+        uint64_t epoca = 0;
+        std::vector<ContaLida> saldos;      // Ordenados por ID
+        double total = 0;
+        double esperado = 0;                // Saldo inicial + créditos - débitos
+        long long duracaoNs = 0;
+
+        bool consistente() const { return std::fabs(total - esperado) <= TOLERANCIA_AUDITORIA; }
+    };
+
+    Snapshot tirarSnapshot() {
+        auto inicio = std::chrono::steady_clock::now();
+        Snapshot foto;
+        double fluxo = 0;
+        foto.epoca = epocas.abrirSnapshot(fluxo);
+        {
+            /*
+             * ITERAÇÃO ESTRUTURADA (C++17):
+             * contasMutex só protege a estrutura do map, não os saldos
+             */
+            std::lock_guard<std::mutex> lock(contasMutex);
+            foto.saldos.reserve(contas.size());
+            for (const auto& [id, conta] : contas) {
+                double saldo = conta->saldoNaEpoca(foto.epoca);
+                foto.saldos.push_back({id, saldo});
+                foto.total += saldo;
+            }
+        }
+        epocas.fecharSnapshot();
+        foto.esperado = saldoInicial + fluxo;
+        foto.duracaoNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - inicio).count();
+        return foto;
+    }
+
+    /*
+     * AUDITOR:
+     * Thread que tira snapshots durante a simulação e confere o total
+     */
+    void iniciarAuditoria(const ConfigAuditoria& config) {
+        if (!config.ativa || auditor.joinable()) return;
+        auditando = true;
+        auditor = std::thread(&Banco::executarAuditoria, this, config.intervaloMs);
+    }
+
+    void pararAuditoria() {
+        if (!auditor.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(auditorMutex);
+            auditando = false;
+        }
+        auditorCv.notify_all();
+        auditor.join();
+    }
+
+    /*
+     * OPERAÇÕES EM MASSA:
+     * As contas são copiadas de contasPorIndice uma única vez (o mutex do
+     * mapa não é tocado por conta) e divididas em faixas contíguas, uma
+     * por thread. Cada faixa é processada em blocos de BLOCO_MASSA contas
+     * consecutivas: o bloco é travado em ordem de índice (a mesma ordem
+     * das transferências e lotes, sem deadlock), os saldos são copiados
+     * para um vetor, a atualização roda sobre o vetor inteiro (um laço
+     * simples que o compilador vetoriza) e só as diferenças voltam às
+     * contas. O bloco inteiro é uma época e um grupo de registros no WAL;
+     * as operações online esperam no máximo um bloco pela conta.
+     * Se 'interromper' for ligada, as threads param no próximo bloco e o
+     * resultado sai com completo = false.
+     */
+    static constexpr size_t BLOCO_MASSA = 64;
+
+    struct ResultadoMassa {
+        size_t contas = 0;                  // Contas visitadas
+        size_t alteradas = 0;               // Contas cujo saldo mudou
+        double valorMovido = 0;             // Soma das alterações (créditos - débitos)
+        long long duracaoNs = 0;
+        bool completo = true;
+    };
+
+    /*
+     * APLICAÇÃO EM TODAS AS CONTAS:
+     * atualizar(antes, depois, n) calcula os saldos novos de um bloco;
+     * as diferenças são arredondadas para centavos
+     */
+    template <typename Atualizacao>
+    ResultadoMassa aplicarEmTodas(Atualizacao atualizar, unsigned numThreads,
+                                  const std::atomic<bool>* interromper = nullptr) {
+        auto inicio = std::chrono::steady_clock::now();
+        ReclamacaoEpocas::Protecao protecao(reclamacao);
+        std::vector<Conta*> todas = copiarContasPorIndice();
+        numThreads = std::max(1u, std::min<unsigned>(numThreads, static_cast<unsigned>(todas.size() / BLOCO_MASSA + 1)));
+        std::vector<ResultadoMassa> parciais(numThreads);
+
+        executarEmParalelo(numThreads, [&](unsigned t) {
+            auto [primeira, ultima] = faixaDaThread(todas.size(), t, numThreads);
+            ResultadoMassa& parcial = parciais[t];
+            std::vector<Conta*> bloco;
+            std::vector<RegistroWAL> registros;
+            uint64_t lsn = 0;
+            alignas(TAMANHO_LINHA_CACHE) double antes[BLOCO_MASSA];
+            alignas(TAMANHO_LINHA_CACHE) double depois[BLOCO_MASSA];
+
+            for (size_t i = primeira; i < ultima; i += BLOCO_MASSA) {
+                if ((interromper && interromper->load(std::memory_order_relaxed)) || walFalhou()) break;
+                size_t n = std::min(BLOCO_MASSA, ultima - i);
+                bloco.assign(todas.begin() + i, todas.begin() + i + n);
+                registros.clear();
+                {
+                    DominioEpocas::Escrita escrita(epocas);
+                    travarEmOrdem(bloco);
+                    for (size_t k = 0; k < n; ++k) antes[k] = bloco[k]->getSaldoUnsafe();
+                    atualizar(antes, depois, n);
+                    for (size_t k = 0; k < n; ++k) {
+                        double delta = std::round((depois[k] - antes[k]) * 100.0) / 100.0;
+                        bool alterada = delta > 0 ? bloco[k]->creditarTravado(delta)
+                                      : delta < 0 && bloco[k]->debitarTravado(-delta);
+                        if (!alterada) continue;
+                        double efetivo = Conta::valorEfetivo(std::fabs(delta));
+                        escrita.registrarFluxo(delta > 0 ? efetivo : -efetivo);
+                        parcial.valorMovido += delta > 0 ? efetivo : -efetivo;
+                        parcial.alteradas++;
+                        if (wal) {
+                            registros.push_back(WriteAheadLog::criarRegistro(
+                                delta > 0 ? TipoRegistroWAL::CREDITO : TipoRegistroWAL::DEBITO,
+                                bloco[k]->getId(), "", std::llround(efetivo * 100.0)));
+                        }
+                    }
+                    lsn = anexarNoWAL(registros.data(), registros.size());
+                    destravarTodas(bloco);
+                }
+                parcial.contas += n;
+                if (!aguardarNoWAL(lsn)) break;     // WAL parado: a passada não continua
+            }
+        });
+
+        ResultadoMassa total;
+        for (const ResultadoMassa& parcial : parciais) {
+            total.contas += parcial.contas;
+            total.alteradas += parcial.alteradas;
+            total.valorMovido += parcial.valorMovido;
+        }
+        total.completo = total.contas == todas.size();
+        total.duracaoNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now() - inicio).count();
+        return total;
+    }
+
+    /*
+     * AGREGAÇÃO SOBRE TODAS AS CONTAS (sem travar nenhuma):
+     * Lê os saldos de um snapshot, em blocos como aplicarEmTodas;
+     * reduzirBloco(valor, saldos, n) acumula um bloco no valor da thread
+     * e juntar(a, b) combina os valores das threads. O snapshot fica
+     * aberto durante a passada (as operações não esperam por ele).
+     */
+    template <typename Valor>
+    struct Agregado {
+        Valor valor;
+        uint64_t epoca = 0;
+        double esperado = 0;                // Saldo inicial + créditos - débitos até a época
+        size_t contas = 0;
+        long long duracaoNs = 0;
+        bool completo = true;
+    };
+
+    template <typename Valor, typename ReduzirBloco, typename Juntar>
+    Agregado<Valor> reduzirTodas(const Valor& inicial, ReduzirBloco reduzirBloco, Juntar juntar,
+                                 unsigned numThreads, const std::atomic<bool>* interromper = nullptr) {
+        auto inicio = std::chrono::steady_clock::now();
+        Agregado<Valor> agregado{inicial};
+        double fluxo = 0;
+        agregado.epoca = epocas.abrirSnapshot(fluxo);
+
+        std::vector<Conta*> todas = copiarContasPorIndice(true);
+        todas.erase(std::remove(todas.begin(), todas.end(), nullptr), todas.end());
+        numThreads = std::max(1u, std::min<unsigned>(numThreads, static_cast<unsigned>(todas.size() / BLOCO_MASSA + 1)));
+        std::vector<Valor> parciais(numThreads, inicial);
+        std::vector<size_t> lidas(numThreads, 0);
+        executarEmParalelo(numThreads, [&](unsigned t) {
+            auto [primeira, ultima] = faixaDaThread(todas.size(), t, numThreads);
+            alignas(TAMANHO_LINHA_CACHE) double saldos[BLOCO_MASSA];
+            for (size_t i = primeira; i < ultima; i += BLOCO_MASSA) {
+                if (interromper && interromper->load(std::memory_order_relaxed)) break;
+                size_t n = std::min(BLOCO_MASSA, ultima - i);
+                for (size_t k = 0; k < n; ++k) saldos[k] = todas[i + k]->saldoNaEpoca(agregado.epoca);
+                reduzirBloco(parciais[t], saldos, n);
+                lidas[t] += n;
+            }
+        });
+        epocas.fecharSnapshot();
+
+        for (const Valor& parcial : parciais) agregado.valor = juntar(agregado.valor, parcial);
+        agregado.esperado = saldoInicial + fluxo;
+        for (size_t n : lidas) agregado.contas += n;
+        agregado.completo = agregado.contas == todas.size();
+        agregado.duracaoNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                 std::chrono::steady_clock::now() - inicio).count();
+        return agregado;
+    }
+
+    /*
+     * CONCILIAÇÃO DE SALDOS:
+     * Total, extremos e contas negativas de um snapshot
+     */
+    struct ResumoSaldos {
+        double total = 0;
+        double minimo = std::numeric_limits<double>::infinity();
+        double maximo = -std::numeric_limits<double>::infinity();
+        size_t negativas = 0;
+    };
+
+    Agregado<ResumoSaldos> conciliarSaldos(unsigned numThreads, const std::atomic<bool>* interromper = nullptr) {
+        return reduzirTodas(
+            ResumoSaldos{},
+            [](ResumoSaldos& r, const double* saldos, size_t n) {
+                double total = 0, minimo = r.minimo, maximo = r.maximo;
+                size_t negativas = 0;
+                for (size_t k = 0; k < n; ++k) {
+                    total += saldos[k];
+                    minimo = std::min(minimo, saldos[k]);
+                    maximo = std::max(maximo, saldos[k]);
+                    negativas += saldos[k] < 0;
+                }
+                r.total += total;
+                r.minimo = minimo;
+                r.maximo = maximo;
+                r.negativas += negativas;
+            },
+            [](ResumoSaldos a, const ResumoSaldos& b) {
+                a.total += b.total;
+                a.minimo = std::min(a.minimo, b.minimo);
+                a.maximo = std::max(a.maximo, b.maximo);
+                a.negativas += b.negativas;
+                return a;
+            },
+            numThreads, interromper);
+    }
+
+    /*
+     * UMA PASSADA DO TRABALHO CONFIGURADO:
+     * Retorna as contas visitadas (completa = passou por todas); a
+     * conciliação conta divergências só de passadas completas
+     */
+    size_t executarPassadaMassa(const ConfigMassa& config, bool& completa) {
+        double parametro = config.parametro;
+        completa = true;
+        switch (config.tipo) {
+            case TipoMassa::JUROS: {
+                ResultadoMassa r = aplicarEmTodas([parametro](const double* antes, double* depois, size_t n) {
+                    for (size_t k = 0; k < n; ++k) depois[k] = antes[k] > 0 ? antes[k] * (1.0 + parametro) : antes[k];
+                }, config.threads, &interromperMassa);
+                completa = r.completo;
+                return r.contas;
+            }
+            case TipoMassa::TARIFA: {
+                ResultadoMassa r = aplicarEmTodas([parametro](const double* antes, double* depois, size_t n) {
+                    for (size_t k = 0; k < n; ++k) depois[k] = antes[k] >= parametro ? antes[k] - parametro : antes[k];
+                }, config.threads, &interromperMassa);
+                completa = r.completo;
+                return r.contas;
+            }
+            case TipoMassa::CONCILIACAO: {
+                Agregado<ResumoSaldos> resumo = conciliarSaldos(config.threads, &interromperMassa);
+                completa = resumo.completo;
+                if (completa && std::fabs(resumo.valor.total - resumo.esperado) > TOLERANCIA_AUDITORIA) {
+                    divergenciasMassa++;
+                    std::cerr << "Conciliação divergente na época " << resumo.epoca << ": total "
+                              << std::fixed << std::setprecision(2) << resumo.valor.total
+                              << ", esperado " << resumo.esperado << std::endl;
+                }
+                return resumo.contas;
+            }
+            default:
+                return 0;
+        }
+    }
+
+    void iniciarMassa(const ConfigMassa& config) {
+        if (!config.ativa() || trabalhoMassa.joinable()) return;
+        passadasMassa.store(0);
+        contasMassa.store(0);
+        tempoMassaNs.store(0);
+        divergenciasMassa.store(0);
+        interromperMassa.store(false);
+        rodandoMassa = true;
+        trabalhoMassa = std::thread(&Banco::executarTrabalhoMassa, this, config);
+    }
+
+    void pararMassa() {
+        if (!trabalhoMassa.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(massaMutex);
+            rodandoMassa = false;
+        }
+        interromperMassa.store(true);
+        massaCv.notify_all();
+        trabalhoMassa.join();
+    }
+
+    int getPassadasMassa() const { return passadasMassa.load(); }
+    long long getContasMassa() const { return contasMassa.load(); }
+    long long getTempoMassaNs() const { return tempoMassaNs.load(); }
+    int getDivergenciasMassa() const { return divergenciasMassa.load(); }
+
+    /*
+     * CHECKPOINTER:
+     * O primeiro checkpoint (todas as contas) é gravado aqui mesmo, antes
+     * das operações; a thread grava os incrementais e pararCheckpoints
+     * grava um último com o estado final
+     */
+    void iniciarCheckpoints(const ConfigCheckpoint& config) {
+        if (!config.ativo || checkpointer.joinable()) return;
+        configCheckpoint = config;
+        for (size_t s = 0; s < slotsCheckpoint.size(); ++s) {
+            if (!slotsCheckpoint[s].abrir(ArquivoCheckpoint::caminhoSlot(config.arquivo, s))) {
+                std::cerr << "Erro ao criar checkpoint: " << ArquivoCheckpoint::caminhoSlot(config.arquivo, s)
+                          << std::endl;
+                for (ArquivoCheckpoint& slot : slotsCheckpoint) slot.fechar();
+                return;
+            }
+        }
+        // Começa pelo slot mais antigo: o mais novo pode ser o único íntegro
+        uint64_t sequencia0 = slotsCheckpoint[0].getSequencia();
+        uint64_t sequencia1 = slotsCheckpoint[1].getSequencia();
+        slotCheckpoint = sequencia0 <= sequencia1 ? 0 : 1;
+        sequenciaCheckpoint = std::max(sequencia0, sequencia1);
+        checkpointBase = false;
+        checkpointsGravados.store(0);
+        registrosCheckpoint.store(0);
+        bytesCheckpoint.store(0);
+        falhasCheckpoint.store(0);
+        duracaoCheckpoints.zerar();
+        gravarCheckpoint();
+        checkpointando = true;
+        checkpointer = std::thread(&Banco::executarCheckpoints, this, config.intervaloMs);
+    }
+
+    void pararCheckpoints() {
+        if (!checkpointer.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(checkpointMutex);
+            checkpointando = false;
+        }
+        checkpointCv.notify_all();
+        checkpointer.join();
+        gravarCheckpoint();
+        for (ArquivoCheckpoint& slot : slotsCheckpoint) slot.fechar();
+    }
+
+    ~Banco() {
+        pararMassa();
+        pararAuditoria();
+        pararCheckpoints();
+        concluirEncerramentos();
+    }
+
+    int getSnapshotsAuditados() const { return snapshotsAuditados.load(); }
+    int getDivergenciasAuditoria() const { return divergenciasAuditoria.load(); }
+    long long getTempoSnapshotsNs() const { return tempoSnapshotsNs.load(); }
+    int getCheckpointsGravados() const { return checkpointsGravados.load(); }
+    long long getRegistrosCheckpoint() const { return registrosCheckpoint.load(); }
+    long long getBytesCheckpoint() const { return bytesCheckpoint.load(); }
+    const HistogramaLatencia& getDuracaoCheckpoints() const { return duracaoCheckpoints; }
+
+    /*
+     * OBTENÇÃO DE PONTEIRO PARA CONTA:
+     * Retorna ponteiro raw para a conta (ou nullptr se não encontrar),
+     * buscado no índice sem lock. Com contas sendo encerradas, o ponteiro
+     * só pode ser usado enquanto durar a Leitura em que foi obtido; sem
+     * encerramentos (servidor, reprodução de trace) ele vale até o fim.
+     */
+    using Leitura = ReclamacaoEpocas::Protecao;
+
+    Leitura protegerLeitura() { return Leitura(reclamacao); }
+
+    Conta* obterConta(const std::string& id) { return indice.buscar(id); }
+
+    /*
+     * ABERTURA DE CONTA COM O BANCO RODANDO:
+     * A conta é criada na arena (índice global reaproveitado de uma conta
+     * já finalizada, se houver), entra no map e no fluxo da auditoria com
+     * o snapshot bloqueado e só então aparece no índice. O registro de
+     * ABERTURA é anexado ao WAL antes de a conta ficar visível, então
+     * nenhuma escrita ou encerramento dela vem antes dele no log.
+     * Falha se o ID já existe (inclusive numa conta ainda em encerramento).
+     * Um ID reaberto recebe de volta, além de 'saldo', o que foi retirado
+     * no seu encerramento: a rotatividade não some com o dinheiro do
+     * arquivo de uma execução para a outra.
+     */
+    StatusOperacao abrirConta(const std::string& id, double saldo) {
+        if (id.empty() || id.size() >= sizeof(RegistroWAL::conta) || saldo < 0 || walFalhou()) {
+            return StatusOperacao::FALHA;
+        }
+        saldo = emCentavos(saldo);
+        Conta* conta = nullptr;
+        uint64_t lsn = 0;
+        {
+            std::unique_lock<std::mutex> lockAbertura(aberturaMutex);
+            if (indice.buscar(id)) return StatusOperacao::FALHA;
+            bool encerrando;
+            {
+                std::lock_guard<std::mutex> lock(contasMutex);
+                encerrando = contas.count(id) > 0;
+                auto retido = saldosRetidos.find(id);
+                if (!encerrando && retido != saldosRetidos.end()) {
+                    saldo = emCentavos(saldo + retido->second);
+                    saldosRetidos.erase(retido);
+                }
+            }
+            if (encerrando) {
+                // Ainda não finalizada: ajuda a reclamação a andar e falha
+                lockAbertura.unlock();
+                reclamacao.tentarLiberar();
+                return StatusOperacao::FALHA;
+            }
+            size_t indiceConta = proximoIndice;
+            if (indicesLivres.empty()) {
+                proximoIndice++;
+                posicaoNaArena.resize(proximoIndice);
+            } else {
+                indiceConta = indicesLivres.back();
+                indicesLivres.pop_back();
+            }
+            size_t bloco = arena.reservar(1);
+            conta = arena.construir(bloco, 0, id, saldo, indiceConta);
+            posicaoNaArena[indiceConta] = {bloco, 0};
+
+            epocas.semSnapshot([&] {
+                {
+                    DominioEpocas::Escrita escrita(epocas);
+                    escrita.registrarFluxo(conta->getSaldoUnsafe());
+                }
+                std::lock_guard<std::mutex> lock(contasMutex);
+                // No log antes de qualquer escrita na conta (passadas em massa a veem por contasPorIndice)
+                lsn = anexarNoWAL(TipoRegistroWAL::ABERTURA, id, "", conta->getSaldoUnsafe());
+                contas.emplace(id, conta);
+                auto encerrado = std::find(idsEncerrados.begin(), idsEncerrados.end(), id);
+                if (encerrado != idsEncerrados.end()) idsEncerrados.erase(encerrado);
+                if (contasPorIndice.size() <= indiceConta) contasPorIndice.resize(indiceConta + 1, nullptr);
+                contasPorIndice[indiceConta] = conta;
+                geracaoContas++;
+            });
+            indice.inserir(id, conta);
+        }
+        bool duravel = aguardarNoWAL(lsn);
+        if (duravel) aberturasRealizadas.adicionar();
+        reclamacao.tentarLiberar();
+        return statusDe(duravel);
+    }
+
+    /*
+     * ENCERRAMENTO DE CONTA COM O BANCO RODANDO (em duas fases):
+     * 1. A conta sai do índice e de contasPorIndice: nenhuma busca ou
+     *    passada nova a encontra. Quem já tinha o ponteiro está numa
+     *    Leitura (operações) ou Protecao (passadas em massa)
+     * 2. A finalização é aposentada na reclamação e só roda quando todos
+     *    esses terminaram: o saldo final (com tudo o que eles fizeram)
+     *    é retirado, a conta sai do map com o snapshot bloqueado e o
+     *    objeto é destruído. Nenhuma thread fica com ponteiro solto.
+     * Até a finalização a conta continua nos snapshots, com o seu saldo.
+     */
+    StatusOperacao encerrarConta(const std::string& id) {
+        Conta* conta = nullptr;
+        {
+            std::lock_guard<std::mutex> lockAbertura(aberturaMutex);
+            conta = indice.remover(id);
+            if (!conta) return StatusOperacao::FALHA;
+            std::lock_guard<std::mutex> lock(contasMutex);
+            contasPorIndice[conta->getIndice()] = nullptr;
+            contasEncerrando.push_back(conta);
+            geracaoContas++;
+        }
+        reclamacao.aposentar([this, conta] { finalizarEncerramento(conta); });
+        encerramentosRealizados.adicionar();
+        reclamacao.tentarLiberar();
+        return StatusOperacao::SUCESSO;
+    }
+
+    /*
+     * FIM DOS ENCERRAMENTOS:
+     * Finaliza todos os pendentes; chamar depois que as operações e as
+     * passadas terminaram (fim da simulação)
+     */
+    void concluirEncerramentos() { reclamacao.liberarTudo(); }
+
+    /*
+     * REABERTURA DAS ENCERRADAS:
+     * Devolve ao banco os IDs encerrados e não reabertos, cada um com o
+     * saldo retirado no encerramento; usado no fim de uma simulação com
+     * rotatividade para que o arquivo salvo (e a próxima execução) tenha
+     * o mesmo universo de contas e não perca o dinheiro delas
+     */
+    int reabrirEncerradas() {
+        std::vector<std::string> ids;
+        {
+            std::lock_guard<std::mutex> lock(contasMutex);
+            ids = idsEncerrados;
+        }
+        int reabertas = 0;
+        for (const std::string& id : ids) {
+            if (abrirConta(id, 0) == StatusOperacao::SUCESSO) reabertas++;
+        }
+        return reabertas;
+    }
+
+    size_t getContasAbertas() const { return indice.tamanho(); }
+    int getAberturas() const { return static_cast<int>(aberturasRealizadas.total()); }
+    int getEncerramentos() const { return static_cast<int>(encerramentosRealizados.total()); }
+    long long getLiberacoesReclamacao() const { return reclamacao.getLiberados(); }
+
+    /*
+     * OPERAÇÕES SIMPLES VIA BANCO:
+     * Passam pelo controle de admissão, executam na conta e, em caso de
+     * sucesso, registram no WAL. A chamada só retorna depois que a
+     * operação está durável. A latência medida inclui a espera na fila
+     * de admissão e pelo commit do WAL; o portão é liberado antes do WAL.
+     */
+    StatusOperacao creditar(Conta* conta, double valor) {
+        valor = emCentavos(valor);
+        uint64_t posicao = GravadorTrace::SEM_POSICAO;
+        StatusOperacao status = escreverSimples(conta, false, valor, posicao);
+        registrarNoTrace(TipoRegistro::CREDITO, conta, nullptr, valor, status, posicao);
+        return status;
+    }
+
+    StatusOperacao debitar(Conta* conta, double valor) {
+        valor = emCentavos(valor);
+        uint64_t posicao = GravadorTrace::SEM_POSICAO;
+        StatusOperacao status = escreverSimples(conta, true, valor, posicao);
+        registrarNoTrace(TipoRegistro::DEBITO, conta, nullptr, valor, status, posicao);
+        return status;
+    }
+
+    StatusOperacao consultarSaldo(Conta* conta, double& saldo) {
+        auto inicio = std::chrono::steady_clock::now();
+        StatusOperacao status = StatusOperacao::REJEITADA;
+        if (admitir(conta, false)) {
+            bool contar = telemetriaAtiva.load(std::memory_order_relaxed);
+            if (contar) consultasAtivas.adicionar(1);
+            saldo = conta->consultarSaldo();
+            if (contar) consultasAtivas.adicionar(-1);
+            liberar(conta, false);
+            registrarLatencia(TipoLatencia::CONSULTA, inicio);
+            status = StatusOperacao::SUCESSO;
+        }
+        registrarNoTrace(TipoRegistro::CONSULTA, conta, nullptr, 0, status);
+        return status;
+    }
+
+    /*
+     * TRANSFERÊNCIA ATÔMICA:
+     * Debita a origem e credita o destino com as duas contas travadas,
+     * portanto nenhuma outra operação observa o dinheiro "em trânsito".
+     * Os locks são adquiridos na ordem global de índice.
+     */
+    bool transferir(Conta* origem, Conta* destino, double valor) {
+        auto inicio = std::chrono::steady_clock::now();
+        valor = emCentavos(valor);
+        if (!origem || !destino || origem == destino || valor <= 0 || walFalhou()) {
+            transferenciasAbortadas.adicionar();
+            registrarLatencia(TipoLatencia::FALHA, inicio);
+            registrarNoTrace(TipoRegistro::TRANSFERENCIA, origem, destino, valor, StatusOperacao::FALHA);
+            return false;
+        }
+
+        Conta* primeira = origem->getIndice() < destino->getIndice() ? origem : destino;
+        Conta* segunda = (primeira == origem) ? destino : origem;
+
+        long long espera;
+        bool sucesso;
+        uint64_t lsn = 0;
+        uint64_t posicao;
+        {
+            // As duas contas mudam na mesma época: nenhum snapshot vê só metade
+            DominioEpocas::Escrita escrita(epocas);
+            auto inicioEspera = std::chrono::steady_clock::now();
+            primeira->travarEscrita();
+            segunda->travarEscrita();
+            espera = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - inicioEspera).count();
+
+            sucesso = origem->debitarTravado(valor);
+            if (sucesso) {
+                destino->creditarTravado(valor);
+                LoggerOperacoes::instancia().registrar(TipoRegistro::TRANSFERENCIA, origem->getId(),
+                                                       valor, origem->getSaldoUnsafe(), 0,
+                                                       destino->getId());
+                if constexpr (Conta::PROCESSA_SOB_LOCK) simularProcessamento();
+                // Um único registro cobre as duas contas: a transferência é atômica também no log
+                lsn = anexarNoWAL(TipoRegistroWAL::TRANSFERENCIA, origem->getId(), destino->getId(), valor);
+            }
+            posicao = reservarNoTrace(1);      // Sucesso ou falha por saldo: a ordem vale para os dois
+
+            segunda->destravarEscrita();
+            primeira->destravarEscrita();
+        }
+
+        if constexpr (!Conta::PROCESSA_SOB_LOCK) {
+            if (sucesso) simularProcessamento();
+        }
+        if (sucesso) sucesso = aguardarNoWAL(lsn);
+
+        esperaLockNs.adicionar(espera);
+        (sucesso ? transferenciasRealizadas : transferenciasAbortadas).adicionar();
+        if (EstatisticaPar* par = estatisticaPar(origem, destino)) {
+            par->esperaNs.fetch_add(espera, std::memory_order_relaxed);
+            sucesso ? par->transferencias++ : par->abortos++;
+        }
+        registrarLatencia(sucesso ? TipoLatencia::TRANSFERENCIA : TipoLatencia::FALHA, inicio);
+        registrarNoTrace(TipoRegistro::TRANSFERENCIA, origem, destino, valor, statusDe(sucesso), posicao);
+        return sucesso;
+    }
+
+    bool transferir(const std::string& origem, const std::string& destino, double valor) {
+        Leitura leitura(reclamacao);
+        return transferir(obterConta(origem), obterConta(destino), valor);
+    }
+
+    /*
+     * EXECUÇÃO DE LOTE (TUDO OU NADA):
+     * 1. Resolve todas as contas envolvidas
+     * 2. Trava todas em ordem de índice (sem deadlock)
+     * 3. Guarda o estado de cada uma e aplica as operações em sequência
+     * 4. Se alguma falhar, restaura os estados salvos e aborta o lote
+     */
+    bool executarLote(std::vector<OperacaoLote> lote) {
+        auto inicio = std::chrono::steady_clock::now();
+        for (OperacaoLote& op : lote) op.valor = emCentavos(op.valor);
+        Leitura leitura(reclamacao);
+        std::vector<Conta*> origens(lote.size(), nullptr);
+        std::vector<Conta*> destinos(lote.size(), nullptr);
+        std::vector<Conta*> envolvidas;
+        envolvidas.reserve(lote.size() * 2);
+
+        for (size_t i = 0; i < lote.size(); ++i) {
+            origens[i] = obterConta(lote[i].conta);
+            if (lote[i].tipo == TipoOperacaoLote::TRANSFERENCIA) {
+                destinos[i] = obterConta(lote[i].destino);
+            }
+            bool invalida = !origens[i] || walFalhou() ||
+                            (lote[i].tipo == TipoOperacaoLote::TRANSFERENCIA &&
+                             (!destinos[i] || destinos[i] == origens[i]));
+            if (invalida) {
+                lotesAbortados.adicionar();
+                registrarLatencia(TipoLatencia::FALHA, inicio);
+                registrarLoteNoTrace(lote, origens, destinos, false);
+                return false;
+            }
+            envolvidas.push_back(origens[i]);
+            if (destinos[i]) envolvidas.push_back(destinos[i]);
+        }
+
+        // O lote inteiro (inclusive um desfazer) acontece numa única época
+        std::optional<DominioEpocas::Escrita> escrita(std::in_place, epocas);
+        long long espera = travarEmOrdem(envolvidas);
+
+        std::vector<typename Conta::Estado> estados;
+        estados.reserve(envolvidas.size());
+        for (Conta* conta : envolvidas) estados.push_back(conta->estadoTravado());
+
+        bool sucesso = true;
+        for (size_t i = 0; i < lote.size() && sucesso; ++i) {
+            const OperacaoLote& op = lote[i];
+            switch (op.tipo) {
+                case TipoOperacaoLote::CREDITO: sucesso = origens[i]->creditarTravado(op.valor); break;
+                case TipoOperacaoLote::DEBITO: sucesso = origens[i]->debitarTravado(op.valor); break;
+                case TipoOperacaoLote::TRANSFERENCIA:
+                    sucesso = origens[i]->debitarTravado(op.valor) &&
+                              destinos[i]->creditarTravado(op.valor);
+                    break;
+            }
+        }
+
+        if (!sucesso) {
+            // Desfaz tudo: nenhuma alteração do lote fica visível
+            for (size_t i = 0; i < envolvidas.size(); ++i) {
+                envolvidas[i]->restaurarEstadoTravado(estados[i]);
+            }
+        } else {
+            for (size_t i = 0; i < lote.size(); ++i) {
+                const OperacaoLote& op = lote[i];
+                TipoRegistro tipo = op.tipo == TipoOperacaoLote::CREDITO ? TipoRegistro::CREDITO
+                                  : op.tipo == TipoOperacaoLote::DEBITO  ? TipoRegistro::DEBITO
+                                                                         : TipoRegistro::TRANSFERENCIA;
+                LoggerOperacoes::instancia().registrar(tipo, op.conta, op.valor,
+                                                       origens[i]->getSaldoUnsafe(), 0, op.destino);
+                if (op.tipo != TipoOperacaoLote::TRANSFERENCIA) {
+                    double efetivo = Conta::valorEfetivo(op.valor);
+                    escrita->registrarFluxo(op.tipo == TipoOperacaoLote::CREDITO ? efetivo : -efetivo);
+                }
+            }
+            if constexpr (Conta::PROCESSA_SOB_LOCK) simularProcessamento();
+        }
+
+        // Registros contíguos marcados com 'continua': recuperados só se completos
+        uint64_t lsn = 0;
+        if (sucesso && wal) {
+            std::vector<RegistroWAL> registros;
+            registros.reserve(lote.size());
+            for (const OperacaoLote& op : lote) {
+                TipoRegistroWAL tipo = op.tipo == TipoOperacaoLote::CREDITO ? TipoRegistroWAL::CREDITO
+                                     : op.tipo == TipoOperacaoLote::DEBITO  ? TipoRegistroWAL::DEBITO
+                                                                            : TipoRegistroWAL::TRANSFERENCIA;
+                registros.push_back(WriteAheadLog::criarRegistro(tipo, op.conta, op.destino,
+                                                                 std::llround(op.valor * 100.0)));
+            }
+            lsn = anexarNoWAL(registros.data(), registros.size());
+        }
+        uint64_t posicao = reservarNoTrace(lote.size());
+
+        destravarTodas(envolvidas);
+        escrita.reset();
+
+        if constexpr (!Conta::PROCESSA_SOB_LOCK) {
+            if (sucesso) simularProcessamento();
+        }
+        if (sucesso) sucesso = aguardarNoWAL(lsn);
+
+        esperaLockNs.adicionar(espera);
+        (sucesso ? lotesRealizados : lotesAbortados).adicionar();
+        registrarLatencia(sucesso ? TipoLatencia::LOTE : TipoLatencia::FALHA, inicio);
+        registrarLoteNoTrace(lote, origens, destinos, sucesso, posicao);
+        return sucesso;
+    }
+
+    /*
+     * CAPTURA DO TRACE:
+     * Chamada sem operações em andamento (antes da simulação ou do
+     * servidor): a tabela do trace guarda o saldo de partida de cada conta
+     */
+    bool iniciarCaptura(const std::string& arquivo) {
+        std::vector<ContaLida> tabela;
+        {
+            std::lock_guard<std::mutex> lock(contasMutex);
+            tabela.resize(contasPorIndice.size());
+            for (size_t i = 0; i < contasPorIndice.size(); ++i) {
+                if (const Conta* conta = contasPorIndice[i]) tabela[i] = {conta->getId(), conta->getSaldoUnsafe()};
+            }
+        }
+        trace = std::make_unique<GravadorTrace>(arquivo, tabela);
+        if (trace->aberto()) return true;
+        std::cerr << "Erro ao criar o trace: " << arquivo << std::endl;
+        trace.reset();
+        return false;
+    }
+
+    /*
+     * FIM DA CAPTURA:
+     * Também sem operações em andamento: o trace fecha com o saldo final
+     * de cada conta, que a reprodução tem de reproduzir. Retorna quantos
+     * registros o trace recebeu
+     */
+    uint64_t pararCaptura() {
+        if (!trace) return 0;
+        std::vector<ContaLida> finais;
+        {
+            std::lock_guard<std::mutex> lock(contasMutex);
+            finais.resize(contasPorIndice.size());
+            for (size_t i = 0; i < contasPorIndice.size(); ++i) {
+                if (const Conta* conta = contasPorIndice[i]) finais[i] = {conta->getId(), conta->getSaldoUnsafe()};
+            }
+        }
+        uint64_t registros = trace->fechar(finais);
+        trace.reset();
+        return registros;
+    }
+
+    /*
+     * LISTAGEM DE IDs:
+     * Retorna vetor com todos os IDs das contas
+     */
+    std::vector<std::string> listarContas() {
+        std::lock_guard<std::mutex> lock(contasMutex);
+        std::vector<std::string> ids;
+        for (const auto& [id, conta] : contas) {
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    // IDs abertos mais os já encerrados: o universo que a rotatividade sorteia
+    std::vector<std::string> listarContasConhecidas() {
+        std::vector<std::string> ids = listarContas();
+        std::lock_guard<std::mutex> lock(contasMutex);
+        ids.insert(ids.end(), idsEncerrados.begin(), idsEncerrados.end());
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    /*
+     * MÉTODOS PARA ESTATÍSTICAS:
+     * Cada thread soma na sua fatia - não precisam de mutex
+     */
+    void incrementarOperacoes() { operacoesRealizadas.adicionar(); }
+    void incrementarFalhas() { operacoesFalhas.adicionar(); }
+
+    int getOperacoesRealizadas() const { return static_cast<int>(operacoesRealizadas.total()); }
+    int getOperacoesFalhas() const { return static_cast<int>(operacoesFalhas.total()); }
+
+    /*
+     * RESET DE ESTATÍSTICAS:
+     * Zera as fatias dos contadores (chamar com as threads paradas)
+     */
+    void resetarEstatisticas() {
+        operacoesRealizadas.zerar();
+        operacoesFalhas.zerar();
+        transferenciasRealizadas.zerar();
+        transferenciasAbortadas.zerar();
+        lotesRealizados.zerar();
+        lotesAbortados.zerar();
+        esperaLockNs.zerar();
+        rejeicoesFilaCheia.zerar();
+        rejeicoesTempoEsgotado.zerar();
+        esperaFilaNs.zerar();
+        snapshotsAuditados.store(0);
+        divergenciasAuditoria.store(0);
+        tempoSnapshotsNs.store(0);
+        aberturasRealizadas.zerar();
+        encerramentosRealizados.zerar();
+        prepararEstatisticasPares();
+        // Zera em vez de descartar: as threads guardam ponteiros para os seus conjuntos
+        histogramasThreads.paraCada([](HistogramasPorTipo& conjunto) {
+            for (auto& h : conjunto) h.zerar();
+        });
+    }
+
+    int getTransferenciasRealizadas() const { return static_cast<int>(transferenciasRealizadas.total()); }
+    int getTransferenciasAbortadas() const { return static_cast<int>(transferenciasAbortadas.total()); }
+    int getLotesRealizados() const { return static_cast<int>(lotesRealizados.total()); }
+    int getLotesAbortados() const { return static_cast<int>(lotesAbortados.total()); }
+    long long getEsperaLockNs() const { return esperaLockNs.total(); }
+
+    /*
+     * LATÊNCIAS DA EXECUÇÃO:
+     * Junta os histogramas de todas as threads; chamar depois que
+     * as threads de simulação terminaram
+     */
+    HistogramasPorTipo latencias() {
+        HistogramasPorTipo juntos;
+        histogramasThreads.paraCada([&](const HistogramasPorTipo& conjunto) {
+            for (size_t t = 0; t < NUM_TIPOS_LATENCIA; ++t) juntos[t].juntar(conjunto[t]);
+        });
+        return juntos;
+    }
+
+    /*
+     * TELEMETRIA DURANTE A EXECUÇÃO:
+     * Ligada e desligada com as threads paradas; drenarJanelas() junta as
+     * latências registradas desde a chamada anterior e pode rodar em
+     * paralelo com as operações
+     */
+    void configurarTelemetria(bool ligada) {
+        telemetriaAtiva.store(ligada);
+        consultasAtivas.zerar();
+        HistogramaLatencia descartadas;
+        drenarJanelas(descartadas);
+    }
+
+    void drenarJanelas(HistogramaLatencia& destino) {
+        janelasThreads.paraCada([&](JanelaLatencia& janela) { janela.drenar(destino); });
+    }
+
+    long long getConsultasAtivas() const { return consultasAtivas.total(); }
+
+    /*
+     * CONTROLE DE ADMISSÃO:
+     * Deve ser configurado antes das simulações (não durante)
+     */
+    void configurarAdmissao(const ConfigAdmissao& config) { configAdmissao = config; }
+    const ConfigAdmissao& getConfigAdmissao() const { return configAdmissao; }
+
+    /*
+     * COMBINAÇÃO DE ESCRITAS:
+     * Modo global e totais somados das contas
+     */
+    void configurarCombinacao(ModoCombinacao modo) { modoCombinacao = modo; }
+    ModoCombinacao getModoCombinacao() const { return modoCombinacao; }
+
+    struct EstatisticasCombinacao {
+        int contasCombinando = 0;       // Contas em modo combinado ao final
+        long long lotes = 0;            // Passadas de combinador
+        long long pedidos = 0;          // Escritas aplicadas por combinadores
+    };
+
+    EstatisticasCombinacao estatisticasCombinacao() {
+        EstatisticasCombinacao e;
+        if constexpr (Conta::SUPORTA_COMBINACAO) {
+            std::lock_guard<std::mutex> lock(contasMutex);
+            for (const auto& [id, conta] : contas) {
+                if (usarCombinacao(conta)) e.contasCombinando++;
+                e.lotes += conta->getLotesCombinados();
+                e.pedidos += conta->getPedidosCombinados();
+            }
+        }
+        return e;
+    }
+    int getRejeicoesFilaCheia() const { return static_cast<int>(rejeicoesFilaCheia.total()); }
+    int getRejeicoesTempoEsgotado() const { return static_cast<int>(rejeicoesTempoEsgotado.total()); }
+    long long getEsperaFilaNs() const { return esperaFilaNs.total(); }
+
+    long long getCommitsWAL() const { return wal ? wal->getCommits() : 0; }
+    WriteAheadLog* getWAL() const { return wal.get(); }
+
+    // ID de cada índice global (vazio = substituído): nomeia as contas do perfil de travas
+    std::vector<std::string> idsPorIndice() {
+        std::lock_guard<std::mutex> lock(contasMutex);
+        std::vector<std::string> ids(contasPorIndice.size());
+        for (size_t i = 0; i < contasPorIndice.size(); ++i) {
+            if (const Conta* conta = contasPorIndice[i]) ids[i] = conta->getId();
+        }
+        return ids;
+    }
+    long long getRegistrosWAL() const { return wal ? wal->getRegistrosGravados() : 0; }
+    long long getRecortesWAL() const { return wal ? wal->getRecortes() : 0; }
+    uint64_t getUltimoLsnWAL() const { return wal ? wal->getUltimoLsn() : 0; }
+
+    /*
+     * PARES MAIS DISPUTADOS:
+     * Ordena os pares de contas pelo tempo de espera por lock
+     */
+    std::vector<ParContencao> paresMaisDisputados(size_t quantidade) {
+        std::vector<ParContencao> resultado;
+        if (!pares) return resultado;
+
+        std::vector<std::string> ids(numContasPares);
+        {
+            std::lock_guard<std::mutex> lock(contasMutex);
+            for (const auto& [id, conta] : contas) {
+                if (conta->getIndice() < numContasPares) ids[conta->getIndice()] = id;
+            }
+        }
+
+        for (size_t i = 0; i < numContasPares; ++i) {
+            for (size_t j = i + 1; j < numContasPares; ++j) {
+                const EstatisticaPar& par = pares[i * numContasPares + j];
+                if (par.transferencias.load() + par.abortos.load() == 0) continue;
+                ParContencao p;
+                p.contaA = ids[i];
+                p.contaB = ids[j];
+                p.transferencias = par.transferencias.load();
+                p.abortos = par.abortos.load();
+                p.esperaNs = par.esperaNs.load();
+                resultado.push_back(p);
+            }
+        }
+
+        std::sort(resultado.begin(), resultado.end(),
+                  [](const ParContencao& a, const ParContencao& b) { return a.esperaNs > b.esperaNs; });
+        if (resultado.size() > quantidade) resultado.resize(quantidade);
+        return resultado;
+    }
+
+    /*
+     * RELATÓRIO DE ESTATÍSTICAS:
+     * Mostra resultados da simulação
+     */
+    void imprimirEstatisticas() {
+        std::cout << "\n=== ESTATÍSTICAS FINAIS ===" << std::endl;
+        std::cout << "Operações realizadas: " << operacoesRealizadas.total() << std::endl;
+        std::cout << "Operações com falha: " << operacoesFalhas.total() << std::endl;
+        std::cout << "Recusadas pela admissão: " << (rejeicoesFilaCheia.total() + rejeicoesTempoEsgotado.total())
+                  << " (fila cheia: " << rejeicoesFilaCheia.total()
+                  << ", tempo esgotado: " << rejeicoesTempoEsgotado.total() << ")" << std::endl;
+        std::cout << "Total de tentativas: "
+                  << (operacoesRealizadas.total() + operacoesFalhas.total() +
+                      rejeicoesFilaCheia.total() + rejeicoesTempoEsgotado.total())
+                  << std::endl;
+
+        EstatisticasCombinacao combinacao = estatisticasCombinacao();
+        if (combinacao.lotes > 0) {
+            std::cout << "Escritas combinadas: " << combinacao.pedidos << " em " << combinacao.lotes
+                      << " seções críticas (" << std::fixed << std::setprecision(2)
+                      << static_cast<double>(combinacao.pedidos) / combinacao.lotes
+                      << " por lote); contas combinando: " << combinacao.contasCombinando << std::endl;
+        }
+
+        if (transferenciasRealizadas.total() + transferenciasAbortadas.total() +
+            lotesRealizados.total() + lotesAbortados.total() > 0) {
+            std::cout << "\n=== TRANSFERÊNCIAS E LOTES ===" << std::endl;
+            std::cout << "Transferências realizadas: " << transferenciasRealizadas.total()
+                      << " (abortadas: " << transferenciasAbortadas.total() << ")" << std::endl;
+            std::cout << "Lotes realizados: " << lotesRealizados.total()
+                      << " (abortados: " << lotesAbortados.total() << ")" << std::endl;
+            std::cout << "Espera total por locks: " << std::fixed << std::setprecision(2)
+                      << esperaLockNs.total() / 1e6 << " ms" << std::endl;
+
+            auto quentes = paresMaisDisputados(5);
+            if (!quentes.empty()) {
+                std::cout << "Pares mais disputados (espera por lock):" << std::endl;
+                for (const auto& p : quentes) {
+                    std::cout << "  " << p.contaA << " <-> " << p.contaB
+                              << ": " << p.transferencias << " transferências, "
+                              << p.abortos << " abortos, espera "
+                              << std::fixed << std::setprecision(3) << p.esperaNs / 1e6 << " ms"
+                              << std::endl;
+                }
+            }
+        }
+
+        if (snapshotsAuditados > 0) {
+            std::cout << "Auditoria: " << snapshotsAuditados.load() << " snapshots, "
+                      << divergenciasAuditoria.load() << " divergências, "
+                      << std::fixed << std::setprecision(1)
+                      << tempoSnapshotsNs.load() / 1e3 / snapshotsAuditados.load()
+                      << " us por snapshot" << std::endl;
+        }
+
+        std::cout << "\n=== SALDOS FINAIS ===" << std::endl;
+        Snapshot foto = tirarSnapshot();
+        for (const ContaLida& conta : foto.saldos) {
+            std::cout << "Conta " << conta.id << ": R$ " << std::fixed << std::setprecision(2) 
+                      << conta.saldo << std::endl;
+        }
+        std::cout << "Total: R$ " << foto.total << " (esperado R$ " << foto.esperado
+                  << (foto.consistente() ? ", confere)" : ", DIVERGENTE)") << std::endl;
+    }
+};
+
+#endif  // BANCO_BANCO_HPP
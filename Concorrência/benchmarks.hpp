@@ -0,0 +1,927 @@
+/*
+ * BENCHMARKS
+ * Métodos de SistemaBancario que medem cada componente (--bench-*) e a
+ * varredura de parâmetros
+ */
+#ifndef BANCO_BENCHMARKS_HPP
+#define BANCO_BENCHMARKS_HPP
+
+#include "sistema.hpp"
+
+/*
+ * VARREDURA DE PARÂMETROS:
+ * Percorre o produto cartesiano dos eixos (motor mais interno, para
+ * que os motores comparados rodem próximos no tempo). Cada rodada cria
+ * um banco novo a partir da mesma cópia das contas em memória, sem WAL
+ * e sem salvar nada; com --semente, a rodada r usa uma semente derivada
+ * dela, então a varredura inteira é reproduzível.
+ */
+inline void SistemaBancario::executarVarredura(const ConfigVarredura& config) {
+    const std::string arquivoRodadas = "varredura.csv";
+    const std::string arquivoResumo = "varredura_resumo.csv";
+    MixOperacoes mixOriginal = mix;
+    ConfigCarga cargaOriginal = configCarga;
+
+    /*
+     * CONTAS DE CADA TAMANHO:
+     * 0 = estado atual do arquivo; N = N contas sintéticas (semente fixa)
+     */
+    std::map<size_t, std::vector<ContaLida>> bases;
+    for (size_t quantidade : config.contas) {
+        std::vector<ContaLida>& base = bases[quantidade];
+        if (!base.empty()) continue;
+        base = quantidade == 0 ? lerContasDoArquivo() : contasSinteticas(quantidade);
+    }
+
+    LoggerVarredura registro(arquivoRodadas, arquivoResumo);
+    if (!registro.aberto()) {
+        std::cerr << "Erro ao criar " << arquivoRodadas << " / " << arquivoResumo << std::endl;
+        return;
+    }
+
+    size_t total = config.configuracoes(motores.size());
+    std::cout << "=== VARREDURA DE PARÂMETROS ===" << std::endl;
+    std::cout << total << " configurações x (" << config.aquecimento << " aquecimento + "
+              << config.repeticoes << " medidas) rodadas" << std::endl;
+    std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+              << ModeloServico::instancia().descricao() << std::endl;
+    std::cout << std::setw(10) << "motor" << std::setw(8) << "threads" << std::setw(8) << "contas"
+              << std::setw(16) << "mix" << std::setw(18) << "distribuição" << std::setw(7) << "ops"
+              << std::setw(24) << "ops/ms (IC 95%)" << std::setw(20) << "p99 us (IC 95%)" << std::endl;
+
+    for (const auto& [quantidade, base] : bases) {
+        for (const MixOperacoes& mixRodada : config.mixes) {
+            for (const ConfigCarga& distribuicao : config.distribuicoes) {
+                for (int operacoes : config.operacoes) {
+                    for (int threads : config.threads) {
+                        for (MotorConta motor : motores) {
+                            mix = mixRodada;
+                            configCarga = distribuicao;
+                            std::vector<double> vazao, p99;
+                            ResultadoSimulacao ultimo;
+                            for (int rodada = 0; rodada < config.aquecimento + config.repeticoes; ++rodada) {
+                                int repeticao = rodada - config.aquecimento;
+                                configCarga.semente = cargaOriginal.semente
+                                    ? derivarSemente(cargaOriginal.semente, static_cast<uint64_t>(rodada)) : 0;
+                                ultimo = despacharMotor(motor, [&](auto tipo) {
+                                    using Conta = typename decltype(tipo)::tipo;
+                                    Banco<Conta> banco;
+                                    configurarBanco(banco);
+                                    banco.adicionarContas(base);
+                                    return executarSimulacao(banco, threads, operacoes, false);
+                                });
+                                if (repeticao < 0) continue;
+                                registro.registrarRodada(ultimo, base.size(), repeticao);
+                                vazao.push_back(ultimo.tempoExecucao > 0
+                                    ? ultimo.operacoesSucesso / ultimo.tempoExecucao : 0);
+                                p99.push_back(ultimo.latenciaP99Us);
+                            }
+
+                            ResumoAmostra resumoVazao = ResumoAmostra::de(vazao);
+                            ResumoAmostra resumoP99 = ResumoAmostra::de(p99);
+                            registro.registrarResumo(ultimo, base.size(), vazao.size(), resumoVazao, resumoP99);
+                            std::ostringstream faixaVazao, faixaP99;
+                            faixaVazao << std::fixed << std::setprecision(2) << resumoVazao.media
+                                       << " ± " << resumoVazao.ic95;
+                            faixaP99 << std::fixed << std::setprecision(1) << resumoP99.media
+                                     << " ± " << resumoP99.ic95;
+                            std::cout << std::setw(10) << ultimo.motor << std::setw(8) << threads
+                                      << std::setw(8) << base.size() << std::setw(16) << ultimo.mix
+                                      << std::setw(18) << ultimo.distribuicao << std::setw(7) << operacoes
+                                      << std::setw(24) << faixaVazao.str()
+                                      << std::setw(20) << faixaP99.str() << std::endl;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    std::cout << "Rodadas em " << arquivoRodadas << ", resumo em " << arquivoResumo << std::endl;
+    mix = mixOriginal;
+    configCarga = cargaOriginal;
+}
+
+/*
+ * BENCHMARK DO SOCKET LOCAL:
+ * As mesmas operações sorteadas são executadas (1) por threads deste
+ * processo chamando o banco diretamente e (2) por 'processos' processos
+ * clientes através do socket, com janelas de pipelining crescentes.
+ * A diferença para (1) é o custo de atravessar a fronteira entre
+ * processos; janelas maiores põem mais pedidos em cada chamada de
+ * sistema e recuperam parte dele. O arquivo de contas não é alterado.
+ */
+inline void SistemaBancario::executarBenchmarkSocket(int processos) {
+    const std::string caminho = "banco_bench.sock";
+    const std::string arquivoWAL = "banco_bench.wal";    // Descartado no fim
+    const int operacoes = 20000;                // Por processo
+    std::vector<int> janelas = {1, 4, 16, 64, 256};
+    std::vector<ContaLida> base = lerContasDoArquivo();
+
+    despacharMotor(motores.front(), [&](auto tipo) {
+        using Conta = typename decltype(tipo)::tipo;
+        Banco<Conta> banco;
+        configurarBanco(banco);
+        banco.adicionarContas(base);
+        banco.iniciarWAL(arquivoWAL);           // Escritas duráveis, como no modo servidor
+        ServidorBanco<Conta> servidor(banco, caminho, threadsDisponiveis());
+
+        std::cout << "=== BENCHMARK DO SOCKET LOCAL (" << Conta::nomeMotor() << ", " << processos
+                  << " clientes x " << operacoes << " operações, WAL " << configWAL.descricao()
+                  << ") ===" << std::endl;
+        std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+                  << ModeloServico::instancia().descricao() << std::endl;
+
+        /*
+         * LINHA DE BASE (EM PROCESSO):
+         * Mesmo gerador e mesma execução do pedido, sem socket
+         */
+        ConfigCarga carga = configCarga;
+        if (carga.semente == 0) carga.semente = std::random_device{}() | 1;
+        std::vector<ResultadoCliente> porThread(static_cast<size_t>(processos));
+        executarEmParalelo(static_cast<unsigned>(processos), [&](unsigned t) {
+            GeradorPedidos gerador(servidor.getNumContas(), mix, carga, t);
+            ResultadoCliente& r = porThread[t];
+            auto inicio = std::chrono::steady_clock::now();
+            for (int i = 0; i < operacoes; ++i) {
+                PedidoRede pedido = gerador.proximo(static_cast<uint32_t>(i));
+                auto antes = std::chrono::steady_clock::now();
+                r.contar(servidor.processar(pedido).status);
+                r.latencia.registrar(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - antes).count()));
+            }
+            r.duracaoNs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count());
+        });
+        ResultadoCliente local;
+        for (const ResultadoCliente& r : porThread) local.juntar(r);
+
+        if (!servidor.iniciar()) return;
+        std::cout << std::setw(14) << "modo" << std::setw(8) << "janela" << std::setw(12) << "ops/s"
+                  << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(14)
+                  << "pedidos/write" << std::setw(13) << "pedidos/read" << std::setw(10) << "custo"
+                  << std::endl;
+        auto imprimir = [&](const std::string& modo, int janela, const ResultadoCliente& r,
+                            double porRead) {
+            std::cout << std::setw(14) << modo << std::setw(8) << janela << std::fixed
+                      << std::setprecision(0) << std::setw(12) << r.opsPorSegundo()
+                      << std::setprecision(1) << std::setw(10) << r.latencia.percentilUs(50.0)
+                      << std::setw(10) << r.latencia.percentilUs(99.0) << std::setprecision(2)
+                      << std::setw(14) << (r.escritas ? static_cast<double>(r.operacoes) / r.escritas : 0)
+                      << std::setw(13) << porRead << std::setw(9)
+                      << (r.opsPorSegundo() > 0 ? local.opsPorSegundo() / r.opsPorSegundo() : 0)
+                      << "x" << std::endl;
+        };
+        imprimir("em processo", 0, local, 0);
+        for (int janela : janelas) {
+            uint64_t pedidosAntes = servidor.getPedidosAtendidos();
+            uint64_t leiturasAntes = servidor.getLeituras();
+            ResultadoCliente r = lancarProcessoCliente(caminho, processos, operacoes, janela);
+            uint64_t leituras = servidor.getLeituras() - leiturasAntes;
+            double porRead = leituras ? static_cast<double>(servidor.getPedidosAtendidos() - pedidosAntes)
+                                        / leituras : 0;
+            if (r.operacoes == 0) {
+                std::cerr << "Clientes com janela " << janela << " não completaram nenhuma operação"
+                          << std::endl;
+                continue;
+            }
+            imprimir("socket", janela, r, porRead);
+        }
+        servidor.parar();
+        ::unlink(arquivoWAL.c_str());
+    });
+}
+
+/*
+ * BENCHMARK DO GROUP COMMIT:
+ * Varia o tamanho máximo do lote de commit e a latência máxima
+ * para cada número de threads; o CSV mostra o efeito em
+ * ops/ms (Throughput_ops_ms) e na latência p99
+ */
+inline void SistemaBancario::executarBenchmarkWAL() {
+    std::vector<int> numThreads = {1, 4, 16, 64};
+    std::vector<std::string> configuracoes = {"desligado", "1:0", "16:1000", "64:2000", "256:5000"};
+    int operacoesPorThread = 50;
+    ConfigWAL original = configWAL;
+
+    std::cout << "=== BENCHMARK DO WAL (GROUP COMMIT) ===" << std::endl;
+
+    for (MotorConta motor : motores) {
+        for (const std::string& texto : configuracoes) {
+            interpretarConfigWAL(texto, configWAL);
+            for (int threads : numThreads) {
+                std::cout << "\n" << std::string(50, '=') << "\n";
+                std::cout << "WAL " << configWAL.descricao() << " COM " << threads << " THREADS\n";
+                std::cout << std::string(50, '=') << "\n";
+                executarSimulacao(motor, threads, operacoesPorThread);
+            }
+        }
+    }
+    configWAL = original;
+}
+
+/*
+ * CUSTO DO CHECKPOINT EM SEGUNDO PLANO:
+ * A mesma carga (mesma semente) sobre N contas sintéticas, sem WAL,
+ * com o checkpoint desligado, completo (todas as contas a cada vez)
+ * e incremental, no intervalo de --checkpoint (padrão: 10 ms). Mostra
+ * a vazão e a cauda das operações e, por checkpoint, contas e bytes
+ * gravados e a duração. O arquivo de contas não é alterado.
+ */
+inline void SistemaBancario::executarBenchmarkCheckpoint(size_t numContas) {
+    std::vector<int> numThreads = {4, 16};
+    int operacoesPorThread = 20000;
+    ConfigCheckpoint original = configCheckpoint;
+    ConfigCarga cargaOriginal = configCarga;
+    if (!configCarga.semente) configCarga.semente = 1;
+    ConfigCheckpoint base = original;
+    if (!base.ativo) base.intervaloMs = 10;
+    base.ativo = true;
+    base.completo = false;
+    ConfigCheckpoint completo = base;
+    completo.completo = true;
+    ConfigCheckpoint desligado;
+    std::vector<ConfigCheckpoint> modos = {desligado, completo, base};
+    std::vector<ContaLida> contas = contasSinteticas(numContas);
+
+    std::cout << "=== BENCHMARK DE CHECKPOINT (" << numContas << " contas, arquivo "
+              << base.arquivo << ") ===" << std::endl;
+    std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+              << ModeloServico::instancia().descricao() << std::endl;
+    std::cout << std::setw(10) << "motor" << std::setw(8) << "threads" << std::setw(18) << "checkpoint"
+              << std::setw(10) << "ops/ms" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "p99.9 us" << std::setw(8) << "ckpts" << std::setw(12) << "contas/ck"
+              << std::setw(10) << "KiB/ck" << std::setw(10) << "p50 ms" << std::setw(10) << "máx ms"
+              << std::setw(10) << "p99 x" << std::endl;
+    for (MotorConta motor : motores) {
+        for (int threads : numThreads) {
+            double p99Desligado = 0;
+            for (const ConfigCheckpoint& modo : modos) {
+                configCheckpoint = modo;
+                ResultadoSimulacao r = despacharMotor(motor, [&](auto tipo) {
+                    using Conta = typename decltype(tipo)::tipo;
+                    Banco<Conta> banco;
+                    configurarBanco(banco);
+                    banco.adicionarContas(contas);
+                    return executarSimulacao(banco, threads, operacoesPorThread, false);
+                });
+                if (!modo.ativo) p99Desligado = r.latenciaP99Us;
+                int n = std::max(1, r.checkpoints);
+                std::cout << std::setw(10) << r.motor << std::setw(8) << threads
+                          << std::setw(18) << r.checkpoint << std::fixed << std::setprecision(1)
+                          << std::setw(10) << (r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0)
+                          << std::setw(10) << r.latenciaP50Us << std::setw(10) << r.latenciaP99Us
+                          << std::setw(10) << r.latenciaP999Us << std::setw(8) << r.checkpoints
+                          << std::setw(12) << r.registrosCheckpoint / n
+                          << std::setw(10) << r.bytesCheckpoint / 1024.0 / n << std::setprecision(3)
+                          << std::setw(10) << r.checkpointP50Ms << std::setw(10) << r.checkpointMaxMs
+                          << std::setprecision(2) << std::setw(10)
+                          << (p99Desligado > 0 ? r.latenciaP99Us / p99Desligado : 0) << std::endl;
+            }
+        }
+    }
+    configCheckpoint = original;
+    configCarga = cargaOriginal;
+}
+
+/*
+ * CUSTO DAS OPERAÇÕES EM MASSA NO CAMINHO ONLINE:
+ * Mesma carga sobre N contas sintéticas sem trabalho em massa e com
+ * juros, tarifa e conciliação repetidos sem pausa durante toda a
+ * simulação (threads da passada de --massa, padrão 2). Lentidão =
+ * vazão e p99 das operações online relativos à rodada sem massa.
+ */
+inline void SistemaBancario::executarBenchmarkMassa(size_t numContas) {
+    std::vector<int> numThreads = {4, 16};
+    int operacoesPorThread = 20000;
+    ConfigMassa original = configMassa;
+    ConfigCarga cargaOriginal = configCarga;
+    if (!configCarga.semente) configCarga.semente = 1;
+    std::vector<ConfigMassa> modos;
+    for (const char* nome : {"desligada", "juros", "tarifa", "conciliacao"}) {
+        ConfigMassa modo;                               // Intervalo padrão 0: passadas sem pausa
+        interpretarConfigMassa(nome, modo);
+        if (original.ativa()) modo.threads = original.threads;
+        modos.push_back(modo);
+    }
+    std::vector<ContaLida> contas = contasSinteticas(numContas);
+
+    std::cout << "=== BENCHMARK DE OPERAÇÕES EM MASSA (" << numContas << " contas, "
+              << modos[1].threads << " threads por passada) ===" << std::endl;
+    std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+              << ModeloServico::instancia().descricao() << std::endl;
+    std::cout << std::setw(10) << "motor" << std::setw(8) << "threads" << std::setw(26) << "massa"
+              << std::setw(10) << "ops/ms" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "p99.9 us" << std::setw(10) << "passadas" << std::setw(12) << "ms/passada"
+              << std::setw(12) << "Mcontas/s" << std::setw(10) << "vazão x" << std::setw(10) << "p99 x"
+              << std::endl;
+    for (MotorConta motor : motores) {
+        for (int threads : numThreads) {
+            double vazaoSem = 0, p99Sem = 0;
+            for (const ConfigMassa& modo : modos) {
+                configMassa = modo;
+                ResultadoSimulacao r = despacharMotor(motor, [&](auto tipo) {
+                    using Conta = typename decltype(tipo)::tipo;
+                    Banco<Conta> banco;
+                    configurarBanco(banco);
+                    banco.adicionarContas(contas);
+                    return executarSimulacao(banco, threads, operacoesPorThread, false);
+                });
+                double vazao = r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0;
+                if (!modo.ativa()) {
+                    vazaoSem = vazao;
+                    p99Sem = r.latenciaP99Us;
+                }
+                double contasPorSegundo = r.passadaMediaMs > 0 ? numContas / (r.passadaMediaMs / 1000.0) : 0;
+                std::cout << std::setw(10) << r.motor << std::setw(8) << threads << std::setw(26) << r.massa
+                          << std::fixed << std::setprecision(1) << std::setw(10) << vazao
+                          << std::setw(10) << r.latenciaP50Us << std::setw(10) << r.latenciaP99Us
+                          << std::setw(10) << r.latenciaP999Us << std::setw(10) << r.passadasMassa
+                          << std::setprecision(3) << std::setw(12) << r.passadaMediaMs
+                          << std::setprecision(2) << std::setw(12) << contasPorSegundo / 1e6
+                          << std::setw(10) << (vazaoSem > 0 ? vazao / vazaoSem : 0)
+                          << std::setw(10) << (p99Sem > 0 ? r.latenciaP99Us / p99Sem : 0) << std::endl;
+                if (r.divergenciasMassa > 0) {
+                    std::cout << "  " << r.divergenciasMassa << " conciliações divergentes!" << std::endl;
+                }
+            }
+        }
+    }
+    configMassa = original;
+    configCarga = cargaOriginal;
+}
+
+/*
+ * BUSCA DE CONTAS SOB ROTATIVIDADE:
+ * Buscas por ID entre N contas sintéticas com 1, 2, 4... threads em
+ * três modos: o map com mutex global (a busca antiga de obterConta),
+ * o índice sem lock e o índice com uma thread encerrando e reabrindo
+ * contas sem parar durante a medição. Cada busca no índice fica numa
+ * Leitura, como uma operação do simulador. Escala = vazão sobre a do
+ * mesmo modo com 1 thread. Usa o primeiro --motor (a busca não depende
+ * do motor).
+ */
+inline void SistemaBancario::executarBenchmarkIndice(size_t numContas) {
+    const size_t buscasPorThread = 1000000;
+    unsigned cpus = threadsDisponiveis();
+    std::vector<unsigned> numThreads;
+    for (unsigned t = 1; t <= std::max(4u, cpus); t *= 2) numThreads.push_back(t);
+    std::vector<ContaLida> contas = contasSinteticas(numContas);
+
+    despacharMotor(motores.front(), [&](auto tipo) {
+        using Conta = typename decltype(tipo)::tipo;
+        Banco<Conta> banco;
+        configurarBanco(banco);
+        banco.adicionarContas(contas);
+
+        std::map<std::string, Conta*> mapa;
+        for (const ContaLida& c : contas) mapa[c.id] = banco.obterConta(c.id);
+        std::mutex mapaMutex;
+
+        std::cout << "=== BENCHMARK DO ÍNDICE DE CONTAS (" << numContas << " contas, " << cpus
+                  << " CPUs, motor " << Conta::nomeMotor() << ") ===" << std::endl;
+        std::cout << std::setw(22) << "modo" << std::setw(9) << "threads" << std::setw(12) << "Mbuscas/s"
+                  << std::setw(9) << "escala" << std::setw(12) << "achadas %" << std::setw(14) << "aberturas/s"
+                  << std::setw(16) << "encerramentos/s" << std::endl;
+        for (const char* modo : {"map+mutex", "indice", "indice+rotatividade"}) {
+            bool comMapa = std::string(modo) == "map+mutex";
+            bool comRotatividade = std::string(modo) == "indice+rotatividade";
+            double vazaoUm = 0;
+            for (unsigned threads : numThreads) {
+                std::atomic<bool> medindo{true};
+                long long aberturas = 0, encerramentos = 0;
+                std::thread rotatividade;
+                if (comRotatividade) {
+                    // Encerra contas sorteadas e reabre cada uma depois de finalizada
+                    rotatividade = std::thread([&] {
+                        std::mt19937_64 rng(derivarSemente(1, threads));
+                        std::deque<std::string> fechadas;
+                        while (medindo.load(std::memory_order_relaxed)) {
+                            if (!fechadas.empty() &&
+                                banco.abrirConta(fechadas.front(), 100.0) == StatusOperacao::SUCESSO) {
+                                fechadas.pop_front();
+                                aberturas++;
+                            } else if (fechadas.size() < 64) {
+                                const std::string& id = contas[rng() % contas.size()].id;
+                                if (banco.encerrarConta(id) == StatusOperacao::SUCESSO) {
+                                    fechadas.push_back(id);
+                                    encerramentos++;
+                                }
+                            }
+                        }
+                        banco.concluirEncerramentos();
+                        for (const std::string& id : fechadas) banco.abrirConta(id, 100.0);
+                    });
+                }
+
+                std::vector<long long> achadas(threads, 0);
+                auto inicio = std::chrono::steady_clock::now();
+                executarEmParalelo(threads, [&](unsigned t) {
+                    uint64_t x = derivarSemente(2, t) | 1;
+                    long long encontradas = 0;
+                    for (size_t i = 0; i < buscasPorThread; ++i) {
+                        x ^= x << 13;                       // xorshift: sorteio barato ao lado da busca
+                        x ^= x >> 7;
+                        x ^= x << 17;
+                        const std::string& id = contas[x % contas.size()].id;
+                        if (comMapa) {
+                            std::lock_guard<std::mutex> lock(mapaMutex);
+                            encontradas += mapa.find(id) != mapa.end();
+                        } else {
+                            auto leitura = banco.protegerLeitura();
+                            encontradas += banco.obterConta(id) != nullptr;
+                        }
+                    }
+                    achadas[t] = encontradas;
+                });
+                double segundos = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+                medindo.store(false);
+                if (rotatividade.joinable()) rotatividade.join();
+
+                double total = static_cast<double>(buscasPorThread) * threads;
+                double vazao = segundos > 0 ? total / segundos / 1e6 : 0;
+                if (threads == 1) vazaoUm = vazao;
+                long long encontradas = 0;
+                for (long long a : achadas) encontradas += a;
+                std::cout << std::setw(22) << modo << std::setw(9) << threads << std::fixed
+                          << std::setprecision(2) << std::setw(12) << vazao << std::setw(9)
+                          << (vazaoUm > 0 ? vazao / vazaoUm : 0) << std::setprecision(3) << std::setw(12)
+                          << 100.0 * encontradas / total << std::setprecision(0) << std::setw(14)
+                          << (segundos > 0 ? aberturas / segundos : 0) << std::setw(16)
+                          << (segundos > 0 ? encerramentos / segundos : 0) << std::endl;
+            }
+        }
+        std::cout << "Índice: " << banco.getContasAbertas() << " contas, "
+                  << banco.getLiberacoesReclamacao() << " liberações adiadas pela reclamação" << std::endl;
+        return 0;
+    });
+}
+
+/*
+ * COMPARTILHADO X PARTICIONADO:
+ * Mesma carga (contas sintéticas, mix, distribuição e semente) com 1,
+ * 2, 4... workers: cada --motor sobre o banco compartilhado (qualquer
+ * thread toca qualquer conta) e o banco particionado (cada worker
+ * fixado numa CPU e dono das suas contas). Escala = vazão sobre a
+ * vazão do mesmo motor com 1 worker.
+ */
+inline void SistemaBancario::executarBenchmarkParticionado(size_t numContas) {
+    int operacoesPorWorker = 20000;
+    ConfigCarga cargaOriginal = configCarga;
+    if (!configCarga.semente) configCarga.semente = 1;
+    unsigned cpus = threadsDisponiveis();
+    std::vector<int> numWorkers;
+    for (unsigned w = 1; w <= std::max(4u, cpus); w *= 2) numWorkers.push_back(static_cast<int>(w));
+    std::vector<ContaLida> contas = contasSinteticas(numContas);
+
+    std::cout << "=== BENCHMARK COMPARTILHADO X PARTICIONADO (" << numContas << " contas, "
+              << cpus << " CPUs) ===" << std::endl;
+    std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+              << ModeloServico::instancia().descricao() << std::endl;
+    if (numWorkers.back() > static_cast<int>(cpus))
+        std::cout << "Acima de " << cpus << " workers as CPUs são divididas (fixação circular)" << std::endl;
+    std::cout << std::setw(14) << "motor" << std::setw(9) << "workers" << std::setw(10) << "ops/ms"
+              << std::setw(9) << "escala" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us"
+              << std::setw(10) << "remotas" << std::setw(12) << "p99 rem us" << std::setw(10) << "entre"
+              << std::setw(9) << "fixados" << std::setw(9) << "total" << std::endl;
+
+    for (MotorConta motor : motores) {
+        double vazaoUm = 0;
+        for (int workers : numWorkers) {
+            ResultadoSimulacao r = despacharMotor(motor, [&](auto tipo) {
+                using Conta = typename decltype(tipo)::tipo;
+                Banco<Conta> banco;
+                configurarBanco(banco);
+                banco.adicionarContas(contas);
+                return executarSimulacao(banco, workers, operacoesPorWorker, false);
+            });
+            double vazao = r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0;
+            if (workers == 1) vazaoUm = vazao;
+            std::cout << std::setw(14) << r.motor << std::setw(9) << workers << std::fixed
+                      << std::setprecision(1) << std::setw(10) << vazao << std::setprecision(2)
+                      << std::setw(9) << (vazaoUm > 0 ? vazao / vazaoUm : 0) << std::setprecision(1)
+                      << std::setw(10) << r.latenciaP50Us << std::setw(10) << r.latenciaP99Us
+                      << std::setw(10) << "-" << std::setw(12) << "-" << std::setw(10) << "-"
+                      << std::setw(9) << "-" << std::setw(9) << "-" << std::endl;
+        }
+    }
+
+    double vazaoUm = 0;
+    for (int workers : numWorkers) {
+        BancoParticionado banco(contas, mix, configCarga, static_cast<unsigned>(workers));
+        BancoParticionado::Resultado r = banco.executar(operacoesPorWorker);
+        long long total = r.sucessos + r.falhas;
+        double vazao = r.tempoMs > 0 ? r.sucessos / r.tempoMs : 0;
+        if (workers == 1) vazaoUm = vazao;
+        std::cout << std::setw(14) << "particionado" << std::setw(9) << workers << std::fixed
+                  << std::setprecision(1) << std::setw(10) << vazao << std::setprecision(2)
+                  << std::setw(9) << (vazaoUm > 0 ? vazao / vazaoUm : 0) << std::setprecision(1)
+                  << std::setw(10) << r.latencia.percentilUs(50.0) << std::setw(10)
+                  << r.latencia.percentilUs(99.0) << std::setw(9)
+                  << (total > 0 ? 100.0 * r.remotas / total : 0) << "%" << std::setw(12)
+                  << r.latenciaRemotas.percentilUs(99.0) << std::setw(9)
+                  << (total > 0 ? 100.0 * r.entreParticoes / total : 0) << "%" << std::setw(9)
+                  << r.fixados << std::setw(9) << (r.confere ? "confere" : "DIVERGE") << std::endl;
+    }
+    configCarga = cargaOriginal;
+}
+
+/*
+ * CLIENTES: UMA THREAD POR CLIENTE X CORROTINAS:
+ * De W clientes (W = CPUs) até MAX, cada cliente com 10 operações e
+ * a pausa do modelo de serviço entre elas. Com uma thread por cliente
+ * (até 1000 threads) cada pausa e cada espera de commit prendem uma
+ * thread; com corrotinas os mesmos clientes rodam em W workers e
+ * suspendem nessas esperas. Roda sobre ContaCorrente.txt, salvo ao
+ * fim de cada rodada como nas simulações.
+ */
+inline void SistemaBancario::executarBenchmarkCorrotinas(size_t maxClientes) {
+    const size_t LIMITE_THREADS = 1000;
+    int operacoesPorCliente = 10;
+    unsigned workers = threadsDisponiveis();
+    size_t clientesOriginal = numClientes;
+    std::vector<size_t> escada;
+    for (size_t c : {static_cast<size_t>(workers), size_t{100}, size_t{1000}, size_t{10000},
+                     size_t{100000}, maxClientes}) {
+        if (c <= maxClientes) escada.push_back(c);
+    }
+    std::sort(escada.begin(), escada.end());
+    escada.erase(std::unique(escada.begin(), escada.end()), escada.end());
+
+    std::cout << "=== BENCHMARK DE CLIENTES: THREADS X CORROTINAS (" << workers << " workers) ==="
+              << std::endl;
+    std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+              << ModeloServico::instancia().descricao() << std::endl;
+    std::cout << "WAL: " << configWAL.descricao() << "; " << operacoesPorCliente
+              << " operações por cliente" << std::endl;
+    // Cada rodada carrega e salva o arquivo (com mensagens): a tabela sai no fim
+    std::ostringstream tabela;
+    tabela << std::setw(10) << "motor" << std::setw(12) << "modo" << std::setw(10) << "clientes"
+           << std::setw(9) << "threads" << std::setw(10) << "ops/ms" << std::setw(13) << "resp p50 us"
+           << std::setw(13) << "resp p99 us" << std::setw(9) << "commits" << std::setw(12) << "reg/commit"
+           << std::setw(11) << "bytes/cli" << "\n";
+    for (MotorConta motor : motores) {
+        for (size_t clientes : escada) {
+            for (bool corrotinas : {false, true}) {
+                if (!corrotinas && clientes > LIMITE_THREADS) continue;
+                numClientes = corrotinas ? clientes : 0;
+                int threads = corrotinas ? static_cast<int>(workers) : static_cast<int>(clientes);
+                ResultadoSimulacao r = despacharMotor(motor, [&](auto tipo) {
+                    using Conta = typename decltype(tipo)::tipo;
+                    Banco<Conta> banco;
+                    configurarBanco(banco);
+                    banco.carregarContas("ContaCorrente.txt");
+                    ResultadoSimulacao resultado = executarSimulacao(banco, threads, operacoesPorCliente, false);
+                    banco.salvarContas("ContaCorrente.txt");
+                    return resultado;
+                });
+                // Com threads a latência do banco já inclui a espera do commit
+                double p50 = corrotinas ? r.respostaP50Us : r.latenciaP50Us;
+                double p99 = corrotinas ? r.respostaP99Us : r.latenciaP99Us;
+                tabela << std::setw(10) << r.motor << std::setw(12) << (corrotinas ? "corrotinas" : "threads")
+                       << std::setw(10) << clientes << std::setw(9) << threads << std::fixed
+                       << std::setprecision(1) << std::setw(10)
+                       << (r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0)
+                       << std::setw(13) << p50 << std::setw(13) << p99 << std::setw(9) << r.commitsWAL
+                       << std::setw(12) << r.registrosPorCommit << std::setprecision(0) << std::setw(11)
+                       << r.bytesPorCliente << "\n";
+            }
+        }
+    }
+    std::cout << "\n" << tabela.str();
+    numClientes = clientesOriginal;
+}
+
+/*
+ * CUSTO DOS SNAPSHOTS:
+ * Mesma carga com o auditor desligado, a cada 10 ms e contínuo;
+ * a perda de vazão em relação ao desligado é o custo dos snapshots
+ * (o versionamento das contas é pago nos três casos)
+ */
+inline void SistemaBancario::executarBenchmarkAuditoria() {
+    std::vector<int> numThreads = {4, 16, 64};
+    std::vector<std::string> configuracoes = {"desligada", "10", "continua"};
+    int operacoesPorThread = 500;
+    ConfigAuditoria original = configAuditoria;
+
+    std::cout << "=== BENCHMARK DE AUDITORIA (SNAPSHOTS) ===" << std::endl;
+    struct Linha {
+        std::string motor;
+        int threads;
+        std::vector<double> vazao;
+        std::vector<int> snapshots;
+        int divergencias = 0;
+    };
+    std::vector<Linha> linhas;
+    for (MotorConta motor : motores) {
+        for (int threads : numThreads) {
+            Linha linha{"", threads, {}, {}, 0};
+            for (const std::string& texto : configuracoes) {
+                interpretarConfigAuditoria(texto, configAuditoria);
+                std::cout << "\n" << std::string(50, '=') << "\n";
+                std::cout << "AUDITORIA " << configAuditoria.descricao() << " COM " << threads
+                          << " THREADS\n";
+                std::cout << std::string(50, '=') << "\n";
+                ResultadoSimulacao r = executarSimulacao(motor, threads, operacoesPorThread);
+                linha.motor = r.motor;
+                linha.vazao.push_back(r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0);
+                linha.snapshots.push_back(r.snapshots);
+                linha.divergencias += r.divergencias;
+            }
+            linhas.push_back(linha);
+        }
+    }
+
+    std::cout << "\n=== CUSTO DOS SNAPSHOTS (ops/ms e perda de vazão) ===" << std::endl;
+    std::cout << std::setw(10) << "motor" << std::setw(8) << "threads";
+    for (const std::string& texto : configuracoes) std::cout << std::setw(12) << texto;
+    std::cout << std::setw(10) << "10ms" << std::setw(10) << "continua"
+              << std::setw(12) << "snapshots" << std::setw(14) << "divergências" << std::endl;
+    for (const Linha& l : linhas) {
+        std::cout << std::setw(10) << l.motor << std::setw(8) << l.threads
+                  << std::fixed << std::setprecision(2);
+        for (double v : l.vazao) std::cout << std::setw(12) << v;
+        for (size_t i = 1; i < l.vazao.size(); ++i) {
+            double perda = l.vazao[0] > 0 ? (1 - l.vazao[i] / l.vazao[0]) * 100 : 0;
+            std::cout << std::setw(9) << std::setprecision(1) << perda << "%";
+        }
+        std::cout << std::setw(12) << l.snapshots.back() << std::setw(14) << l.divergencias << std::endl;
+    }
+    configAuditoria = original;
+}
+
+/*
+ * BENCHMARK DE COMBINAÇÃO DE ESCRITAS:
+ * Carga de escrita concentrada (hotspot: 10% das contas com 90% dos
+ * acessos) no motor rwlock, comparando os três modos de combinação
+ * por número de threads. Com o modelo de serviço legado (sleeps) o
+ * custo do lock é irrelevante; use --servico=giro ou nenhum.
+ */
+inline void SistemaBancario::executarBenchmarkCombinacao() {
+    std::vector<int> numThreads = {1, 2, 4, 8, 16, 32, 64};
+    std::vector<ModoCombinacao> modos = {ModoCombinacao::DESLIGADA, ModoCombinacao::AUTO,
+                                         ModoCombinacao::SEMPRE};
+    int operacoesPorThread = 200;
+    MixOperacoes mixOriginal = mix;
+    ConfigCarga cargaOriginal = configCarga;
+    ModoCombinacao modoOriginal = modoCombinacao;
+    mix = MixOperacoes::escrita();
+    interpretarDistribuicao("hotspot:0.1:0.9", configCarga);
+
+    std::cout << "=== BENCHMARK DE COMBINAÇÃO DE ESCRITAS ===" << std::endl;
+    std::map<int, std::vector<double>> vazao;          // threads -> ops/ms por modo
+    for (ModoCombinacao modo : modos) {
+        modoCombinacao = modo;
+        for (int threads : numThreads) {
+            std::cout << "\n" << std::string(50, '=') << "\n";
+            std::cout << "COMBINAÇÃO " << nomeModoCombinacao(modo) << " COM " << threads << " THREADS\n";
+            std::cout << std::string(50, '=') << "\n";
+            ResultadoSimulacao r = executarSimulacao(MotorConta::RWLOCK, threads, operacoesPorThread);
+            vazao[threads].push_back(r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0);
+        }
+    }
+
+    std::cout << "\n=== VAZÃO EM CONTAS QUENTES (ops/ms) ===" << std::endl;
+    std::cout << std::setw(8) << "threads";
+    for (ModoCombinacao modo : modos) std::cout << std::setw(12) << nomeModoCombinacao(modo);
+    std::cout << std::setw(12) << "ganho auto" << std::endl;
+    for (const auto& [threads, valores] : vazao) {
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2);
+        for (double v : valores) std::cout << std::setw(12) << v;
+        double ganho = valores[0] > 0 ? (valores[1] / valores[0] - 1) * 100 : 0;
+        std::cout << std::setw(11) << std::setprecision(1) << ganho << "%" << std::endl;
+    }
+
+    mix = mixOriginal;
+    configCarga = cargaOriginal;
+    modoCombinacao = modoOriginal;
+}
+
+/*
+ * BENCHMARK DE SATURAÇÃO (CICLO ABERTO):
+ * Dobra a taxa de chegada a cada rodada com o mesmo número de workers.
+ * Enquanto o banco dá conta, a taxa obtida acompanha a alvo e a latência
+ * de resposta fica estável; depois do ponto de saturação a fila cresce
+ * e a latência dispara. A varredura para duas rodadas após saturar.
+ */
+inline void SistemaBancario::executarBenchmarkSaturacao(int numThreads) {
+    const double DURACAO_ALVO_S = 2.0;        // Duração planejada de cada rodada
+    const int MAXIMO_OPERACOES = 20000;
+    ConfigChegada original = chegada;
+    if (!chegada.aberto()) chegada.modo = ModoChegada::POISSON;
+
+    std::cout << "=== BENCHMARK DE SATURAÇÃO (" << numThreads << " workers) ===" << std::endl;
+
+    for (MotorConta motor : motores) {
+        std::vector<ResultadoSimulacao> resultados;
+        double ultimaSustentada = 0;
+        int rodadasSaturadas = 0;
+        for (double taxa = 50; rodadasSaturadas < 2; taxa *= 2) {
+            chegada.taxa = taxa;
+            int total = std::min(MAXIMO_OPERACOES,
+                                 std::max(numThreads * 5, static_cast<int>(taxa * DURACAO_ALVO_S)));
+            int porThread = (total + numThreads - 1) / numThreads;
+
+            std::cout << "\n" << std::string(50, '=') << "\n";
+            std::cout << "TAXA " << chegada.descricao() << " OPS/S\n";
+            std::cout << std::string(50, '=') << "\n";
+            ResultadoSimulacao r = executarSimulacao(motor, numThreads, porThread);
+            resultados.push_back(r);
+
+            if (r.taxaObtida >= 0.9 * r.taxaAlvo) {
+                ultimaSustentada = r.taxaAlvo;
+                rodadasSaturadas = 0;
+            } else {
+                rodadasSaturadas++;
+            }
+        }
+
+        std::cout << "\n=== SATURAÇÃO: " << resultados.front().motor << " ===" << std::endl;
+        std::cout << std::setw(12) << "alvo" << std::setw(12) << "obtida"
+                  << std::setw(14) << "p50 (us)" << std::setw(14) << "p99 (us)" << std::endl;
+        for (const auto& r : resultados) {
+            std::cout << std::fixed << std::setprecision(1) << std::setw(12) << r.taxaAlvo
+                      << std::setw(12) << r.taxaObtida << std::setw(14) << r.respostaP50Us
+                      << std::setw(14) << r.respostaP99Us << std::endl;
+        }
+        std::cout << "Maior taxa sustentada: " << ultimaSustentada << " ops/s" << std::endl;
+    }
+    chegada = original;
+}
+
+/*
+ * BENCHMARK DE COERÊNCIA DE CACHE:
+ * Nenhum dado é logicamente compartilhado entre as threads; a queda
+ * de vazão com mais threads é o custo do tráfego de coerência.
+ * 1. Contadores: cada thread soma (a) num atomic único, (b) no seu
+ *    próprio atomic de um vetor contíguo (false sharing) e (c) num
+ *    ContadorDistribuido (uma linha por fatia)
+ * 2. Contas: cada thread credita na sua própria conta, com as contas
+ *    em cada arranjo de memória (heap, compacto, alinhado)
+ * Mede só o motor: roda com log desligado e serviço "nenhum".
+ */
+inline void SistemaBancario::executarBenchmarkCoerencia() {
+    std::vector<unsigned> numThreads = {1, 2, 4, 8, 16};
+    const long long incrementos = 2000000;
+    const long long creditos = 200000;
+
+    LoggerOperacoes::instancia().configurarNivel(NivelLog::NENHUM);
+    ModeloServico::instancia().configurar("nenhum");
+    std::cout << "=== BENCHMARK DE COERÊNCIA DE CACHE ===" << std::endl;
+    std::cout << "Threads de hardware: " << threadsDisponiveis()
+              << " (com menos núcleos do que threads não há disputa de linha)" << std::endl;
+
+    // Milhões de operações por segundo, somando todas as threads
+    auto medir = [](unsigned threads, long long porThread, auto&& corpo) {
+        auto inicio = std::chrono::steady_clock::now();
+        executarEmParalelo(threads, corpo);
+        double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - inicio).count();
+        return s > 0 ? threads * porThread / s / 1e6 : 0;
+    };
+
+    std::cout << "\n=== CONTADORES (Mops/s) ===" << std::endl;
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "atomic único"
+              << std::setw(14) << "vizinhos" << std::setw(14) << "distribuído" << std::endl;
+    for (unsigned threads : numThreads) {
+        std::atomic<long long> unico{0};
+        auto vizinhos = std::make_unique<std::atomic<long long>[]>(threads);
+        auto distribuido = std::make_unique<ContadorDistribuido>();
+        double a = medir(threads, incrementos, [&](unsigned) {
+            for (long long i = 0; i < incrementos; ++i) unico.fetch_add(1, std::memory_order_relaxed);
+        });
+        double b = medir(threads, incrementos, [&](unsigned t) {
+            for (long long i = 0; i < incrementos; ++i) vizinhos[t].fetch_add(1, std::memory_order_relaxed);
+        });
+        double c = medir(threads, incrementos, [&](unsigned) {
+            for (long long i = 0; i < incrementos; ++i) distribuido->adicionar();
+        });
+        if (unico.load() != distribuido->total()) std::cerr << "Contagem divergente!" << std::endl;
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(1)
+                  << std::setw(14) << a << std::setw(14) << b << std::setw(14) << c << std::endl;
+    }
+
+    std::vector<ArranjoContas> arranjos = {ArranjoContas::HEAP, ArranjoContas::COMPACTO,
+                                           ArranjoContas::ALINHADO};
+    std::vector<ContaLida> lidas;
+    char id[16];
+    for (unsigned i = 0; i < numThreads.back(); ++i) {
+        std::snprintf(id, sizeof(id), "C%03u", i);
+        lidas.push_back({id, 1000.0});
+    }
+
+    for (MotorConta motor : {MotorConta::RWLOCK, MotorConta::ATOMICO}) {
+        despacharMotor(motor, [&](auto tipo) {
+            using Conta = typename decltype(tipo)::tipo;
+            std::cout << "\n=== CONTAS " << Conta::nomeMotor() << " (Mops/s, " << sizeof(Conta)
+                      << " bytes por conta) ===" << std::endl;
+            std::cout << std::setw(8) << "threads";
+            for (ArranjoContas arranjo : arranjos) std::cout << std::setw(12) << nomeArranjo(arranjo);
+            std::cout << std::endl;
+
+            std::vector<std::unique_ptr<Banco<Conta>>> bancos;
+            std::vector<std::vector<Conta*>> porArranjo;
+            for (ArranjoContas arranjo : arranjos) {
+                bancos.push_back(std::make_unique<Banco<Conta>>());
+                bancos.back()->configurarArranjo(arranjo);
+                bancos.back()->adicionarContas(lidas);
+                std::vector<Conta*> contas;
+                for (const ContaLida& c : lidas) contas.push_back(bancos.back()->obterConta(c.id));
+                porArranjo.push_back(contas);
+            }
+            for (unsigned threads : numThreads) {
+                std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2);
+                for (const auto& contas : porArranjo) {
+                    double v = medir(threads, creditos, [&](unsigned t) {
+                        for (long long i = 0; i < creditos; ++i) contas[t]->creditar(0.01);
+                    });
+                    std::cout << std::setw(12) << v;
+                }
+                std::cout << std::endl;
+            }
+            return 0;
+        });
+    }
+}
+
+/*
+ * BENCHMARK DE CARGA:
+ * Gera um livro de contas sintético com numContas contas nos dois
+ * formatos e compara o tempo de carga por milhão de contas
+ */
+inline void SistemaBancario::executarBenchmarkCarga(size_t numContas) {
+    std::cout << "=== BENCHMARK DE CARGA (" << numContas << " contas) ===" << std::endl;
+    const std::string arquivoTexto = "contas_bench.txt";
+    const std::string arquivoBinario = "contas_bench.bin";
+
+    std::vector<ContaLida> contas(numContas);
+    std::mt19937 gerador(42);
+    std::uniform_int_distribution<long long> centavosDist(0, 5000000);
+    char id[24];
+    for (size_t i = 0; i < numContas; ++i) {
+        std::snprintf(id, sizeof(id), "%010zu", i + 1);
+        contas[i] = {id, centavosDist(gerador) / 100.0};
+    }
+    if (!ArmazenamentoContas::gravarAtomicamente(arquivoTexto, ArmazenamentoContas::serializarTexto(contas)) ||
+        !ArmazenamentoContas::gravarAtomicamente(arquivoBinario, ArmazenamentoContas::serializarBinario(contas))) {
+        std::cerr << "Erro ao gerar arquivos do benchmark de carga" << std::endl;
+        return;
+    }
+    contas.clear();
+    contas.shrink_to_fit();
+
+    double milhoes = numContas / 1e6;
+    unsigned numThreads = threadsDisponiveis();
+    auto medir = [&](const std::string& descricao, auto&& funcao) {
+        auto inicio = std::chrono::steady_clock::now();
+        size_t carregadas = funcao();
+        double ms = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - inicio).count();
+        std::cout << std::left << std::setw(44) << descricao << std::right
+                  << std::fixed << std::setprecision(1) << std::setw(10) << ms << " ms  "
+                  << std::setw(10) << (milhoes > 0 ? ms / milhoes : 0) << " ms/milhão  ("
+                  << carregadas << " contas)" << std::endl;
+    };
+
+    medir("texto getline+stringstream (1 thread)", [&] {
+        std::ifstream file(arquivoTexto);
+        std::string linha;
+        size_t n = 0;
+        while (std::getline(file, linha)) {
+            std::stringstream ss(linha);
+            std::string idLido;
+            double saldo;
+            if (std::getline(ss, idLido, '|') && ss >> saldo) ++n;
+        }
+        return n;
+    });
+    medir("texto mmap+from_chars (1 thread)", [&] {
+        ArquivoMapeado mapa(arquivoTexto);
+        return ArmazenamentoContas::lerTexto(mapa.data(), mapa.size(), 1).size();
+    });
+    medir("texto mmap+from_chars (" + std::to_string(numThreads) + " threads)", [&] {
+        ArquivoMapeado mapa(arquivoTexto);
+        return ArmazenamentoContas::lerTexto(mapa.data(), mapa.size(), numThreads).size();
+    });
+    medir("binário mmap+checksum (" + std::to_string(numThreads) + " threads)", [&] {
+        ArquivoMapeado mapa(arquivoBinario);
+        return ArmazenamentoContas::lerBinario(mapa.data(), mapa.size(), numThreads).size();
+    });
+
+    for (const std::string& arquivo : {arquivoTexto, arquivoBinario}) {
+        Banco<ContaCorrenteAtomica> banco;
+        ConfigWAL semWAL;
+        semWAL.ativo = false;
+        banco.configurarWAL(semWAL);
+        banco.carregarContas(arquivo);
+        std::cout << "Banco completo a partir de " << arquivo << ": leitura "
+                  << std::fixed << std::setprecision(1) << banco.getTempoLeituraMs() << " ms, total "
+                  << banco.getTempoCargaMs() << " ms ("
+                  << (milhoes > 0 ? banco.getTempoCargaMs() / milhoes : 0) << " ms/milhão)" << std::endl;
+    }
+
+    std::remove(arquivoTexto.c_str());
+    std::remove(arquivoBinario.c_str());
+}
+
+#endif  // BANCO_BENCHMARKS_HPP
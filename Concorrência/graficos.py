@@ -3,11 +3,30 @@ import seaborn as sns
 import matplotlib.pyplot as plt
 from matplotlib.ticker import MaxNLocator
 import numpy as np
+import os
 
 # Definição dos nomes das colunas esperadas
 colunas = [
     'NumThreads', 'OperacoesPorThread', 'TotalOperacoes', 'TempoExecucao_ms',
-    'OperacoesSucesso', 'OperacoesFalhas', 'TaxaSucesso', 'Throughput_ops_ms', 'Timestamp'
+    'OperacoesSucesso', 'OperacoesFalhas', 'TaxaSucesso', 'Throughput_ops_ms', 'Timestamp',
+    'Motor', 'Mix', 'Transferencias', 'TransferenciasAbortadas', 'Lotes', 'LotesAbortados',
+    'EsperaLock_ms', 'WAL', 'CommitsWAL', 'RegistrosPorCommit', 'LatenciaP99_us',
+    'UtilizacaoMin', 'UtilizacaoMedia', 'UtilizacaoMax', 'TarefasRoubadas', 'UtilizacaoPorWorker',
+    'Distribuicao', 'Semente',
+    'LatenciaP50_us', 'LatenciaP90_us', 'LatenciaP999_us', 'LatenciaMax_us',
+    'P99Credito_us', 'P99Debito_us', 'P99Consulta_us', 'P99Transferencia_us',
+    'P99Lote_us', 'P99Falha_us',
+    'Chegada', 'TaxaAlvo_ops_s', 'TaxaObtida_ops_s',
+    'RespostaP50_us', 'RespostaP99_us', 'RespostaP999_us', 'RespostaMax_us',
+    'Servico', 'Admissao', 'RejeicoesFila', 'RejeicoesTempo', 'EsperaFila_ms', 'FilaP99_us',
+    'Combinacao', 'ContasCombinando', 'LotesCombinados', 'PedidosPorLote',
+    'Auditoria', 'Snapshots', 'Divergencias', 'SnapshotMedio_us',
+    'Arranjo', 'Trava',
+    'Checkpoint', 'Checkpoints', 'RegistrosCheckpoint', 'BytesCheckpoint',
+    'CheckpointP50_ms', 'CheckpointMax_ms',
+    'Clientes', 'BytesPorCliente',
+    'Massa', 'PassadasMassa', 'PassadaMedia_ms', 'DivergenciasMassa',
+    'Aberturas', 'Encerramentos'
 ]
 
 # Função para carregar o CSV, tentando com e sem cabeçalho
@@ -57,4 +76,211 @@ plt.gca().set_yticks(ticks_y)
 
 plt.legend()
 plt.tight_layout()
+
+# Comparação de throughput entre os motores de contas (rwlock x atomico)
+if 'Motor' in df.columns:
+    plt.figure(figsize=(10, 6))
+    sns.lineplot(data=df, x='NumThreads', y='Throughput_ops_ms', hue='Motor', marker='o')
+    plt.xscale('log', base=2)
+    plt.xticks(sorted(df['NumThreads'].unique()), sorted(df['NumThreads'].unique()))
+    plt.xlabel('Número de Threads')
+    plt.ylabel('Throughput (ops/ms)')
+    plt.title('Throughput por Motor de Contas')
+    plt.tight_layout()
+
+# Efeito do group commit do WAL: ops/ms e latência p99 por número de threads
+if 'WAL' in df.columns and df['WAL'].nunique() > 1:
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.lineplot(data=df, x='NumThreads', y='Throughput_ops_ms', hue='WAL', marker='o', ax=ax1)
+    sns.lineplot(data=df, x='NumThreads', y='LatenciaP99_us', hue='WAL', marker='o', ax=ax2)
+    ax1.set_title('Throughput por Configuração do WAL')
+    ax2.set_title('Latência p99 por Configuração do WAL')
+    ax1.set_xlabel('Número de Threads')
+    ax2.set_xlabel('Número de Threads')
+    ax1.set_ylabel('Throughput (ops/ms)')
+    ax2.set_ylabel('Latência p99 (us)')
+    plt.tight_layout()
+
+# Balanceamento do pool de trabalho: faixa de utilização dos workers
+if 'UtilizacaoMedia' in df.columns and df['UtilizacaoMedia'].notna().any():
+    util = df.dropna(subset=['UtilizacaoMedia']).groupby('NumThreads')[
+        ['UtilizacaoMin', 'UtilizacaoMedia', 'UtilizacaoMax']].mean() * 100
+    plt.figure(figsize=(10, 6))
+    plt.plot(util.index, util['UtilizacaoMedia'], marker='o', label='Média')
+    plt.fill_between(util.index, util['UtilizacaoMin'], util['UtilizacaoMax'],
+                     alpha=0.3, label='Mínimo–máximo')
+    plt.xscale('log', base=2)
+    plt.xticks(util.index, util.index)
+    plt.xlabel('Número de Threads (workers)')
+    plt.ylabel('Utilização (%)')
+    plt.title('Utilização dos Workers do Pool')
+    plt.legend()
+    plt.tight_layout()
+
+# Cauda da latência por número de threads (percentis dos histogramas)
+if 'LatenciaP50_us' in df.columns and df['LatenciaP50_us'].notna().any():
+    percentis = {'p50': 'LatenciaP50_us', 'p90': 'LatenciaP90_us', 'p99': 'LatenciaP99_us',
+                 'p99.9': 'LatenciaP999_us', 'máx': 'LatenciaMax_us'}
+    motores = df['Motor'].dropna().unique() if 'Motor' in df.columns else [None]
+    fig, eixos = plt.subplots(1, len(motores), figsize=(7 * len(motores), 6), squeeze=False)
+    for ax, motor in zip(eixos[0], motores):
+        dados = df if motor is None else df[df['Motor'] == motor]
+        dados = dados.groupby('NumThreads')[list(percentis.values())].mean() / 1000
+        for nome, coluna in percentis.items():
+            ax.plot(dados.index, dados[coluna], marker='o', label=nome)
+        ax.set_xscale('log', base=2)
+        ax.set_yscale('log')
+        ax.set_xticks(dados.index)
+        ax.set_xticklabels(dados.index)
+        ax.set_xlabel('Número de Threads')
+        ax.set_ylabel('Latência (ms)')
+        ax.set_title('Cauda da Latência' + (f' ({motor})' if motor is not None else ''))
+        ax.legend()
+    plt.tight_layout()
+
+# Curva de saturação (ciclo aberto): taxa obtida e latência de resposta por taxa alvo
+if 'TaxaAlvo_ops_s' in df.columns and (df['TaxaAlvo_ops_s'] > 0).any():
+    aberto = df[df['TaxaAlvo_ops_s'] > 0]
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.lineplot(data=aberto, x='TaxaAlvo_ops_s', y='TaxaObtida_ops_s', hue='Motor', marker='o', ax=ax1)
+    limite = aberto['TaxaAlvo_ops_s'].max()
+    ax1.plot([0, limite], [0, limite], linestyle='--', color='gray', label='ideal')
+    sns.lineplot(data=aberto, x='TaxaAlvo_ops_s', y='RespostaP99_us', hue='Motor', marker='o', ax=ax2)
+    for ax in (ax1, ax2):
+        ax.set_xscale('log', base=2)
+        ax.set_xlabel('Taxa alvo (ops/s)')
+    ax2.set_yscale('log')
+    ax1.set_ylabel('Taxa obtida (ops/s)')
+    ax2.set_ylabel('Latência de resposta p99 (us)')
+    ax1.set_title('Vazão x Taxa de Chegada')
+    ax2.set_title('Latência desde o Instante Planejado')
+    ax1.legend()
+    plt.tight_layout()
+
+# Controle de admissão: recusas por carga (separadas das falhas de negócio)
+if 'RejeicoesTempo' in df.columns and (df[['RejeicoesFila', 'RejeicoesTempo']].fillna(0).sum(axis=1) > 0).any():
+    recusas = df.copy()
+    recusas['Recusas'] = recusas['RejeicoesFila'].fillna(0) + recusas['RejeicoesTempo'].fillna(0)
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.lineplot(data=recusas, x='NumThreads', y='Recusas', hue='Motor', marker='o', ax=ax1, label='Recusas')
+    sns.lineplot(data=recusas, x='NumThreads', y='OperacoesFalhas', hue='Motor', marker='x',
+                 linestyle='--', ax=ax1)
+    sns.lineplot(data=recusas, x='NumThreads', y='FilaP99_us', hue='Motor', marker='o', ax=ax2)
+    ax1.set_title('Recusas da Admissão x Falhas de Negócio')
+    ax2.set_title('Espera na Fila de Admissão (p99)')
+    ax1.set_xlabel('Número de Threads')
+    ax2.set_xlabel('Número de Threads')
+    ax1.set_ylabel('Operações')
+    ax2.set_ylabel('Espera p99 (us)')
+    plt.tight_layout()
+
+# Combinação de escritas (flat combining): vazão por modo no motor rwlock
+if 'Combinacao' in df.columns and df['Combinacao'].dropna().nunique() > 1:
+    rwlock = df[df['Combinacao'] != 'n/a']
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.lineplot(data=rwlock, x='NumThreads', y='Throughput_ops_ms', hue='Combinacao', marker='o', ax=ax1)
+    sns.lineplot(data=rwlock, x='NumThreads', y='PedidosPorLote', hue='Combinacao', marker='o', ax=ax2)
+    for ax in (ax1, ax2):
+        ax.set_xscale('log', base=2)
+        ax.set_xlabel('Número de Threads')
+    ax1.set_ylabel('Throughput (ops/ms)')
+    ax2.set_ylabel('Escritas por seção crítica')
+    ax1.set_title('Throughput por Modo de Combinação')
+    ax2.set_title('Tamanho Médio dos Lotes Combinados')
+    plt.tight_layout()
+
+# Custo dos snapshots: vazão por intervalo do auditor, para cada motor
+if 'Auditoria' in df.columns and df['Auditoria'].dropna().nunique() > 1:
+    motores = df['Motor'].dropna().unique()
+    fig, eixos = plt.subplots(1, len(motores), figsize=(7 * len(motores), 6), squeeze=False)
+    for ax, motor in zip(eixos[0], motores):
+        dados = df[df['Motor'] == motor]
+        sns.barplot(data=dados, x='NumThreads', y='Throughput_ops_ms', hue='Auditoria', ax=ax)
+        ax.set_xlabel('Número de Threads')
+        ax.set_ylabel('Throughput (ops/ms)')
+        ax.set_title(f'Custo dos Snapshots ({motor})')
+    plt.tight_layout()
+
+# Arranjo das contas na memória: vazão por layout, para cada motor
+if 'Arranjo' in df.columns and df['Arranjo'].dropna().nunique() > 1:
+    plt.figure(figsize=(10, 6))
+    sns.lineplot(data=df, x='NumThreads', y='Throughput_ops_ms', hue='Arranjo', style='Motor', marker='o')
+    plt.xscale('log', base=2)
+    plt.xticks(sorted(df['NumThreads'].unique()), sorted(df['NumThreads'].unique()))
+    plt.xlabel('Número de Threads')
+    plt.ylabel('Throughput (ops/ms)')
+    plt.title('Throughput por Arranjo das Contas')
+    plt.tight_layout()
+
+# Checkpoint em segundo plano: cauda das operações e bytes gravados por modo
+if 'Checkpoint' in df.columns and df['Checkpoint'].dropna().nunique() > 1:
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.barplot(data=df, x='NumThreads', y='LatenciaP99_us', hue='Checkpoint', ax=ax1)
+    sns.barplot(data=df, x='NumThreads', y='BytesCheckpoint', hue='Checkpoint', ax=ax2)
+    for ax in (ax1, ax2):
+        ax.set_xlabel('Número de Threads')
+    ax1.set_ylabel('Latência p99 (us)')
+    ax2.set_ylabel('Bytes gravados')
+    ax1.set_title('Latência p99 por Modo de Checkpoint')
+    ax2.set_title('Bytes Gravados pelos Checkpoints')
+    plt.tight_layout()
+
+# Operações em massa concorrentes: quanto cada trabalho atrasa as operações online
+if 'Massa' in df.columns and df['Massa'].dropna().nunique() > 1:
+    fig, (ax1, ax2) = plt.subplots(1, 2, figsize=(14, 6))
+    sns.barplot(data=df, x='NumThreads', y='Throughput_ops_ms', hue='Massa', ax=ax1)
+    sns.barplot(data=df, x='NumThreads', y='LatenciaP99_us', hue='Massa', ax=ax2)
+    for ax in (ax1, ax2):
+        ax.set_xlabel('Número de Threads')
+    ax1.set_ylabel('Throughput (ops/ms)')
+    ax2.set_ylabel('Latência p99 (us)')
+    ax1.set_title('Throughput com Trabalho em Massa')
+    ax2.set_title('Latência p99 com Trabalho em Massa')
+    plt.tight_layout()
+
+# Varredura de parâmetros: uma linha por rodada, IC de 95% calculado pelo seaborn
+if os.path.exists('varredura.csv'):
+    varredura = pd.read_csv('varredura.csv')
+    grade = sns.relplot(data=varredura, x='Threads', y='Throughput_ops_ms', hue='Motor', style='Mix',
+                        col='Distribuicao', row='Contas', kind='line', marker='o',
+                        errorbar=('ci', 95), facet_kws={'sharey': False})
+    grade.set(xscale='log')
+    grade.set_axis_labels('Número de Threads', 'Throughput (ops/ms)')
+    grade.figure.suptitle('Varredura de Parâmetros (média e IC de 95%)', y=1.02)
+
+# Perfil das travas: espera por conta (as mais disputadas) x número de threads, um mapa por motor
+if os.path.exists('perfil_travas.csv'):
+    perfil = pd.read_csv('perfil_travas.csv', dtype={'Conta': str})
+    if not perfil.empty:
+        espera = perfil.groupby(['Motor', 'Conta', 'Threads'], as_index=False)['Espera_ms'].sum()
+        motores = sorted(espera['Motor'].unique())
+        fig, eixos = plt.subplots(1, len(motores), figsize=(7 * len(motores), 8), squeeze=False)
+        for ax, motor in zip(eixos[0], motores):
+            dados = espera[espera['Motor'] == motor]
+            contas = dados.groupby('Conta')['Espera_ms'].sum().nlargest(20).index
+            mapa = dados[dados['Conta'].isin(contas)].pivot(index='Conta', columns='Threads', values='Espera_ms')
+            mapa = mapa.reindex(contas).fillna(0)
+            sns.heatmap(mapa, cmap='rocket_r', annot=len(contas) <= 10, fmt='.1f', ax=ax,
+                        cbar_kws={'label': 'Espera pela trava (ms)'})
+            ax.set_xlabel('Número de Threads')
+            ax.set_ylabel('Conta')
+            ax.set_title(f'Espera por Conta ({motor})')
+        plt.tight_layout()
+
+# Telemetria: vazão e p99 ao longo de cada simulação (aquecimento, colapsos, oscilações)
+if os.path.exists('telemetria.csv'):
+    telemetria = pd.read_csv('telemetria.csv')
+    if not telemetria.empty:
+        grade = sns.relplot(data=telemetria, x='Instante_ms', y='Throughput_ops_ms', hue='Threads',
+                            units='Simulacao', estimator=None, col='Motor', kind='line',
+                            palette='viridis', facet_kws={'sharey': False})
+        grade.set_axis_labels('Tempo desde o início (ms)', 'Throughput no intervalo (ops/ms)')
+        grade.figure.suptitle('Vazão ao Longo da Simulação', y=1.02)
+        grade = sns.relplot(data=telemetria, x='Instante_ms', y='LatenciaP99_us', hue='Threads',
+                            units='Simulacao', estimator=None, col='Motor', kind='line',
+                            palette='viridis', facet_kws={'sharey': False})
+        grade.set(yscale='log')
+        grade.set_axis_labels('Tempo desde o início (ms)', 'Latência p99 no intervalo (us)')
+        grade.figure.suptitle('Cauda da Latência ao Longo da Simulação', y=1.02)
+
 plt.show()
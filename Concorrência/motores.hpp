@@ -0,0 +1,1169 @@
+/*
+ * MOTORES DE CONTA
+ * Políticas de trava, perfil de disputa, ContaCorrente (trava plugável)
+ * e ContaCorrenteAtomica (CAS)
+ */
+#ifndef BANCO_MOTORES_HPP
+#define BANCO_MOTORES_HPP
+
+#include "suporte.hpp"
+
+// ===================================
+// Políticas de trava das contas
+// ===================================
+/*
+ * POLÍTICAS DE TRAVA (LOCKS):
+ * ContaComTrava<Trava> é especializada em tempo de compilação para cada
+ * política, então não há despacho virtual no caminho quente. Toda
+ * política tem lock/try_lock/unlock (escritas) e lock_shared/
+ * try_lock_shared/unlock_shared (consultas), que nas exclusivas
+ * simplesmente travam; as otimistas
+ * oferecem ainda lerOtimista, usada no lugar de lock_shared.
+ * - TravaLeituraEscrita: std::shared_mutex (motor "rwlock" original)
+ * - TravaMutex: std::mutex (consultas também exclusivas)
+ * - TravaTTAS: test-and-test-and-set; gira lendo até a trava parecer livre
+ * - TravaTicket: senhas atendidas em ordem de chegada (justa)
+ * - TravaMCS: fila de nós; cada thread gira na sua própria linha de cache
+ * - TravaSeq: seqlock; escritores exclusivos e leitores otimistas, que
+ *   não escrevem na memória compartilhada e repetem se um escritor passou
+ * - TravaLeituraEscritaGiro: leitores e escritor numa palavra atômica,
+ *   com preferência para o escritor que está esperando
+ */
+
+/*
+ * ESPERA ATIVA:
+ * Algumas voltas com a instrução de pausa da CPU e, depois, cede o
+ * processador: com mais threads do que núcleos o dono da trava pode
+ * estar fora da CPU, e continuar girando só o atrasaria
+ */
+inline void esperarGiro(unsigned& voltas) {
+    if (++voltas < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+        __builtin_ia32_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    } else {
+        std::this_thread::yield();
+    }
+}
+
+class TravaLeituraEscrita {
+private:
+    std::shared_mutex mutex;
+
+public:
+    static constexpr const char* NOME = "rwlock";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() { mutex.lock(); }
+    bool try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { mutex.lock_shared(); }
+    bool try_lock_shared() { return mutex.try_lock_shared(); }
+    void unlock_shared() { mutex.unlock_shared(); }
+};
+
+class TravaMutex {
+private:
+    std::mutex mutex;
+
+public:
+    static constexpr const char* NOME = "mutex";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() { mutex.lock(); }
+    bool try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+    void lock_shared() { lock(); }
+    bool try_lock_shared() { return try_lock(); }
+    void unlock_shared() { unlock(); }
+};
+
+class TravaTTAS {
+private:
+    std::atomic<bool> ocupada{false};
+
+public:
+    static constexpr const char* NOME = "ttas";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() {
+        unsigned voltas = 0;
+        while (ocupada.exchange(true, std::memory_order_acquire)) {
+            // Só lê enquanto ocupada: a linha fica compartilhada nos caches
+            while (ocupada.load(std::memory_order_relaxed)) esperarGiro(voltas);
+        }
+    }
+    bool try_lock() {
+        return !ocupada.load(std::memory_order_relaxed) &&
+               !ocupada.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() { ocupada.store(false, std::memory_order_release); }
+    void lock_shared() { lock(); }
+    bool try_lock_shared() { return try_lock(); }
+    void unlock_shared() { unlock(); }
+};
+
+class TravaTicket {
+private:
+    std::atomic<uint32_t> proxima{0};       // Próxima senha a ser entregue
+    std::atomic<uint32_t> atendida{0};      // Senha que tem a trava
+
+public:
+    static constexpr const char* NOME = "ticket";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() {
+        uint32_t senha = proxima.fetch_add(1, std::memory_order_relaxed);
+        unsigned voltas = 0;
+        while (atendida.load(std::memory_order_acquire) != senha) esperarGiro(voltas);
+    }
+    // Só pega a trava se ninguém está com ela nem na fila
+    bool try_lock() {
+        uint32_t senha = atendida.load(std::memory_order_acquire);
+        return proxima.compare_exchange_strong(senha, senha + 1, std::memory_order_acquire,
+                                               std::memory_order_relaxed);
+    }
+    void unlock() {
+        atendida.store(atendida.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    void lock_shared() { lock(); }
+    bool try_lock_shared() { return try_lock(); }
+    void unlock_shared() { unlock(); }
+};
+
+class TravaMCS {
+private:
+    struct alignas(TAMANHO_LINHA_CACHE) No {
+        std::atomic<No*> proximo{nullptr};
+        std::atomic<bool> esperando{false};
+    };
+
+    /*
+     * NÓS DA THREAD:
+     * Uma thread pode ter várias travas MCS ao mesmo tempo (transferências
+     * e lotes), então cada aquisição usa um nó da lista de livres da
+     * thread. Depois do unlock nenhuma outra thread toca mais no nó.
+     */
+    struct NosDaThread {
+        std::vector<std::unique_ptr<No>> todos;
+        std::vector<No*> livres;
+    };
+    static NosDaThread& nosDaThread() {
+        thread_local NosDaThread nos;
+        return nos;
+    }
+    static No* obterNo() {
+        NosDaThread& nos = nosDaThread();
+        No* no;
+        if (nos.livres.empty()) {
+            nos.todos.push_back(std::make_unique<No>());
+            no = nos.todos.back().get();
+        } else {
+            no = nos.livres.back();
+            nos.livres.pop_back();
+        }
+        no->proximo.store(nullptr, std::memory_order_relaxed);
+        no->esperando.store(true, std::memory_order_relaxed);
+        return no;
+    }
+    static void devolverNo(No* no) { nosDaThread().livres.push_back(no); }
+
+    std::atomic<No*> cauda{nullptr};
+    No* dono = nullptr;                     // Nó de quem tem a trava (protegido por ela)
+
+public:
+    static constexpr const char* NOME = "mcs";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() {
+        No* no = obterNo();
+        No* anterior = cauda.exchange(no, std::memory_order_acq_rel);
+        if (anterior) {
+            anterior->proximo.store(no, std::memory_order_release);
+            unsigned voltas = 0;
+            while (no->esperando.load(std::memory_order_acquire)) esperarGiro(voltas);
+        }
+        dono = no;
+    }
+    bool try_lock() {
+        No* no = obterNo();
+        No* vazia = nullptr;
+        if (cauda.compare_exchange_strong(vazia, no, std::memory_order_acq_rel,
+                                          std::memory_order_relaxed)) {
+            dono = no;
+            return true;
+        }
+        devolverNo(no);
+        return false;
+    }
+    void unlock() {
+        No* no = dono;
+        No* sucessor = no->proximo.load(std::memory_order_acquire);
+        if (!sucessor) {
+            No* esperado = no;
+            if (cauda.compare_exchange_strong(esperado, nullptr, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed)) {
+                devolverNo(no);
+                return;
+            }
+            // Alguém entrou na fila mas ainda não se ligou a este nó
+            unsigned voltas = 0;
+            while (!(sucessor = no->proximo.load(std::memory_order_acquire))) esperarGiro(voltas);
+        }
+        sucessor->esperando.store(false, std::memory_order_release);
+        devolverNo(no);
+    }
+    void lock_shared() { lock(); }
+    bool try_lock_shared() { return try_lock(); }
+    void unlock_shared() { unlock(); }
+};
+
+class TravaSeq {
+private:
+    std::atomic<uint64_t> sequencia{0};     // Ímpar = escritor dentro
+
+public:
+    static constexpr const char* NOME = "seqlock";
+    static constexpr bool LEITURA_OTIMISTA = true;
+
+    void lock() {
+        unsigned voltas = 0;
+        while (!try_lock()) esperarGiro(voltas);
+    }
+    bool try_lock() {
+        uint64_t atual = sequencia.load(std::memory_order_relaxed);
+        if ((atual & 1) || !sequencia.compare_exchange_strong(atual, atual + 1, std::memory_order_acquire,
+                                                              std::memory_order_relaxed)) {
+            return false;
+        }
+        // O número ímpar fica visível antes de qualquer escrita protegida
+        std::atomic_thread_fence(std::memory_order_release);
+        return true;
+    }
+    void unlock() {
+        sequencia.store(sequencia.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    void lock_shared() { lock(); }
+    bool try_lock_shared() { return try_lock(); }
+    void unlock_shared() { unlock(); }
+
+    /*
+     * LEITURA OTIMISTA:
+     * Os dados protegidos devem ser atômicos (lidos com relaxed); a leitura
+     * vale se a sequência era par e não mudou até o fim
+     */
+    template <typename Leitura>
+    auto lerOtimista(Leitura&& leitura) const {
+        unsigned voltas = 0;
+        while (true) {
+            uint64_t antes = sequencia.load(std::memory_order_acquire);
+            if (!(antes & 1)) {
+                auto valor = leitura();
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequencia.load(std::memory_order_relaxed) == antes) return valor;
+            }
+            esperarGiro(voltas);
+        }
+    }
+};
+
+class TravaLeituraEscritaGiro {
+private:
+    static constexpr uint32_t ESCRITOR = 1u << 31;             // Escritor dentro
+    static constexpr uint32_t ESCRITOR_ESPERANDO = 1u << 30;   // Barra novos leitores
+    std::atomic<uint32_t> estado{0};                            // Bits baixos: leitores
+
+public:
+    static constexpr const char* NOME = "rwgiro";
+    static constexpr bool LEITURA_OTIMISTA = false;
+
+    void lock() {
+        unsigned voltas = 0;
+        while (true) {
+            uint32_t atual = estado.load(std::memory_order_relaxed);
+            if ((atual & ~ESCRITOR_ESPERANDO) == 0) {
+                if (estado.compare_exchange_weak(atual, ESCRITOR, std::memory_order_acquire,
+                                                 std::memory_order_relaxed)) return;
+            } else if (!(atual & ESCRITOR_ESPERANDO)) {
+                estado.compare_exchange_weak(atual, atual | ESCRITOR_ESPERANDO, std::memory_order_relaxed);
+            }
+            esperarGiro(voltas);
+        }
+    }
+    bool try_lock() {
+        uint32_t atual = estado.load(std::memory_order_relaxed);
+        return (atual & ~ESCRITOR_ESPERANDO) == 0 &&
+               estado.compare_exchange_strong(atual, ESCRITOR, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+    // Mantém o aviso de outro escritor que chegou enquanto este estava dentro
+    void unlock() { estado.fetch_and(~ESCRITOR, std::memory_order_release); }
+    void lock_shared() {
+        unsigned voltas = 0;
+        while (true) {
+            uint32_t atual = estado.load(std::memory_order_relaxed);
+            if (!(atual & (ESCRITOR | ESCRITOR_ESPERANDO)) &&
+                estado.compare_exchange_weak(atual, atual + 1, std::memory_order_acquire,
+                                             std::memory_order_relaxed)) return;
+            esperarGiro(voltas);
+        }
+    }
+    bool try_lock_shared() {
+        uint32_t atual = estado.load(std::memory_order_relaxed);
+        return !(atual & (ESCRITOR | ESCRITOR_ESPERANDO)) &&
+               estado.compare_exchange_strong(atual, atual + 1, std::memory_order_acquire,
+                                              std::memory_order_relaxed);
+    }
+    void unlock_shared() { estado.fetch_sub(1, std::memory_order_release); }
+};
+
+// ===================================
+// Perfil de disputa das travas
+// ===================================
+/*
+ * PERFIL DAS TRAVAS POR CONTA (opcional, --perfil-travas):
+ * - Cada aquisição da trava de uma conta registra a espera até conseguir,
+ *   o tempo de posse e se houve disputa (a tentativa sem espera falhou),
+ *   separados entre modo compartilhado (consultas) e exclusivo (escritas,
+ *   transferências, lotes e o combinador)
+ * - Cada thread acumula num buffer só seu (índice da conta -> contadores),
+ *   sem atomics nem locks no caminho quente; juntar() soma os buffers
+ *   com as threads paradas, ao fim da rodada
+ * - Desligado, cada aquisição só lê uma flag: nem o relógio é consultado
+ * Leituras otimistas (seqlock) e escritas aplicadas por outro combinador
+ * não adquirem a trava e não aparecem no perfil.
+ */
+enum class ModoTrava { COMPARTILHADO = 0, EXCLUSIVO = 1 };
+constexpr size_t NUM_MODOS_TRAVA = 2;
+
+inline const char* nomeModoTrava(size_t modo) {
+    static const char* nomes[NUM_MODOS_TRAVA] = {"compartilhado", "exclusivo"};
+    return nomes[modo];
+}
+
+struct ContadoresTrava {
+    long long aquisicoes = 0;
+    long long disputadas = 0;
+    uint64_t esperaNs = 0;
+    uint64_t posseNs = 0;
+    uint64_t maiorEsperaNs = 0;
+
+    void juntar(const ContadoresTrava& outro) {
+        aquisicoes += outro.aquisicoes;
+        disputadas += outro.disputadas;
+        esperaNs += outro.esperaNs;
+        posseNs += outro.posseNs;
+        maiorEsperaNs = std::max(maiorEsperaNs, outro.maiorEsperaNs);
+    }
+};
+
+using PerfilConta = std::array<ContadoresTrava, NUM_MODOS_TRAVA>;   // Indexado por ModoTrava
+
+class PerfilTravas {
+private:
+    using Buffer = std::unordered_map<size_t, PerfilConta>;
+
+    std::atomic<bool> ativo{false};
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<Buffer>> buffers;   // Um por thread que já registrou (nunca liberados)
+
+    PerfilTravas() = default;
+
+    Buffer& bufferDaThread() {
+        thread_local Buffer* buffer = nullptr;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(buffersMutex);
+            buffers.push_back(std::make_unique<Buffer>());
+            buffer = buffers.back().get();
+        }
+        return *buffer;
+    }
+
+public:
+    static PerfilTravas& instancia() {
+        static PerfilTravas perfil;
+        return perfil;
+    }
+
+    static bool ligado() { return instancia().ativo.load(std::memory_order_relaxed); }
+
+    static uint64_t agoraNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void ligar(bool valor) { ativo.store(valor); }
+
+    void registrar(size_t conta, ModoTrava modo, uint64_t esperaNs, uint64_t posseNs, bool disputada) {
+        ContadoresTrava& c = bufferDaThread()[conta][static_cast<size_t>(modo)];
+        c.aquisicoes++;
+        c.disputadas += disputada ? 1 : 0;
+        c.esperaNs += esperaNs;
+        c.posseNs += posseNs;
+        c.maiorEsperaNs = std::max(c.maiorEsperaNs, esperaNs);
+    }
+
+    // Com as threads paradas (entre rodadas): os índices são do banco da rodada
+    void zerar() {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        for (auto& buffer : buffers) buffer->clear();
+    }
+
+    std::map<size_t, PerfilConta> juntar() {
+        std::lock_guard<std::mutex> lock(buffersMutex);
+        std::map<size_t, PerfilConta> total;
+        for (const auto& buffer : buffers) {
+            for (const auto& [conta, perfil] : *buffer) {
+                PerfilConta& destino = total[conta];
+                for (size_t m = 0; m < NUM_MODOS_TRAVA; ++m) destino[m].juntar(perfil[m]);
+            }
+        }
+        return total;
+    }
+};
+
+/*
+ * MEDIÇÃO DE UMA AQUISIÇÃO:
+ * Criada antes de tentar a trava; adquirida() com a trava em mãos e
+ * liberada() logo depois de soltá-la (que já recomeça a medição para a
+ * próxima aquisição). Com o perfil desligado não lê o relógio.
+ */
+class MedidaTrava {
+private:
+    bool ligada;
+    bool disputada = false;
+    uint64_t inicio = 0;
+    uint64_t adquiridaEm = 0;
+
+public:
+    MedidaTrava() : ligada(PerfilTravas::ligado()) {
+        if (ligada) inicio = PerfilTravas::agoraNs();
+    }
+
+    bool ativa() const { return ligada; }
+
+    void adquirida(bool houveDisputa) {
+        disputada = houveDisputa;
+        if (ligada) adquiridaEm = PerfilTravas::agoraNs();
+    }
+
+    void liberada(size_t conta, ModoTrava modo) {
+        if (!ligada) return;
+        uint64_t agora = PerfilTravas::agoraNs();
+        PerfilTravas::instancia().registrar(conta, modo, adquiridaEm - inicio, agora - adquiridaEm, disputada);
+        inicio = agora;
+    }
+};
+
+// ===================================
+// Classe ContaCorrente
+// ===================================
+/*
+ * AÇÃO SOB A TRAVA:
+ * Opcional em creditar/debitar: roda depois da escrita, com o resultado
+ * e com a conta ainda travada. O Banco reserva aí o LSN do WAL (só com
+ * sucesso) e a posição no trace (sempre, já que uma falha por saldo
+ * também depende da ordem), para que o log e o trace tenham as escritas
+ * de cada conta na ordem em que foram aplicadas
+ */
+using AcaoSobTrava = std::function<void(bool sucesso)>;
+
+/*
+ * CONTA COM TRAVA:
+ * A política de trava é um parâmetro do template; ContaCorrente (o motor
+ * "rwlock" original) é a instância com std::shared_mutex
+ */
+template <typename Trava>
+class ContaComTrava {
+private:
+    std::string identificador;              // ID único da conta
+
+    /*
+     * SALDO ATUAL:
+     * Só é alterado com o lock exclusivo, mas o snapshot o lê sem lock;
+     * por isso é atômico (load/store relaxed custam o mesmo que um double)
+     */
+    std::atomic<double> saldo;
+    VersaoEpoca<double> versao;            // Pré-imagem para snapshots
+    
+    /*
+     * SINCRONIZAÇÃO:
+     * - Débitos/créditos (escrita) são sempre exclusivos
+     * - Consultas (leitura) usam lock_shared: simultâneas no shared_mutex
+     *   e no rwgiro, exclusivas nas demais; na seqlock não travam
+     */
+    mutable Trava trava;
+    
+    /*
+     * CONTADOR ATÔMICO:
+     * - atomic<int> garante que operações de incremento/decremento sejam thread-safe
+     * - Informativo (aparece no log); o limite de consultas simultâneas
+     *   é aplicado pelo controle de admissão, antes do lock
+     */
+    mutable std::atomic<int> leitoresAtivos{0};  // Conta quantos threads estão lendo
+
+    /*
+     * ADMISSÃO:
+     * Fila justa na frente da trava (usada pelas operações via Banco)
+     */
+    ControleAdmissao admissao;
+
+    /*
+     * COMBINAÇÃO DE ESCRITAS (FLAT COMBINING):
+     * Em vez de cada escritor disputar a trava, os pedidos de crédito e
+     * débito são publicados numa lista; quem conseguir o lock aplica a
+     * lista inteira numa única seção crítica e devolve os resultados.
+     * O pedido vive na pilha de quem o publicou: o combinador só o toca
+     * até marcar 'pronto'.
+     */
+    struct PedidoEscrita {
+        bool debito;
+        double valor;
+        uint64_t epoca;                     // Época de quem publicou (snapshot)
+        const AcaoSobTrava* aoAplicar = nullptr;
+        bool resultado = false;
+        std::atomic<bool> pronto{false};
+        PedidoEscrita* proximo = nullptr;
+    };
+    std::atomic<PedidoEscrita*> publicados{nullptr};
+
+    /*
+     * LIGA/DESLIGA AUTOMÁTICO:
+     * A cada JANELA_COMBINACAO escritas a conta decide o modo:
+     * - liga se pelo menos LIMIAR_LIGAR% das escritas encontraram disputa
+     * - desliga se, combinando, os lotes tiveram em média menos de
+     *   LOTE_MINIMO pedidos (não há disputa suficiente para compensar)
+     */
+    static constexpr uint32_t JANELA_COMBINACAO = 64;
+    static constexpr uint32_t LIMIAR_LIGAR = 25;
+    static constexpr double LOTE_MINIMO = 1.5;
+    std::atomic<bool> modoCombinado{false};
+    std::atomic<uint32_t> escritasJanela{0};
+    std::atomic<uint32_t> disputasJanela{0};
+    std::atomic<uint32_t> lotesJanela{0};
+    std::atomic<uint32_t> pedidosJanela{0};
+    std::atomic<long long> lotesCombinados{0};        // Totais (relatório)
+    std::atomic<long long> pedidosCombinados{0};
+
+    void avaliarModo() {
+        if (escritasJanela.fetch_add(1, std::memory_order_relaxed) + 1 < JANELA_COMBINACAO) return;
+        escritasJanela.store(0, std::memory_order_relaxed);
+        uint32_t disputas = disputasJanela.exchange(0, std::memory_order_relaxed);
+        uint32_t lotes = lotesJanela.exchange(0, std::memory_order_relaxed);
+        uint32_t pedidos = pedidosJanela.exchange(0, std::memory_order_relaxed);
+        if (!modoCombinado.load(std::memory_order_relaxed)) {
+            if (disputas * 100 >= LIMIAR_LIGAR * JANELA_COMBINACAO) modoCombinado.store(true);
+        } else if (lotes > 0 && pedidos < LOTE_MINIMO * lotes) {
+            modoCombinado.store(false);
+        }
+    }
+
+    /*
+     * ALTERAÇÃO DO SALDO (com o lock exclusivo):
+     * Único ponto de escrita do saldo; versiona antes de alterar
+     */
+    void alterarSaldo(double delta, uint64_t epoca) {
+        double atual = saldo.load(std::memory_order_relaxed);
+        versao.antesDeAlterar(epoca, atual, delta);
+        saldo.store(atual + delta, std::memory_order_relaxed);
+    }
+
+    /*
+     * APLICAÇÃO DE UM PEDIDO (com o lock exclusivo)
+     */
+    bool aplicarTravado(bool debito, double valor, uint64_t epoca) {
+        if (valor <= 0 || (debito && saldo.load(std::memory_order_relaxed) < valor)) return false;
+        alterarSaldo(debito ? -valor : valor, epoca);
+        LoggerOperacoes::instancia().registrar(debito ? TipoRegistro::DEBITO : TipoRegistro::CREDITO,
+                                               identificador, valor, saldo.load(std::memory_order_relaxed));
+        ModeloServico::instancia().executar(debito ? EtapaServico::DEBITO : EtapaServico::CREDITO);
+        return true;
+    }
+
+    /*
+     * PASSADA DO COMBINADOR:
+     * Retira todos os pedidos publicados e aplica em ordem de chegada
+     * (a lista é uma pilha, então é invertida antes)
+     */
+    void combinarPublicados() {
+        PedidoEscrita* lista = publicados.exchange(nullptr, std::memory_order_acquire);
+        if (!lista) return;
+        PedidoEscrita* fifo = nullptr;
+        while (lista) {
+            PedidoEscrita* proximo = lista->proximo;
+            lista->proximo = fifo;
+            fifo = lista;
+            lista = proximo;
+        }
+        uint32_t quantidade = 0;
+        while (fifo) {
+            PedidoEscrita* proximo = fifo->proximo;          // Lido antes de liberar o pedido
+            fifo->resultado = aplicarTravado(fifo->debito, fifo->valor, fifo->epoca);
+            if (fifo->aoAplicar) (*fifo->aoAplicar)(fifo->resultado);
+            fifo->pronto.store(true, std::memory_order_release);
+            fifo = proximo;
+            ++quantidade;
+        }
+        lotesJanela.fetch_add(1, std::memory_order_relaxed);
+        pedidosJanela.fetch_add(quantidade, std::memory_order_relaxed);
+        lotesCombinados.fetch_add(1, std::memory_order_relaxed);
+        pedidosCombinados.fetch_add(quantidade, std::memory_order_relaxed);
+    }
+
+    /*
+     * ESCRITA PELO CAMINHO DIRETO:
+     * try_lock primeiro só para saber se houve disputa
+     */
+    bool escreverComLock(bool debito, double valor, const AcaoSobTrava& aoAplicar) {
+        MedidaTrava medida;
+        std::unique_lock<Trava> lock(trava, std::try_to_lock);
+        bool disputada = !lock.owns_lock();
+        if (disputada) {
+            disputasJanela.fetch_add(1, std::memory_order_relaxed);
+            lock.lock();
+        }
+        medida.adquirida(disputada);
+        bool sucesso = aplicarTravado(debito, valor, DominioEpocas::epocaDaThread());
+        if (aoAplicar) aoAplicar(sucesso);
+        lock.unlock();
+        medida.liberada(indice, ModoTrava::EXCLUSIVO);
+        avaliarModo();
+        return sucesso;
+    }
+
+    /*
+     * ÍNDICE GLOBAL:
+     * Define a ordem em que locks de várias contas são adquiridos
+     * (transferências e lotes), o que elimina deadlocks
+     */
+    size_t indice;
+
+    // Aquisição em curso de travarEscrita, fechada em destravarEscrita (perfil)
+    MedidaTrava medidaEscrita;
+
+public:
+    /*
+     * ESTADO SALVO EM OPERAÇÕES COM VÁRIAS CONTAS:
+     * Permite desfazer um lote abortado restaurando o valor exato
+     */
+    using Estado = double;
+
+    /*
+     * O processamento simulado de uma transferência acontece
+     * com os locks adquiridos (mesmo comportamento de creditar/debitar)
+     */
+    static constexpr bool PROCESSA_SOB_LOCK = true;
+
+    /*
+     * Operações simples passam pelo controle de admissão antes do lock
+     */
+    static constexpr bool USA_ADMISSAO = true;
+
+    ControleAdmissao& getAdmissao() { return admissao; }
+
+    /*
+     * Créditos e débitos podem ser combinados (flat combining)
+     */
+    static constexpr bool SUPORTA_COMBINACAO = true;
+
+    bool combinando() const { return modoCombinado.load(std::memory_order_relaxed); }
+    long long getLotesCombinados() const { return lotesCombinados.load(); }
+    long long getPedidosCombinados() const { return pedidosCombinados.load(); }
+
+    // Espera fora da conta (ex.: fila de admissão) também conta como disputa
+    void registrarDisputa() { disputasJanela.fetch_add(1, std::memory_order_relaxed); }
+
+    /*
+     * ESCRITA COMBINADA:
+     * Publica o pedido e espera: ou outro combinador o aplica, ou esta
+     * thread consegue o lock e vira o combinador da vez
+     */
+    bool escreverCombinado(bool debito, double valor, const AcaoSobTrava& aoAplicar = {}) {
+        PedidoEscrita pedido;
+        pedido.debito = debito;
+        pedido.valor = valor;
+        if (aoAplicar) pedido.aoAplicar = &aoAplicar;
+        pedido.epoca = DominioEpocas::epocaDaThread();
+        pedido.proximo = publicados.load(std::memory_order_relaxed);
+        while (!publicados.compare_exchange_weak(pedido.proximo, &pedido,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {}
+
+        /*
+         * No perfil, a espera desta thread até virar combinadora conta como
+         * uma aquisição disputada; se outro combinador aplicou o pedido,
+         * ela não adquiriu a trava e nada é registrado
+         */
+        MedidaTrava medida;
+        bool disputada = false;
+        while (!pedido.pronto.load(std::memory_order_acquire)) {
+            if (trava.try_lock()) {
+                medida.adquirida(disputada);
+                combinarPublicados();
+                trava.unlock();
+                medida.liberada(indice, ModoTrava::EXCLUSIVO);
+            } else {
+                disputada = true;
+                std::this_thread::yield();
+            }
+        }
+        avaliarModo();
+        return pedido.resultado;
+    }
+
+    /*
+     * CONSTRUTOR:
+     * Inicializa a conta com ID, saldo inicial e índice global
+     */
+    ContaComTrava(const std::string& id, double saldoInicial, size_t indiceGlobal = 0) 
+        : identificador(id), saldo(saldoInicial), indice(indiceGlobal) {}
+
+    /*
+     * GETTER SIMPLES:
+     * Retorna o ID da conta (operação rápida, não precisa de sincronização)
+     */
+    std::string getId() const { return identificador; }
+
+    /*
+     * NOME DO MOTOR (registrado no CSV)
+     */
+    static const char* nomeMotor() { return Trava::NOME; }
+    static const char* nomeTrava() { return Trava::NOME; }
+
+    /*
+     * OPERAÇÃO DE CRÉDITO (ESCRITA):
+     * Adiciona dinheiro à conta de forma thread-safe
+     */
+    bool creditar(double valor, const AcaoSobTrava& aoAplicar = {}) {
+        /*
+         * UNIQUE_LOCK (em escreverComLock):
+         * - Bloqueia EXCLUSIVAMENTE a trava da conta
+         * - Nenhuma outra thread pode ler ou escrever enquanto isso
+         * - Garante que apenas uma thread modifique o saldo por vez
+         * - O log é só uma cópia para o anel da thread, e o tempo de
+         *   processamento segue o modelo de serviço
+         */
+        return escreverComLock(false, valor, aoAplicar);
+    }
+
+    /*
+     * OPERAÇÃO DE DÉBITO (ESCRITA):
+     * Remove dinheiro da conta de forma thread-safe
+     * (mesmo padrão do crédito, validando saldo suficiente)
+     */
+    bool debitar(double valor, const AcaoSobTrava& aoAplicar = {}) {
+        return escreverComLock(true, valor, aoAplicar);
+    }
+
+    /*
+     * CONSULTA DE SALDO (LEITURA):
+     * Permite múltiplas threads lerem simultaneamente
+     */
+    double consultarSaldo() const {
+        if constexpr (Trava::LEITURA_OTIMISTA) {
+            /*
+             * LEITURA OTIMISTA (seqlock):
+             * Lê sem travar e repete se um escritor passou no meio; o
+             * processamento simulado acontece depois, sem segurar nada
+             */
+            leitoresAtivos++;
+            double saldoAtual = trava.lerOtimista([this] { return saldo.load(std::memory_order_relaxed); });
+            LoggerOperacoes::instancia().registrar(TipoRegistro::CONSULTA, identificador, 0.0,
+                                                   saldoAtual, leitoresAtivos.load());
+            ModeloServico::instancia().executar(EtapaServico::CONSULTA);
+            leitoresAtivos--;
+            return saldoAtual;
+        }
+
+        /*
+         * SHARED_LOCK:
+         * - Permite que múltiplas threads leiam ao mesmo tempo
+         * - Bloqueia apenas se houver um escritor ativo
+         * - Mais eficiente que unique_lock para operações de leitura
+         *   (nas travas exclusivas equivale a um lock comum)
+         * - Com o perfil ligado, tenta sem esperar antes, só para saber
+         *   se houve disputa
+         */
+        MedidaTrava medida;
+        std::shared_lock<Trava> lock(trava, std::defer_lock);
+        bool disputada = medida.ativa() && !lock.try_lock();
+        if (!lock.owns_lock()) lock.lock();
+        medida.adquirida(disputada);
+        
+        /*
+         * INCREMENTO ATÔMICO:
+         * ++ em atomic<int> é thread-safe (não precisa de mutex adicional)
+         */
+        leitoresAtivos++;
+        
+        // Log da consulta (assíncrono)
+        LoggerOperacoes::instancia().registrar(TipoRegistro::CONSULTA, identificador, 0.0,
+                                               saldo.load(std::memory_order_relaxed),
+                                               leitoresAtivos.load());
+        
+        // Simulação de processamento (mais rápida que escrita, no modelo legado)
+        ModeloServico::instancia().executar(EtapaServico::CONSULTA);
+        
+        // Cópia do saldo para retorno
+        double saldoAtual = saldo.load(std::memory_order_relaxed);
+        
+        /*
+         * DECREMENTO ATÔMICO:
+         * Remove este thread da contagem de leitores ativos
+         */
+        leitoresAtivos--;
+
+        lock.unlock();
+        medida.liberada(indice, ModoTrava::COMPARTILHADO);
+        return saldoAtual;
+    }
+
+    /*
+     * ACESSO DIRETO (SEM SINCRONIZAÇÃO):
+     * Usado apenas quando já há garantia de exclusão mútua
+     * (ex: quando o banco já está com lock)
+     */
+    double getSaldoUnsafe() const {
+        return saldo.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * SALDO AO FIM DA ÉPOCA S (snapshot, sem lock)
+     */
+    double saldoNaEpoca(uint64_t epoca) const {
+        return versao.ler(epoca, [this] { return saldo.load(std::memory_order_relaxed); });
+    }
+
+    // Época da última escrita (0 = inalterada desde a carga): marca de sujeira do checkpoint
+    uint64_t getVersao() const { return versao.getEpoca(); }
+
+    /*
+     * VALOR QUE UMA OPERAÇÃO DE 'valor' REALMENTE MOVE (auditoria)
+     */
+    static double valorEfetivo(double valor) { return valor; }
+
+    size_t getIndice() const { return indice; }
+
+    /*
+     * INTERFACE PARA OPERAÇÕES COM VÁRIAS CONTAS:
+     * O Banco adquire o lock exclusivo de cada conta envolvida (em ordem
+     * de índice) e só então aplica as alterações com os métodos "Travado",
+     * que assumem que o lock já está em posse de quem chama.
+     */
+    void travarEscrita() {
+        MedidaTrava medida;
+        bool disputada = medida.ativa() && !trava.try_lock();
+        if (!medida.ativa() || disputada) trava.lock();
+        medida.adquirida(disputada);
+        medidaEscrita = medida;             // Protegida pela própria trava
+    }
+    void destravarEscrita() {
+        MedidaTrava medida = medidaEscrita;
+        trava.unlock();
+        medida.liberada(indice, ModoTrava::EXCLUSIVO);
+    }
+
+    Estado estadoTravado() const { return saldo.load(std::memory_order_relaxed); }
+
+    void restaurarEstadoTravado(Estado estado) {
+        alterarSaldo(estado - estadoTravado(), DominioEpocas::epocaDaThread());
+    }
+
+    bool creditarTravado(double valor) {
+        if (valor <= 0) return false;
+        alterarSaldo(valor, DominioEpocas::epocaDaThread());
+        return true;
+    }
+
+    bool debitarTravado(double valor) {
+        if (valor <= 0 || estadoTravado() < valor) return false;
+        alterarSaldo(-valor, DominioEpocas::epocaDaThread());
+        return true;
+    }
+};
+
+using ContaCorrente = ContaComTrava<TravaLeituraEscrita>;
+
+// ===================================
+// Classe ContaCorrenteAtomica
+// ===================================
+/*
+ * MOTOR LIVRE DE LOCKS:
+ * - O saldo é guardado em centavos num único atomic<long long>
+ * - Crédito e débito são laços CAS (compare-and-swap): leem o saldo,
+ *   calculam o novo valor e só publicam se ninguém alterou no meio
+ * - A verificação de saldo insuficiente acontece DENTRO do laço,
+ *   portanto nunca é feita sobre um valor desatualizado
+ * - A consulta é uma leitura otimista (load com acquire): não bloqueia
+ *   escritores nem é bloqueada pelos laços CAS. Como o estado da conta é
+ *   uma única palavra de 64 bits, a leitura já é consistente sem precisar
+ *   de contador de sequência (seqlock); só espera, como os laços CAS,
+ *   enquanto uma transferência ou lote segura a palavra
+ */
+class ContaCorrenteAtomica {
+private:
+    std::string identificador;              // ID único da conta
+    std::atomic<long long> saldoCentavos;   // Saldo em centavos (ponto fixo)
+    size_t indice;                          // Ordem global para operações com várias contas
+
+    /*
+     * BIT DE TRAVA:
+     * Transferências e lotes precisam alterar várias contas de forma atômica.
+     * Enquanto o bit 62 está ligado a palavra pertence a uma dessas operações,
+     * que grava nela os valores intermediários (origem já debitada e destino
+     * ainda não creditado, lote que ainda pode ser desfeito): os laços CAS de
+     * crédito/débito e a consulta esperam o bit apagar. Só os snapshots leem
+     * a palavra travada, pela pré-imagem da época (ver saldoNaEpoca).
+     */
+    static constexpr long long BIT_TRAVA = 1LL << 62;
+
+    /*
+     * VERSÃO PARA SNAPSHOTS:
+     * A pré-imagem não cabe na mesma palavra do CAS. Por isso a primeira
+     * escrita de cada época (ou uma escrita atrasada de época anterior)
+     * segue pelo caminho com o bit de trava, que versiona e altera sem
+     * ninguém no meio; as demais escritas da época continuam no laço CAS.
+     * O bit 61 guarda a paridade da época da versão: versionar sempre
+     * muda a palavra, então um CAS preparado antes do versionamento
+     * falha mesmo que um lote desfeito tenha devolvido o mesmo saldo.
+     */
+    static constexpr long long BIT_EPOCA = 1LL << 61;
+    VersaoEpoca<long long> versao;
+
+    /*
+     * SALDO DESLOCADO:
+     * Os bits 0..60 guardam saldo + DESLOCAMENTO, sempre não negativo:
+     * um saldo negativo (a carga aceita) não liga os bits de trava e de
+     * época. Cabem saldos de -2^60 a 2^60 - 1 centavos; crédito e débito
+     * somam direto na palavra, sem decodificar.
+     */
+    static constexpr long long DESLOCAMENTO = 1LL << 60;
+    static constexpr long long MASCARA_SALDO = BIT_EPOCA - 1;
+    static constexpr long long SALDO_MAXIMO = DESLOCAMENTO - 1;
+
+    static long long codificar(long long centavos) { return centavos + DESLOCAMENTO; }
+    static long long semTrava(long long palavra) { return palavra & ~BIT_TRAVA; }
+    static long long saldoDe(long long palavra) { return (palavra & MASCARA_SALDO) - DESLOCAMENTO; }
+
+    // O CAS só pode alterar a palavra se a conta já foi versionada nesta época
+    bool emDia(long long palavra, uint64_t epoca) const {
+        if (epoca == 0) return true;
+        return versao.emDia(epoca) && ((palavra & BIT_EPOCA) != 0) == ((epoca & 1) != 0);
+    }
+
+    bool escreverVersionado(bool debito, double valor, const AcaoSobTrava& aoAplicar) {
+        travarEscrita();
+        bool sucesso = debito ? debitarTravado(valor) : creditarTravado(valor);
+        long long novo = estadoTravado();
+        if (aoAplicar) aoAplicar(sucesso);
+        destravarEscrita();
+        if (!sucesso) return false;
+
+        LoggerOperacoes::instancia().registrar(debito ? TipoRegistro::DEBITO : TipoRegistro::CREDITO,
+                                               identificador, valor, paraReais(novo));
+        ModeloServico::instancia().executar(debito ? EtapaServico::DEBITO : EtapaServico::CREDITO);
+        return true;
+    }
+
+    // Com a palavra travada: versiona e grava o novo saldo (mantendo a trava)
+    void alterarTravado(long long delta) {
+        long long atual = estadoTravado();
+        versao.antesDeAlterar(DominioEpocas::epocaDaThread(), atual, delta);
+        long long bitEpoca = (versao.getEpoca() & 1) ? BIT_EPOCA : 0;
+        saldoCentavos.store(codificar(atual + delta) | BIT_TRAVA | bitEpoca, std::memory_order_relaxed);
+    }
+
+public:
+    using Estado = long long;
+
+    /*
+     * Aqui não há lock de verdade para segurar: o processamento simulado
+     * de uma transferência acontece depois de liberar as contas
+     */
+    static constexpr bool PROCESSA_SOB_LOCK = false;
+
+    /*
+     * Sem lock nas operações simples: nada a admitir
+     */
+    static constexpr bool USA_ADMISSAO = false;
+
+    /*
+     * O laço CAS já não tem lock a disputar: nada a combinar
+     */
+    static constexpr bool SUPORTA_COMBINACAO = false;
+
+    static const char* nomeMotor() { return "atomico"; }
+    static const char* nomeTrava() { return "cas"; }
+
+    /*
+     * CONVERSÃO PARA PONTO FIXO:
+     * Arredonda para o centavo mais próximo
+     */
+    static long long paraCentavos(double valor) { return std::llround(valor * 100.0); }
+    static double paraReais(long long centavos) { return static_cast<double>(centavos) / 100.0; }
+
+    ContaCorrenteAtomica(const std::string& id, double saldoInicial, size_t indiceGlobal = 0)
+        : identificador(id), saldoCentavos(codificar(paraCentavos(saldoInicial))), indice(indiceGlobal) {}
+
+    std::string getId() const { return identificador; }
+    size_t getIndice() const { return indice; }
+
+    /*
+     * CRÉDITO (LAÇO CAS):
+     * compare_exchange_weak atualiza 'atual' com o valor corrente
+     * quando falha, então basta recalcular e tentar de novo.
+     * Com uma ação sob a trava, a escrita segue pelo bit de trava: no
+     * laço CAS não há momento em que a conta esteja segura para ela
+     */
+    bool creditar(double valor, const AcaoSobTrava& aoAplicar = {}) {
+        long long centavos = paraCentavos(valor);
+        if (centavos <= 0) return false;
+        if (aoAplicar) return escreverVersionado(false, valor, aoAplicar);
+        uint64_t epoca = DominioEpocas::epocaDaThread();
+
+        long long atual = saldoCentavos.load(std::memory_order_acquire);
+        long long novo;
+        while (true) {
+            if (atual & BIT_TRAVA) {              // Transferência em andamento
+                std::this_thread::yield();
+                atual = saldoCentavos.load(std::memory_order_acquire);
+                continue;
+            }
+            if (!emDia(atual, epoca)) return escreverVersionado(false, valor, aoAplicar);
+            if (saldoDe(atual) > SALDO_MAXIMO - centavos) return false;   // Não cabe na palavra
+            novo = atual + centavos;
+            if (saldoCentavos.compare_exchange_weak(atual, novo,
+                                                    std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) break;
+        }
+
+        LoggerOperacoes::instancia().registrar(TipoRegistro::CREDITO, identificador,
+                                               valor, paraReais(saldoDe(novo)));
+
+        // Simulação de processamento (não há lock a segurar)
+        ModeloServico::instancia().executar(EtapaServico::CREDITO);
+        return true;
+    }
+
+    /*
+     * DÉBITO (LAÇO CAS):
+     * A checagem de saldo insuficiente é refeita a cada tentativa
+     */
+    bool debitar(double valor, const AcaoSobTrava& aoAplicar = {}) {
+        long long centavos = paraCentavos(valor);
+        if (centavos <= 0) return false;
+        if (aoAplicar) return escreverVersionado(true, valor, aoAplicar);
+        uint64_t epoca = DominioEpocas::epocaDaThread();
+
+        long long atual = saldoCentavos.load(std::memory_order_acquire);
+        long long novo;
+        while (true) {
+            if (atual & BIT_TRAVA) {
+                std::this_thread::yield();
+                atual = saldoCentavos.load(std::memory_order_acquire);
+                continue;
+            }
+            if (!emDia(atual, epoca)) return escreverVersionado(true, valor, aoAplicar);
+            if (saldoDe(atual) < centavos) return false;   // Saldo insuficiente
+            novo = atual - centavos;
+            if (saldoCentavos.compare_exchange_weak(atual, novo,
+                                                    std::memory_order_acq_rel,
+                                                    std::memory_order_acquire)) break;
+        }
+
+        LoggerOperacoes::instancia().registrar(TipoRegistro::DEBITO, identificador,
+                                               valor, paraReais(saldoDe(novo)));
+
+        ModeloServico::instancia().executar(EtapaServico::DEBITO);
+        return true;
+    }
+
+    /*
+     * CONSULTA OTIMISTA:
+     * Não há limite de leitores: a leitura não disputa nenhum lock. Com o
+     * bit de trava ligado a palavra guarda um valor intermediário, que
+     * nunca é devolvido: espera o dono destravar, como os laços CAS
+     */
+    double consultarSaldo() const {
+        long long palavra = saldoCentavos.load(std::memory_order_acquire);
+        while (palavra & BIT_TRAVA) {
+            std::this_thread::yield();
+            palavra = saldoCentavos.load(std::memory_order_acquire);
+        }
+        double saldo = paraReais(saldoDe(palavra));
+
+        LoggerOperacoes::instancia().registrar(TipoRegistro::CONSULTA, identificador, 0.0, saldo);
+
+        ModeloServico::instancia().executar(EtapaServico::CONSULTA);
+        return saldo;
+    }
+
+    double getSaldoUnsafe() const {
+        return paraReais(saldoDe(saldoCentavos.load(std::memory_order_relaxed)));
+    }
+
+    /*
+     * SALDO AO FIM DA ÉPOCA S (snapshot, sem travar a palavra):
+     * Com o bit ligado a palavra ainda guarda um valor consistente
+     * (o anterior à operação em andamento, ou o já alterado por ela,
+     * que nesse caso é de S+1 e faz a leitura usar a pré-imagem)
+     */
+    double saldoNaEpoca(uint64_t epoca) const {
+        return paraReais(versao.ler(epoca, [this] {
+            return saldoDe(saldoCentavos.load(std::memory_order_relaxed));
+        }));
+    }
+
+    uint64_t getVersao() const { return versao.getEpoca(); }
+
+    // O motor arredonda cada operação para centavos
+    static double valorEfetivo(double valor) { return paraReais(paraCentavos(valor)); }
+
+    /*
+     * INTERFACE PARA OPERAÇÕES COM VÁRIAS CONTAS:
+     * travarEscrita liga o bit de trava com CAS; enquanto ele estiver
+     * ligado só o dono altera a palavra (com store simples)
+     */
+    void travarEscrita() {
+        long long atual = saldoCentavos.load(std::memory_order_relaxed);
+        while (true) {
+            if (atual & BIT_TRAVA) {
+                std::this_thread::yield();
+                atual = saldoCentavos.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (saldoCentavos.compare_exchange_weak(atual, atual | BIT_TRAVA,
+                                                    std::memory_order_acquire,
+                                                    std::memory_order_relaxed)) return;
+        }
+    }
+
+    void destravarEscrita() {
+        saldoCentavos.store(semTrava(saldoCentavos.load(std::memory_order_relaxed)),
+                            std::memory_order_release);
+    }
+
+    Estado estadoTravado() const { return saldoDe(saldoCentavos.load(std::memory_order_relaxed)); }
+
+    void restaurarEstadoTravado(Estado estado) {
+        alterarTravado(estado - estadoTravado());
+    }
+
+    bool creditarTravado(double valor) {
+        long long centavos = paraCentavos(valor);
+        if (centavos <= 0 || estadoTravado() > SALDO_MAXIMO - centavos) return false;
+        alterarTravado(centavos);
+        return true;
+    }
+
+    bool debitarTravado(double valor) {
+        long long centavos = paraCentavos(valor);
+        if (centavos <= 0 || estadoTravado() < centavos) return false;
+        alterarTravado(-centavos);
+        return true;
+    }
+};
+
+#endif  // BANCO_MOTORES_HPP
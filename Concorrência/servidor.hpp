@@ -0,0 +1,577 @@
+/*
+ * SERVIDOR LOCAL
+ * Protocolo binário, servidor por socket Unix (epoll) e clientes de carga
+ */
+#ifndef BANCO_SERVIDOR_HPP
+#define BANCO_SERVIDOR_HPP
+
+#include "simulador.hpp"
+
+// ===================================
+// Servidor local (socket Unix) e cliente de carga
+// ===================================
+/*
+ * PROTOCOLO BINÁRIO:
+ * - Pedidos de 24 bytes e respostas de 16 bytes, em ordem de máquina
+ *   (cliente e servidor estão na mesma máquina), sem cabeçalho extra
+ * - As contas são índices na ordem dos IDs (o pedido CONTAS devolve
+ *   quantas existem), então nenhuma string atravessa o socket
+ * - Pipelining: o cliente pode mandar vários pedidos sem esperar as
+ *   respostas; o servidor processa tudo o que chegou num read e devolve
+ *   as respostas, na mesma ordem, com um único write
+ */
+enum class TipoPedido : uint8_t { CREDITO, DEBITO, CONSULTA, TRANSFERENCIA, CONTAS };
+
+// Status da resposta: os três primeiros são os de StatusOperacao
+constexpr uint8_t STATUS_INVALIDO = 3;
+
+struct PedidoRede {
+    uint32_t sequencia;         // Devolvida na resposta
+    uint8_t tipo;               // TipoPedido
+    uint8_t reservado[3];
+    uint32_t conta;             // Índice da conta
+    uint32_t destino;           // Índice da conta de destino (transferência)
+    int64_t centavos;           // Valor da operação
+};
+
+struct RespostaRede {
+    uint32_t sequencia;
+    uint8_t status;             // SUCESSO, FALHA, REJEITADA ou STATUS_INVALIDO
+    uint8_t reservado[3];
+    int64_t valor;              // Saldo em centavos (consulta) ou quantidade de contas
+};
+
+static_assert(sizeof(PedidoRede) == 24, "Pedido do protocolo deve ter 24 bytes");
+static_assert(sizeof(RespostaRede) == 16, "Resposta do protocolo deve ter 16 bytes");
+
+/*
+ * PEDIDOS SORTEADOS:
+ * Mesmo gerador de carga do simulador (mix, distribuição e semente por
+ * fluxo), sobre IDs sintéticos que são o próprio índice da conta. Lotes
+ * não existem no protocolo: o peso do lote vira transferência.
+ */
+class GeradorPedidos {
+private:
+    ModeloCarga modelo;
+    GeradorCarga gerador;
+
+    static std::vector<std::string> idsPorIndice(uint32_t numContas) {
+        std::vector<std::string> ids(numContas);
+        char id[16];
+        for (uint32_t i = 0; i < numContas; ++i) {
+            std::snprintf(id, sizeof(id), "%010u", i);
+            ids[i] = id;
+        }
+        return ids;
+    }
+
+    static uint32_t indice(const std::string& id) {
+        return static_cast<uint32_t>(std::strtoul(id.c_str(), nullptr, 10));
+    }
+
+public:
+    GeradorPedidos(uint32_t numContas, const MixOperacoes& mix, const ConfigCarga& carga, uint64_t fluxo)
+        : modelo(idsPorIndice(numContas), mix, carga), gerador(modelo, carga.semente, fluxo) {}
+
+    GeradorPedidos(const GeradorPedidos&) = delete;
+    GeradorPedidos& operator=(const GeradorPedidos&) = delete;
+
+    PedidoRede proximo(uint32_t sequencia) {
+        PedidoRede pedido{};
+        pedido.sequencia = sequencia;
+        const std::string& id = gerador.proximaConta();
+        pedido.conta = indice(id);
+        int operacao = gerador.proximaOperacao();
+        if (operacao >= 3 && modelo.getContas().size() >= 2) {
+            pedido.tipo = static_cast<uint8_t>(TipoPedido::TRANSFERENCIA);
+            pedido.destino = indice(gerador.outraConta(id));
+        } else {
+            pedido.tipo = static_cast<uint8_t>(operacao >= 3 ? TipoPedido::CONSULTA
+                                                             : static_cast<TipoPedido>(operacao));
+        }
+        pedido.centavos = std::llround(gerador.proximoValor() * 100);
+        return pedido;
+    }
+};
+
+/*
+ * RESULTADO DE UM CLIENTE (ou da soma de vários):
+ * Copiável byte a byte, para voltar dos processos filhos por um pipe
+ */
+struct ResultadoCliente {
+    uint64_t operacoes = 0;
+    uint64_t sucessos = 0;
+    uint64_t falhas = 0;
+    uint64_t rejeicoes = 0;
+    uint64_t invalidos = 0;
+    uint64_t duracaoNs = 0;         // Na soma: a do processo mais lento
+    uint64_t escritas = 0;          // Chamadas write/read feitas pelo cliente
+    uint64_t leituras = 0;
+    HistogramaLatencia latencia;    // Do envio do pedido até a chegada da resposta
+
+    void contar(uint8_t status) {
+        operacoes++;
+        switch (status) {
+            case static_cast<uint8_t>(StatusOperacao::SUCESSO): sucessos++; break;
+            case static_cast<uint8_t>(StatusOperacao::FALHA): falhas++; break;
+            case static_cast<uint8_t>(StatusOperacao::REJEITADA): rejeicoes++; break;
+            default: invalidos++; break;
+        }
+    }
+
+    void juntar(const ResultadoCliente& outro) {
+        operacoes += outro.operacoes;
+        sucessos += outro.sucessos;
+        falhas += outro.falhas;
+        rejeicoes += outro.rejeicoes;
+        invalidos += outro.invalidos;
+        duracaoNs = std::max(duracaoNs, outro.duracaoNs);
+        escritas += outro.escritas;
+        leituras += outro.leituras;
+        latencia.juntar(outro.latencia);
+    }
+
+    double opsPorSegundo() const { return duracaoNs ? operacoes * 1e9 / duracaoNs : 0; }
+};
+
+static_assert(std::is_trivially_copyable<ResultadoCliente>::value,
+              "ResultadoCliente atravessa um pipe byte a byte");
+
+inline bool enderecoSocket(const std::string& caminho, sockaddr_un& endereco) {
+    std::memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (caminho.size() >= sizeof(endereco.sun_path)) return false;
+    std::memcpy(endereco.sun_path, caminho.c_str(), caminho.size() + 1);
+    return true;
+}
+
+/*
+ * SERVIDOR DO BANCO:
+ * - Um laço epoll por thread; o laço 0 também aceita conexões e as
+ *   distribui em rodízio entre os laços (cada conexão fica num só laço,
+ *   então seus buffers não precisam de lock)
+ * - Sockets não bloqueantes: cada read traz todos os pedidos disponíveis,
+ *   que são executados em ordem; as respostas saem num único write
+ * - Se o cliente não consome as respostas, o laço para de ler dele até
+ *   esvaziar a saída (controle de fluxo)
+ * As operações vão direto ao Banco, com as mesmas estatísticas do simulador.
+ */
+template <typename Conta>
+class ServidorBanco {
+private:
+    struct Conexao {
+        int fd = -1;
+        std::vector<char> entrada;      // Bytes recebidos ainda sem pedido completo no fim
+        std::vector<char> saida;        // Respostas ainda não enviadas
+        size_t enviados = 0;            // Prefixo de 'saida' já enviado
+    };
+
+    static constexpr size_t TAMANHO_LEITURA = 64 * 1024;
+
+    Banco<Conta>& banco;
+    std::vector<Conta*> contas;         // Índice do protocolo -> conta (ordem dos IDs)
+    std::string caminho;
+    unsigned numLacos;
+
+    int escuta = -1;
+    int eventoParada = -1;              // eventfd que acorda todos os laços
+    std::vector<int> epolls;
+    std::vector<std::thread> lacos;
+    std::atomic<unsigned> proximoLaco{0};
+
+    std::mutex conexoesMutex;           // Só na abertura e no fechamento
+    std::map<Conexao*, std::unique_ptr<Conexao>> conexoes;
+
+    std::atomic<uint64_t> pedidosAtendidos{0};
+    std::atomic<uint64_t> leiturasFeitas{0};
+    std::atomic<uint64_t> escritasFeitas{0};
+
+    void fechar(int epoll, Conexao* conexao) {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, conexao->fd, nullptr);
+        ::close(conexao->fd);
+        std::lock_guard<std::mutex> lock(conexoesMutex);
+        conexoes.erase(conexao);
+    }
+
+    void aceitar() {
+        while (true) {
+            int fd = accept4(escuta, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) return;                     // EAGAIN: nada mais na fila
+            auto nova = std::make_unique<Conexao>();
+            nova->fd = fd;
+            nova->entrada.reserve(TAMANHO_LEITURA + sizeof(PedidoRede));
+            Conexao* conexao = nova.get();
+            {
+                std::lock_guard<std::mutex> lock(conexoesMutex);
+                conexoes[conexao] = std::move(nova);
+            }
+            epoll_event evento{};
+            evento.events = EPOLLIN | EPOLLRDHUP;
+            evento.data.ptr = conexao;
+            unsigned laco = proximoLaco.fetch_add(1, std::memory_order_relaxed) % numLacos;
+            epoll_ctl(epolls[laco], EPOLL_CTL_ADD, fd, &evento);
+        }
+    }
+
+    /*
+     * ENVIO DAS RESPOSTAS PENDENTES:
+     * Retorna false se a conexão caiu; com saída pendente o laço espera
+     * EPOLLOUT em vez de EPOLLIN
+     */
+    bool enviar(int epoll, Conexao* conexao) {
+        while (conexao->enviados < conexao->saida.size()) {
+            ssize_t n = ::send(conexao->fd, conexao->saida.data() + conexao->enviados,
+                               conexao->saida.size() - conexao->enviados, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break;
+            if (n <= 0) return false;
+            escritasFeitas.fetch_add(1, std::memory_order_relaxed);
+            conexao->enviados += static_cast<size_t>(n);
+        }
+        bool pendente = conexao->enviados < conexao->saida.size();
+        if (!pendente) {
+            conexao->saida.clear();
+            conexao->enviados = 0;
+        }
+        epoll_event evento{};
+        evento.events = (pendente ? EPOLLOUT : EPOLLIN) | EPOLLRDHUP;
+        evento.data.ptr = conexao;
+        epoll_ctl(epoll, EPOLL_CTL_MOD, conexao->fd, &evento);
+        return true;
+    }
+
+    /*
+     * LEITURA E EXECUÇÃO:
+     * Lê o que houver, executa todos os pedidos completos e guarda o
+     * resto (pedido partido ao meio) para o próximo read. As escritas só
+     * anexam ao WAL (espera adiada): um único commit, esperado antes de
+     * as respostas saírem, cobre todos os pedidos lidos de uma vez. Se o
+     * WAL falhar antes dele, as escritas do read respondem FALHA
+     */
+    bool receber(Conexao* conexao) {
+        size_t usados = conexao->entrada.size();
+        conexao->entrada.resize(usados + TAMANHO_LEITURA);
+        ssize_t n;
+        do {
+            n = ::read(conexao->fd, conexao->entrada.data() + usados, TAMANHO_LEITURA);
+        } while (n < 0 && errno == EINTR);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            conexao->entrada.resize(usados);
+            return true;
+        }
+        if (n <= 0) return false;
+        leiturasFeitas.fetch_add(1, std::memory_order_relaxed);
+        conexao->entrada.resize(usados + static_cast<size_t>(n));
+
+        size_t completos = conexao->entrada.size() / sizeof(PedidoRede);
+        size_t inicioSaida = conexao->saida.size();
+        conexao->saida.resize(inicioSaida + completos * sizeof(RespostaRede));
+        WriteAheadLog::EsperaAdiada& adiada = WriteAheadLog::esperaAdiadaDaThread();
+        adiada.ativa = true;
+        std::vector<RespostaRede> respostas(completos);
+        for (size_t i = 0; i < completos; ++i) {
+            PedidoRede pedido;
+            std::memcpy(&pedido, conexao->entrada.data() + i * sizeof(PedidoRede), sizeof(pedido));
+            respostas[i] = executar(pedido);
+        }
+        adiada.ativa = false;
+        bool duravel = true;
+        if (uint64_t lsn = WriteAheadLog::retirarLsnAdiado()) duravel = banco.getWAL()->aguardarDuravel(lsn);
+        for (size_t i = 0; i < completos; ++i) {
+            PedidoRede pedido;
+            std::memcpy(&pedido, conexao->entrada.data() + i * sizeof(PedidoRede), sizeof(pedido));
+            if (!duravel && escrita(pedido) && respostas[i].status == static_cast<uint8_t>(StatusOperacao::SUCESSO)) {
+                respostas[i].status = static_cast<uint8_t>(StatusOperacao::FALHA);
+            }
+            contar(pedido, respostas[i]);
+        }
+        if (completos > 0) {
+            std::memcpy(conexao->saida.data() + inicioSaida, respostas.data(), completos * sizeof(RespostaRede));
+        }
+        conexao->entrada.erase(conexao->entrada.begin(),
+                               conexao->entrada.begin() + completos * sizeof(PedidoRede));
+        pedidosAtendidos.fetch_add(completos, std::memory_order_relaxed);
+        return true;
+    }
+
+    void executarLaco(unsigned laco) {
+        std::array<epoll_event, 64> eventos;
+        while (true) {
+            int prontos = epoll_wait(epolls[laco], eventos.data(), static_cast<int>(eventos.size()), -1);
+            if (prontos < 0 && errno == EINTR) continue;
+            if (prontos < 0) return;
+            for (int i = 0; i < prontos; ++i) {
+                void* origem = eventos[i].data.ptr;
+                if (origem == &eventoParada) return;
+                if (origem == &escuta) {
+                    aceitar();
+                    continue;
+                }
+                Conexao* conexao = static_cast<Conexao*>(origem);
+                bool viva = !(eventos[i].events & EPOLLERR);
+                if (viva && (eventos[i].events & EPOLLIN)) viva = receber(conexao);
+                if (viva && !conexao->saida.empty()) viva = enviar(epolls[laco], conexao);
+                // Fechou do outro lado: só depois de atender o que já tinha chegado
+                if (viva && (eventos[i].events & (EPOLLRDHUP | EPOLLHUP)) &&
+                    conexao->saida.empty()) viva = false;
+                if (!viva) fechar(epolls[laco], conexao);
+            }
+        }
+    }
+
+public:
+    ServidorBanco(Banco<Conta>& b, const std::string& caminhoSocket, unsigned lacosEpoll)
+        : banco(b), caminho(caminhoSocket), numLacos(std::max(1u, lacosEpoll)) {
+        for (const std::string& id : banco.listarContas()) contas.push_back(banco.obterConta(id));
+    }
+
+    ~ServidorBanco() { parar(); }
+
+    ServidorBanco(const ServidorBanco&) = delete;
+    ServidorBanco& operator=(const ServidorBanco&) = delete;
+
+    /*
+     * EXECUÇÃO DE UM PEDIDO:
+     * Também usada diretamente (sem socket) como linha de base do benchmark
+     */
+    /*
+     * PEDIDO ISOLADO:
+     * Executa e conta; com a espera adiada desligada o banco já esperou
+     * o commit (e respondeu FALHA se o WAL falhou)
+     */
+    RespostaRede processar(const PedidoRede& pedido) {
+        RespostaRede resposta = executar(pedido);
+        contar(pedido, resposta);
+        return resposta;
+    }
+
+    static bool escrita(const PedidoRede& pedido) {
+        TipoPedido tipo = static_cast<TipoPedido>(pedido.tipo);
+        return tipo == TipoPedido::CREDITO || tipo == TipoPedido::DEBITO || tipo == TipoPedido::TRANSFERENCIA;
+    }
+
+    void contar(const PedidoRede& pedido, const RespostaRede& resposta) {
+        if (static_cast<TipoPedido>(pedido.tipo) == TipoPedido::CONTAS) return;
+        StatusOperacao status = static_cast<StatusOperacao>(resposta.status);
+        if (status == StatusOperacao::SUCESSO) banco.incrementarOperacoes();
+        else if (status == StatusOperacao::FALHA) banco.incrementarFalhas();
+    }
+
+    RespostaRede executar(const PedidoRede& pedido) {
+        RespostaRede resposta{};
+        resposta.sequencia = pedido.sequencia;
+        resposta.status = STATUS_INVALIDO;
+        TipoPedido tipo = static_cast<TipoPedido>(pedido.tipo);
+        if (tipo == TipoPedido::CONTAS) {
+            resposta.status = static_cast<uint8_t>(StatusOperacao::SUCESSO);
+            resposta.valor = static_cast<int64_t>(contas.size());
+            return resposta;
+        }
+        if (pedido.conta >= contas.size()) return resposta;
+        Conta* conta = contas[pedido.conta];
+        double valor = pedido.centavos / 100.0;
+        StatusOperacao status;
+        switch (tipo) {
+            case TipoPedido::CREDITO: status = banco.creditar(conta, valor); break;
+            case TipoPedido::DEBITO: status = banco.debitar(conta, valor); break;
+            case TipoPedido::CONSULTA: {
+                double saldo = 0;
+                status = banco.consultarSaldo(conta, saldo);
+                resposta.valor = std::llround(saldo * 100);
+                break;
+            }
+            case TipoPedido::TRANSFERENCIA:
+                if (pedido.destino >= contas.size()) return resposta;
+                status = statusDe(banco.transferir(conta, contas[pedido.destino], valor));
+                break;
+            default:
+                return resposta;
+        }
+        resposta.status = static_cast<uint8_t>(status);
+        return resposta;
+    }
+
+    /*
+     * INÍCIO:
+     * Cria o socket (removendo um arquivo de socket antigo) e os laços
+     */
+    bool iniciar() {
+        sockaddr_un endereco;
+        if (!enderecoSocket(caminho, endereco)) {
+            std::cerr << "Caminho de socket longo demais: " << caminho << std::endl;
+            return false;
+        }
+        ::unlink(caminho.c_str());
+        escuta = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (escuta < 0 || ::bind(escuta, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0 ||
+            ::listen(escuta, SOMAXCONN) < 0) {
+            std::cerr << "Erro ao abrir o socket " << caminho << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        eventoParada = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        for (unsigned i = 0; i < numLacos; ++i) {
+            epolls.push_back(epoll_create1(EPOLL_CLOEXEC));
+            epoll_event evento{};
+            evento.events = EPOLLIN;
+            evento.data.ptr = &eventoParada;
+            epoll_ctl(epolls[i], EPOLL_CTL_ADD, eventoParada, &evento);
+        }
+        epoll_event evento{};
+        evento.events = EPOLLIN;
+        evento.data.ptr = &escuta;
+        epoll_ctl(epolls[0], EPOLL_CTL_ADD, escuta, &evento);
+        for (unsigned i = 0; i < numLacos; ++i) lacos.emplace_back(&ServidorBanco::executarLaco, this, i);
+        return true;
+    }
+
+    /*
+     * PARADA:
+     * Acorda os laços, fecha as conexões e remove o arquivo do socket
+     */
+    void parar() {
+        if (lacos.empty()) return;
+        uint64_t um = 1;
+        escreverTudo(eventoParada, &um, sizeof(um));
+        for (auto& laco : lacos) laco.join();
+        lacos.clear();
+        for (auto& [ponteiro, conexao] : conexoes) ::close(conexao->fd);
+        conexoes.clear();
+        for (int epoll : epolls) ::close(epoll);
+        epolls.clear();
+        ::close(eventoParada);
+        ::close(escuta);
+        ::unlink(caminho.c_str());
+    }
+
+    const std::string& getCaminho() const { return caminho; }
+    uint32_t getNumContas() const { return static_cast<uint32_t>(contas.size()); }
+    uint64_t getPedidosAtendidos() const { return pedidosAtendidos.load(); }
+    uint64_t getLeituras() const { return leiturasFeitas.load(); }
+    uint64_t getEscritas() const { return escritasFeitas.load(); }
+};
+
+/*
+ * PARADA DO MODO SERVIDOR:
+ * SIGINT/SIGTERM só marcam a flag (atomic sem lock é seguro num handler)
+ */
+inline std::atomic<bool> servidorEncerrando{false};
+
+extern "C" inline void tratarSinalParada(int) { servidorEncerrando.store(true); }
+
+/*
+ * UM CLIENTE DE CARGA (um processo):
+ * Conecta, descobre quantas contas existem e envia 'operacoes' pedidos
+ * sorteados mantendo até 'janela' pedidos em trânsito. Cada volta envia
+ * de uma vez todos os pedidos que cabem na janela e lê o que já chegou,
+ * então com janela 1 é um pedido por write/read e com janelas grandes
+ * muitos pedidos por chamada de sistema.
+ */
+inline ResultadoCliente executarClienteSocket(const std::string& caminho, int operacoes, int janela,
+                                              const MixOperacoes& mix, const ConfigCarga& carga,
+                                              uint64_t fluxo) {
+    ResultadoCliente resultado;
+    sockaddr_un endereco;
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || !enderecoSocket(caminho, endereco) ||
+        ::connect(fd, reinterpret_cast<sockaddr*>(&endereco), sizeof(endereco)) < 0) {
+        std::cerr << "Erro ao conectar em " << caminho << ": " << std::strerror(errno) << std::endl;
+        if (fd >= 0) ::close(fd);
+        return resultado;
+    }
+
+    PedidoRede consulta{};
+    consulta.tipo = static_cast<uint8_t>(TipoPedido::CONTAS);
+    RespostaRede contas{};
+    if (!escreverTudo(fd, &consulta, sizeof(consulta)) || !lerTudo(fd, &contas, sizeof(contas)) ||
+        contas.valor <= 0) {
+        ::close(fd);
+        return resultado;
+    }
+
+    GeradorPedidos gerador(static_cast<uint32_t>(contas.valor), mix, carga, fluxo);
+    janela = std::max(1, janela);
+    std::vector<PedidoRede> envio;
+    std::vector<std::chrono::steady_clock::time_point> enviadoEm(static_cast<size_t>(janela));
+    std::vector<char> recebidos(std::max<size_t>(64 * 1024, janela * sizeof(RespostaRede)));
+    size_t pendentes = 0;                   // Bytes de uma resposta incompleta
+    int enviados = 0, respondidos = 0;
+
+    auto inicio = std::chrono::steady_clock::now();
+    while (respondidos < operacoes) {
+        envio.clear();
+        auto agora = std::chrono::steady_clock::now();
+        while (enviados - respondidos < janela && enviados < operacoes) {
+            enviadoEm[static_cast<size_t>(enviados % janela)] = agora;
+            envio.push_back(gerador.proximo(static_cast<uint32_t>(enviados)));
+            ++enviados;
+        }
+        if (!envio.empty()) {
+            if (!escreverTudo(fd, envio.data(), envio.size() * sizeof(PedidoRede))) break;
+            resultado.escritas++;
+        }
+
+        ssize_t n = ::read(fd, recebidos.data() + pendentes, recebidos.size() - pendentes);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        resultado.leituras++;
+        agora = std::chrono::steady_clock::now();
+        size_t disponiveis = pendentes + static_cast<size_t>(n);
+        size_t completas = disponiveis / sizeof(RespostaRede);
+        for (size_t i = 0; i < completas; ++i) {
+            RespostaRede resposta;
+            std::memcpy(&resposta, recebidos.data() + i * sizeof(RespostaRede), sizeof(resposta));
+            resultado.contar(resposta.status);
+            resultado.latencia.registrar(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    agora - enviadoEm[resposta.sequencia % static_cast<uint32_t>(janela)]).count()));
+            ++respondidos;
+        }
+        pendentes = disponiveis - completas * sizeof(RespostaRede);
+        std::memmove(recebidos.data(), recebidos.data() + completas * sizeof(RespostaRede), pendentes);
+    }
+    resultado.duracaoNs = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - inicio).count());
+    ::close(fd);
+    return resultado;
+}
+
+/*
+ * CLIENTE DE CARGA COM VÁRIOS PROCESSOS:
+ * Cria 'processos' filhos com fork (chamado antes de qualquer thread de
+ * trabalho existir); cada filho roda um cliente e devolve o resultado por
+ * um pipe. A semente de cada processo é derivada do número do processo.
+ */
+inline ResultadoCliente executarClientesCarga(const std::string& caminho, int processos, int operacoes,
+                                              int janela, const MixOperacoes& mix, ConfigCarga carga) {
+    if (carga.semente == 0) carga.semente = std::random_device{}() | 1;
+    std::vector<std::pair<pid_t, int>> filhos;
+    for (int p = 0; p < processos; ++p) {
+        int canal[2];
+        if (::pipe(canal) < 0) break;
+        pid_t pid = ::fork();
+        if (pid == 0) {
+            ::close(canal[0]);
+            ResultadoCliente r = executarClienteSocket(caminho, operacoes, janela, mix, carga,
+                                                       static_cast<uint64_t>(p));
+            escreverTudo(canal[1], &r, sizeof(r));
+            ::_exit(0);
+        }
+        ::close(canal[1]);
+        if (pid < 0) {
+            ::close(canal[0]);
+            break;
+        }
+        filhos.emplace_back(pid, canal[0]);
+    }
+
+    ResultadoCliente total;
+    for (auto [pid, canal] : filhos) {
+        ResultadoCliente r;
+        if (lerTudo(canal, &r, sizeof(r))) total.juntar(r);
+        ::close(canal);
+        ::waitpid(pid, nullptr, 0);
+    }
+    return total;
+}
+
+#endif  // BANCO_SERVIDOR_HPP
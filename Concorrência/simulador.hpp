@@ -0,0 +1,1681 @@
+/*
+ * SIMULAÇÃO
+ * Mix e gerador de carga, clientes em corrotinas, simulador de operações,
+ * logger das simulações, varredura, telemetria e pool de trabalho
+ */
+#ifndef BANCO_SIMULADOR_HPP
+#define BANCO_SIMULADOR_HPP
+
+#include "banco.hpp"
+
+// ===================================
+// Mix de operações do simulador
+// ===================================
+/*
+ * PESOS RELATIVOS DE CADA TIPO DE OPERAÇÃO:
+ * - padrao: 1/3 crédito, 1/3 débito, 1/3 consulta (comportamento original)
+ * - transferencias: carga dominada por transferências e lotes,
+ *   usada para medir abortos e espera por locks em pares de contas
+ * - leitura: 95% consultas, 5% escritas (carga de leitura intensa)
+ * - escrita: 90% créditos/débitos, 10% consultas
+ * - rotatividade: carga padrão com 10% de aberturas e encerramentos de
+ *   contas (9 aberturas para cada encerramento: ~90% das contas abertas)
+ * - Pesos livres no formato C:D:Q:T:L (crédito, débito, consulta,
+ *   transferência, lote), por exemplo 1:1:8:0:0, ou C:D:Q:T:L:A:E com
+ *   aberturas e encerramentos
+ *
+ * A abertura usa o ID sorteado (falha se a conta já está aberta) e o
+ * encerramento fecha a conta sorteada: com rotatividade, parte das
+ * buscas cai em contas fechadas e falha.
+ */
+struct MixOperacoes {
+    std::string nome;
+    double credito;
+    double debito;
+    double consulta;
+    double transferencia;
+    double lote;
+    double abertura = 0;
+    double encerramento = 0;
+
+    bool temRotatividade() const { return abertura > 0 || encerramento > 0; }
+
+    static MixOperacoes padrao() { return {"padrao", 1, 1, 1, 0, 0}; }
+    static MixOperacoes transferencias() { return {"transferencias", 1, 1, 2, 5, 1}; }
+    static MixOperacoes leitura() { return {"leitura", 2.5, 2.5, 95, 0, 0}; }
+    static MixOperacoes escrita() { return {"escrita", 45, 45, 10, 0, 0}; }
+    static MixOperacoes rotatividade() { return {"rotatividade", 30, 30, 30, 0, 0, 9, 1}; }
+};
+
+inline bool interpretarMix(const std::string& texto, MixOperacoes& mix) {
+    if (texto == "padrao") mix = MixOperacoes::padrao();
+    else if (texto == "transferencias") mix = MixOperacoes::transferencias();
+    else if (texto == "leitura") mix = MixOperacoes::leitura();
+    else if (texto == "escrita") mix = MixOperacoes::escrita();
+    else if (texto == "rotatividade") mix = MixOperacoes::rotatividade();
+    else {
+        // Pesos livres: C:D:Q:T:L ou C:D:Q:T:L:A:E
+        double pesos[7] = {};
+        int campos = static_cast<int>(std::count(texto.begin(), texto.end(), ':')) + 1;
+        if (campos != 5 && campos != 7) return false;
+        size_t inicio = 0;
+        for (int i = 0; i < campos; ++i) {
+            size_t fim = texto.find(':', inicio);
+            try {
+                size_t usados = 0;
+                std::string campo = texto.substr(inicio, fim - inicio);
+                pesos[i] = std::stod(campo, &usados);
+                if (usados != campo.size() || pesos[i] < 0) return false;
+            } catch (const std::exception&) {
+                return false;
+            }
+            inicio = fim + 1;
+        }
+        if (pesos[0] + pesos[1] + pesos[2] + pesos[3] + pesos[4] + pesos[5] + pesos[6] <= 0) return false;
+        mix = {texto, pesos[0], pesos[1], pesos[2], pesos[3], pesos[4], pesos[5], pesos[6]};
+    }
+    return true;
+}
+
+// ===================================
+// Gerador de carga (seleção de contas e sementes)
+// ===================================
+/*
+ * DISTRIBUIÇÃO DE ACESSO ÀS CONTAS:
+ * - UNIFORME: todas as contas com a mesma probabilidade
+ * - ZIPF: a k-ésima conta mais popular é sorteada com peso 1/k^theta
+ * - HOTSPOT: uma fração pequena das contas recebe a maior parte dos acessos
+ *
+ * A popularidade não segue a ordem do arquivo: as contas são embaralhadas
+ * com a semente, então as contas "quentes" variam de uma semente para outra
+ * mas são as mesmas para a mesma semente.
+ */
+enum class DistribuicaoContas { UNIFORME, ZIPF, HOTSPOT };
+
+struct ConfigCarga {
+    DistribuicaoContas distribuicao = DistribuicaoContas::UNIFORME;
+    double theta = 0.99;                // Expoente do Zipf (0 < theta < 1)
+    double fracaoQuente = 0.01;         // Fração das contas no conjunto quente
+    double probabilidadeQuente = 0.9;   // Probabilidade de acessar o conjunto quente
+    uint64_t semente = 0;               // 0 = sorteada no início de cada simulação
+
+    std::string descricao() const {
+        std::ostringstream texto;
+        switch (distribuicao) {
+            case DistribuicaoContas::UNIFORME: texto << "uniforme"; break;
+            case DistribuicaoContas::ZIPF: texto << "zipf:" << theta; break;
+            case DistribuicaoContas::HOTSPOT:
+                texto << "hotspot:" << fracaoQuente << ":" << probabilidadeQuente;
+                break;
+        }
+        return texto.str();
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --distribuicao:
+ * "uniforme", "zipf[:THETA]" ou "hotspot[:FRACAO:PROBABILIDADE]"
+ */
+inline bool interpretarDistribuicao(const std::string& texto, ConfigCarga& config) {
+    ConfigCarga nova = config;
+    try {
+        if (texto == "uniforme") {
+            nova.distribuicao = DistribuicaoContas::UNIFORME;
+        } else if (texto.rfind("zipf", 0) == 0) {
+            nova.distribuicao = DistribuicaoContas::ZIPF;
+            if (texto.size() > 4) {
+                if (texto[4] != ':') return false;
+                nova.theta = std::stod(texto.substr(5));
+            }
+            if (!(nova.theta > 0 && nova.theta < 1)) return false;
+        } else if (texto.rfind("hotspot", 0) == 0) {
+            nova.distribuicao = DistribuicaoContas::HOTSPOT;
+            if (texto.size() > 7) {
+                if (texto[7] != ':') return false;
+                std::string resto = texto.substr(8);
+                size_t separador = resto.find(':');
+                if (separador == std::string::npos) return false;
+                nova.fracaoQuente = std::stod(resto.substr(0, separador));
+                nova.probabilidadeQuente = std::stod(resto.substr(separador + 1));
+            }
+            if (!(nova.fracaoQuente > 0 && nova.fracaoQuente <= 1)) return false;
+            if (!(nova.probabilidadeQuente >= 0 && nova.probabilidadeQuente <= 1)) return false;
+        } else {
+            return false;
+        }
+    } catch (const std::exception&) {
+        return false;
+    }
+    config = nova;
+    return true;
+}
+
+/*
+ * MODO DE CHEGADA DAS OPERAÇÕES:
+ * - FECHADO: cada worker só envia a próxima operação depois da anterior
+ *   (mais 1 ms de pausa); a taxa se ajusta sozinha à velocidade do banco
+ * - CONSTANTE: operações chegam a intervalos fixos de 1/taxa
+ * - POISSON: intervalos exponenciais com média 1/taxa (chegadas independentes)
+ */
+enum class ModoChegada { FECHADO, CONSTANTE, POISSON };
+
+struct ConfigChegada {
+    ModoChegada modo = ModoChegada::FECHADO;
+    double taxa = 0;                    // Operações por segundo (ciclo aberto)
+
+    bool aberto() const { return modo != ModoChegada::FECHADO; }
+
+    std::string descricao() const {
+        if (!aberto()) return "fechado";
+        std::ostringstream texto;
+        texto << (modo == ModoChegada::POISSON ? "poisson:" : "constante:") << taxa;
+        return texto.str();
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --chegada:
+ * "fechado", "constante:TAXA" ou "poisson:TAXA" (TAXA em operações/s)
+ */
+inline bool interpretarChegada(const std::string& texto, ConfigChegada& config) {
+    if (texto == "fechado") {
+        config = ConfigChegada();
+        return true;
+    }
+    size_t separador = texto.find(':');
+    if (separador == std::string::npos) return false;
+    std::string modo = texto.substr(0, separador);
+    ConfigChegada nova;
+    if (modo == "constante") nova.modo = ModoChegada::CONSTANTE;
+    else if (modo == "poisson") nova.modo = ModoChegada::POISSON;
+    else return false;
+    try {
+        size_t usados = 0;
+        std::string valor = texto.substr(separador + 1);
+        nova.taxa = std::stod(valor, &usados);
+        if (usados != valor.size() || !(nova.taxa > 0)) return false;
+    } catch (const std::exception&) {
+        return false;
+    }
+    config = nova;
+    return true;
+}
+
+/*
+ * DERIVAÇÃO DE SEMENTES (splitmix64):
+ * Gera sementes independentes para cada fluxo a partir da semente da simulação
+ */
+inline uint64_t derivarSemente(uint64_t semente, uint64_t fluxo) {
+    uint64_t z = semente + 0x9E3779B97F4A7C15ULL * (fluxo + 1);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/*
+ * MODELO DE CARGA:
+ * Parte imutável e compartilhada entre as threads: contas na ordem de
+ * popularidade, pesos do mix e as constantes do Zipf (calculadas uma vez)
+ */
+class ModeloCarga {
+private:
+    std::vector<std::string> contas;    // Índice 0 = conta mais popular
+    MixOperacoes mix;
+    ConfigCarga config;
+
+    // Constantes do gerador Zipf de Gray et al. (o mesmo usado pelo YCSB)
+    double zetaN = 0, alfa = 0, eta = 0, limiteSegundo = 0;
+    size_t tamanhoQuente = 0;
+
+public:
+    ModeloCarga(std::vector<std::string> ids, const MixOperacoes& m, const ConfigCarga& c)
+        : contas(std::move(ids)), mix(m), config(c) {
+        std::sort(contas.begin(), contas.end());   // Independe da ordem do mapa
+        std::mt19937_64 embaralhador(derivarSemente(config.semente, ~0ULL));
+        std::shuffle(contas.begin(), contas.end(), embaralhador);
+
+        size_t n = contas.size();
+        if (config.distribuicao == DistribuicaoContas::ZIPF && n > 1) {
+            double zeta2 = 1 + std::pow(0.5, config.theta);
+            for (size_t i = 1; i <= n; ++i) zetaN += std::pow(static_cast<double>(i), -config.theta);
+            alfa = 1.0 / (1.0 - config.theta);
+            eta = (1 - std::pow(2.0 / n, 1 - config.theta)) / (1 - zeta2 / zetaN);
+            limiteSegundo = 1 + std::pow(0.5, config.theta);
+        }
+        if (config.distribuicao == DistribuicaoContas::HOTSPOT) {
+            tamanhoQuente = std::max<size_t>(1, static_cast<size_t>(n * config.fracaoQuente));
+            tamanhoQuente = std::min(tamanhoQuente, n);
+        }
+    }
+
+    const std::vector<std::string>& getContas() const { return contas; }
+    const MixOperacoes& getMix() const { return mix; }
+
+    /*
+     * SORTEIO DE UMA POSIÇÃO (0 = mais popular):
+     * u é um número uniforme em [0, 1) e v outro, usado só pelo hotspot
+     */
+    size_t posicao(double u, double v) const {
+        size_t n = contas.size();
+        switch (config.distribuicao) {
+            case DistribuicaoContas::ZIPF: {
+                if (n < 2) return 0;
+                double uz = u * zetaN;
+                if (uz < 1) return 0;
+                if (uz < limiteSegundo) return 1;
+                size_t k = static_cast<size_t>(n * std::pow(eta * u - eta + 1, alfa));
+                return std::min(k, n - 1);
+            }
+            case DistribuicaoContas::HOTSPOT: {
+                if (v < config.probabilidadeQuente || tamanhoQuente == n) {
+                    return std::min(static_cast<size_t>(u * tamanhoQuente), tamanhoQuente - 1);
+                }
+                size_t frias = n - tamanhoQuente;
+                return tamanhoQuente + std::min(static_cast<size_t>(u * frias), frias - 1);
+            }
+            default:
+                return std::min(static_cast<size_t>(u * n), n - 1);
+        }
+    }
+};
+
+/*
+ * GERADOR DE CARGA POR FLUXO:
+ * Cada fluxo (thread ou bloco de operações) tem o seu próprio gerador e
+ * distribuições, então nada é compartilhado entre threads. A semente do
+ * fluxo depende só da semente da simulação e do número do fluxo: a mesma
+ * semente reproduz a mesma sequência de operações.
+ */
+class GeradorCarga {
+private:
+    const ModeloCarga& modelo;
+    uint64_t sementeBase;
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<> uniforme{0.0, 1.0};
+    std::discrete_distribution<> operacaoDist;
+    std::uniform_real_distribution<> valorDist{10.0, 500.0};    // Valores entre R$ 10 e R$ 500
+
+    /*
+     * 0=crédito, 1=débito, 2=consulta, 3=transferência, 4=lote, 5=abertura,
+     * 6=encerramento. Sem rotatividade ficam só os cinco primeiros: pesos
+     * zero no fim mudariam (raramente) o sorteio das sementes antigas
+     */
+    static std::discrete_distribution<> distribuicaoOperacoes(const MixOperacoes& mix) {
+        std::vector<double> pesos = {mix.credito, mix.debito, mix.consulta, mix.transferencia, mix.lote};
+        if (mix.temRotatividade()) {
+            pesos.push_back(mix.abertura);
+            pesos.push_back(mix.encerramento);
+        }
+        return std::discrete_distribution<>(pesos.begin(), pesos.end());
+    }
+
+public:
+    GeradorCarga(const ModeloCarga& m, uint64_t semente, uint64_t fluxo)
+        : modelo(m), sementeBase(semente), rng(derivarSemente(semente, fluxo)),
+          operacaoDist(distribuicaoOperacoes(m.getMix())) {}
+
+    // Passa a gerar a sequência de outro fluxo (ex.: uma operação da agenda)
+    void reposicionar(uint64_t fluxo) { rng.seed(derivarSemente(sementeBase, fluxo)); }
+
+    // Posição da conta sorteada em modelo.getContas() (0 = mais popular)
+    size_t proximaPosicao() {
+        double u = uniforme(rng);
+        double v = uniforme(rng);
+        return modelo.posicao(u, v);
+    }
+
+    const std::string& proximaConta() { return modelo.getContas()[proximaPosicao()]; }
+
+    // Sorteia uma posição diferente de 'excluida' (exige ao menos duas contas)
+    size_t outraPosicao(size_t excluida) {
+        while (true) {
+            size_t posicao = proximaPosicao();
+            if (posicao != excluida) return posicao;
+        }
+    }
+
+    // Sorteia uma conta diferente de 'excluida' (exige ao menos duas contas)
+    const std::string& outraConta(const std::string& excluida) {
+        while (true) {
+            const std::string& id = proximaConta();
+            if (id != excluida) return id;
+        }
+    }
+
+    int proximaOperacao() { return operacaoDist(rng); }
+    double proximoValor() { return valorDist(rng); }
+};
+
+#if BANCO_CORROTINAS
+// ===================================
+// Clientes em corrotinas (C++20)
+// ===================================
+/*
+ * TAREFA DE UM CLIENTE:
+ * Corrotina que começa suspensa (o escalonador decide quando roda) e
+ * continua suspensa ao terminar (o escalonador vê done() e destrói o
+ * quadro depois). Os bytes dos quadros são somados para mostrar o custo
+ * de memória de cada cliente.
+ */
+struct TarefaCliente {
+    struct promise_type {
+        TarefaCliente get_return_object() {
+            return {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t tamanho) {
+            bytesQuadros().fetch_add(tamanho, std::memory_order_relaxed);
+            return ::operator new(tamanho);
+        }
+        static void operator delete(void* quadro) { ::operator delete(quadro); }
+    };
+
+    static std::atomic<size_t>& bytesQuadros() {
+        static std::atomic<size_t> bytes{0};
+        return bytes;
+    }
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+/*
+ * ESCALONADOR DE CLIENTES:
+ * - Cada cliente fica preso a um worker (cliente % workers) do começo ao
+ *   fim, então as filas de um worker só são tocadas pela thread dele
+ * - O worker roda o próximo cliente pronto até ele suspender: na pausa
+ *   entre operações o cliente vai para um heap ordenado pelo instante de
+ *   volta; esperando o commit do WAL, para uma fila ordenada por LSN
+ * - A cada volta o worker acorda os clientes cujo instante passou e os
+ *   cujo LSN já é durável. Sem cliente pronto, dorme até o próximo
+ *   instante ou, havendo espera no WAL, até o próximo commit
+ * As operações continuam síncronas: locks, admissão e o tempo de
+ * serviço das etapas dentro do banco ainda ocupam o worker.
+ */
+class EscalonadorClientes {
+private:
+    using Instante = std::chrono::steady_clock::time_point;
+
+    struct Pensando {
+        Instante volta;
+        std::coroutine_handle<> cliente;
+        bool operator>(const Pensando& outro) const { return volta > outro.volta; }
+    };
+
+    struct EsperandoCommit {
+        uint64_t lsn;
+        std::coroutine_handle<> cliente;
+    };
+
+    struct alignas(TAMANHO_LINHA_CACHE) Worker {
+        std::deque<std::coroutine_handle<>> prontos;
+        std::priority_queue<Pensando, std::vector<Pensando>, std::greater<Pensando>> pensando;
+        std::deque<EsperandoCommit> esperandoCommit;    // LSN crescente: o worker anexa em ordem
+        std::vector<std::coroutine_handle<>> clientes;
+        size_t vivos = 0;
+        long long suspensoesPausa = 0;
+        long long suspensoesCommit = 0;
+        HistogramaLatencia resposta;                    // Operação + espera do commit
+    };
+
+    WriteAheadLog* wal;
+    std::vector<std::unique_ptr<Worker>> workers;
+    size_t numClientes = 0;
+
+    static Worker*& workerAtual() {
+        thread_local Worker* worker = nullptr;
+        return worker;
+    }
+
+    void acordar(Worker& w) {
+        if (!w.pensando.empty()) {
+            Instante agora = std::chrono::steady_clock::now();
+            while (!w.pensando.empty() && w.pensando.top().volta <= agora) {
+                w.prontos.push_back(w.pensando.top().cliente);
+                w.pensando.pop();
+            }
+        }
+        if (!w.esperandoCommit.empty()) {
+            // WAL parado: todos seguem (e o Commit de cada um retorna false)
+            uint64_t duravel = wal->falhou() ? UINT64_MAX : wal->getLsnDuravel();
+            while (!w.esperandoCommit.empty() && w.esperandoCommit.front().lsn <= duravel) {
+                w.prontos.push_back(w.esperandoCommit.front().cliente);
+                w.esperandoCommit.pop_front();
+            }
+        }
+    }
+
+public:
+    // co_await pausa(ns): o cliente "pensa" sem ocupar o worker
+    struct Pausa {
+        uint64_t ns;
+        bool await_ready() const noexcept { return ns == 0; }
+        void await_suspend(std::coroutine_handle<> cliente) const {
+            Worker* w = workerAtual();
+            w->pensando.push({std::chrono::steady_clock::now() + std::chrono::nanoseconds(ns), cliente});
+            w->suspensoesPausa++;
+        }
+        void await_resume() const noexcept {}
+    };
+
+    /*
+     * co_await commit(lsn): o cliente só segue com a operação durável ou
+     * com o WAL parado; o resultado diz qual (false = não confirmar)
+     */
+    struct Commit {
+        WriteAheadLog* wal;
+        uint64_t lsn;
+        bool duravel() const noexcept { return !wal || lsn == 0 || wal->getLsnDuravel() >= lsn; }
+        bool await_ready() const noexcept { return duravel() || wal->falhou(); }
+        void await_suspend(std::coroutine_handle<> cliente) const {
+            Worker* w = workerAtual();
+            w->esperandoCommit.push_back({lsn, cliente});
+            w->suspensoesCommit++;
+        }
+        bool await_resume() const noexcept { return duravel(); }
+    };
+
+    struct Resultado {
+        long long suspensoesPausa = 0;
+        long long suspensoesCommit = 0;
+        HistogramaLatencia resposta;
+    };
+
+    EscalonadorClientes(unsigned numWorkers, WriteAheadLog* w) : wal(w) {
+        for (unsigned i = 0; i < std::max(1u, numWorkers); ++i) workers.push_back(std::make_unique<Worker>());
+    }
+
+    ~EscalonadorClientes() {
+        for (auto& w : workers) {
+            for (std::coroutine_handle<> cliente : w->clientes) cliente.destroy();
+        }
+    }
+
+    EscalonadorClientes(const EscalonadorClientes&) = delete;
+    EscalonadorClientes& operator=(const EscalonadorClientes&) = delete;
+
+    unsigned getNumWorkers() const { return static_cast<unsigned>(workers.size()); }
+
+    // Worker ao qual o próximo cliente adicionado ficará preso
+    unsigned proximoWorker() const { return static_cast<unsigned>(numClientes % workers.size()); }
+
+    void adicionar(TarefaCliente tarefa) {
+        Worker& w = *workers[proximoWorker()];
+        numClientes++;
+        w.clientes.push_back(tarefa.handle);
+        w.prontos.push_back(tarefa.handle);
+        w.vivos++;
+    }
+
+    static Pausa pausa(uint64_t ns) { return {ns}; }
+    Commit commit(uint64_t lsn) const { return {wal, lsn}; }
+
+    // Chamado pelo cliente, na thread do seu worker
+    static void registrarResposta(Instante inicio) {
+        workerAtual()->resposta.registrar(static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - inicio).count()));
+    }
+
+    /*
+     * LAÇO DO WORKER i (uma tarefa do pool por worker):
+     * Liga a espera adiada do WAL nesta thread; se o WAL falhar, os
+     * clientes esperando commit são liberados e cada um conta a sua
+     * operação como falha
+     */
+    void executarWorker(unsigned i) {
+        Worker& w = *workers[i];
+        workerAtual() = &w;
+        WriteAheadLog::EsperaAdiada& adiada = WriteAheadLog::esperaAdiadaDaThread();
+        adiada.ativa = wal != nullptr;
+        while (w.vivos > 0) {
+            acordar(w);
+            if (w.prontos.empty()) {
+                if (!w.esperandoCommit.empty()) {
+                    if (!wal->aguardarDuravel(w.esperandoCommit.front().lsn)) {
+                        for (const EsperandoCommit& e : w.esperandoCommit) w.prontos.push_back(e.cliente);
+                        w.esperandoCommit.clear();
+                    }
+                } else if (!w.pensando.empty()) {
+                    std::this_thread::sleep_until(w.pensando.top().volta);
+                }
+                continue;
+            }
+            std::coroutine_handle<> cliente = w.prontos.front();
+            w.prontos.pop_front();
+            cliente.resume();
+            if (cliente.done()) w.vivos--;
+        }
+        adiada = WriteAheadLog::EsperaAdiada{};
+        workerAtual() = nullptr;
+    }
+
+    Resultado resultado() const {
+        Resultado r;
+        for (const auto& w : workers) {
+            r.suspensoesPausa += w->suspensoesPausa;
+            r.suspensoesCommit += w->suspensoesCommit;
+            r.resposta.juntar(w->resposta);
+        }
+        return r;
+    }
+};
+#endif
+
+// ===================================
+// Classe Simulador de Operações
+// ===================================
+template <typename Conta>
+class SimuladorOperacoes {
+private:
+    Banco<Conta>& banco;                             // Referência ao banco
+    uint64_t semente;                               // Semente da simulação (reprodutibilidade)
+    ModeloCarga modelo;                             // Contas, mix e distribuição de acesso
+    std::atomic<bool> executando{true};             // Flag para parar execução
+
+    static constexpr int TAMANHO_LOTE = 4;          // Operações por lote sorteado
+#if BANCO_CORROTINAS
+    std::vector<std::unique_ptr<GeradorCarga>> geradoresClientes;   // Um por worker do escalonador
+#endif
+
+    /*
+     * ESTADO DO CICLO ABERTO:
+     * Instantes planejados (relativos ao início), próxima operação a
+     * despachar e latência de resposta medida desde o instante planejado
+     */
+    std::vector<long long> agendaNs;
+    std::atomic<size_t> proximaAgendada{0};
+    std::chrono::steady_clock::time_point inicioAgenda;
+    std::mutex respostaMutex;
+    HistogramaLatencia resposta;
+
+    /*
+     * UMA OPERAÇÃO SORTEADA:
+     * Conta, tipo e valor vêm do gerador; atualiza os contadores do banco
+     */
+    StatusOperacao executarUmaOperacao(GeradorCarga& gerador) {
+        /*
+         * SELEÇÃO DE CONTA:
+         * Segue a distribuição de acesso configurada (uniforme, zipf, hotspot).
+         * A Leitura cobre a operação inteira: uma conta encerrada no meio
+         * dela só é finalizada depois
+         */
+        auto leitura = banco.protegerLeitura();
+        const std::string& contaId = gerador.proximaConta();
+        Conta* conta = banco.obterConta(contaId);
+        
+        if (!conta && !modelo.getMix().temRotatividade()) return StatusOperacao::FALHA;
+
+        /*
+         * SELEÇÃO ALEATÓRIA DE OPERAÇÃO:
+         * 0 = crédito, 1 = débito, 2 = consulta, 3 = transferência, 4 = lote,
+         * 5 = abertura, 6 = encerramento (só com rotatividade no mix)
+         */
+        int operacao = gerador.proximaOperacao();
+        double valor = gerador.proximoValor();
+        StatusOperacao status = StatusOperacao::FALHA;
+        double saldo = 0;
+
+        if (operacao == 5) {
+            status = banco.abrirConta(contaId, valor);
+        } else if (operacao == 6) {
+            status = banco.encerrarConta(contaId);
+        } else if (!conta) {
+            operacao = -1;                  // Conta fechada: a busca falhou
+        }
+
+        /*
+         * EXECUÇÃO DA OPERAÇÃO:
+         * Switch baseado no tipo de operação sorteado
+         */
+        switch (operacao) {
+            case 0: status = banco.creditar(conta, valor); break;
+            case 1: status = banco.debitar(conta, valor); break;
+            case 2: status = banco.consultarSaldo(conta, saldo); break;
+            case 3: {
+                // Destino sorteado entre as demais contas
+                if (modelo.getContas().size() < 2) break;
+                const std::string& destinoId = gerador.outraConta(contaId);
+                status = statusDe(banco.transferir(conta, banco.obterConta(destinoId), valor));
+                break;
+            }
+            case 4: {
+                // Lote atômico de transferências a partir da conta sorteada
+                if (modelo.getContas().size() < 2) break;
+                std::vector<OperacaoLote> lote;
+                for (int k = 0; k < TAMANHO_LOTE; ++k) {
+                    const std::string& destinoId = gerador.outraConta(contaId);
+                    lote.push_back({TipoOperacaoLote::TRANSFERENCIA, contaId, destinoId,
+                                    gerador.proximoValor() / TAMANHO_LOTE});
+                }
+                status = statusDe(banco.executarLote(lote));
+                break;
+            }
+            default: break;
+        }
+
+        return status;
+    }
+
+    /*
+     * ATUALIZAÇÃO DE ESTATÍSTICAS:
+     * Incrementa contador apropriado baseado no resultado
+     * (recusas da admissão já foram contadas pelo banco)
+     */
+    void contarResultado(StatusOperacao status) {
+        if (status == StatusOperacao::SUCESSO) banco.incrementarOperacoes();
+        else if (status == StatusOperacao::FALHA) banco.incrementarFalhas();
+    }
+
+    static uint64_t escolherSemente(uint64_t configurada) {
+        if (configurada != 0) return configurada;
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32) | rd();
+    }
+
+public:
+    /*
+     * CONSTRUTOR:
+     * Monta o modelo de carga; com semente 0 uma semente nova é sorteada
+     * (e fica disponível em getSemente() para repetir a execução)
+     */
+    SimuladorOperacoes(Banco<Conta>& b, const MixOperacoes& mix = MixOperacoes::padrao(),
+                       const ConfigCarga& carga = ConfigCarga())
+        : banco(b),
+          semente(escolherSemente(carga.semente)),
+          modelo(mix.temRotatividade() ? b.listarContasConhecidas() : b.listarContas(), mix, [&] { ConfigCarga c = carga; c.semente = semente; return c; }()) {}
+
+    uint64_t getSemente() const { return semente; }
+
+    /*
+     * EXECUÇÃO DE OPERAÇÕES POR THREAD:
+     * Cada thread executa um número determinado de operações aleatórias
+     */
+    void executarOperacoes(int threadId, int numOperacoes) {
+        executarBloco(static_cast<uint64_t>(threadId), numOperacoes);
+        std::cout << "Thread " << threadId << " finalizou suas operações.\n";
+    }
+
+    /*
+     * EXECUÇÃO DE UM BLOCO DE OPERAÇÕES (CICLO FECHADO):
+     * Unidade de trabalho submetida ao pool; pode rodar em qualquer worker.
+     * O fluxo identifica o bloco: a sequência sorteada não depende de qual
+     * worker executou o bloco. Cada operação só começa depois que a
+     * anterior terminou (mais a pausa do modelo de serviço).
+     */
+    void executarBloco(uint64_t fluxo, int numOperacoes) {
+        if (modelo.getContas().empty()) return;
+
+        GeradorCarga gerador(modelo, semente, fluxo);
+
+        /*
+         * LOOP PRINCIPAL DE OPERAÇÕES:
+         * Cada thread executa o número especificado de operações
+         */
+        for (int i = 0; i < numOperacoes && executando; ++i) {
+            contarResultado(executarUmaOperacao(gerador));
+
+            /*
+             * PAUSA ENTRE OPERAÇÕES:
+             * Simula tempo de processamento entre operações
+             */
+            ModeloServico::instancia().executar(EtapaServico::PAUSA);
+        }
+    }
+
+#if BANCO_CORROTINAS
+    /*
+     * CLIENTE EM CORROTINA:
+     * Mesmo laço de executarBloco, mas a espera pelo commit do WAL e a
+     * pausa entre operações suspendem o cliente em vez de parar a thread.
+     * A operação i do cliente c usa o fluxo c * numOperacoes + i: a carga
+     * não depende de como o escalonador intercala os clientes. O gerador
+     * é do worker (só é usado entre duas suspensões), o que deixa o
+     * quadro do cliente com poucas dezenas de bytes.
+     */
+    TarefaCliente executarCliente(EscalonadorClientes& escalonador, GeradorCarga& gerador,
+                                  uint64_t cliente, int numOperacoes) {
+        for (int i = 0; i < numOperacoes && executando; ++i) {
+            gerador.reposicionar(cliente * static_cast<uint64_t>(numOperacoes) + static_cast<uint64_t>(i));
+            auto inicio = std::chrono::steady_clock::now();
+            StatusOperacao status = executarUmaOperacao(gerador);
+            // Só conta como sucesso com o commit: o WAL pode falhar enquanto o cliente espera
+            bool duravel = co_await escalonador.commit(WriteAheadLog::retirarLsnAdiado());
+            contarResultado(duravel ? status : StatusOperacao::FALHA);
+            EscalonadorClientes::registrarResposta(inicio);
+            co_await EscalonadorClientes::pausa(ModeloServico::instancia().amostrarNs(EtapaServico::PAUSA));
+        }
+    }
+
+    // Cria numClientes clientes, distribuídos entre os workers do escalonador
+    void criarClientes(EscalonadorClientes& escalonador, size_t numClientes, int numOperacoes) {
+        geradoresClientes.clear();
+        for (unsigned w = 0; w < escalonador.getNumWorkers(); ++w) {
+            geradoresClientes.push_back(std::make_unique<GeradorCarga>(modelo, semente, w));
+        }
+        if (modelo.getContas().empty()) return;
+        for (size_t c = 0; c < numClientes; ++c) {
+            GeradorCarga& gerador = *geradoresClientes[escalonador.proximoWorker()];
+            escalonador.adicionar(executarCliente(escalonador, gerador, c, numOperacoes));
+        }
+    }
+#endif
+
+    /*
+     * AGENDA DE CHEGADAS (CICLO ABERTO):
+     * Calcula o instante planejado de cada operação a partir da taxa alvo.
+     * A agenda não depende do andamento da execução: se o banco atrasar,
+     * as operações seguintes continuam marcadas para o mesmo instante e o
+     * atraso aparece como tempo de fila na latência (sem omissão coordenada).
+     */
+    void prepararAgenda(const ConfigChegada& chegada, size_t totalOperacoes) {
+        agendaNs.assign(totalOperacoes, 0);
+        std::mt19937_64 rng(derivarSemente(semente, ~1ULL));
+        std::exponential_distribution<> intervalo(chegada.taxa);
+        double instante = 0;                 // Em segundos
+        for (size_t i = 0; i < totalOperacoes; ++i) {
+            agendaNs[i] = static_cast<long long>(instante * 1e9);
+            instante += chegada.modo == ModoChegada::POISSON ? intervalo(rng) : 1.0 / chegada.taxa;
+        }
+        proximaAgendada.store(0);
+        resposta.zerar();
+    }
+
+    void iniciarAgenda() { inicioAgenda = std::chrono::steady_clock::now(); }
+
+    /*
+     * WORKER DE CICLO ABERTO:
+     * Pega a próxima operação da agenda, espera o instante planejado (se
+     * ainda não chegou) e executa. A latência de resposta é medida desde o
+     * instante planejado, não desde o início efetivo.
+     */
+    void executarAgenda() {
+        if (modelo.getContas().empty()) return;
+
+        GeradorCarga gerador(modelo, semente, 0);
+        HistogramaLatencia respostaLocal;
+
+        while (executando) {
+            size_t i = proximaAgendada.fetch_add(1, std::memory_order_relaxed);
+            if (i >= agendaNs.size()) break;
+
+            auto planejado = inicioAgenda + std::chrono::nanoseconds(agendaNs[i]);
+            std::this_thread::sleep_until(planejado);
+
+            gerador.reposicionar(i);     // Mesma operação i para a mesma semente
+            contarResultado(executarUmaOperacao(gerador));
+
+            respostaLocal.registrar(static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - planejado).count()));
+        }
+
+        std::lock_guard<std::mutex> lock(respostaMutex);
+        resposta.juntar(respostaLocal);
+    }
+
+    // Chamar depois que os workers terminaram
+    const HistogramaLatencia& getResposta() const { return resposta; }
+
+    /*
+     * PARADA SEGURA:
+     * Sinaliza para todas as threads pararem
+     */
+    void pararExecucao() {
+        executando.store(false);
+    }
+};
+
+// ================================================================================================
+// CLASSE LOGGER PARA SIMULAÇÕES
+// ================================================================================================
+/*
+ * RESULTADO DE UMA SIMULAÇÃO:
+ * Agrupa as métricas que vão para uma linha do CSV
+ */
+struct ResultadoSimulacao {
+    std::string motor;              // Motor de contas usado (rwlock, atomico)
+    int numThreads = 0;
+    int operacoesPorThread = 0;
+    double tempoExecucao = 0;       // Em milissegundos (fração: sem sleeps uma rodada pode durar < 1 ms)
+    int operacoesSucesso = 0;
+    int operacoesFalhas = 0;
+    std::string mix;                // Mix de operações usado
+    int transferencias = 0;         // Transferências concluídas
+    int transferenciasAbortadas = 0;
+    int lotes = 0;                  // Lotes concluídos
+    int lotesAbortados = 0;
+    double esperaLockMs = 0;        // Espera por locks em transferências/lotes
+    std::string wal;                // Configuração do WAL (lote:latência ou desligado)
+    long long commitsWAL = 0;       // Quantidade de write+fdatasync
+    double registrosPorCommit = 0;  // Tamanho médio dos grupos de commit
+    double latenciaP99Us = 0;       // Latência p99 das operações
+    double latenciaP50Us = 0;       // Demais pontos da distribuição (todas as operações)
+    double latenciaP90Us = 0;
+    double latenciaP999Us = 0;
+    double latenciaMaxUs = 0;
+    std::array<double, NUM_TIPOS_OPERACAO> latenciaP99PorTipoUs{};   // p99 de cada tipo
+    std::vector<double> utilizacaoPorWorker;   // Fração do tempo ocupado de cada worker
+    long long tarefasRoubadas = 0;  // Blocos executados por um worker que não era o dono
+    std::string distribuicao;       // Distribuição de acesso às contas
+    uint64_t semente = 0;           // Semente que reproduz a carga
+    std::string chegada;            // fechado, constante:TAXA ou poisson:TAXA
+    double taxaAlvo = 0;            // ops/s planejadas (0 no ciclo fechado)
+    double taxaObtida = 0;          // ops/s efetivamente concluídas
+    double respostaP50Us = 0;       // Latência desde o instante planejado (ciclo aberto)
+    double respostaP99Us = 0;
+    double respostaP999Us = 0;
+    double respostaMaxUs = 0;
+    std::string servico;            // Modelo de tempo de serviço (etapa=modo:us;...)
+    std::string admissao;           // Controle de admissão (leitores:fila:timeout ou desligada)
+    int rejeicoesFila = 0;          // Recusadas por fila cheia (não contam como falha)
+    int rejeicoesTempo = 0;         // Recusadas por tempo esgotado na fila
+    double esperaFilaMs = 0;        // Espera total na fila de admissão
+    double filaP99Us = 0;           // p99 da espera na fila
+    std::string combinacao;         // Modo de combinação de escritas
+    int contasCombinando = 0;       // Contas em modo combinado ao final
+    long long lotesCombinados = 0;  // Seções críticas de combinadores
+    double pedidosPorLote = 0;      // Escritas aplicadas por seção crítica combinada
+    std::string auditoria;          // Intervalo do auditor de snapshots
+    int snapshots = 0;              // Snapshots tirados durante a simulação
+    int divergencias = 0;           // Snapshots cujo total não conferiu
+    double snapshotMedioUs = 0;     // Duração média de um snapshot
+    std::string arranjo;            // Layout das contas na memória
+    std::string trava;              // Política de trava das contas (cas no motor atômico)
+    std::string checkpoint;         // Intervalo do checkpoint em segundo plano
+    int checkpoints = 0;            // Checkpoints gravados (inclui o inicial e o final)
+    long long registrosCheckpoint = 0;  // Contas gravadas, somando todos os checkpoints
+    long long bytesCheckpoint = 0;  // Bytes escritos nos checkpoints (registros + cabeçalhos)
+    double checkpointP50Ms = 0;     // Duração mediana de um checkpoint (varredura + E/S + fdatasync)
+    double checkpointMaxMs = 0;
+    int clientes = 0;               // Clientes em corrotinas (0 = um cliente por thread)
+    double bytesPorCliente = 0;     // Quadro de uma corrotina cliente
+    std::string massa;              // Trabalho em massa concorrente (juros, tarifa, conciliação)
+    int passadasMassa = 0;          // Passadas completas sobre todas as contas
+    double passadaMediaMs = 0;
+    int divergenciasMassa = 0;      // Conciliações cujo total não conferiu
+    int aberturas = 0;              // Contas abertas durante a simulação (mix com rotatividade)
+    int encerramentos = 0;
+};
+
+/*
+ * Responsável por registrar os resultados das simulações em arquivo CSV
+ * para análise posterior de performance.
+ */
+class LoggerSimulacao {
+private:
+    std::mutex logMutex;        // Proteção para escrita no arquivo
+    std::string nomeArquivo;    // Nome do arquivo de log
+    bool headerEscrito;         // Flag para controle do cabeçalho
+    std::ofstream arquivo;      // Aberto uma vez (append) e reaberto só por limparLogs
+
+    /*
+     * ABERTURA EM MODO APPEND:
+     * Adiciona ao final do arquivo sem sobrescrever; o cabeçalho já
+     * existe se o arquivo tem conteúdo (verificado só aqui)
+     */
+    void abrir(std::ios::openmode modo) {
+        if (arquivo.is_open()) arquivo.close();
+        std::ifstream teste(nomeArquivo, std::ios::ate);
+        headerEscrito = !(modo & std::ios::trunc) && teste.good() && teste.tellg() > 0;
+        teste.close();
+        arquivo.open(nomeArquivo, modo);
+    }
+
+public:
+    LoggerSimulacao(const std::string& arquivo) : nomeArquivo(arquivo), headerEscrito(false) {
+        abrir(std::ios::app);
+    }
+
+    /*
+     * REGISTRO DE LOG DE SIMULAÇÃO:
+     * Salva métricas da simulação em formato CSV
+     */
+    void registrarLogSimulacao(const ResultadoSimulacao& resultado) {
+        std::lock_guard<std::mutex> lock(logMutex);
+
+        int numThreads = resultado.numThreads;
+        int operacoesPorThread = resultado.operacoesPorThread;
+        double tempoExecucao = resultado.tempoExecucao;
+        int operacoesSucesso = resultado.operacoesSucesso;
+        int operacoesFalhas = resultado.operacoesFalhas;
+        
+        if (!arquivo.is_open()) {
+            std::cerr << "Erro ao abrir arquivo de log: " << nomeArquivo << std::endl;
+            return;
+        }
+        
+        /*
+         * ESCRITA DO CABEÇALHO:
+         * Apenas se o arquivo estava vazio ou não existia
+         * (inclusive depois de limparLogs)
+         */
+        if (!headerEscrito) {
+            headerEscrito = true;
+            arquivo << "NumThreads,OperacoesPorThread,TotalOperacoes,TempoExecucao_ms,"
+                   << "OperacoesSucesso,OperacoesFalhas,TaxaSucesso,Throughput_ops_ms,"
+                   << "Timestamp,Motor,Mix,Transferencias,TransferenciasAbortadas,"
+                   << "Lotes,LotesAbortados,EsperaLock_ms,WAL,CommitsWAL,RegistrosPorCommit,"
+                   << "LatenciaP99_us,UtilizacaoMin,UtilizacaoMedia,UtilizacaoMax,"
+                   << "TarefasRoubadas,UtilizacaoPorWorker,Distribuicao,Semente,"
+                   << "LatenciaP50_us,LatenciaP90_us,LatenciaP999_us,LatenciaMax_us";
+            for (size_t t = 0; t < NUM_TIPOS_OPERACAO; ++t) {
+                arquivo << ",P99" << nomeTipoLatencia(t) << "_us";
+            }
+            arquivo << ",Chegada,TaxaAlvo_ops_s,TaxaObtida_ops_s,"
+                    << "RespostaP50_us,RespostaP99_us,RespostaP999_us,RespostaMax_us,Servico,"
+                    << "Admissao,RejeicoesFila,RejeicoesTempo,EsperaFila_ms,FilaP99_us,"
+                    << "Combinacao,ContasCombinando,LotesCombinados,PedidosPorLote,"
+                    << "Auditoria,Snapshots,Divergencias,SnapshotMedio_us,Arranjo,Trava,"
+                    << "Checkpoint,Checkpoints,RegistrosCheckpoint,BytesCheckpoint,"
+                    << "CheckpointP50_ms,CheckpointMax_ms,Clientes,BytesPorCliente,"
+                    << "Massa,PassadasMassa,PassadaMedia_ms,DivergenciasMassa,Aberturas,Encerramentos\n";
+        }
+        
+        /*
+         * CÁLCULO DE MÉTRICAS DERIVADAS:
+         */
+        int totalOperacoes = (resultado.clientes > 0 ? resultado.clientes : numThreads) * operacoesPorThread;
+        double taxaSucesso = (totalOperacoes > 0) ? 
+                           (static_cast<double>(operacoesSucesso) / totalOperacoes) * 100 : 0;
+        double throughput = (tempoExecucao > 0) ? 
+                          static_cast<double>(operacoesSucesso) / tempoExecucao : 0;
+        
+        /*
+         * GERAÇÃO DE TIMESTAMP:
+         * Marca temporal para cada simulação
+         */
+        auto agora = std::chrono::system_clock::now();
+        auto tempo_t = std::chrono::system_clock::to_time_t(agora);
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&tempo_t), "%Y-%m-%d %H:%M:%S");
+        
+        /*
+         * ESCRITA DOS DADOS:
+         * Formato CSV com vírgula como separador
+         */
+        arquivo << numThreads << ","
+                << operacoesPorThread << ","
+                << totalOperacoes << ","
+                << std::fixed << std::setprecision(3) << tempoExecucao << ","
+                << operacoesSucesso << ","
+                << operacoesFalhas << ","
+                << std::fixed << std::setprecision(2) << taxaSucesso << ","
+                << std::fixed << std::setprecision(4) << throughput << ","
+                << ss.str() << ","
+                << resultado.motor << ","
+                << resultado.mix << ","
+                << resultado.transferencias << ","
+                << resultado.transferenciasAbortadas << ","
+                << resultado.lotes << ","
+                << resultado.lotesAbortados << ","
+                << std::fixed << std::setprecision(3) << resultado.esperaLockMs << ","
+                << resultado.wal << ","
+                << resultado.commitsWAL << ","
+                << std::fixed << std::setprecision(2) << resultado.registrosPorCommit << ","
+                << std::fixed << std::setprecision(1) << resultado.latenciaP99Us << ",";
+
+        /*
+         * UTILIZAÇÃO DOS WORKERS:
+         * Mínimo, média e máximo, seguidos da lista completa separada por ';'
+         */
+        const auto& utilizacao = resultado.utilizacaoPorWorker;
+        double minimo = 0, media = 0, maximo = 0;
+        if (!utilizacao.empty()) {
+            minimo = *std::min_element(utilizacao.begin(), utilizacao.end());
+            maximo = *std::max_element(utilizacao.begin(), utilizacao.end());
+            for (double u : utilizacao) media += u;
+            media /= utilizacao.size();
+        }
+        arquivo << std::fixed << std::setprecision(3) << minimo << ","
+                << media << "," << maximo << ","
+                << resultado.tarefasRoubadas << ",";
+        for (size_t i = 0; i < utilizacao.size(); ++i) {
+            arquivo << (i ? ";" : "") << std::setprecision(3) << utilizacao[i];
+        }
+        arquivo << "," << resultado.distribuicao << "," << resultado.semente;
+
+        /*
+         * CAUDA DA LATÊNCIA:
+         * p50/p90/p99.9/máximo de todas as operações e p99 de cada tipo
+         */
+        arquivo << std::fixed << std::setprecision(1)
+                << "," << resultado.latenciaP50Us << "," << resultado.latenciaP90Us
+                << "," << resultado.latenciaP999Us << "," << resultado.latenciaMaxUs;
+        for (double p99 : resultado.latenciaP99PorTipoUs) arquivo << "," << p99;
+
+        /*
+         * CICLO ABERTO:
+         * Taxas e latência de resposta (zeros no ciclo fechado)
+         */
+        arquivo << "," << resultado.chegada << "," << resultado.taxaAlvo << "," << resultado.taxaObtida
+                << "," << resultado.respostaP50Us << "," << resultado.respostaP99Us
+                << "," << resultado.respostaP999Us << "," << resultado.respostaMaxUs
+                << "," << resultado.servico;
+
+        /*
+         * CONTROLE DE ADMISSÃO:
+         * Recusas por carga ficam separadas das falhas de negócio
+         */
+        arquivo << "," << resultado.admissao << "," << resultado.rejeicoesFila
+                << "," << resultado.rejeicoesTempo << "," << std::setprecision(3)
+                << resultado.esperaFilaMs << "," << std::setprecision(1) << resultado.filaP99Us;
+
+        /*
+         * COMBINAÇÃO DE ESCRITAS
+         */
+        arquivo << "," << resultado.combinacao << "," << resultado.contasCombinando
+                << "," << resultado.lotesCombinados << "," << std::setprecision(2)
+                << resultado.pedidosPorLote;
+
+        /*
+         * AUDITORIA POR SNAPSHOTS
+         */
+        arquivo << "," << resultado.auditoria << "," << resultado.snapshots << ","
+                << resultado.divergencias << "," << std::setprecision(1)
+                << resultado.snapshotMedioUs << "," << resultado.arranjo << "," << resultado.trava;
+
+        /*
+         * CHECKPOINT EM SEGUNDO PLANO
+         */
+        arquivo << "," << resultado.checkpoint << "," << resultado.checkpoints << ","
+                << resultado.registrosCheckpoint << "," << resultado.bytesCheckpoint << ","
+                << std::setprecision(3) << resultado.checkpointP50Ms << "," << resultado.checkpointMaxMs;
+
+        /*
+         * CLIENTES EM CORROTINAS
+         */
+        arquivo << "," << resultado.clientes << "," << std::setprecision(0) << resultado.bytesPorCliente;
+
+        /*
+         * OPERAÇÕES EM MASSA CONCORRENTES
+         */
+        arquivo << "," << resultado.massa << "," << resultado.passadasMassa << "," << std::setprecision(3)
+                << resultado.passadaMediaMs << "," << resultado.divergenciasMassa;
+
+        /*
+         * ROTATIVIDADE DE CONTAS
+         */
+        arquivo << "," << resultado.aberturas << "," << resultado.encerramentos << "\n";
+        arquivo.flush();
+        
+        std::cout << "Log registrado: " << resultado.motor << ", " << numThreads << " threads, " 
+                  << tempoExecucao << "ms, " << operacoesSucesso << " sucessos, "
+                  << operacoesFalhas << " falhas" << std::endl;
+    }
+    
+    /*
+     * LIMPEZA DE LOGS:
+     * Remove o conteúdo do arquivo de log
+     */
+    void limparLogs() {
+        std::lock_guard<std::mutex> lock(logMutex);
+        abrir(std::ios::trunc);
+        std::cout << "Logs limpos do arquivo: " << nomeArquivo << std::endl;
+    }
+};
+
+// ===================================
+// Varredura de parâmetros (benchmark)
+// ===================================
+/*
+ * EIXOS DA VARREDURA:
+ * Cada combinação dos valores (produto cartesiano dos eixos) é uma
+ * configuração. Cada configuração roda 'aquecimento' rodadas descartadas
+ * e depois 'repeticoes' rodadas medidas, sempre sobre uma cópia nova das
+ * contas em memória: o arquivo de contas é lido uma vez e nunca alterado.
+ * O motor de contas (estratégia de lock) é o eixo dado por --motor.
+ */
+struct ConfigVarredura {
+    std::vector<int> threads = {1, 4, 16};
+    std::vector<size_t> contas = {0};               // 0 = contas do arquivo
+    std::vector<MixOperacoes> mixes = {MixOperacoes::leitura(), MixOperacoes::padrao(),
+                                       MixOperacoes::escrita()};
+    std::vector<ConfigCarga> distribuicoes;         // Padrão: uniforme e zipf:0.99
+    std::vector<int> operacoes = {1000};            // Operações por thread (duração da rodada)
+    int aquecimento = 1;                            // Rodadas descartadas por configuração
+    int repeticoes = 5;                             // Rodadas medidas por configuração
+
+    ConfigVarredura() {
+        ConfigCarga zipf;
+        interpretarDistribuicao("zipf:0.99", zipf);
+        distribuicoes = {ConfigCarga(), zipf};
+    }
+
+    size_t configuracoes(size_t motores) const {
+        return motores * threads.size() * contas.size() * mixes.size()
+             * distribuicoes.size() * operacoes.size();
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --varrer-EIXO=V1,V2,...:
+ * threads, contas (0 = arquivo), mix, distribuicao e ops (por thread)
+ * recebem listas; aquecimento e repeticoes recebem um único número
+ */
+inline bool interpretarEixoVarredura(const std::string& eixo, const std::string& lista, ConfigVarredura& config) {
+    std::vector<std::string> valores;
+    size_t inicio = 0;
+    while (true) {
+        size_t fim = lista.find(',', inicio);
+        valores.push_back(lista.substr(inicio, fim - inicio));
+        if (fim == std::string::npos) break;
+        inicio = fim + 1;
+    }
+    auto inteiro = [](const std::string& texto, long long minimo, long long& valor) {
+        try {
+            size_t usados = 0;
+            valor = std::stoll(texto, &usados);
+            return usados == texto.size() && valor >= minimo;
+        } catch (const std::exception&) {
+            return false;
+        }
+    };
+
+    ConfigVarredura nova = config;
+    long long n = 0;
+    if (eixo == "aquecimento" || eixo == "repeticoes") {
+        if (valores.size() != 1 || !inteiro(valores[0], eixo == "aquecimento" ? 0 : 1, n)) return false;
+        (eixo == "aquecimento" ? nova.aquecimento : nova.repeticoes) = static_cast<int>(n);
+    } else if (eixo == "threads" || eixo == "ops") {
+        std::vector<int>& destino = eixo == "threads" ? nova.threads : nova.operacoes;
+        destino.clear();
+        for (const std::string& v : valores) {
+            if (!inteiro(v, 1, n)) return false;
+            destino.push_back(static_cast<int>(n));
+        }
+    } else if (eixo == "contas") {
+        nova.contas.clear();
+        for (const std::string& v : valores) {
+            if (!inteiro(v, 0, n) || n == 1) return false;   // Transferências exigem duas contas
+            nova.contas.push_back(static_cast<size_t>(n));
+        }
+    } else if (eixo == "mix") {
+        nova.mixes.clear();
+        for (const std::string& v : valores) {
+            MixOperacoes mix;
+            if (!interpretarMix(v, mix)) return false;
+            nova.mixes.push_back(mix);
+        }
+    } else if (eixo == "distribuicao") {
+        nova.distribuicoes.clear();
+        for (const std::string& v : valores) {
+            ConfigCarga carga;
+            if (!interpretarDistribuicao(v, carga)) return false;
+            nova.distribuicoes.push_back(carga);
+        }
+    } else {
+        return false;
+    }
+    config = nova;
+    return true;
+}
+
+/*
+ * RESUMO DE UMA AMOSTRA:
+ * Média, desvio padrão amostral e meia largura do intervalo de 95%.
+ * Com poucas repetições a normal subestima o intervalo, então o
+ * quantil vem da t de Student com n-1 graus de liberdade.
+ */
+struct ResumoAmostra {
+    double media = 0;
+    double desvio = 0;
+    double ic95 = 0;                // Intervalo: media ± ic95
+
+    static double quantilT95(size_t grausLiberdade) {
+        static const double tabela[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                                        2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                                        2.110, 2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                                        2.060, 2.056, 2.052, 2.048, 2.045, 2.042};
+        if (grausLiberdade == 0) return 0;
+        if (grausLiberdade <= std::size(tabela)) return tabela[grausLiberdade - 1];
+        return 1.960;
+    }
+
+    static ResumoAmostra de(const std::vector<double>& valores) {
+        ResumoAmostra resumo;
+        size_t n = valores.size();
+        if (n == 0) return resumo;
+        for (double v : valores) resumo.media += v;
+        resumo.media /= n;
+        if (n < 2) return resumo;
+        double soma = 0;
+        for (double v : valores) soma += (v - resumo.media) * (v - resumo.media);
+        resumo.desvio = std::sqrt(soma / (n - 1));
+        resumo.ic95 = quantilT95(n - 1) * resumo.desvio / std::sqrt(static_cast<double>(n));
+        return resumo;
+    }
+};
+
+/*
+ * CSVs DA VARREDURA (formato "tidy"):
+ * - rodadas: uma linha por rodada medida, com os eixos como colunas
+ *   (o aquecimento não é registrado)
+ * - resumo: uma linha por configuração, com média e IC de 95%
+ * Os arquivos são recriados a cada varredura.
+ */
+class LoggerVarredura {
+private:
+    std::ofstream rodadas;
+    std::ofstream resumo;
+
+    // Colunas que identificam a configuração, comuns aos dois arquivos
+    static void escreverEixos(std::ofstream& arquivo, const ResultadoSimulacao& r, size_t contas) {
+        arquivo << r.motor << "," << r.numThreads << "," << contas << "," << r.mix << ","
+                << r.distribuicao << "," << r.operacoesPorThread << ",";
+    }
+
+public:
+    LoggerVarredura(const std::string& arquivoRodadas, const std::string& arquivoResumo)
+        : rodadas(arquivoRodadas, std::ios::trunc), resumo(arquivoResumo, std::ios::trunc) {
+        rodadas << "Motor,Threads,Contas,Mix,Distribuicao,OperacoesPorThread,Repeticao,Semente,"
+                << "TempoExecucao_ms,Throughput_ops_ms,OperacoesSucesso,OperacoesFalhas,"
+                << "LatenciaP50_us,LatenciaP99_us,LatenciaP999_us,Servico,Arranjo\n";
+        resumo << "Motor,Threads,Contas,Mix,Distribuicao,OperacoesPorThread,Repeticoes,"
+               << "Throughput_media_ops_ms,Throughput_desvio,Throughput_ic95,"
+               << "LatenciaP99_media_us,LatenciaP99_ic95_us\n";
+    }
+
+    bool aberto() const { return rodadas.is_open() && resumo.is_open(); }
+
+    void registrarRodada(const ResultadoSimulacao& r, size_t contas, int repeticao) {
+        escreverEixos(rodadas, r, contas);
+        rodadas << repeticao << "," << r.semente << "," << std::fixed << std::setprecision(3)
+                << r.tempoExecucao << "," << std::setprecision(4)
+                << (r.tempoExecucao > 0 ? r.operacoesSucesso / r.tempoExecucao : 0) << ","
+                << r.operacoesSucesso << "," << r.operacoesFalhas << "," << std::setprecision(1)
+                << r.latenciaP50Us << "," << r.latenciaP99Us << "," << r.latenciaP999Us << ","
+                << r.servico << "," << r.arranjo << "\n";
+    }
+
+    void registrarResumo(const ResultadoSimulacao& r, size_t contas, size_t repeticoes,
+                         const ResumoAmostra& vazao, const ResumoAmostra& p99) {
+        escreverEixos(resumo, r, contas);
+        resumo << repeticoes << "," << std::fixed << std::setprecision(4) << vazao.media << ","
+               << vazao.desvio << "," << vazao.ic95 << "," << std::setprecision(1)
+               << p99.media << "," << p99.ic95 << "\n";
+        resumo.flush();
+        rodadas.flush();
+    }
+};
+
+/*
+ * CSV DO PERFIL DAS TRAVAS (formato "tidy"):
+ * Uma linha por simulação x conta x modo (só contas cujas travas foram
+ * adquiridas); conta x threads vira o mapa de calor do graficos.py.
+ * O arquivo é recriado a cada execução do programa.
+ */
+class LoggerPerfilTravas {
+private:
+    std::ofstream arquivo;
+
+public:
+    explicit LoggerPerfilTravas(const std::string& nome) : arquivo(nome, std::ios::trunc) {
+        arquivo << "Motor,Threads,Mix,Distribuicao,Conta,Indice,Modo,Aquisicoes,Disputadas,TaxaDisputa,"
+                << "Espera_ms,EsperaMedia_us,EsperaMax_us,Posse_ms,PosseMedia_us\n";
+    }
+
+    bool aberto() const { return arquivo.is_open(); }
+
+    void registrar(const ResultadoSimulacao& r, const std::vector<std::string>& ids,
+                   const std::map<size_t, PerfilConta>& perfil) {
+        for (const auto& [indice, contadores] : perfil) {
+            const std::string& id = indice < ids.size() ? ids[indice] : std::string();
+            for (size_t m = 0; m < NUM_MODOS_TRAVA; ++m) {
+                const ContadoresTrava& c = contadores[m];
+                if (c.aquisicoes == 0) continue;
+                arquivo << r.motor << "," << r.numThreads << "," << r.mix << "," << r.distribuicao << ","
+                        << id << "," << indice << "," << nomeModoTrava(m) << "," << c.aquisicoes << ","
+                        << c.disputadas << "," << std::fixed << std::setprecision(4)
+                        << static_cast<double>(c.disputadas) / c.aquisicoes << "," << std::setprecision(3)
+                        << c.esperaNs / 1e6 << "," << c.esperaNs / 1e3 / c.aquisicoes << ","
+                        << c.maiorEsperaNs / 1e3 << "," << c.posseNs / 1e6 << ","
+                        << c.posseNs / 1e3 / c.aquisicoes << "\n";
+            }
+        }
+        arquivo.flush();
+    }
+};
+
+// ===================================
+// Telemetria durante a simulação
+// ===================================
+/*
+ * SÉRIE TEMPORAL (--telemetria):
+ * O resumo de uma simulação esconde o que acontece dentro dela; uma
+ * thread amostradora grava, a cada intervalo, a vazão, a taxa de falhas,
+ * as consultas em andamento e os percentis de latência do intervalo.
+ * Aquecimento, colapso de vazão e oscilações aparecem como curvas.
+ * O CSV (formato "tidy", uma linha por amostra) fica aberto durante toda
+ * a execução do programa e é recriado a cada execução.
+ */
+struct AmostraTelemetria {
+    int simulacao = 0;                  // Número da simulação na execução do programa
+    std::string motor;
+    int numThreads = 0;
+    std::string mix;
+    std::string distribuicao;
+    double instanteMs = 0;              // Fim do intervalo, desde o início da simulação
+    double intervaloMs = 0;
+    long long operacoes = 0;            // Sucessos no intervalo
+    long long falhas = 0;
+    long long consultasAtivas = 0;      // No instante da amostra
+    HistogramaLatencia latencia;        // Operações terminadas no intervalo
+};
+
+class LoggerTelemetria {
+private:
+    std::ofstream arquivo;
+
+public:
+    explicit LoggerTelemetria(const std::string& nome) : arquivo(nome, std::ios::trunc) {
+        arquivo << "Simulacao,Motor,Threads,Mix,Distribuicao,Instante_ms,Intervalo_ms,Operacoes,Falhas,"
+                << "Throughput_ops_ms,TaxaFalhas,ConsultasAtivas,LatenciaP50_us,LatenciaP99_us,"
+                << "LatenciaP999_us,LatenciaMax_us\n";
+    }
+
+    bool aberto() const { return arquivo.is_open(); }
+
+    // Só a thread amostradora escreve (uma simulação por vez)
+    void registrar(const AmostraTelemetria& a) {
+        long long tentativas = a.operacoes + a.falhas;
+        const HistogramaLatencia& h = a.latencia;
+        arquivo << a.simulacao << "," << a.motor << "," << a.numThreads << "," << a.mix << ","
+                << a.distribuicao << "," << std::fixed << std::setprecision(1) << a.instanteMs << ","
+                << a.intervaloMs << "," << a.operacoes << "," << a.falhas << "," << std::setprecision(4)
+                << (a.intervaloMs > 0 ? a.operacoes / a.intervaloMs : 0) << ","
+                << (tentativas > 0 ? static_cast<double>(a.falhas) / tentativas : 0) << ","
+                << a.consultasAtivas << "," << std::setprecision(1) << h.percentilUs(50.0) << ","
+                << h.percentilUs(99.0) << "," << h.percentilUs(99.9) << "," << h.getMaximoNs() / 1000.0
+                << "\n";
+        arquivo.flush();
+    }
+};
+
+/*
+ * AMOSTRADOR:
+ * Acorda a cada intervalo e lê só o que é seguro ler com as operações
+ * em andamento: contadores fatiados, o contador de consultas e as
+ * janelas de latência das threads. A última amostra cobre o pedaço
+ * final, do último intervalo cheio até o fim da simulação.
+ */
+template <typename Conta>
+class AmostradorTelemetria {
+private:
+    Banco<Conta>& banco;
+    LoggerTelemetria& logger;
+    AmostraTelemetria modelo;                      // Identificação da simulação
+    std::chrono::milliseconds intervalo;
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool parar = false;                            // Protegido por mutex
+
+    std::chrono::steady_clock::time_point inicio;
+    std::chrono::steady_clock::time_point anterior;
+    long long operacoesAnteriores = 0;
+    long long falhasAnteriores = 0;
+
+    void amostrar() {
+        auto agora = std::chrono::steady_clock::now();
+        AmostraTelemetria amostra = modelo;
+        amostra.instanteMs = std::chrono::duration<double, std::milli>(agora - inicio).count();
+        amostra.intervaloMs = std::chrono::duration<double, std::milli>(agora - anterior).count();
+        long long operacoes = banco.getOperacoesRealizadas();
+        long long falhas = banco.getOperacoesFalhas();
+        amostra.operacoes = operacoes - operacoesAnteriores;
+        amostra.falhas = falhas - falhasAnteriores;
+        amostra.consultasAtivas = banco.getConsultasAtivas();
+        banco.drenarJanelas(amostra.latencia);
+        logger.registrar(amostra);
+        anterior = agora;
+        operacoesAnteriores = operacoes;
+        falhasAnteriores = falhas;
+    }
+
+    void executar() {
+        std::unique_lock<std::mutex> lock(mutex);
+        auto proxima = inicio + intervalo;
+        while (!cv.wait_until(lock, proxima, [this] { return parar; })) {
+            lock.unlock();
+            amostrar();
+            lock.lock();
+            proxima += intervalo;
+        }
+        lock.unlock();
+        amostrar();
+    }
+
+public:
+    // Chamar com as estatísticas do banco já zeradas, logo antes da execução
+    AmostradorTelemetria(Banco<Conta>& bancoAlvo, LoggerTelemetria& loggerAlvo,
+                         const AmostraTelemetria& identificacao, std::chrono::milliseconds periodo)
+        : banco(bancoAlvo), logger(loggerAlvo), modelo(identificacao), intervalo(periodo) {
+        banco.configurarTelemetria(true);
+        inicio = anterior = std::chrono::steady_clock::now();
+        thread = std::thread(&AmostradorTelemetria::executar, this);
+    }
+
+    ~AmostradorTelemetria() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            parar = true;
+        }
+        cv.notify_one();
+        thread.join();
+        banco.configurarTelemetria(false);
+    }
+};
+
+// ===================================
+// Pool de trabalho com roubo de tarefas (work stealing)
+// ===================================
+/*
+ * FUNCIONAMENTO:
+ * - Os workers são criados uma vez e reaproveitados entre simulações
+ *   (o pool só cresce quando uma simulação pede mais workers)
+ * - Cada execução distribui as tarefas em rodízio nas filas dos workers ativos
+ * - Cada worker consome a própria fila pelo fim (LIFO, melhor localidade)
+ * - Um worker sem trabalho rouba do início da fila de outro (FIFO),
+ *   então um worker lento não segura a execução inteira
+ * - Ao final, o tempo ocupado de cada worker mostra o desbalanceamento
+ */
+class PoolTrabalho {
+public:
+    using Tarefa = std::function<void(unsigned)>;   // Recebe o ID do worker
+
+    struct EstatisticasExecucao {
+        double tempoMs = 0;
+        std::vector<double> utilizacao;          // Fração do tempo ocupado, por worker
+        std::vector<long long> tarefasExecutadas;
+        long long tarefasRoubadas = 0;
+    };
+
+private:
+    /*
+     * ESTADO DE UM WORKER:
+     * alignas(TAMANHO_LINHA_CACHE) evita que filas de workers vizinhos dividam linha de cache.
+     * Os contadores são escritos só pelo próprio worker e lidos depois
+     * que a execução termina.
+     */
+    struct alignas(TAMANHO_LINHA_CACHE) Trabalhador {
+        std::mutex mutex;
+        std::deque<Tarefa> fila;
+        long long ocupadoNs = 0;
+        long long executadas = 0;
+        long long roubadas = 0;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Trabalhador>> trabalhadores;
+
+    std::mutex controleMutex;
+    std::condition_variable cvInicio;             // Nova execução disponível
+    std::condition_variable cvFim;                // Um worker terminou a execução
+    unsigned ativos = 0;                          // Workers participantes da execução atual
+    unsigned terminaram = 0;
+    unsigned long long geracao = 0;               // Identifica cada execução
+    bool encerrando = false;
+
+    std::atomic<long long> pendentes{0};          // Tarefas ainda não concluídas
+
+    bool pegarPropria(Trabalhador& eu, Tarefa& tarefa) {
+        std::lock_guard<std::mutex> lock(eu.mutex);
+        if (eu.fila.empty()) return false;
+        tarefa = std::move(eu.fila.back());
+        eu.fila.pop_back();
+        return true;
+    }
+
+    bool roubar(unsigned id, unsigned numAtivos, std::minstd_rand& rng, Tarefa& tarefa) {
+        if (numAtivos < 2) return false;
+        unsigned inicio = static_cast<unsigned>(rng() % numAtivos);
+        for (unsigned k = 0; k < numAtivos; ++k) {
+            unsigned vitima = (inicio + k) % numAtivos;
+            if (vitima == id) continue;
+            Trabalhador& outro = *trabalhadores[vitima];
+            std::lock_guard<std::mutex> lock(outro.mutex);
+            if (!outro.fila.empty()) {
+                tarefa = std::move(outro.fila.front());
+                outro.fila.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+     * EXECUÇÃO DAS TAREFAS DE UMA GERAÇÃO:
+     * Trabalha enquanto houver tarefas pendentes em qualquer fila
+     */
+    void trabalhar(unsigned id, unsigned numAtivos) {
+        Trabalhador& eu = *trabalhadores[id];
+        std::minstd_rand rng(id + 1);
+        int tentativasVazias = 0;
+
+        while (pendentes.load(std::memory_order_acquire) > 0) {
+            Tarefa tarefa;
+            bool roubada = false;
+            if (!pegarPropria(eu, tarefa)) {
+                if (!roubar(id, numAtivos, rng, tarefa)) {
+                    // Nada para roubar agora: as tarefas restantes estão em execução
+                    if (++tentativasVazias < 16) std::this_thread::yield();
+                    else std::this_thread::sleep_for(std::chrono::microseconds(50));
+                    continue;
+                }
+                roubada = true;
+            }
+            tentativasVazias = 0;
+
+            auto inicio = std::chrono::steady_clock::now();
+            tarefa(id);
+            eu.ocupadoNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                std::chrono::steady_clock::now() - inicio).count();
+            eu.executadas++;
+            if (roubada) eu.roubadas++;
+            pendentes.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    void laco(unsigned id) {
+        unsigned long long vista = 0;
+        while (true) {
+            unsigned numAtivos;
+            {
+                std::unique_lock<std::mutex> lock(controleMutex);
+                cvInicio.wait(lock, [&] { return encerrando || (geracao != vista && id < ativos); });
+                if (encerrando) return;
+                vista = geracao;
+                numAtivos = ativos;
+            }
+
+            trabalhar(id, numAtivos);
+
+            std::lock_guard<std::mutex> lock(controleMutex);
+            if (++terminaram == ativos) cvFim.notify_all();
+        }
+    }
+
+    /*
+     * CRESCIMENTO DO POOL:
+     * Só é chamado entre execuções (nenhum worker está ativo)
+     */
+    void garantirTrabalhadores(unsigned quantidade) {
+        while (trabalhadores.size() < quantidade) {
+            unsigned id = static_cast<unsigned>(trabalhadores.size());
+            trabalhadores.push_back(std::make_unique<Trabalhador>());
+            trabalhadores.back()->thread = std::thread(&PoolTrabalho::laco, this, id);
+        }
+    }
+
+public:
+    PoolTrabalho() = default;
+
+    ~PoolTrabalho() {
+        {
+            std::lock_guard<std::mutex> lock(controleMutex);
+            encerrando = true;
+        }
+        cvInicio.notify_all();
+        for (auto& t : trabalhadores) t->thread.join();
+    }
+
+    PoolTrabalho(const PoolTrabalho&) = delete;
+    PoolTrabalho& operator=(const PoolTrabalho&) = delete;
+
+    size_t tamanho() const { return trabalhadores.size(); }
+
+    /*
+     * EXECUÇÃO SÍNCRONA:
+     * Distribui as tarefas entre numTrabalhadores workers, espera todas
+     * terminarem e devolve as estatísticas de utilização
+     */
+    EstatisticasExecucao executar(unsigned numTrabalhadores, std::vector<Tarefa> tarefas) {
+        numTrabalhadores = std::max(1u, numTrabalhadores);
+        garantirTrabalhadores(numTrabalhadores);
+
+        for (unsigned i = 0; i < numTrabalhadores; ++i) {
+            Trabalhador& t = *trabalhadores[i];
+            t.ocupadoNs = 0;
+            t.executadas = 0;
+            t.roubadas = 0;
+        }
+        for (size_t i = 0; i < tarefas.size(); ++i) {
+            Trabalhador& t = *trabalhadores[i % numTrabalhadores];
+            std::lock_guard<std::mutex> lock(t.mutex);
+            t.fila.push_back(std::move(tarefas[i]));
+        }
+        pendentes.store(static_cast<long long>(tarefas.size()), std::memory_order_release);
+
+        auto inicio = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(controleMutex);
+            ativos = numTrabalhadores;
+            terminaram = 0;
+            ++geracao;
+        }
+        cvInicio.notify_all();
+        {
+            std::unique_lock<std::mutex> lock(controleMutex);
+            cvFim.wait(lock, [&] { return terminaram == ativos; });
+        }
+        auto fim = std::chrono::steady_clock::now();
+
+        EstatisticasExecucao estatisticas;
+        estatisticas.tempoMs = std::chrono::duration<double, std::milli>(fim - inicio).count();
+        double totalNs = std::max(1.0, estatisticas.tempoMs * 1e6);
+        for (unsigned i = 0; i < numTrabalhadores; ++i) {
+            const Trabalhador& t = *trabalhadores[i];
+            estatisticas.utilizacao.push_back(std::min(1.0, t.ocupadoNs / totalNs));
+            estatisticas.tarefasExecutadas.push_back(t.executadas);
+            estatisticas.tarefasRoubadas += t.roubadas;
+        }
+        return estatisticas;
+    }
+};
+
+#endif  // BANCO_SIMULADOR_HPP
@@ -0,0 +1,1736 @@
+/*
+ * SISTEMA BANCÁRIO
+ * Reprodução de traces, banco particionado, seleção do motor e a classe
+ * SistemaBancario, com os autotestes
+ */
+#ifndef BANCO_SISTEMA_HPP
+#define BANCO_SISTEMA_HPP
+
+#include "servidor.hpp"
+
+// ===================================
+// Reprodução de traces
+// ===================================
+/*
+ * REPRODUÇÃO EM PARALELO PRESERVANDO A ORDEM POR CONTA:
+ * - Uma unidade é uma operação do trace ou um lote inteiro
+ * - Cada conta pertence a uma raia (hash do índice); cada raia executa,
+ *   na ordem do trace, as unidades que tocam alguma conta sua
+ * - Unidade de uma raia só: a raia executa direto. Unidade de várias
+ *   raias (transferência ou lote entre raias): cada raia chega nela e a
+ *   última a chegar executa; as outras esperam a execução antes de seguir
+ * Toda conta vê as suas operações exatamente na ordem do trace, que é o
+ * que decide os saldos e as falhas por saldo insuficiente, então o
+ * resultado é o da reprodução sequencial. Não há deadlock: uma raia
+ * parada numa unidade U só espera raias que ainda não chegaram a U, e
+ * elas nunca esperam por unidades posteriores a U.
+ * Operações recusadas na captura (admissão) não aconteceram e não são
+ * reproduzidas; o banco de reprodução roda sem controle de admissão.
+ */
+template <typename Conta>
+class ReprodutorTrace {
+private:
+    struct Unidade {
+        size_t primeiro;            // Primeiro registro
+        size_t quantidade;          // Mais de um registro só em lotes
+    };
+
+    struct Encontro {
+        std::atomic<uint32_t> chegadas{0};
+        std::atomic<bool> feita{false};
+    };
+
+    Banco<Conta>& banco;
+    const TraceOperacoes& trace;
+    std::vector<Conta*> contas;                 // Índice da tabela -> conta do banco
+    std::vector<Unidade> unidades;
+    std::atomic<long long> diferentes{0};       // Resultado diferente do capturado
+    long long recusadas = 0;                    // Recusadas na captura (puladas)
+    size_t entreRaias = 0;                      // Unidades da última reprodução em mais de uma raia
+
+    Conta* conta(uint32_t indice) const { return indice < contas.size() ? contas[indice] : nullptr; }
+
+    const std::string& id(uint32_t indice) const {
+        static const std::string vazio;
+        return indice < trace.contas.size() ? trace.contas[indice].id : vazio;
+    }
+
+    void executar(const Unidade& u) {
+        const RegistroTrace& r = trace.registros[u.primeiro];
+        StatusOperacao capturado = static_cast<StatusOperacao>(r.status);
+        if (capturado == StatusOperacao::REJEITADA) return;
+        StatusOperacao status = StatusOperacao::FALHA;
+        double valor = r.valorCentavos / 100.0;
+        if (r.flags & GravadorTrace::LOTE) {
+            std::vector<OperacaoLote> lote;
+            lote.reserve(u.quantidade);
+            for (size_t i = u.primeiro; i < u.primeiro + u.quantidade; ++i) {
+                const RegistroTrace& op = trace.registros[i];
+                TipoRegistro tipo = static_cast<TipoRegistro>(op.tipo);
+                TipoOperacaoLote tipoLote = tipo == TipoRegistro::CREDITO ? TipoOperacaoLote::CREDITO
+                                          : tipo == TipoRegistro::DEBITO  ? TipoOperacaoLote::DEBITO
+                                                                          : TipoOperacaoLote::TRANSFERENCIA;
+                lote.push_back({tipoLote, id(op.conta), id(op.destino), op.valorCentavos / 100.0});
+            }
+            status = statusDe(banco.executarLote(lote));
+        } else {
+            Conta* origem = conta(r.conta);
+            double saldo = 0;
+            switch (static_cast<TipoRegistro>(r.tipo)) {
+                case TipoRegistro::CREDITO:
+                    if (origem) status = banco.creditar(origem, valor);
+                    break;
+                case TipoRegistro::DEBITO:
+                    if (origem) status = banco.debitar(origem, valor);
+                    break;
+                case TipoRegistro::CONSULTA:
+                    if (origem) status = banco.consultarSaldo(origem, saldo);
+                    break;
+                case TipoRegistro::TRANSFERENCIA:
+                    status = statusDe(banco.transferir(origem, conta(r.destino), valor));
+                    break;
+            }
+        }
+        if (status != capturado) diferentes.fetch_add(1, std::memory_order_relaxed);
+    }
+
+public:
+    ReprodutorTrace(Banco<Conta>& b, const TraceOperacoes& t) : banco(b), trace(t) {
+        contas.resize(trace.contas.size(), nullptr);
+        for (size_t i = 0; i < trace.contas.size(); ++i) {
+            if (!trace.contas[i].id.empty()) contas[i] = banco.obterConta(trace.contas[i].id);
+        }
+        const std::vector<RegistroTrace>& registros = trace.registros;
+        for (size_t i = 0; i < registros.size();) {
+            size_t fim = i;
+            while (fim < registros.size() && (registros[fim].flags & GravadorTrace::CONTINUA)) ++fim;
+            if (fim == registros.size()) break;     // Lote cortado no fim de uma captura interrompida
+            unidades.push_back({i, fim - i + 1});
+            if (registros[i].status == static_cast<uint8_t>(StatusOperacao::REJEITADA)) recusadas++;
+            i = fim + 1;
+        }
+    }
+
+    size_t getUnidades() const { return unidades.size(); }
+    long long getDiferentes() const { return diferentes.load(); }
+    long long getRecusadas() const { return recusadas; }
+    size_t getEntreRaias() const { return entreRaias; }
+
+    // Retornam o tempo de execução em ms (sem a preparação das raias)
+    double sequencial() {
+        auto inicio = std::chrono::steady_clock::now();
+        for (const Unidade& u : unidades) executar(u);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    }
+
+    double paralelo(unsigned raias) {
+        raias = std::max(1u, raias);
+        auto raiaDe = [raias](uint32_t indice) {
+            return static_cast<unsigned>(((indice * 0x9E3779B97F4A7C15ULL) >> 32) % raias);
+        };
+
+        std::vector<std::vector<size_t>> filas(raias);
+        std::vector<uint32_t> numRaias(unidades.size());
+        std::vector<unsigned> tocadas;
+        entreRaias = 0;
+        for (size_t u = 0; u < unidades.size(); ++u) {
+            tocadas.clear();
+            for (size_t i = unidades[u].primeiro; i < unidades[u].primeiro + unidades[u].quantidade; ++i) {
+                for (uint32_t indice : {trace.registros[i].conta, trace.registros[i].destino}) {
+                    if (indice < contas.size()) tocadas.push_back(raiaDe(indice));
+                }
+            }
+            std::sort(tocadas.begin(), tocadas.end());
+            tocadas.erase(std::unique(tocadas.begin(), tocadas.end()), tocadas.end());
+            if (tocadas.empty()) tocadas.push_back(0);   // Só contas inexistentes: falha em qualquer raia
+            for (unsigned raia : tocadas) filas[raia].push_back(u);
+            numRaias[u] = static_cast<uint32_t>(tocadas.size());
+            if (tocadas.size() > 1) entreRaias++;
+        }
+        std::vector<Encontro> encontros(unidades.size());
+
+        auto inicio = std::chrono::steady_clock::now();
+        executarEmParalelo(raias, [&](unsigned raia) {
+            for (size_t u : filas[raia]) {
+                if (numRaias[u] == 1) {
+                    executar(unidades[u]);
+                    continue;
+                }
+                Encontro& encontro = encontros[u];
+                if (encontro.chegadas.fetch_add(1, std::memory_order_acq_rel) + 1 == numRaias[u]) {
+                    executar(unidades[u]);
+                    encontro.feita.store(true, std::memory_order_release);
+                } else {
+                    unsigned voltas = 0;
+                    while (!encontro.feita.load(std::memory_order_acquire)) esperarGiro(voltas);
+                }
+            }
+        });
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+    }
+};
+
+// ===================================
+// Banco particionado (shared-nothing)
+// ===================================
+/*
+ * FILA SPSC (UM PRODUTOR, UM CONSUMIDOR):
+ * Anel sem travas com capacidade potência de 2. A cauda (escrita só pelo
+ * produtor) e a cabeça (só pelo consumidor) ficam em linhas de cache
+ * separadas, e cada lado guarda a última posição que viu do outro: a
+ * linha do outro lado só é relida quando o anel parece cheio ou vazio.
+ */
+template <typename T, size_t CAPACIDADE>
+class FilaSPSC {
+    static_assert((CAPACIDADE & (CAPACIDADE - 1)) == 0, "Capacidade deve ser potência de 2");
+
+private:
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> cauda{0};
+    size_t cabecaVista = 0;                 // Cópia do produtor
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> cabeca{0};
+    size_t caudaVista = 0;                  // Cópia do consumidor
+    alignas(TAMANHO_LINHA_CACHE) std::array<T, CAPACIDADE> itens{};
+
+public:
+    // Só o produtor chama; false com o anel cheio
+    bool inserir(const T& item) {
+        size_t t = cauda.load(std::memory_order_relaxed);
+        if (t - cabecaVista == CAPACIDADE) {
+            cabecaVista = cabeca.load(std::memory_order_acquire);
+            if (t - cabecaVista == CAPACIDADE) return false;
+        }
+        itens[t & (CAPACIDADE - 1)] = item;
+        cauda.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Só o consumidor chama; false com o anel vazio
+    bool retirar(T& item) {
+        size_t c = cabeca.load(std::memory_order_relaxed);
+        if (c == caudaVista) {
+            caudaVista = cauda.load(std::memory_order_acquire);
+            if (c == caudaVista) return false;
+        }
+        item = itens[c & (CAPACIDADE - 1)];
+        cabeca.store(c + 1, std::memory_order_release);
+        return true;
+    }
+};
+
+/*
+ * AFINIDADE DE CPU:
+ * Fixa a thread atual na n-ésima CPU permitida ao processo (circular,
+ * respeitando taskset e cgroups). Devolve false se o sistema recusar.
+ */
+inline bool fixarNaCPU(unsigned n) {
+    cpu_set_t permitidas;
+    CPU_ZERO(&permitidas);
+    if (sched_getaffinity(0, sizeof(permitidas), &permitidas) != 0) return false;
+    int total = CPU_COUNT(&permitidas);
+    if (total == 0) return false;
+    int alvo = static_cast<int>(n % static_cast<unsigned>(total));
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &permitidas) || alvo-- > 0) continue;
+        cpu_set_t conjunto;
+        CPU_ZERO(&conjunto);
+        CPU_SET(cpu, &conjunto);
+        return pthread_setaffinity_np(pthread_self(), sizeof(conjunto), &conjunto) == 0;
+    }
+    return false;
+}
+
+/*
+ * BANCO PARTICIONADO:
+ * - Cada worker é dono de uma partição (contas cujo hash do ID, módulo o
+ *   número de workers, é o seu número) e é o único que lê ou escreve os
+ *   saldos dela: centavos em um vetor simples, sem trava nem atômico
+ * - Cada worker fica fixado numa CPU e gera a própria carga com o mesmo
+ *   gerador, mix e distribuição do simulador (fluxo = número do worker)
+ * - Operação sobre conta de outra partição vira um pedido na fila SPSC
+ *   worker -> dono, com um espaço de resposta na pilha de quem pediu.
+ *   Enquanto espera a resposta, ou com a fila cheia, o worker atende as
+ *   suas próprias filas de entrada; entre duas operações também. Assim
+ *   dois workers esperando um pelo outro sempre avançam.
+ * - O mapa posição -> (partição, índice) é montado antes e só lido
+ */
+class BancoParticionado {
+public:
+    struct Resultado {
+        double tempoMs = 0;
+        long long sucessos = 0;
+        long long falhas = 0;
+        long long remotas = 0;          // Operações com alguma conta de outra partição
+        long long entreParticoes = 0;   // Transferências/lotes com contas em mais de uma partição
+        unsigned fixados = 0;           // Workers fixados numa CPU
+        bool confere = false;           // Total final == inicial + créditos - débitos
+        long long negativos = 0;        // Contas com saldo final abaixo de zero
+        HistogramaLatencia latencia;    // Todas as operações
+        HistogramaLatencia latenciaRemotas;
+    };
+
+private:
+    /*
+     * PEDIDOS AO DONO:
+     * RESERVA e APLICACAO são as duas fases de uma transferência ou lote;
+     * os demais são as operações simples
+     */
+    enum class TipoPedido : uint8_t { CREDITO, DEBITO, CONSULTA, RESERVA, APLICACAO };
+
+    struct Resposta {
+        std::atomic<bool> pronta{false};
+        bool sucesso = false;
+        int64_t saldoCentavos = 0;
+    };
+
+    struct Pedido {
+        TipoPedido tipo;
+        uint32_t conta;             // Índice na partição dona
+        int64_t centavos;
+        Resposta* resposta;
+    };
+
+    static constexpr int TAMANHO_LOTE = 4;          // Mesmo lote do simulador
+    static constexpr size_t CAPACIDADE_FILA = 64;   // Cada worker tem até TAMANHO_LOTE pedidos em trânsito
+    using Fila = FilaSPSC<Pedido, CAPACIDADE_FILA>;
+
+    struct Localizacao {
+        uint32_t particao;
+        uint32_t indice;
+    };
+
+    struct alignas(TAMANHO_LINHA_CACHE) Particao {
+        std::vector<int64_t> saldos;                    // Só o dono toca
+        std::vector<std::unique_ptr<Fila>> entrada;     // entrada[origem]: pedidos vindos de 'origem'
+        // Estatísticas do dono (lidas só depois do join)
+        long long sucessos = 0, falhas = 0, remotas = 0, entreParticoes = 0;
+        int64_t creditados = 0, debitados = 0;          // Centavos que entraram/saíram do banco
+        bool fixado = false;
+        HistogramaLatencia latencia, latenciaRemotas;
+    };
+
+    ModeloCarga modelo;
+    uint64_t semente;
+    std::vector<Localizacao> localizacoes;              // Posição em modelo.getContas() -> dono
+    std::vector<std::unique_ptr<Particao>> particoes;
+    int64_t totalInicial = 0;
+    std::atomic<unsigned> terminados{0};
+
+    static std::vector<std::string> idsDe(const std::vector<ContaLida>& contas) {
+        std::vector<std::string> ids;
+        ids.reserve(contas.size());
+        for (const ContaLida& c : contas) ids.push_back(c.id);
+        return ids;
+    }
+
+    // Executa o pedido (só o worker dono da partição chama)
+    void aplicar(Particao& dona, const Pedido& pedido) {
+        int64_t& saldo = dona.saldos[pedido.conta];
+        bool sucesso = true;
+        switch (pedido.tipo) {
+            case TipoPedido::CREDITO:
+                ModeloServico::instancia().executar(EtapaServico::CREDITO);
+                saldo += pedido.centavos;
+                break;
+            case TipoPedido::DEBITO:
+            case TipoPedido::RESERVA:
+                ModeloServico::instancia().executar(pedido.tipo == TipoPedido::DEBITO
+                                                        ? EtapaServico::DEBITO : EtapaServico::MULTICONTA);
+                sucesso = pedido.centavos > 0 && saldo >= pedido.centavos;
+                if (sucesso) saldo -= pedido.centavos;
+                break;
+            case TipoPedido::CONSULTA:
+                ModeloServico::instancia().executar(EtapaServico::CONSULTA);
+                break;
+            case TipoPedido::APLICACAO:
+                saldo += pedido.centavos;
+                break;
+        }
+        pedido.resposta->sucesso = sucesso;
+        pedido.resposta->saldoCentavos = saldo;
+        pedido.resposta->pronta.store(true, std::memory_order_release);
+    }
+
+    void atenderFilas(unsigned p) {
+        Particao& dona = *particoes[p];
+        Pedido pedido{};
+        for (auto& fila : dona.entrada) {
+            if (!fila) continue;
+            while (fila->retirar(pedido)) aplicar(dona, pedido);
+        }
+    }
+
+    // Conta da própria partição executa direto; de outra vai para a fila do dono
+    void pedir(unsigned p, Localizacao conta, TipoPedido tipo, int64_t centavos, Resposta& resposta) {
+        Pedido pedido{tipo, conta.indice, centavos, &resposta};
+        if (conta.particao == p) {
+            aplicar(*particoes[p], pedido);
+            return;
+        }
+        Fila& fila = *particoes[conta.particao]->entrada[p];
+        unsigned voltas = 0;
+        while (!fila.inserir(pedido)) {
+            atenderFilas(p);
+            esperarGiro(voltas);
+        }
+    }
+
+    void aguardar(unsigned p, Resposta& resposta) {
+        unsigned voltas = 0;
+        while (!resposta.pronta.load(std::memory_order_acquire)) {
+            atenderFilas(p);
+            esperarGiro(voltas);
+        }
+    }
+
+    /*
+     * TRANSFERÊNCIA EM DUAS FASES (origem -> destinos):
+     * 1. RESERVA: o dono da origem debita o total se houver saldo; sem
+     *    saldo a operação falha aqui e nenhum destino é tocado
+     * 2. APLICACAO: o dono de cada destino credita a sua parte
+     * A fase 2 não falha (só credita contas que existem), então nunca há
+     * o que desfazer. Entre as fases o valor está em trânsito: já saiu da
+     * origem e ainda não chegou aos destinos, mas nenhum saldo fica
+     * negativo e o total fecha quando a operação termina. Com todas as
+     * contas na partição do próprio worker as fases rodam seguidas, sem
+     * nenhuma outra operação entre elas.
+     */
+    bool transferir(unsigned p, Localizacao origem, const Localizacao* destinos,
+                    const int64_t* valores, int n) {
+        int64_t total = 0;
+        for (int k = 0; k < n; ++k) total += valores[k];
+        Resposta reserva;
+        pedir(p, origem, TipoPedido::RESERVA, total, reserva);
+        aguardar(p, reserva);
+        if (!reserva.sucesso) return false;
+
+        Resposta aplicacoes[TAMANHO_LOTE];
+        for (int k = 0; k < n; ++k) pedir(p, destinos[k], TipoPedido::APLICACAO, valores[k], aplicacoes[k]);
+        for (int k = 0; k < n; ++k) aguardar(p, aplicacoes[k]);
+        return true;
+    }
+
+    /*
+     * UMA OPERAÇÃO SORTEADA:
+     * Mesma sequência de sorteios do SimuladorOperacoes (conta, tipo,
+     * valor e destinos); o lote debita a origem uma vez pelo total
+     */
+    void executarOperacao(unsigned p, GeradorCarga& gerador) {
+        Particao& minha = *particoes[p];
+        size_t posicao = gerador.proximaPosicao();
+        Localizacao conta = localizacoes[posicao];
+        int operacao = gerador.proximaOperacao();
+        int64_t centavos = std::llround(gerador.proximoValor() * 100);
+        bool remota = conta.particao != p;
+        bool sucesso = false;
+        auto inicio = std::chrono::steady_clock::now();
+
+        switch (operacao) {
+            case 0:
+            case 1:
+            case 2: {
+                static const TipoPedido tipos[] = {TipoPedido::CREDITO, TipoPedido::DEBITO, TipoPedido::CONSULTA};
+                Resposta resposta;
+                pedir(p, conta, tipos[operacao], centavos, resposta);
+                aguardar(p, resposta);
+                sucesso = resposta.sucesso;
+                if (sucesso && operacao == 0) minha.creditados += centavos;
+                if (sucesso && operacao == 1) minha.debitados += centavos;
+                break;
+            }
+            case 3:
+            case 4: {
+                if (localizacoes.size() < 2) break;
+                int n = operacao == 3 ? 1 : TAMANHO_LOTE;
+                Localizacao destinos[TAMANHO_LOTE];
+                int64_t valores[TAMANHO_LOTE];
+                bool entre = false;
+                for (int k = 0; k < n; ++k) {
+                    destinos[k] = localizacoes[gerador.outraPosicao(posicao)];
+                    valores[k] = operacao == 3 ? centavos
+                                               : std::llround(gerador.proximoValor() / TAMANHO_LOTE * 100);
+                    remota |= destinos[k].particao != p;
+                    entre |= destinos[k].particao != conta.particao;
+                }
+                sucesso = transferir(p, conta, destinos, valores, n);
+                if (entre) minha.entreParticoes++;
+                break;
+            }
+        }
+
+        uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - inicio).count());
+        if (sucesso) minha.sucessos++;
+        else minha.falhas++;
+        minha.latencia.registrar(ns);
+        if (remota) {
+            minha.remotas++;
+            minha.latenciaRemotas.registrar(ns);
+        }
+    }
+
+    /*
+     * WORKER DONO DA PARTIÇÃO p:
+     * Depois das próprias operações continua atendendo as filas até
+     * todos terminarem: um worker só termina depois de receber todas as
+     * suas respostas, então aí não resta pedido em nenhuma fila
+     */
+    void executarWorker(unsigned p, int operacoes) {
+        Particao& minha = *particoes[p];
+        minha.fixado = fixarNaCPU(p);
+        if (!modelo.getContas().empty()) {
+            GeradorCarga gerador(modelo, semente, p);
+            for (int i = 0; i < operacoes; ++i) {
+                executarOperacao(p, gerador);
+                atenderFilas(p);
+                ModeloServico::instancia().executar(EtapaServico::PAUSA);
+            }
+        }
+        terminados.fetch_add(1, std::memory_order_acq_rel);
+        unsigned voltas = 0;
+        while (terminados.load(std::memory_order_acquire) < particoes.size()) {
+            atenderFilas(p);
+            esperarGiro(voltas);
+        }
+    }
+
+public:
+    BancoParticionado(const std::vector<ContaLida>& contas, const MixOperacoes& mix,
+                      const ConfigCarga& carga, unsigned numParticoes)
+        : modelo(idsDe(contas), mix, carga), semente(carga.semente) {
+        numParticoes = std::max(1u, numParticoes);
+        for (unsigned p = 0; p < numParticoes; ++p) {
+            particoes.push_back(std::make_unique<Particao>());
+            for (unsigned origem = 0; origem < numParticoes; ++origem)
+                particoes[p]->entrada.push_back(origem == p ? nullptr : std::make_unique<Fila>());
+        }
+
+        std::map<std::string, double> saldoPorId;
+        for (const ContaLida& c : contas) saldoPorId[c.id] = c.saldo;
+        const std::vector<std::string>& ids = modelo.getContas();
+        localizacoes.resize(ids.size());
+        for (size_t i = 0; i < ids.size(); ++i) {
+            uint32_t p = static_cast<uint32_t>(hashFNV1a(ids[i].data(), ids[i].size()) % numParticoes);
+            int64_t centavos = std::llround(saldoPorId[ids[i]] * 100);
+            localizacoes[i] = {p, static_cast<uint32_t>(particoes[p]->saldos.size())};
+            particoes[p]->saldos.push_back(centavos);
+            totalInicial += centavos;
+        }
+    }
+
+    unsigned getNumParticoes() const { return static_cast<unsigned>(particoes.size()); }
+
+    /*
+     * EXECUÇÃO:
+     * Uma thread nova por partição (mesmo com uma só: fixar a thread
+     * principal prenderia as threads criadas depois dela à mesma CPU)
+     */
+    Resultado executar(int operacoesPorWorker) {
+        terminados.store(0);
+        auto inicio = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned p = 0; p < particoes.size(); ++p)
+            workers.emplace_back([this, p, operacoesPorWorker] { executarWorker(p, operacoesPorWorker); });
+        for (auto& w : workers) w.join();
+
+        Resultado r;
+        r.tempoMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - inicio).count();
+        int64_t totalFinal = 0, creditados = 0, debitados = 0;
+        for (const auto& parte : particoes) {
+            for (int64_t saldo : parte->saldos) {
+                totalFinal += saldo;
+                if (saldo < 0) r.negativos++;
+            }
+            creditados += parte->creditados;
+            debitados += parte->debitados;
+            r.sucessos += parte->sucessos;
+            r.falhas += parte->falhas;
+            r.remotas += parte->remotas;
+            r.entreParticoes += parte->entreParticoes;
+            r.fixados += parte->fixado ? 1 : 0;
+            r.latencia.juntar(parte->latencia);
+            r.latenciaRemotas.juntar(parte->latenciaRemotas);
+        }
+        r.confere = totalFinal == totalInicial + creditados - debitados;
+        return r;
+    }
+};
+
+// ===================================
+// Seleção do motor de contas
+// ===================================
+/*
+ * MOTORES DISPONÍVEIS:
+ * - RWLOCK: ContaCorrente original (double + shared_mutex)
+ * - ATOMICO: ContaCorrenteAtomica (centavos em atomic + CAS)
+ * - MUTEX, TTAS, TICKET, MCS, SEQLOCK, RWGIRO: ContaComTrava com a
+ *   política de trava correspondente (mesmo nome no CSV)
+ */
+enum class MotorConta { RWLOCK, ATOMICO, MUTEX, TTAS, TICKET, MCS, SEQLOCK, RWGIRO };
+
+inline const std::vector<std::pair<std::string, MotorConta>>& motoresConhecidos() {
+    static const std::vector<std::pair<std::string, MotorConta>> motores = {
+        {"rwlock", MotorConta::RWLOCK}, {"atomico", MotorConta::ATOMICO},
+        {"mutex", MotorConta::MUTEX}, {"ttas", MotorConta::TTAS},
+        {"ticket", MotorConta::TICKET}, {"mcs", MotorConta::MCS},
+        {"seqlock", MotorConta::SEQLOCK}, {"rwgiro", MotorConta::RWGIRO}};
+    return motores;
+}
+
+/*
+ * ETIQUETA DE TIPO:
+ * Carrega o tipo de conta para dentro de uma lambda genérica
+ */
+template <typename T>
+struct TipoConta { using tipo = T; };
+
+/*
+ * DESPACHO EM TEMPO DE EXECUÇÃO -> INSTANCIAÇÃO EM TEMPO DE COMPILAÇÃO:
+ * O switch acontece uma única vez por simulação; dentro da função
+ * chamada todo o código já está especializado para o tipo de conta.
+ */
+template <typename Funcao>
+auto despacharMotor(MotorConta motor, Funcao&& funcao) {
+    switch (motor) {
+        case MotorConta::ATOMICO: return funcao(TipoConta<ContaCorrenteAtomica>{});
+        case MotorConta::MUTEX:   return funcao(TipoConta<ContaComTrava<TravaMutex>>{});
+        case MotorConta::TTAS:    return funcao(TipoConta<ContaComTrava<TravaTTAS>>{});
+        case MotorConta::TICKET:  return funcao(TipoConta<ContaComTrava<TravaTicket>>{});
+        case MotorConta::MCS:     return funcao(TipoConta<ContaComTrava<TravaMCS>>{});
+        case MotorConta::SEQLOCK: return funcao(TipoConta<ContaComTrava<TravaSeq>>{});
+        case MotorConta::RWGIRO:  return funcao(TipoConta<ContaComTrava<TravaLeituraEscritaGiro>>{});
+        case MotorConta::RWLOCK:
+        default:                  return funcao(TipoConta<ContaCorrente>{});
+    }
+}
+
+/*
+ * INTERPRETAÇÃO DE --motor:
+ * Lista de nomes separados por vírgula ou "todos"
+ */
+inline bool interpretarMotores(const std::string& texto, std::vector<MotorConta>& motores) {
+    std::vector<MotorConta> escolhidos;
+    if (texto == "todos") {
+        for (const auto& [nome, motor] : motoresConhecidos()) escolhidos.push_back(motor);
+        motores = escolhidos;
+        return true;
+    }
+    size_t inicio = 0;
+    while (true) {
+        size_t fim = texto.find(',', inicio);
+        std::string nome = texto.substr(inicio, fim - inicio);
+        auto it = std::find_if(motoresConhecidos().begin(), motoresConhecidos().end(),
+                               [&](const auto& par) { return par.first == nome; });
+        if (it == motoresConhecidos().end()) return false;
+        escolhidos.push_back(it->second);
+        if (fim == std::string::npos) break;
+        inicio = fim + 1;
+    }
+    motores = escolhidos;
+    return true;
+}
+
+// ===================================
+// Classe principal Sistema Bancário
+// ===================================
+class SistemaBancario {
+private:
+    std::unique_ptr<LoggerSimulacao> logger;         // Logger para CSV
+    PoolTrabalho pool;                               // Workers reaproveitados entre simulações
+    std::vector<MotorConta> motores;                 // Motores comparados nas simulações
+    MixOperacoes mix = MixOperacoes::padrao();       // Mix de operações do simulador
+    ConfigCarga configCarga;                         // Distribuição de acesso e semente
+    ConfigChegada chegada;                           // Ciclo fechado ou taxa de chegada
+    ConfigAdmissao configAdmissao;                   // Fila justa na frente dos locks das contas
+    ModoCombinacao modoCombinacao = ModoCombinacao::AUTO;   // Flat combining em contas disputadas
+    ConfigAuditoria configAuditoria;                 // Auditor de snapshots durante a simulação
+    ArranjoContas arranjo = ArranjoContas::HEAP;     // Layout das contas na memória
+    ConfigWAL configWAL;                             // Configuração do group commit
+    ConfigCheckpoint configCheckpoint;               // Checkpoint incremental durante a simulação
+    std::string arquivoCaptura;                      // Trace das operações (vazio = sem captura)
+    ConfigMassa configMassa;                         // Trabalho em massa durante a simulação
+    size_t numClientes = 0;                          // Clientes em corrotinas (0 = um por thread)
+    std::unique_ptr<LoggerPerfilTravas> loggerPerfil;  // Perfil das travas por conta (nullptr = desligado)
+    std::unique_ptr<LoggerTelemetria> loggerTelemetria;  // Série temporal das simulações (nullptr = desligada)
+    std::chrono::milliseconds intervaloTelemetria{100};
+    int simulacoesAmostradas = 0;
+
+public:
+    /*
+     * CONSTRUTOR:
+     * Inicializa o logger e, por padrão, compara os dois motores
+     */
+    SistemaBancario() : logger(std::make_unique<LoggerSimulacao>("simulacao_logs.csv")),
+                        motores{MotorConta::RWLOCK, MotorConta::ATOMICO} {}
+
+    void configurarMotores(const std::vector<MotorConta>& lista) { motores = lista; }
+    void configurarMix(const MixOperacoes& novoMix) { mix = novoMix; }
+    void configurarCarga(const ConfigCarga& config) { configCarga = config; }
+    void configurarChegada(const ConfigChegada& config) { chegada = config; }
+    void configurarAdmissao(const ConfigAdmissao& config) { configAdmissao = config; }
+    void configurarCombinacao(ModoCombinacao modo) { modoCombinacao = modo; }
+    void configurarAuditoria(const ConfigAuditoria& config) { configAuditoria = config; }
+    void configurarArranjo(ArranjoContas novo) { arranjo = novo; }
+    void configurarWAL(const ConfigWAL& config) { configWAL = config; }
+    void configurarCheckpoint(const ConfigCheckpoint& config) { configCheckpoint = config; }
+    void configurarCaptura(const std::string& arquivo) { arquivoCaptura = arquivo; }
+    void configurarMassa(const ConfigMassa& config) { configMassa = config; }
+    void configurarClientes(size_t quantidade) { numClientes = quantidade; }
+
+    bool configurarPerfilTravas(const std::string& arquivo) {
+        loggerPerfil = std::make_unique<LoggerPerfilTravas>(arquivo);
+        if (!loggerPerfil->aberto()) {
+            std::cerr << "Erro ao criar o perfil das travas: " << arquivo << std::endl;
+            loggerPerfil.reset();
+            return false;
+        }
+        PerfilTravas::instancia().ligar(true);
+        return true;
+    }
+
+    bool configurarTelemetria(int intervaloMs, const std::string& arquivo) {
+        loggerTelemetria = std::make_unique<LoggerTelemetria>(arquivo);
+        if (!loggerTelemetria->aberto()) {
+            std::cerr << "Erro ao criar o arquivo de telemetria: " << arquivo << std::endl;
+            loggerTelemetria.reset();
+            return false;
+        }
+        intervaloTelemetria = std::chrono::milliseconds(intervaloMs);
+        return true;
+    }
+
+    /*
+     * INICIALIZAÇÃO DO SISTEMA:
+     * Valida o arquivo de contas antes de começar
+     * (cada simulação cria o seu próprio banco)
+     */
+    void inicializar() {
+        std::cout << "=== INICIALIZANDO SISTEMA BANCÁRIO ===" << std::endl;
+        Banco<ContaCorrente> banco;
+        banco.configurarWAL(configWAL);
+        banco.configurarCheckpoint(configCheckpoint);
+        banco.carregarContas("ContaCorrente.txt");
+    }
+
+    static constexpr int TAMANHO_BLOCO = 5;          // Operações por tarefa do pool
+
+    /*
+     * EXECUÇÃO DE SIMULAÇÃO ÚNICA:
+     * Executa uma simulação com parâmetros específicos sobre um banco já carregado.
+     * Sem relatório (rodadas da varredura) só mede: nada é impresso, registrado
+     * no CSV de simulações ou salvo no arquivo de contas.
+     */
+    template <typename Conta>
+    ResultadoSimulacao executarSimulacao(Banco<Conta>& banco, int numThreads, int operacoesPorThread,
+                                         bool relatorio = true) {
+        if (relatorio) {
+            std::cout << "\n=== INICIANDO SIMULAÇÃO ===" << std::endl;
+            std::cout << "Motor: " << Conta::nomeMotor() << std::endl;
+            std::cout << "Threads: " << numThreads << std::endl;
+            std::cout << "Operações por thread: " << operacoesPorThread << std::endl;
+            if (numClientes > 0) {
+                std::cout << "Clientes em corrotinas: " << numClientes << " (operações por thread = por cliente)"
+                          << std::endl;
+            }
+        }
+
+        SimuladorOperacoes<Conta> simulador(banco, mix, configCarga);
+        int totalOperacoes = (numClientes > 0 ? static_cast<int>(numClientes) : numThreads) * operacoesPorThread;
+        if (chegada.aberto()) {
+            if (relatorio) {
+                std::cout << "Chegadas: " << chegada.descricao() << " ops/s (ciclo aberto)" << std::endl;
+            }
+            simulador.prepararAgenda(chegada, static_cast<size_t>(totalOperacoes));
+        }
+
+        /*
+         * RESET DE ESTATÍSTICAS:
+         * Limpa contadores antes de começar
+         */
+        banco.resetarEstatisticas();
+        LoggerOperacoes::instancia().resetarDescartados();
+        if (loggerPerfil) PerfilTravas::instancia().zerar();
+
+        /*
+         * MEDIÇÃO DE TEMPO:
+         * Marca o início da simulação
+         */
+        auto inicio = std::chrono::high_resolution_clock::now();
+
+        /*
+         * DIVISÃO EM TAREFAS:
+         * - Ciclo fechado: o total de operações (threads x operações por
+         *   thread) é quebrado em blocos pequenos; os workers do pool roubam
+         *   blocos uns dos outros, então nenhum worker lento segura a
+         *   simulação inteira
+         * - Ciclo aberto: uma tarefa por worker, cada uma consumindo a
+         *   agenda de chegadas até o fim
+         * - Clientes em corrotinas: uma tarefa por worker, cada uma rodando
+         *   o laço do escalonador sobre os clientes presos a ela
+         */
+        std::vector<PoolTrabalho::Tarefa> tarefas;
+#if BANCO_CORROTINAS
+        std::unique_ptr<EscalonadorClientes> escalonador;
+        size_t bytesQuadros = 0;
+#endif
+        if (chegada.aberto()) {
+            simulador.iniciarAgenda();
+            for (int i = 0; i < numThreads; ++i) {
+                tarefas.push_back([&simulador](unsigned) { simulador.executarAgenda(); });
+            }
+        } else if (numClientes > 0) {
+#if BANCO_CORROTINAS
+            escalonador = std::make_unique<EscalonadorClientes>(static_cast<unsigned>(numThreads), banco.getWAL());
+            size_t antes = TarefaCliente::bytesQuadros().load();
+            simulador.criarClientes(*escalonador, numClientes, operacoesPorThread);
+            bytesQuadros = TarefaCliente::bytesQuadros().load() - antes;
+            for (unsigned i = 0; i < escalonador->getNumWorkers(); ++i) {
+                tarefas.push_back([&escalonador, i](unsigned) { escalonador->executarWorker(i); });
+            }
+#endif
+        } else {
+            for (int feitas = 0; feitas < totalOperacoes; feitas += TAMANHO_BLOCO) {
+                int quantidade = std::min(TAMANHO_BLOCO, totalOperacoes - feitas);
+                uint64_t fluxo = static_cast<uint64_t>(feitas / TAMANHO_BLOCO);
+                tarefas.push_back([&simulador, fluxo, quantidade](unsigned) {
+                    simulador.executarBloco(fluxo, quantidade);
+                });
+            }
+        }
+
+        /*
+         * EXECUÇÃO E SINCRONIZAÇÃO:
+         * Bloqueia até que todas as tarefas tenham sido executadas;
+         * o auditor e o checkpointer (se ligados) rodam durante toda a execução
+         */
+        if (!arquivoCaptura.empty()) banco.iniciarCaptura(arquivoCaptura);
+        banco.iniciarCheckpoints(configCheckpoint);
+        banco.iniciarAuditoria(configAuditoria);
+        banco.iniciarMassa(configMassa);
+        std::unique_ptr<AmostradorTelemetria<Conta>> amostrador;
+        if (loggerTelemetria) {
+            AmostraTelemetria identificacao;
+            identificacao.simulacao = ++simulacoesAmostradas;
+            identificacao.motor = Conta::nomeMotor();
+            identificacao.numThreads = numThreads;
+            identificacao.mix = mix.nome;
+            identificacao.distribuicao = configCarga.descricao();
+            amostrador = std::make_unique<AmostradorTelemetria<Conta>>(banco, *loggerTelemetria, identificacao,
+                                                                       intervaloTelemetria);
+        }
+        PoolTrabalho::EstatisticasExecucao execucao =
+            pool.executar(static_cast<unsigned>(numThreads), std::move(tarefas));
+        amostrador.reset();                 // Última amostra: o trecho final da execução
+        banco.pararMassa();
+        banco.pararAuditoria();
+        banco.pararCheckpoints();
+        banco.concluirEncerramentos();      // Ninguém mais segura contas: finaliza os encerramentos
+        uint64_t registrosTrace = banco.pararCaptura();
+
+        for (size_t i = 0; relatorio && i < execucao.utilizacao.size(); ++i) {
+            std::cout << "Worker " << i << " finalizou: " << execucao.tarefasExecutadas[i]
+                      << " blocos, utilização " << std::fixed << std::setprecision(1)
+                      << execucao.utilizacao[i] * 100 << "%\n";
+        }
+
+        /*
+         * DESCARGA DO LOG:
+         * Garante que todas as operações registradas já foram escritas
+         * antes de imprimir o resumo
+         */
+        LoggerOperacoes::instancia().descarregar();
+
+        /*
+         * MEDIÇÃO FINAL:
+         * Calcula tempo total de execução
+         */
+        auto fim = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double, std::milli> duracao = fim - inicio;
+
+        /*
+         * COLETA DE RESULTADOS:
+         * Obtém estatísticas finais
+         */
+        ResultadoSimulacao resultado;
+        resultado.motor = Conta::nomeMotor();
+        resultado.numThreads = numThreads;
+        resultado.operacoesPorThread = operacoesPorThread;
+        resultado.tempoExecucao = duracao.count();
+        resultado.operacoesSucesso = banco.getOperacoesRealizadas();
+        resultado.operacoesFalhas = banco.getOperacoesFalhas();
+        resultado.mix = mix.nome;
+        resultado.transferencias = banco.getTransferenciasRealizadas();
+        resultado.transferenciasAbortadas = banco.getTransferenciasAbortadas();
+        resultado.lotes = banco.getLotesRealizados();
+        resultado.lotesAbortados = banco.getLotesAbortados();
+        resultado.esperaLockMs = banco.getEsperaLockNs() / 1e6;
+        resultado.wal = configWAL.descricao();
+        resultado.commitsWAL = banco.getCommitsWAL();
+        resultado.registrosPorCommit = resultado.commitsWAL > 0
+            ? static_cast<double>(banco.getRegistrosWAL()) / resultado.commitsWAL : 0;
+        /*
+         * LATÊNCIAS:
+         * Junta os histogramas das threads; o agregado inclui todos os tipos
+         */
+        HistogramasPorTipo porTipo = banco.latencias();
+        HistogramaLatencia todas;
+        for (size_t t = 0; t < NUM_TIPOS_OPERACAO; ++t) {
+            todas.juntar(porTipo[t]);
+            resultado.latenciaP99PorTipoUs[t] = porTipo[t].percentilUs(99.0);
+        }
+        resultado.latenciaP50Us = todas.percentilUs(50.0);
+        resultado.latenciaP90Us = todas.percentilUs(90.0);
+        resultado.latenciaP99Us = todas.percentilUs(99.0);
+        resultado.latenciaP999Us = todas.percentilUs(99.9);
+        resultado.latenciaMaxUs = todas.getMaximoNs() / 1000.0;
+        resultado.admissao = banco.getConfigAdmissao().descricao();
+        resultado.rejeicoesFila = banco.getRejeicoesFilaCheia();
+        resultado.rejeicoesTempo = banco.getRejeicoesTempoEsgotado();
+        resultado.esperaFilaMs = banco.getEsperaFilaNs() / 1e6;
+        resultado.filaP99Us = porTipo[static_cast<size_t>(TipoLatencia::FILA)].percentilUs(99.0);
+        auto combinacao = banco.estatisticasCombinacao();
+        resultado.combinacao = Conta::SUPORTA_COMBINACAO
+            ? nomeModoCombinacao(banco.getModoCombinacao()) : "n/a";
+        resultado.contasCombinando = combinacao.contasCombinando;
+        resultado.lotesCombinados = combinacao.lotes;
+        resultado.pedidosPorLote = combinacao.lotes > 0
+            ? static_cast<double>(combinacao.pedidos) / combinacao.lotes : 0;
+        resultado.auditoria = configAuditoria.descricao();
+        resultado.arranjo = nomeArranjo(banco.getArranjo());
+        resultado.trava = Conta::nomeTrava();
+        resultado.snapshots = banco.getSnapshotsAuditados();
+        resultado.divergencias = banco.getDivergenciasAuditoria();
+        resultado.snapshotMedioUs = resultado.snapshots > 0
+            ? banco.getTempoSnapshotsNs() / 1e3 / resultado.snapshots : 0;
+        resultado.checkpoint = configCheckpoint.descricao();
+        resultado.checkpoints = banco.getCheckpointsGravados();
+        resultado.registrosCheckpoint = banco.getRegistrosCheckpoint();
+        resultado.bytesCheckpoint = banco.getBytesCheckpoint();
+        resultado.checkpointP50Ms = banco.getDuracaoCheckpoints().percentilUs(50.0) / 1000.0;
+        resultado.checkpointMaxMs = banco.getDuracaoCheckpoints().getMaximoNs() / 1e6;
+        resultado.massa = configMassa.descricao();
+        resultado.passadasMassa = banco.getPassadasMassa();
+        resultado.passadaMediaMs = resultado.passadasMassa > 0
+            ? banco.getTempoMassaNs() / 1e6 / resultado.passadasMassa : 0;
+        resultado.divergenciasMassa = banco.getDivergenciasMassa();
+        resultado.aberturas = banco.getAberturas();
+        resultado.encerramentos = banco.getEncerramentos();
+        resultado.utilizacaoPorWorker = execucao.utilizacao;
+        resultado.tarefasRoubadas = execucao.tarefasRoubadas;
+        resultado.distribuicao = configCarga.descricao();
+        resultado.semente = simulador.getSemente();
+        resultado.chegada = chegada.descricao();
+        resultado.servico = ModeloServico::instancia().descricao();
+        resultado.taxaAlvo = chegada.taxa;
+        resultado.taxaObtida = execucao.tempoMs > 0 ? totalOperacoes / (execucao.tempoMs / 1000.0) : 0;
+        if (chegada.aberto()) {
+            const HistogramaLatencia& resposta = simulador.getResposta();
+            resultado.respostaP50Us = resposta.percentilUs(50.0);
+            resultado.respostaP99Us = resposta.percentilUs(99.0);
+            resultado.respostaP999Us = resposta.percentilUs(99.9);
+            resultado.respostaMaxUs = resposta.getMaximoNs() / 1000.0;
+        }
+#if BANCO_CORROTINAS
+        EscalonadorClientes::Resultado clientes;
+        if (escalonador) {
+            // Resposta medida pelo cliente: operação + espera do commit (sem a pausa)
+            clientes = escalonador->resultado();
+            resultado.clientes = static_cast<int>(numClientes);
+            resultado.bytesPorCliente = static_cast<double>(bytesQuadros) / std::max<size_t>(1, numClientes);
+            resultado.respostaP50Us = clientes.resposta.percentilUs(50.0);
+            resultado.respostaP99Us = clientes.resposta.percentilUs(99.0);
+            resultado.respostaP999Us = clientes.resposta.percentilUs(99.9);
+            resultado.respostaMaxUs = clientes.resposta.getMaximoNs() / 1000.0;
+        }
+#endif
+        if (!relatorio) return resultado;
+
+        std::cout << "\n=== SIMULAÇÃO CONCLUÍDA ===" << std::endl;
+        std::cout << "Tempo de execução: " << std::fixed << std::setprecision(3)
+                  << duracao.count() << " ms" << std::endl;
+        std::cout << "Carga: mix " << resultado.mix << ", distribuição " << resultado.distribuicao
+                  << ", semente " << resultado.semente << std::endl;
+        std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+                  << resultado.servico << std::endl;
+        std::cout << "Latência (us)   " << std::setw(8) << "ops" << std::setw(10) << "p50"
+                  << std::setw(10) << "p90" << std::setw(10) << "p99" << std::setw(10) << "p99.9"
+                  << std::setw(10) << "máx" << std::endl;
+        auto imprimirLinha = [](const std::string& nome, const HistogramaLatencia& h) {
+            std::cout << "  " << std::left << std::setw(14) << nome << std::right
+                      << std::setw(8) << h.getTotal() << std::fixed << std::setprecision(1)
+                      << std::setw(10) << h.percentilUs(50.0) << std::setw(10) << h.percentilUs(90.0)
+                      << std::setw(10) << h.percentilUs(99.0) << std::setw(10) << h.percentilUs(99.9)
+                      << std::setw(10) << h.getMaximoNs() / 1000.0 << std::endl;
+        };
+        for (size_t t = 0; t < NUM_TIPOS_OPERACAO; ++t) {
+            if (porTipo[t].getTotal() > 0) imprimirLinha(nomeTipoLatencia(t), porTipo[t]);
+        }
+        imprimirLinha("Todas", todas);
+        const HistogramaLatencia& fila = porTipo[static_cast<size_t>(TipoLatencia::FILA)];
+        if (fila.getTotal() > 0) imprimirLinha("Fila admissão", fila);
+        if (chegada.aberto()) {
+            // Desde o instante planejado: inclui o tempo esperando um worker livre
+            imprimirLinha("Resposta", simulador.getResposta());
+            std::cout << "Taxa alvo: " << std::setprecision(1) << resultado.taxaAlvo
+                      << " ops/s, obtida: " << resultado.taxaObtida << " ops/s" << std::endl;
+        }
+#if BANCO_CORROTINAS
+        if (escalonador) {
+            imprimirLinha("Resposta", clientes.resposta);
+            std::cout << "Clientes: " << resultado.clientes << " corrotinas em " << numThreads
+                      << " workers, " << std::setprecision(0) << resultado.bytesPorCliente
+                      << " bytes por cliente; suspensões: " << clientes.suspensoesPausa << " na pausa, "
+                      << clientes.suspensoesCommit << " no commit do WAL" << std::endl;
+        }
+#endif
+        if (resultado.commitsWAL > 0) {
+            std::cout << "WAL (" << resultado.wal << "): " << resultado.commitsWAL
+                      << " commits, " << std::setprecision(2) << resultado.registrosPorCommit
+                      << " registros por commit" << std::endl;
+        }
+        if (configMassa.ativa()) {
+            std::cout << "Massa (" << resultado.massa << "): " << resultado.passadasMassa << " passadas, "
+                      << banco.getContasMassa() << " contas, " << std::setprecision(3)
+                      << resultado.passadaMediaMs << " ms por passada";
+            if (configMassa.tipo == TipoMassa::CONCILIACAO) {
+                std::cout << ", " << resultado.divergenciasMassa << " divergências";
+            }
+            std::cout << std::endl;
+        }
+        if (mix.temRotatividade()) {
+            std::cout << "Rotatividade: " << resultado.aberturas << " aberturas, " << resultado.encerramentos
+                      << " encerramentos, " << banco.getContasAbertas() << " contas abertas ao final; "
+                      << banco.getLiberacoesReclamacao() << " liberações adiadas pela reclamação" << std::endl;
+        }
+        if (registrosTrace > 0) {
+            std::cout << "Trace: " << registrosTrace << " registros em " << arquivoCaptura << std::endl;
+        }
+        if (resultado.checkpoints > 0) {
+            std::cout << "Checkpoint (" << resultado.checkpoint << "): " << resultado.checkpoints
+                      << " checkpoints, " << resultado.registrosCheckpoint << " contas, "
+                      << std::setprecision(1) << resultado.bytesCheckpoint / 1024.0
+                      << " KiB; duração p50 " << std::setprecision(3) << resultado.checkpointP50Ms
+                      << " ms, máx " << resultado.checkpointMaxMs << " ms" << std::endl;
+        }
+        if (LoggerOperacoes::instancia().getDescartados() > 0) {
+            std::cout << "Registros de log descartados (anel cheio): "
+                      << LoggerOperacoes::instancia().getDescartados() << std::endl;
+        }
+
+        /*
+         * REGISTRO DE LOG:
+         * Salva resultados no arquivo CSV (e o perfil das travas, se ligado)
+         */
+        logger->registrarLogSimulacao(resultado);
+        if (loggerPerfil) {
+            std::vector<std::string> ids = banco.idsPorIndice();
+            std::map<size_t, PerfilConta> perfil = PerfilTravas::instancia().juntar();
+            loggerPerfil->registrar(resultado, ids, perfil);
+            imprimirPerfilTravas(ids, perfil);
+        }
+
+        /*
+         * RELATÓRIOS E PERSISTÊNCIA:
+         * Mostra estatísticas e salva estado final
+         */
+        if (mix.temRotatividade()) {
+            std::cout << "Contas encerradas reabertas com o saldo retirado: " << banco.reabrirEncerradas() << std::endl;
+        }
+        banco.imprimirEstatisticas();
+        banco.salvarContas("ContaCorrente.txt");
+        return resultado;
+    }
+
+    /*
+     * RESUMO DO PERFIL DAS TRAVAS:
+     * As contas com maior espera total (os dois modos somados) e quanto
+     * da espera elas concentram
+     */
+    static void imprimirPerfilTravas(const std::vector<std::string>& ids,
+                                     const std::map<size_t, PerfilConta>& perfil) {
+        static constexpr size_t MAIS_DISPUTADAS = 10;
+        std::vector<std::pair<uint64_t, size_t>> porEspera;   // (espera total, índice)
+        uint64_t esperaTotal = 0;
+        long long aquisicoes = 0;
+        for (const auto& [indice, contadores] : perfil) {
+            uint64_t espera = 0;
+            for (const ContadoresTrava& c : contadores) {
+                espera += c.esperaNs;
+                aquisicoes += c.aquisicoes;
+            }
+            esperaTotal += espera;
+            porEspera.emplace_back(espera, indice);
+        }
+        if (aquisicoes == 0) {
+            std::cout << "Perfil das travas: nenhuma aquisição (motor sem travas por conta)" << std::endl;
+            return;
+        }
+        size_t topo = std::min(MAIS_DISPUTADAS, porEspera.size());
+        std::partial_sort(porEspera.begin(), porEspera.begin() + topo, porEspera.end(),
+                          [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        uint64_t esperaTopo = 0;
+        for (size_t i = 0; i < topo; ++i) esperaTopo += porEspera[i].first;
+        std::cout << "Perfil das travas: " << aquisicoes << " aquisições em " << perfil.size()
+                  << " contas, espera total " << std::fixed << std::setprecision(3) << esperaTotal / 1e6
+                  << " ms; as " << topo << " mais disputadas concentram " << std::setprecision(1)
+                  << (esperaTotal > 0 ? 100.0 * esperaTopo / esperaTotal : 0.0) << "% da espera" << std::endl;
+        std::cout << "  " << std::left << std::setw(12) << "Conta" << std::setw(14) << "Modo" << std::right
+                  << std::setw(10) << "aquis." << std::setw(10) << "disput.%" << std::setw(12) << "espera ms"
+                  << std::setw(12) << "máx us" << std::setw(12) << "posse ms" << std::endl;
+        for (size_t i = 0; i < topo; ++i) {
+            size_t indice = porEspera[i].second;
+            const PerfilConta& contadores = perfil.at(indice);
+            for (size_t m = 0; m < NUM_MODOS_TRAVA; ++m) {
+                const ContadoresTrava& c = contadores[m];
+                if (c.aquisicoes == 0) continue;
+                std::cout << "  " << std::left << std::setw(12) << (indice < ids.size() ? ids[indice] : "?")
+                          << std::setw(14) << nomeModoTrava(m) << std::right << std::setw(10) << c.aquisicoes
+                          << std::setw(10) << std::setprecision(1) << 100.0 * c.disputadas / c.aquisicoes
+                          << std::setw(12) << std::setprecision(3) << c.esperaNs / 1e6
+                          << std::setw(12) << std::setprecision(1) << c.maiorEsperaNs / 1e3
+                          << std::setw(12) << std::setprecision(3) << c.posseNs / 1e6 << std::endl;
+            }
+        }
+    }
+
+    /*
+     * CONFIGURAÇÃO DE UM BANCO NOVO:
+     * Aplica as configurações do sistema antes de carregar as contas
+     */
+    template <typename Conta>
+    void configurarBanco(Banco<Conta>& banco) {
+        banco.configurarWAL(configWAL);
+        banco.configurarCheckpoint(configCheckpoint);
+        banco.configurarAdmissao(configAdmissao);
+        banco.configurarCombinacao(modoCombinacao);
+        banco.configurarArranjo(arranjo);
+    }
+
+    /*
+     * CÓPIA DAS CONTAS EM MEMÓRIA:
+     * Estado atual do arquivo, sem aplicar o WAL nem abrir um novo
+     * (para bancos descartáveis que não alteram o arquivo)
+     */
+    static std::vector<ContaLida> lerContasDoArquivo() {
+        ArquivoMapeado mapa("ContaCorrente.txt");
+        if (!mapa.aberto()) throw std::runtime_error("Arquivo ContaCorrente.txt não encontrado.");
+        return ArmazenamentoContas::ler(mapa.data(), mapa.size(), threadsDisponiveis());
+    }
+
+    /*
+     * CONTAS SINTÉTICAS:
+     * IDs 00000001.. e saldos de 0 a 50000 (semente fixa, sempre as mesmas)
+     */
+    static std::vector<ContaLida> contasSinteticas(size_t quantidade) {
+        std::mt19937 gerador(42);
+        std::uniform_int_distribution<long long> centavosDist(0, 5000000);
+        char id[24];
+        std::vector<ContaLida> contas(quantidade);
+        for (size_t i = 0; i < quantidade; ++i) {
+            std::snprintf(id, sizeof(id), "%08zu", i + 1);
+            contas[i] = {id, centavosDist(gerador) / 100.0};
+        }
+        return contas;
+    }
+
+    /*
+     * PROCESSO CLIENTE DO BENCHMARK DE SOCKET:
+     * Executa este mesmo binário em modo cliente (posix_spawn, seguro com
+     * threads) e lê o resultado agregado, em binário, da saída padrão dele
+     */
+    ResultadoCliente lancarProcessoCliente(const std::string& caminho, int processos, int operacoes,
+                                           int janela) {
+        std::vector<std::string> argumentos = {
+            "/proc/self/exe", "--log=nenhum", "--mix=" + mix.nome,
+            "--distribuicao=" + configCarga.descricao(),
+            "--cliente=" + caminho + "," + std::to_string(processos) + "," +
+                std::to_string(operacoes) + "," + std::to_string(janela),
+            "--cliente-binario"};
+        if (configCarga.semente) argumentos.push_back("--semente=" + std::to_string(configCarga.semente));
+        std::vector<char*> argv;
+        for (std::string& argumento : argumentos) argv.push_back(argumento.data());
+        argv.push_back(nullptr);
+
+        ResultadoCliente resultado;
+        int canal[2];
+        if (::pipe(canal) < 0) return resultado;
+        posix_spawn_file_actions_t acoes;
+        posix_spawn_file_actions_init(&acoes);
+        posix_spawn_file_actions_adddup2(&acoes, canal[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addclose(&acoes, canal[0]);
+        posix_spawn_file_actions_addclose(&acoes, canal[1]);
+        pid_t pid;
+        int erro = posix_spawn(&pid, argv[0], &acoes, nullptr, argv.data(), environ);
+        posix_spawn_file_actions_destroy(&acoes);
+        ::close(canal[1]);
+        if (erro == 0) {
+            if (!lerTudo(canal[0], &resultado, sizeof(resultado))) resultado = ResultadoCliente();
+            ::waitpid(pid, nullptr, 0);
+        } else {
+            std::cerr << "Erro ao criar processo cliente: " << std::strerror(erro) << std::endl;
+        }
+        ::close(canal[0]);
+        return resultado;
+    }
+
+    /*
+     * SIMULAÇÃO COM MOTOR ESCOLHIDO EM TEMPO DE EXECUÇÃO:
+     * Cria um banco novo do tipo certo, carrega as contas e executa
+     */
+    ResultadoSimulacao executarSimulacao(MotorConta motor, int numThreads, int operacoesPorThread) {
+        return despacharMotor(motor, [&](auto tipo) {
+            using Conta = typename decltype(tipo)::tipo;
+            Banco<Conta> banco;
+            configurarBanco(banco);
+            banco.carregarContas("ContaCorrente.txt");
+            return executarSimulacao(banco, numThreads, operacoesPorThread);
+        });
+    }
+
+    /*
+     * MÚLTIPLAS SIMULAÇÕES:
+     * Compara os motores configurados de 2 a 64 threads
+     */
+    void executarMultiplasSimulacoes() {
+        /*
+         * CONFIGURAÇÃO DE TESTE:
+         * Array com diferentes números de threads para testar
+         */
+        std::vector<int> numThreads = {2, 4, 8, 16, 32, 64};
+        int operacoesPorThread = 50;
+
+        std::cout << "=== INICIANDO MÚLTIPLAS SIMULAÇÕES ===" << std::endl;
+        std::cout << "Será gerado arquivo: simulacao_logs.csv" << std::endl;
+
+        /*
+         * LOOP DE SIMULAÇÕES:
+         * Para cada motor e cada configuração de threads
+         */
+        for (MotorConta motor : motores) {
+            for (int threads : numThreads) {
+                std::cout << "\n" << std::string(50, '=') << "\n";
+                std::cout << "SIMULAÇÃO COM " << threads << " THREADS\n";
+                std::cout << std::string(50, '=') << "\n";
+
+                /*
+                 * EXECUÇÃO DA SIMULAÇÃO:
+                 * Cada execução recria o banco para garantir estado limpo
+                 */
+                executarSimulacao(motor, threads, operacoesPorThread);
+
+                /*
+                 * PAUSA ENTRE SIMULAÇÕES:
+                 * Evita sobrecarga do sistema
+                 */
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            }
+        }
+    }
+
+    /*
+     * BENCHMARKS E VARREDURA:
+     * Definidos em benchmarks.hpp
+     */
+    void executarVarredura(const ConfigVarredura& config);
+    void executarBenchmarkSocket(int processos);
+    void executarBenchmarkWAL();
+    void executarBenchmarkCheckpoint(size_t numContas);
+    void executarBenchmarkMassa(size_t numContas);
+    void executarBenchmarkIndice(size_t numContas);
+    void executarBenchmarkParticionado(size_t numContas);
+    void executarBenchmarkCorrotinas(size_t maxClientes);
+    void executarBenchmarkAuditoria();
+    void executarBenchmarkCombinacao();
+    void executarBenchmarkSaturacao(int numThreads);
+    void executarBenchmarkCoerencia();
+    void executarBenchmarkCarga(size_t numContas);
+
+    /*
+     * MODO SERVIDOR:
+     * Carrega as contas (com WAL, como uma simulação), atende pedidos pelo
+     * socket até SIGINT/SIGTERM e então salva as contas. Usa o primeiro
+     * motor de --motor e 'lacos' laços epoll.
+     */
+    void executarServidor(const std::string& caminho, unsigned lacos) {
+        despacharMotor(motores.front(), [&](auto tipo) {
+            using Conta = typename decltype(tipo)::tipo;
+            Banco<Conta> banco;
+            configurarBanco(banco);
+            banco.carregarContas("ContaCorrente.txt");
+            ServidorBanco<Conta> servidor(banco, caminho, lacos);
+            std::signal(SIGINT, tratarSinalParada);
+            std::signal(SIGTERM, tratarSinalParada);
+            if (!servidor.iniciar()) return;
+            std::cout << "Servidor (" << Conta::nomeMotor() << ") em " << caminho << " com " << lacos
+                      << " laços epoll; Ctrl+C encerra" << std::endl;
+            if (!arquivoCaptura.empty()) banco.iniciarCaptura(arquivoCaptura);
+            banco.iniciarCheckpoints(configCheckpoint);
+            while (!servidorEncerrando.load()) std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            servidor.parar();
+            banco.pararCheckpoints();
+            uint64_t registrosTrace = banco.pararCaptura();
+
+            std::cout << "\n=== SERVIDOR ENCERRADO ===" << std::endl;
+            std::cout << "Pedidos atendidos: " << servidor.getPedidosAtendidos() << " ("
+                      << std::fixed << std::setprecision(2)
+                      << (servidor.getLeituras() ? static_cast<double>(servidor.getPedidosAtendidos())
+                                                   / servidor.getLeituras() : 0)
+                      << " por read)" << std::endl;
+            if (registrosTrace > 0) {
+                std::cout << "Trace: " << registrosTrace << " registros em " << arquivoCaptura << std::endl;
+            }
+            if (banco.getCheckpointsGravados() > 0) {
+                std::cout << "Checkpoints em " << configCheckpoint.arquivo << ": "
+                          << banco.getCheckpointsGravados() << " (" << banco.getRegistrosCheckpoint()
+                          << " contas, " << std::setprecision(1) << banco.getBytesCheckpoint() / 1024.0
+                          << " KiB); WAL recortado " << banco.getRecortesWAL() << " vezes" << std::endl;
+            }
+            banco.imprimirEstatisticas();
+            banco.salvarContas("ContaCorrente.txt");
+        });
+    }
+
+    /*
+     * REPRODUÇÃO DE UM TRACE:
+     * Para cada motor de --motor, reproduz o trace sobre um banco novo com
+     * as contas de partida do próprio trace, primeiro em sequência e
+     * depois em 'raias' raias. O estado final de cada reprodução é
+     * identificado pelo hash do texto das contas (centavos); todas têm de
+     * conferir com os saldos finais gravados pela captura (ou, num trace
+     * sem eles, com a primeira reprodução) e nenhuma operação pode ter
+     * resultado diferente do capturado: o trace está na ordem em que
+     * cada conta viu as operações. O arquivo de contas não é alterado.
+     */
+    bool executarReproducao(const std::string& arquivo, unsigned raias) {
+        TraceOperacoes trace = lerTrace(arquivo);
+        std::vector<ContaLida> iniciais;
+        for (const ContaLida& c : trace.contas) {
+            if (!c.id.empty()) iniciais.push_back(c);
+        }
+        ConfigAdmissao admissaoOriginal = configAdmissao;
+        configAdmissao.ativa = false;
+
+        struct Linha {
+            std::string motor;
+            std::string modo;
+            size_t unidades = 0;
+            double tempoMs = 0;
+            long long diferentes = 0;
+            long long recusadas = 0;
+            size_t entreRaias = 0;
+            uint64_t hash = 0;
+            bool consistente = false;
+        };
+
+        std::cout << "=== REPRODUÇÃO DO TRACE " << arquivo << " ===" << std::endl;
+        std::cout << trace.registros.size() << " registros, " << iniciais.size() << " contas, "
+                  << raias << " raias" << std::endl;
+        std::cout << "Serviço (" << ModeloServico::instancia().getNomePreset() << "): "
+                  << ModeloServico::instancia().descricao() << std::endl;
+        std::cout << std::setw(10) << "motor" << std::setw(12) << "modo" << std::setw(12) << "tempo ms"
+                  << std::setw(12) << "ops/s" << std::setw(12) << "entre raias" << std::setw(12)
+                  << "diferentes" << std::setw(20) << "hash estado final" << std::setw(10) << "confere"
+                  << std::endl;
+        auto hashContas = [](std::vector<ContaLida> contas) {
+            std::sort(contas.begin(), contas.end(),
+                      [](const ContaLida& a, const ContaLida& b) { return a.id < b.id; });
+            std::string texto = ArmazenamentoContas::serializarTexto(contas);
+            return hashFNV1a(texto.data(), texto.size());
+        };
+        uint64_t referencia = 0;
+        long long recusadas = 0;
+        bool primeira = true, tudoConfere = true;
+        if (!trace.finais.empty()) {
+            std::vector<ContaLida> finais;
+            for (const ContaLida& c : trace.finais) {
+                if (!c.id.empty()) finais.push_back(c);
+            }
+            referencia = hashContas(std::move(finais));
+            primeira = false;
+            std::cout << std::setw(10) << "captura" << std::setw(72) << std::hex << referencia << std::dec
+                      << std::endl;
+        }
+        for (MotorConta motor : motores) {
+            for (unsigned modo : {0u, raias}) {
+                Linha l = despacharMotor(motor, [&](auto tipo) {
+                    using Conta = typename decltype(tipo)::tipo;
+                    Banco<Conta> banco;
+                    configurarBanco(banco);
+                    banco.adicionarContas(iniciais);
+                    ReprodutorTrace<Conta> reprodutor(banco, trace);
+                    Linha linha;
+                    linha.motor = Conta::nomeMotor();
+                    linha.modo = modo == 0 ? "sequencial" : std::to_string(modo) + " raias";
+                    linha.tempoMs = modo == 0 ? reprodutor.sequencial() : reprodutor.paralelo(modo);
+                    linha.unidades = reprodutor.getUnidades();
+                    linha.diferentes = reprodutor.getDiferentes();
+                    linha.recusadas = reprodutor.getRecusadas();
+                    linha.entreRaias = reprodutor.getEntreRaias();
+                    typename Banco<Conta>::Snapshot foto = banco.tirarSnapshot();
+                    linha.hash = hashContas(foto.saldos);
+                    linha.consistente = foto.consistente();
+                    return linha;
+                });
+                if (primeira) referencia = l.hash;
+                primeira = false;
+                bool confere = l.hash == referencia && l.consistente && l.diferentes == 0;
+                tudoConfere = tudoConfere && confere;
+                std::cout << std::setw(10) << l.motor << std::setw(12) << l.modo << std::fixed
+                          << std::setprecision(1) << std::setw(12) << l.tempoMs << std::setprecision(0)
+                          << std::setw(12) << (l.tempoMs > 0 ? (l.unidades - l.recusadas) / (l.tempoMs / 1000.0) : 0)
+                          << std::setw(12) << l.entreRaias << std::setw(12) << l.diferentes
+                          << std::setw(20) << std::hex << l.hash << std::dec
+                          << std::setw(10) << (confere ? "sim" : "NÃO") << std::endl;
+                recusadas = l.recusadas;
+            }
+        }
+        if (recusadas > 0) {
+            std::cout << recusadas << " operações recusadas na captura não foram reproduzidas" << std::endl;
+        }
+        if (trace.finais.empty()) std::cout << "Trace sem saldos finais: conferido só entre as reproduções" << std::endl;
+        std::cout << (tudoConfere ? "Todas as reproduções conferem."
+                                  : "ATENÇÃO: reproduções divergiram da captura ou entre si.")
+                  << std::endl;
+        configAdmissao = admissaoOriginal;
+        return tudoConfere;
+    }
+
+    /*
+     * CONVERSÃO ENTRE FORMATOS:
+     * O formato de entrada é detectado pelo cabeçalho; o de saída pela
+     * extensão (.bin = binário, qualquer outra = texto ID|SALDO)
+     */
+    void converterContas(const std::string& entrada, const std::string& saida) {
+        std::cout << "=== CONVERSÃO DE CONTAS ===" << std::endl;
+        Banco<ContaCorrente> banco;
+        ConfigWAL semWAL;
+        semWAL.ativo = false;
+        banco.configurarWAL(semWAL);
+        banco.carregarContas(entrada);
+        banco.salvarContas(saida);
+        std::cout << entrada << " -> " << saida << " ("
+                  << (ArmazenamentoContas::caminhoBinario(saida) ? "binário" : "texto") << ")" << std::endl;
+    }
+
+    /*
+     * AUTOTESTE DA RECUPERAÇÃO PELO WAL (semente fixa, uma thread):
+     * 1. Grava contas sintéticas num arquivo próprio e o carrega com WAL;
+     *    executa créditos, débitos, transferências, lotes (parte falha
+     *    por saldo), encerramentos e reaberturas dos mesmos IDs e guarda,
+     *    pelo último LSN, o estado depois de cada um
+     * 2. Corta uma cópia do WAL em cada fronteira de registro e no meio
+     *    de cada registro e recupera cada corte como carregarContas
+     * 3. Confere que cada recuperação é o estado de uma operação terminada
+     *    (nunca meio lote), com as mesmas contas abertas, o total esperado
+     *    até ela (saldo inicial + créditos - débitos) e nenhum saldo negativo
+     * Não toca em ContaCorrente.txt. Retorna false na primeira divergência.
+     */
+    bool verificarRecuperacaoWAL(size_t operacoes) {
+        const std::string arquivo = "autoteste_wal.txt";
+        const std::string arquivoWAL = arquivo + ".wal";           // Ver Banco::caminhoWAL
+        const std::string arquivoCorte = arquivo + ".corte";
+        std::vector<ContaLida> base = contasSinteticas(16);
+        std::string conteudo = ArmazenamentoContas::serializar(arquivo, base);
+        base = ArmazenamentoContas::lerTexto(conteudo.data(), conteudo.size(), 1);
+        uint64_t hashBase = hashBlocos(conteudo.data(), conteudo.size());
+        ConfigWAL walTeste;
+        walTeste.loteMaximo = 1;
+        walTeste.latenciaMaxima = std::chrono::microseconds(0);
+
+        struct EstadoEsperado {
+            std::map<std::string, long long> saldos;               // Centavos
+            long long total = 0;                                    // Inicial + créditos - débitos
+        };
+
+        std::cout << "=== AUTOTESTE DA RECUPERAÇÃO PELO WAL (" << operacoes << " operações) ===" << std::endl;
+        bool ok = true;
+        for (MotorConta motor : motores) {
+            std::map<uint64_t, EstadoEsperado> estados;             // Pelo último LSN
+            std::remove(arquivoWAL.c_str());                        // Cada motor parte do mesmo arquivo, sem WAL
+            if (!ArmazenamentoContas::gravarAtomicamente(arquivo, conteudo)) {
+                std::cerr << "Erro ao gravar " << arquivo << std::endl;
+                return false;
+            }
+            std::string nome = despacharMotor(motor, [&](auto tipo) {
+                using Conta = typename decltype(tipo)::tipo;
+                Banco<Conta> banco;
+                configurarBanco(banco);
+                banco.configurarWAL(walTeste);
+                banco.configurarCheckpoint(ConfigCheckpoint{});
+                banco.carregarContas(arquivo);
+                auto registrarEstado = [&] {
+                    auto foto = banco.tirarSnapshot();
+                    EstadoEsperado estado;
+                    for (const ContaLida& c : foto.saldos) estado.saldos[c.id] = std::llround(c.saldo * 100.0);
+                    estado.total = std::llround(foto.esperado * 100.0);
+                    estados[banco.getUltimoLsnWAL()] = std::move(estado);
+                };
+                registrarEstado();
+
+                std::mt19937 gerador(7);
+                std::uniform_int_distribution<long long> centavosDist(1, 3000000);
+                std::vector<std::string> abertas, fechadas;
+                for (const ContaLida& c : base) abertas.push_back(c.id);
+                auto sortear = [&](const std::vector<std::string>& ids) {
+                    return ids[std::uniform_int_distribution<size_t>(0, ids.size() - 1)(gerador)];
+                };
+                std::string a, b;
+                for (size_t i = 0; i < operacoes; ++i) {
+                    double valor = centavosDist(gerador) / 100.0;
+                    a = sortear(abertas);
+                    do { b = sortear(abertas); } while (b == a);
+                    switch (i % 6) {
+                        case 0: banco.creditar(banco.obterConta(a), valor); break;
+                        case 1: banco.debitar(banco.obterConta(a), valor); break;
+                        case 2: banco.transferir(a, b, valor); break;
+                        case 3: {
+                            std::vector<OperacaoLote> lote = {{TipoOperacaoLote::CREDITO, a, "", valor / 3},
+                                                              {TipoOperacaoLote::TRANSFERENCIA, a, b, valor},
+                                                              {TipoOperacaoLote::DEBITO, b, "", valor / 2}};
+                            banco.executarLote(std::move(lote));
+                            break;
+                        }
+                        case 4:
+                            // Rotatividade: encerra (com saldo) e finaliza já, para o estado ser o do log
+                            if (abertas.size() > base.size() / 2 && banco.encerrarConta(a) == StatusOperacao::SUCESSO) {
+                                banco.concluirEncerramentos();
+                                abertas.erase(std::find(abertas.begin(), abertas.end(), a));
+                                fechadas.push_back(a);
+                            }
+                            break;
+                        default:
+                            if (i % 12 == 5) {
+                                // ID que não está no arquivo de partida (depois também encerrado e reaberto)
+                                std::string novo = "NOVA" + std::to_string(i);
+                                if (banco.abrirConta(novo, valor) == StatusOperacao::SUCESSO) abertas.push_back(novo);
+                            } else if (!fechadas.empty() &&
+                                       banco.abrirConta(fechadas.front(), valor) == StatusOperacao::SUCESSO) {
+                                // Reabre o ID encerrado há mais tempo: o mesmo ID abre e fecha várias vezes no log
+                                abertas.push_back(fechadas.front());
+                                fechadas.erase(fechadas.begin());
+                            }
+                    }
+                    registrarEstado();
+                }
+                return std::string(Conta::nomeMotor());
+            });
+
+            /*
+             * CORTES:
+             * Com o banco destruído o WAL está completo; cada corte é
+             * recuperado sobre o mesmo snapshot de partida
+             */
+            std::ifstream in(arquivoWAL, std::ios::binary);
+            std::string wal((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+            size_t numRegistros = (wal.size() - std::min(wal.size(), sizeof(CabecalhoWAL))) / sizeof(RegistroWAL);
+            size_t cortes = 0;
+            std::string divergencia;
+            for (size_t k = 0; k <= numRegistros && divergencia.empty(); ++k) {
+                for (size_t meio : {size_t{0}, sizeof(RegistroWAL) / 2}) {
+                    if (k == numRegistros && meio > 0) break;
+                    size_t tamanho = sizeof(CabecalhoWAL) + k * sizeof(RegistroWAL) + meio;
+                    std::ofstream(arquivoCorte, std::ios::binary | std::ios::trunc).write(wal.data(), tamanho);
+                    RecuperacaoWAL recuperado = WriteAheadLog::recuperar(arquivoCorte, hashBase);
+                    std::vector<ContaLida> contas = base;
+                    aplicarRecuperacao(contas, recuperado);
+                    cortes++;
+
+                    auto esperado = estados.find(recuperado.ultimoLsn);
+                    std::map<std::string, long long> saldos;
+                    std::string negativo;
+                    long long total = 0;
+                    for (const ContaLida& c : contas) {
+                        long long centavos = std::llround(c.saldo * 100.0);
+                        if (centavos < 0 && negativo.empty()) negativo = c.id;
+                        saldos[c.id] = centavos;
+                        total += centavos;
+                    }
+                    if (!recuperado.valido) {
+                        divergencia = "WAL recusado";
+                    } else if (!negativo.empty()) {
+                        divergencia = "saldo negativo em " + negativo;
+                    } else if (esperado == estados.end()) {
+                        divergencia = "LSN " + std::to_string(recuperado.ultimoLsn) + " não fecha uma operação";
+                    } else if (total != esperado->second.total) {
+                        divergencia = "total " + std::to_string(total) + " != esperado " +
+                                      std::to_string(esperado->second.total) + " (centavos)";
+                    } else if (saldos != esperado->second.saldos) {
+                        divergencia = "saldos diferentes do estado do LSN " + std::to_string(recuperado.ultimoLsn);
+                    }
+                    if (!divergencia.empty()) {
+                        divergencia = "corte em " + std::to_string(tamanho) + " bytes: " + divergencia;
+                        break;
+                    }
+                }
+            }
+            std::cout << std::setw(10) << nome << ": " << numRegistros << " registros, " << cortes
+                      << " cortes recuperados, " << (divergencia.empty() ? "ok" : divergencia) << std::endl;
+            ok = ok && divergencia.empty();
+        }
+        std::remove(arquivo.c_str());
+        std::remove(arquivoWAL.c_str());
+        std::remove(arquivoCorte.c_str());
+        return ok;
+    }
+
+    /*
+     * AUTOTESTE DE CONCORRÊNCIA:
+     * 1. Travas seqlock, ticket e mcs: 4 threads sorteiam créditos,
+     *    débitos, consultas, transferências e lotes (N operações no total)
+     *    sobre 8 contas, com débitos recusados por falta de saldo, enquanto
+     *    outra thread tira snapshots. Cada snapshot e o estado final têm
+     *    de fechar o total esperado, sem saldo negativo nem consulta
+     *    negativa
+     * 2. Cada uma dessas cargas é capturada num trace e reproduzida
+     *    (executarReproducao) nos mesmos motores, em sequência e em 4
+     *    raias: toda reprodução tem de chegar aos saldos finais da captura
+     * 3. Banco particionado: a transferência em duas fases com 1, 2 e 4
+     *    partições, mix de transferências e conjunto quente, tem de fechar
+     *    o total sem saldo negativo
+     * Não toca em ContaCorrente.txt. Retorna false se alguma parte falhar.
+     */
+    bool verificarConcorrencia(size_t operacoes) {
+        const std::string arquivoTrace = "autoteste_concorrencia.trace";
+        const unsigned threads = 4;
+        const std::vector<MotorConta> verificados = {MotorConta::SEQLOCK, MotorConta::TICKET, MotorConta::MCS};
+        std::vector<ContaLida> base = contasSinteticas(8);
+        std::vector<std::string> ids;
+        for (const ContaLida& c : base) ids.push_back(c.id);
+
+        std::cout << "=== AUTOTESTE DE CONCORRÊNCIA (" << operacoes << " operações) ===" << std::endl;
+        bool ok = true;
+        for (MotorConta motor : verificados) {
+            long long snapshots = 0;
+            bool capturado = false;
+            std::string divergencia;
+            std::string nome = despacharMotor(motor, [&](auto tipo) {
+                using Conta = typename decltype(tipo)::tipo;
+                Banco<Conta> banco;
+                configurarBanco(banco);
+                banco.adicionarContas(base);
+                if (!banco.iniciarCaptura(arquivoTrace)) {
+                    divergencia = "trace não criado";
+                    return std::string(Conta::nomeMotor());
+                }
+                capturado = true;
+
+                std::atomic<unsigned> terminadas{0};
+                std::atomic<long long> consultasNegativas{0};
+                long long snapshotsDivergentes = 0;
+                executarEmParalelo(threads + 1, [&](unsigned t) {
+                    if (t == threads) {
+                        // Auditor: snapshots até a última thread de carga terminar
+                        while (terminadas.load(std::memory_order_acquire) < threads) {
+                            typename Banco<Conta>::Snapshot foto = banco.tirarSnapshot();
+                            bool negativo = std::any_of(foto.saldos.begin(), foto.saldos.end(),
+                                                        [](const ContaLida& c) { return c.saldo < 0; });
+                            snapshots++;
+                            if (!foto.consistente() || negativo) snapshotsDivergentes++;
+                        }
+                        return;
+                    }
+                    std::mt19937 gerador(t + 1);
+                    std::uniform_int_distribution<long long> centavosDist(1, 2000000);
+                    std::uniform_int_distribution<size_t> contaDist(0, ids.size() - 1);
+                    for (size_t i = t; i < operacoes; i += threads) {
+                        double valor = centavosDist(gerador) / 100.0;
+                        const std::string& a = ids[contaDist(gerador)];
+                        const std::string* b = &ids[contaDist(gerador)];
+                        while (*b == a) b = &ids[contaDist(gerador)];
+                        double saldo = 0;
+                        switch (gerador() % 5) {
+                            case 0: banco.creditar(banco.obterConta(a), valor); break;
+                            case 1: banco.debitar(banco.obterConta(a), valor); break;
+                            case 2:
+                                banco.consultarSaldo(banco.obterConta(a), saldo);
+                                if (saldo < 0) consultasNegativas++;
+                                break;
+                            case 3: banco.transferir(a, *b, valor); break;
+                            default:
+                                banco.executarLote({{TipoOperacaoLote::CREDITO, a, "", valor / 3},
+                                                    {TipoOperacaoLote::TRANSFERENCIA, a, *b, valor},
+                                                    {TipoOperacaoLote::DEBITO, *b, "", valor / 2}});
+                        }
+                    }
+                    terminadas.fetch_add(1, std::memory_order_acq_rel);
+                });
+                banco.pararCaptura();
+
+                typename Banco<Conta>::Snapshot foto = banco.tirarSnapshot();
+                bool negativo = std::any_of(foto.saldos.begin(), foto.saldos.end(),
+                                            [](const ContaLida& c) { return c.saldo < 0; });
+                if (snapshotsDivergentes > 0) {
+                    divergencia = std::to_string(snapshotsDivergentes) + " snapshots sem fechar o total";
+                } else if (!foto.consistente()) {
+                    divergencia = "total final " + std::to_string(foto.total) + " != esperado " +
+                                  std::to_string(foto.esperado);
+                } else if (negativo) {
+                    divergencia = "saldo final negativo";
+                } else if (consultasNegativas > 0) {
+                    divergencia = std::to_string(consultasNegativas.load()) + " consultas negativas";
+                }
+                return std::string(Conta::nomeMotor());
+            });
+            std::cout << std::setw(10) << nome << ": " << snapshots << " snapshots durante a carga, "
+                      << (divergencia.empty() ? "ok" : divergencia) << std::endl;
+            ok = ok && divergencia.empty();
+
+            if (!capturado) continue;
+            // Reprodução da carga que acabou de ser capturada
+            std::vector<MotorConta> motoresOriginal = motores;
+            motores = verificados;
+            ok = executarReproducao(arquivoTrace, threads) && ok;
+            motores = motoresOriginal;
+        }
+        std::remove(arquivoTrace.c_str());
+
+        ConfigCarga carga;
+        carga.distribuicao = DistribuicaoContas::HOTSPOT;
+        carga.fracaoQuente = 0.25;
+        carga.semente = 7;
+        std::cout << "=== BANCO PARTICIONADO ===" << std::endl;
+        for (unsigned particoes : {1u, 2u, 4u}) {
+            BancoParticionado banco(base, MixOperacoes::transferencias(), carga, particoes);
+            BancoParticionado::Resultado r = banco.executar(static_cast<int>(operacoes / particoes));
+            bool confere = r.confere && r.negativos == 0;
+            std::cout << std::setw(10) << particoes << " partições: " << r.sucessos << " sucessos, " << r.falhas
+                      << " falhas, " << r.entreParticoes << " entre partições, "
+                      << (confere ? "ok" : r.confere ? "saldo negativo" : "total diverge") << std::endl;
+            ok = ok && confere;
+        }
+        std::cout << (ok ? "Autoteste de concorrência ok." : "ATENÇÃO: autoteste de concorrência falhou.")
+                  << std::endl;
+        return ok;
+    }
+
+    /*
+     * SIMULAÇÃO PERSONALIZADA:
+     * Permite especificar configurações customizadas
+     */
+    void executarSimulacaoPersonalizada(const std::vector<int>& threads, 
+                                       int operacoesPorThread) {
+        std::cout << "=== SIMULAÇÃO PERSONALIZADA ===" << std::endl;
+        
+        for (MotorConta motor : motores) {
+            for (int numThreads : threads) {
+                std::cout << "\n" << std::string(50, '=') << "\n";
+                std::cout << "SIMULAÇÃO COM " << numThreads << " THREADS\n";
+                std::cout << std::string(50, '=') << "\n";
+
+                // Mesmo padrão: recria o banco para estado limpo
+                executarSimulacao(motor, numThreads, operacoesPorThread);
+                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            }
+        }
+    }
+
+    /*
+     * LIMPEZA DE LOGS:
+     * Remove logs anteriores
+     */
+    void limparLogs() {
+        logger->limparLogs();
+    }
+};
+
+#endif  // BANCO_SISTEMA_HPP
@@ -0,0 +1,1250 @@
+/*
+ * INFRAESTRUTURA COMUM
+ * Includes, log assíncrono de operações, modelo de tempo de serviço,
+ * controle de admissão, contadores distribuídos, épocas dos snapshots e
+ * reclamação de memória por épocas
+ */
+#ifndef BANCO_SUPORTE_HPP
+#define BANCO_SUPORTE_HPP
+
+#include <iostream>          // Para entrada/saída (cout, cin)
+#include <fstream>           // Para manipulação de arquivos
+#include <thread>            // Para criação e gerenciamento de threads
+#include <mutex>             // Para sincronização básica (exclusão mútua)
+#include <condition_variable> // Para sincronização avançada (thread de drenagem do log)
+#include <shared_mutex>      // Para Reader-Writer locks
+#include <vector>            // Para arrays dinâmicos
+#include <map>               // Para mapeamento chave-valor
+#include <unordered_map>     // Para os buffers por thread do perfil de travas
+#include <random>            // Para geração de números aleatórios
+#include <chrono>            // Para medição de tempo
+#include <string>            // Para manipulação de strings
+#include <sstream>           // Para conversão string-stream
+#include <atomic>            // Para operações atômicas (thread-safe)
+#include <iomanip>           // Para formatação de saída
+#include <memory>            // Para unique_ptr e shared_ptr
+#include <cstdio>            // Para snprintf
+#include <cstring>           // Para strncpy
+#include <cmath>             // Para llround (conversão para centavos)
+#include <algorithm>         // Para sort (ordenação de locks)
+#include <cstdint>           // Para inteiros de tamanho fixo (formato binário do WAL)
+#include <cstddef>           // Para offsetof
+#include <cerrno>            // Para errno
+#include <fcntl.h>           // Para open (POSIX)
+#include <unistd.h>          // Para write, fdatasync, ftruncate (POSIX)
+#include <sys/mman.h>        // Para mmap (arquivo binário de contas)
+#include <sys/stat.h>        // Para fstat
+#include <charconv>          // Para from_chars (parsing rápido de texto)
+#include <iterator>          // Para back_inserter
+#include <deque>             // Para as filas do pool de trabalho
+#include <array>             // Para os baldes dos histogramas de latência
+#include <functional>        // Para std::function (tarefas do pool)
+#include <optional>          // Para a época de um lote (fechada antes do WAL)
+#include <limits>            // Para numeric_limits (extremos da conciliação)
+#include <numeric>           // Para iota (regravação completa de um slot de checkpoint)
+#include <csignal>           // Para encerrar o modo servidor com SIGINT/SIGTERM
+#include <spawn.h>           // Para posix_spawn (processos clientes do benchmark de socket)
+#include <sys/socket.h>      // Para o servidor local (socket Unix)
+#include <sys/un.h>          // Para sockaddr_un
+#include <sys/epoll.h>       // Para o laço de eventos do servidor
+#include <sys/eventfd.h>     // Para acordar os laços na parada
+#include <sys/wait.h>        // Para waitpid (processos clientes)
+#include <sched.h>           // Para sched_getaffinity (CPUs permitidas ao processo)
+#include <pthread.h>         // Para pthread_setaffinity_np (workers fixados do banco particionado)
+#include <queue>             // Para priority_queue (clientes pausados, por instante de volta)
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>         // Para os clientes em corrotinas (só com -std=c++20)
+#define BANCO_CORROTINAS 1
+#else
+#define BANCO_CORROTINAS 0
+#endif
+
+/*
+ * LINHA DE CACHE:
+ * Unidade de coerência entre os núcleos. Dois dados escritos por threads
+ * diferentes na mesma linha fazem a linha migrar de cache em cache a cada
+ * escrita (false sharing), mesmo sem nenhum dado compartilhado de fato.
+ */
+constexpr size_t TAMANHO_LINHA_CACHE = 64;
+
+// ===================================
+// Logger Assíncrono de Operações
+// ===================================
+/*
+ * NÍVEIS DE VERBOSIDADE:
+ * - NENHUM: nada é registrado (o caminho quente só testa uma flag)
+ * - ESCRITAS: apenas créditos e débitos
+ * - TODAS: créditos, débitos e consultas
+ */
+enum class NivelLog { NENHUM = 0, ESCRITAS = 1, TODAS = 2 };
+
+enum class TipoRegistro : unsigned char { CREDITO, DEBITO, CONSULTA, TRANSFERENCIA };
+
+/*
+ * REGISTRO DE TAMANHO FIXO:
+ * É tudo o que o caminho quente copia. A formatação do texto fica
+ * a cargo da thread de drenagem, fora de qualquer lock das contas.
+ */
+struct RegistroOperacao {
+    TipoRegistro tipo;
+    char conta[15];        // ID da conta (truncado se necessário)
+    char destino[15];      // Conta de destino (apenas transferências)
+    double valor;          // Valor creditado/debitado
+    double saldo;          // Saldo após a operação (ou saldo da origem na transferência)
+    int leitores;          // Leitores ativos (apenas consultas)
+};
+
+/*
+ * BUFFER CIRCULAR SPSC (um produtor, um consumidor):
+ * - Cada thread produtora possui o seu próprio anel
+ * - Apenas a thread de drenagem consome
+ * - cabeca e cauda ficam em linhas de cache distintas para evitar falso compartilhamento
+ */
+class AnelRegistros {
+public:
+    static constexpr size_t CAPACIDADE = 4096;   // Potência de 2
+
+    std::atomic<bool> abandonado{false};         // Thread produtora terminou
+
+    /*
+     * INSERÇÃO (PRODUTOR):
+     * Retorna false se o anel estiver cheio; o produtor nunca espera.
+     */
+    bool inserir(const RegistroOperacao& registro) {
+        size_t t = cauda.load(std::memory_order_relaxed);
+        if (t - cabeca.load(std::memory_order_acquire) == CAPACIDADE) return false;
+        buffer[t & (CAPACIDADE - 1)] = registro;
+        cauda.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /*
+     * DRENAGEM (CONSUMIDOR):
+     * Entrega todos os registros disponíveis à função e libera o espaço
+     */
+    template <typename Funcao>
+    size_t drenar(Funcao&& consumir) {
+        size_t h = cabeca.load(std::memory_order_relaxed);
+        size_t t = cauda.load(std::memory_order_acquire);
+        for (size_t i = h; i != t; ++i) {
+            consumir(buffer[i & (CAPACIDADE - 1)]);
+        }
+        cabeca.store(t, std::memory_order_release);
+        return t - h;
+    }
+
+    bool vazio() const {
+        return cabeca.load(std::memory_order_acquire) == cauda.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> cabeca{0};   // Escrito apenas pelo consumidor
+    alignas(TAMANHO_LINHA_CACHE) std::atomic<size_t> cauda{0};    // Escrito apenas pelo produtor
+    alignas(TAMANHO_LINHA_CACHE) RegistroOperacao buffer[CAPACIDADE];
+};
+
+/*
+ * LOGGER DE OPERAÇÕES:
+ * - Instância única compartilhada por todas as contas
+ * - Caminho quente: testa o nível, copia um registro fixo para o anel da thread
+ * - Thread de drenagem: formata e escreve em lotes, com um único flush por lote
+ * - Se o anel estiver cheio o registro é descartado e contabilizado,
+ *   para que o log nunca segure uma operação bancária
+ */
+class LoggerOperacoes {
+private:
+    std::atomic<int> nivelAtual{static_cast<int>(NivelLog::TODAS)};
+    std::atomic<long long> descartados{0};
+
+    std::mutex aneisMutex;                                  // Protege a lista de anéis
+    std::vector<std::shared_ptr<AnelRegistros>> aneis;      // Um anel por thread produtora
+
+    std::mutex drenagemMutex;                               // Coordena drenagem e descarga
+    std::condition_variable drenagemCv;
+    long long pedidosDescarga = 0;                          // Pedidos de descarga recebidos
+    long long descargasConcluidas = 0;                      // Passadas completas após pedidos
+    bool encerrando = false;
+
+    std::thread drenador;                                   // Thread de drenagem
+
+    /*
+     * ANEL DA THREAD ATUAL:
+     * Criado e registrado no primeiro uso. Quando a thread termina,
+     * o destrutor marca o anel como abandonado e o drenador o descarta
+     * depois de esvaziá-lo.
+     */
+    AnelRegistros& anelLocal() {
+        struct ProdutorLocal {
+            std::shared_ptr<AnelRegistros> anel;
+            ~ProdutorLocal() { if (anel) anel->abandonado.store(true); }
+        };
+        thread_local ProdutorLocal produtor;
+        if (!produtor.anel) {
+            produtor.anel = std::make_shared<AnelRegistros>();
+            std::lock_guard<std::mutex> lock(aneisMutex);
+            aneis.push_back(produtor.anel);
+        }
+        return *produtor.anel;
+    }
+
+    /*
+     * FORMATAÇÃO:
+     * Mesmo texto que as contas escreviam diretamente no cout
+     */
+    static void formatar(const RegistroOperacao& r, std::string& saida) {
+        char linha[160];
+        int n = 0;
+        switch (r.tipo) {
+            case TipoRegistro::CREDITO:
+                n = std::snprintf(linha, sizeof(linha),
+                                  "[CRÉDITO] Conta %s - Valor: R$ %.2f - Novo saldo: R$ %.2f\n",
+                                  r.conta, r.valor, r.saldo);
+                break;
+            case TipoRegistro::DEBITO:
+                n = std::snprintf(linha, sizeof(linha),
+                                  "[DÉBITO] Conta %s - Valor: R$ %.2f - Novo saldo: R$ %.2f\n",
+                                  r.conta, r.valor, r.saldo);
+                break;
+            case TipoRegistro::CONSULTA:
+                n = std::snprintf(linha, sizeof(linha),
+                                  "[CONSULTA] Conta %s - Saldo: R$ %.2f - Leitores ativos: %d\n",
+                                  r.conta, r.saldo, r.leitores);
+                break;
+            case TipoRegistro::TRANSFERENCIA:
+                n = std::snprintf(linha, sizeof(linha),
+                                  "[TRANSFERÊNCIA] Conta %s -> %s - Valor: R$ %.2f - Saldo origem: R$ %.2f\n",
+                                  r.conta, r.destino, r.valor, r.saldo);
+                break;
+        }
+        if (n > 0) saida.append(linha, std::min<size_t>(n, sizeof(linha) - 1));
+    }
+
+    /*
+     * UMA PASSADA DE DRENAGEM:
+     * Esvazia todos os anéis, escreve o lote de uma vez e remove
+     * anéis de threads que já terminaram
+     */
+    size_t drenarTodos(std::string& lote) {
+        std::vector<std::shared_ptr<AnelRegistros>> copia;
+        {
+            std::lock_guard<std::mutex> lock(aneisMutex);
+            copia = aneis;
+        }
+
+        size_t total = 0;
+        for (auto& anel : copia) {
+            total += anel->drenar([&](const RegistroOperacao& r) { formatar(r, lote); });
+        }
+
+        if (!lote.empty()) {
+            std::cout.write(lote.data(), static_cast<std::streamsize>(lote.size()));
+            std::cout.flush();
+            lote.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(aneisMutex);
+        for (size_t i = 0; i < aneis.size();) {
+            if (aneis[i]->abandonado.load() && aneis[i]->vazio()) {
+                aneis[i] = aneis.back();
+                aneis.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        return total;
+    }
+
+    /*
+     * LAÇO DA THREAD DE DRENAGEM:
+     * Acorda periodicamente (ou quando há pedido de descarga)
+     * e escreve tudo o que foi acumulado
+     */
+    void lacoDrenagem() {
+        std::string lote;
+        lote.reserve(1 << 16);
+        std::unique_lock<std::mutex> lock(drenagemMutex);
+        while (true) {
+            drenagemCv.wait_for(lock, std::chrono::milliseconds(5), [&] {
+                return encerrando || pedidosDescarga > descargasConcluidas;
+            });
+            long long pedidos = pedidosDescarga;
+            bool sair = encerrando;
+
+            lock.unlock();
+            drenarTodos(lote);
+            lock.lock();
+
+            descargasConcluidas = pedidos;
+            drenagemCv.notify_all();
+            if (sair) break;
+        }
+    }
+
+    LoggerOperacoes() : drenador(&LoggerOperacoes::lacoDrenagem, this) {}
+
+public:
+    ~LoggerOperacoes() {
+        {
+            std::lock_guard<std::mutex> lock(drenagemMutex);
+            encerrando = true;
+        }
+        drenagemCv.notify_all();
+        drenador.join();
+    }
+
+    LoggerOperacoes(const LoggerOperacoes&) = delete;
+    LoggerOperacoes& operator=(const LoggerOperacoes&) = delete;
+
+    static LoggerOperacoes& instancia() {
+        static LoggerOperacoes logger;
+        return logger;
+    }
+
+    void configurarNivel(NivelLog nivel) { nivelAtual.store(static_cast<int>(nivel)); }
+    NivelLog nivel() const { return static_cast<NivelLog>(nivelAtual.load(std::memory_order_relaxed)); }
+
+    /*
+     * FILTRO DE NÍVEL:
+     * Consultas só são registradas no nível TODAS
+     */
+    bool ativo(TipoRegistro tipo) const {
+        int n = nivelAtual.load(std::memory_order_relaxed);
+        if (tipo == TipoRegistro::CONSULTA) return n >= static_cast<int>(NivelLog::TODAS);
+        return n >= static_cast<int>(NivelLog::ESCRITAS);
+    }
+
+    /*
+     * REGISTRO (CAMINHO QUENTE):
+     * Não faz I/O nem toma locks compartilhados
+     */
+    void registrar(TipoRegistro tipo, const std::string& conta,
+                   double valor, double saldo, int leitores = 0,
+                   const std::string& destino = std::string()) {
+        if (!ativo(tipo)) return;
+
+        RegistroOperacao r;
+        r.tipo = tipo;
+        std::strncpy(r.conta, conta.c_str(), sizeof(r.conta) - 1);
+        r.conta[sizeof(r.conta) - 1] = '\0';
+        std::strncpy(r.destino, destino.c_str(), sizeof(r.destino) - 1);
+        r.destino[sizeof(r.destino) - 1] = '\0';
+        r.valor = valor;
+        r.saldo = saldo;
+        r.leitores = leitores;
+
+        if (!anelLocal().inserir(r)) {
+            descartados.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * DESCARGA SÍNCRONA:
+     * Bloqueia até que tudo o que foi registrado antes da chamada
+     * tenha sido escrito na saída
+     */
+    void descarregar() {
+        std::unique_lock<std::mutex> lock(drenagemMutex);
+        long long meuPedido = ++pedidosDescarga;
+        drenagemCv.notify_all();
+        drenagemCv.wait(lock, [&] { return descargasConcluidas >= meuPedido || encerrando; });
+    }
+
+    long long getDescartados() const { return descartados.load(); }
+    void resetarDescartados() { descartados.store(0); }
+};
+
+/*
+ * CONVERSÃO DO NÍVEL A PARTIR DE TEXTO (linha de comando)
+ */
+inline bool interpretarNivelLog(const std::string& texto, NivelLog& nivel) {
+    if (texto == "nenhum") nivel = NivelLog::NENHUM;
+    else if (texto == "escritas") nivel = NivelLog::ESCRITAS;
+    else if (texto == "todas") nivel = NivelLog::TODAS;
+    else return false;
+    return true;
+}
+
+// ===================================
+// Modelo de tempo de serviço
+// ===================================
+/*
+ * ONDE O TEMPO DE SERVIÇO É GASTO:
+ * - CREDITO, DEBITO, CONSULTA: dentro das operações das contas
+ *   (com o lock da conta, no motor rwlock)
+ * - MULTICONTA: processamento de transferências e lotes
+ * - PAUSA: intervalo entre operações de um worker no ciclo fechado
+ *
+ * COMO O TEMPO É GASTO:
+ * - NENHUM: sem espera; mede só o custo real de locks e coerência de cache
+ * - GIRO: ocupa a CPU por um tempo fixo com um laço calibrado na partida
+ * - SONO: sleep_for de tempo fixo (a thread libera a CPU)
+ * - EXPONENCIAL: sleep_for com duração sorteada (média dada)
+ *
+ * O padrão "legado" reproduz os tempos fixos originais (10 ms para
+ * escritas, 5 ms para consultas e 1 ms entre operações).
+ */
+enum class EtapaServico { CREDITO, DEBITO, CONSULTA, MULTICONTA, PAUSA };
+constexpr size_t NUM_ETAPAS_SERVICO = 5;
+
+enum class ModoServico { NENHUM, GIRO, SONO, EXPONENCIAL };
+
+struct TempoServico {
+    ModoServico modo = ModoServico::NENHUM;
+    double microssegundos = 0;          // Duração (ou média, no exponencial)
+
+    std::string descricao() const {
+        std::ostringstream texto;
+        switch (modo) {
+            case ModoServico::NENHUM: return "nenhum";
+            case ModoServico::GIRO: texto << "giro:"; break;
+            case ModoServico::SONO: texto << "sono:"; break;
+            case ModoServico::EXPONENCIAL: texto << "exp:"; break;
+        }
+        texto << microssegundos;
+        return texto.str();
+    }
+};
+
+class ModeloServico {
+private:
+    std::array<TempoServico, NUM_ETAPAS_SERVICO> tempos;
+    std::string nomePreset = "legado";
+    double iteracoesPorUs = 0;          // Calibração do laço de giro
+    std::once_flag calibrado;
+
+    ModeloServico() { tempos = preset("legado"); }
+
+    /*
+     * CALIBRAÇÃO DO GIRO:
+     * Mede quantas iterações do laço cabem em 1 us nesta máquina,
+     * para que o giro não precise consultar o relógio a cada volta
+     */
+    static inline void girar(uint64_t iteracoes) {
+        for (uint64_t i = 0; i < iteracoes; ++i) {
+            asm volatile("" ::: "memory");      // Impede o compilador de remover o laço
+        }
+    }
+
+    void calibrar() {
+        const uint64_t amostra = 1000000;
+        double melhor = 0;
+        for (int tentativa = 0; tentativa < 5; ++tentativa) {
+            auto inicio = std::chrono::steady_clock::now();
+            girar(amostra);
+            double us = std::chrono::duration<double, std::micro>(
+                            std::chrono::steady_clock::now() - inicio).count();
+            if (us > 0) melhor = std::max(melhor, amostra / us);   // Menor interferência
+        }
+        iteracoesPorUs = melhor > 0 ? melhor : 1000;
+    }
+
+public:
+    static ModeloServico& instancia() {
+        static ModeloServico modelo;
+        return modelo;
+    }
+
+    static const char* nomeEtapa(size_t etapa) {
+        static const char* nomes[NUM_ETAPAS_SERVICO] = {
+            "credito", "debito", "consulta", "multiconta", "pausa"};
+        return nomes[etapa];
+    }
+
+    /*
+     * PRESETS:
+     * - legado: tempos fixos originais com sleep
+     * - nenhum: sem tempo de serviço (mede o motor)
+     * - giro: tempos curtos ocupando a CPU (contenção real dentro do lock)
+     */
+    static std::array<TempoServico, NUM_ETAPAS_SERVICO> preset(const std::string& nome) {
+        std::array<TempoServico, NUM_ETAPAS_SERVICO> t{};
+        if (nome == "legado") {
+            t = {{{ModoServico::SONO, 10000}, {ModoServico::SONO, 10000}, {ModoServico::SONO, 5000},
+                  {ModoServico::SONO, 10000}, {ModoServico::SONO, 1000}}};
+        } else if (nome == "giro") {
+            t = {{{ModoServico::GIRO, 20}, {ModoServico::GIRO, 20}, {ModoServico::GIRO, 5},
+                  {ModoServico::GIRO, 40}, {ModoServico::NENHUM, 0}}};
+        } else if (nome != "nenhum") {
+            throw std::invalid_argument("preset de serviço desconhecido: " + nome);
+        }
+        return t;
+    }
+
+    /*
+     * CONFIGURAÇÃO (antes das simulações):
+     * "PRESET[,etapa=MODO[:US]]..." por exemplo "nenhum,consulta=giro:5".
+     * Retorna false se o texto for inválido (sem alterar o modelo).
+     */
+    bool configurar(const std::string& texto) {
+        std::array<TempoServico, NUM_ETAPAS_SERVICO> novos;
+        std::string nome;
+        std::stringstream partes(texto);
+        std::string parte;
+        bool primeira = true;
+        try {
+            while (std::getline(partes, parte, ',')) {
+                size_t igual = parte.find('=');
+                if (primeira) {
+                    primeira = false;
+                    if (igual == std::string::npos) {
+                        novos = preset(parte);
+                        nome = parte;
+                        continue;
+                    }
+                    novos = preset("legado");
+                    nome = "legado";
+                }
+                if (igual == std::string::npos) return false;
+
+                std::string etapa = parte.substr(0, igual);
+                std::string valor = parte.substr(igual + 1);
+                size_t indice = NUM_ETAPAS_SERVICO;
+                for (size_t e = 0; e < NUM_ETAPAS_SERVICO; ++e) {
+                    if (etapa == nomeEtapa(e)) indice = e;
+                }
+                if (indice == NUM_ETAPAS_SERVICO) return false;
+
+                TempoServico tempo;
+                size_t doisPontos = valor.find(':');
+                std::string modo = valor.substr(0, doisPontos);
+                if (modo == "nenhum") tempo.modo = ModoServico::NENHUM;
+                else if (modo == "giro") tempo.modo = ModoServico::GIRO;
+                else if (modo == "sono") tempo.modo = ModoServico::SONO;
+                else if (modo == "exp") tempo.modo = ModoServico::EXPONENCIAL;
+                else return false;
+                if (tempo.modo != ModoServico::NENHUM) {
+                    if (doisPontos == std::string::npos) return false;
+                    size_t usados = 0;
+                    std::string numero = valor.substr(doisPontos + 1);
+                    tempo.microssegundos = std::stod(numero, &usados);
+                    if (usados != numero.size() || tempo.microssegundos < 0) return false;
+                }
+                novos[indice] = tempo;
+                nome = "personalizado";
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+        if (primeira) return false;
+        tempos = novos;
+        nomePreset = nome;
+        return true;
+    }
+
+    /*
+     * DESCRIÇÃO PARA O CSV:
+     * etapa=modo:us separadas por ';' (a vírgula é o separador do CSV)
+     */
+    std::string descricao() const {
+        std::string texto;
+        for (size_t e = 0; e < NUM_ETAPAS_SERVICO; ++e) {
+            if (e) texto += ";";
+            texto += std::string(nomeEtapa(e)) + "=" + tempos[e].descricao();
+        }
+        return texto;
+    }
+
+    const std::string& getNomePreset() const { return nomePreset; }
+
+    /*
+     * EXECUÇÃO DO TEMPO DE SERVIÇO DE UMA ETAPA
+     */
+    void executar(EtapaServico etapa) {
+        const TempoServico& tempo = tempos[static_cast<size_t>(etapa)];
+        switch (tempo.modo) {
+            case ModoServico::NENHUM:
+                break;
+            case ModoServico::GIRO:
+                std::call_once(calibrado, [this] { calibrar(); });
+                girar(static_cast<uint64_t>(tempo.microssegundos * iteracoesPorUs));
+                break;
+            case ModoServico::SONO:
+                std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(tempo.microssegundos));
+                break;
+            case ModoServico::EXPONENCIAL: {
+                thread_local std::mt19937_64 rng(std::random_device{}());
+                std::exponential_distribution<> dist(1.0 / std::max(tempo.microssegundos, 1e-3));
+                std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(dist(rng)));
+                break;
+            }
+        }
+    }
+
+    /*
+     * DURAÇÃO SORTEADA DE UMA ETAPA, SEM GASTÁ-LA (em ns):
+     * Para quem suspende em vez de esperar (clientes em corrotinas);
+     * giro, sono e exponencial viram todos uma suspensão
+     */
+    uint64_t amostrarNs(EtapaServico etapa) {
+        const TempoServico& tempo = tempos[static_cast<size_t>(etapa)];
+        double us = tempo.microssegundos;
+        if (tempo.modo == ModoServico::NENHUM) return 0;
+        if (tempo.modo == ModoServico::EXPONENCIAL) {
+            thread_local std::mt19937_64 rng(std::random_device{}());
+            std::exponential_distribution<> dist(1.0 / std::max(tempo.microssegundos, 1e-3));
+            us = dist(rng);
+        }
+        return static_cast<uint64_t>(us * 1000.0);
+    }
+};
+
+// ===================================
+// Controle de admissão (leitores e escritores)
+// ===================================
+/*
+ * PORTÃO DE ADMISSÃO POR CONTA:
+ * Fica na frente do shared_mutex da conta e decide quem pode tentá-lo.
+ * - Ordem de chegada (FIFO) entre leitores e escritores: um escritor
+ *   esperando bloqueia os leitores que chegam depois, então um fluxo
+ *   contínuo de consultas não deixa escritores sem vez (starvation)
+ * - No máximo maxLeitores consultas admitidas ao mesmo tempo
+ * - Fila limitada: acima de capacidadeFila o pedido é recusado na hora
+ * - Tempo limite: quem espera mais do que timeoutUs desiste
+ *
+ * Recusas (fila cheia, tempo esgotado) são contabilizadas à parte das
+ * falhas de negócio (saldo insuficiente etc.).
+ */
+struct ConfigAdmissao {
+    bool ativa = true;
+    int maxLeitores = 5;            // Consultas simultâneas admitidas por conta
+    int capacidadeFila = 64;        // Pedidos esperando por conta
+    long long timeoutUs = 50000;    // Espera máxima na fila
+
+    std::string descricao() const {
+        if (!ativa) return "desligada";
+        return std::to_string(maxLeitores) + ":" + std::to_string(capacidadeFila) + ":" +
+               std::to_string(timeoutUs);
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --admissao:
+ * "desligada" ou "LEITORES:FILA:TIMEOUT_US"
+ */
+inline bool interpretarConfigAdmissao(const std::string& texto, ConfigAdmissao& config) {
+    if (texto == "desligada") {
+        config.ativa = false;
+        return true;
+    }
+    ConfigAdmissao nova;
+    char sobra;
+    if (std::sscanf(texto.c_str(), "%d:%d:%lld%c", &nova.maxLeitores, &nova.capacidadeFila,
+                    &nova.timeoutUs, &sobra) != 3) return false;
+    if (nova.maxLeitores < 1 || nova.capacidadeFila < 0 || nova.timeoutUs < 0) return false;
+    config = nova;
+    return true;
+}
+
+enum class ResultadoAdmissao { ADMITIDA, FILA_CHEIA, TEMPO_ESGOTADO };
+
+class ControleAdmissao {
+private:
+    struct Pedido {
+        bool escrita;
+        bool admitido = false;
+    };
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Pedido*> fila;       // Pedidos esperando, em ordem de chegada
+    int leitores = 0;               // Consultas admitidas em andamento
+    bool escritor = false;          // Escrita admitida em andamento
+
+    bool compativel(bool escrita, int maxLeitores) const {
+        return escrita ? (!escritor && leitores == 0) : (!escritor && leitores < maxLeitores);
+    }
+
+    void ocupar(bool escrita) { escrita ? (void)(escritor = true) : (void)leitores++; }
+
+    /*
+     * PROMOÇÃO DA CABEÇA DA FILA:
+     * Admite pedidos do início enquanto forem compatíveis; para no
+     * primeiro incompatível, sem pular ninguém (é isso que dá a justiça)
+     */
+    void promover(int maxLeitores) {
+        bool admitiu = false;
+        while (!fila.empty() && compativel(fila.front()->escrita, maxLeitores)) {
+            Pedido* p = fila.front();
+            fila.pop_front();
+            ocupar(p->escrita);
+            p->admitido = true;
+            admitiu = true;
+        }
+        if (admitiu) cv.notify_all();
+    }
+
+public:
+    /*
+     * ADMISSÃO:
+     * Retorna ADMITIDA (o chamador deve chamar liberar depois) ou o motivo
+     * da recusa. esperaNs recebe o tempo passado na fila.
+     */
+    ResultadoAdmissao admitir(bool escrita, const ConfigAdmissao& config, long long& esperaNs) {
+        esperaNs = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+
+        // Caminho rápido: ninguém na fila e a conta está livre para este tipo de acesso
+        if (fila.empty() && compativel(escrita, config.maxLeitores)) {
+            ocupar(escrita);
+            return ResultadoAdmissao::ADMITIDA;
+        }
+        if (static_cast<int>(fila.size()) >= config.capacidadeFila) {
+            return ResultadoAdmissao::FILA_CHEIA;
+        }
+
+        Pedido pedido{escrita};
+        fila.push_back(&pedido);
+        auto inicio = std::chrono::steady_clock::now();
+        bool admitido = cv.wait_until(lock, inicio + std::chrono::microseconds(config.timeoutUs),
+                                      [&] { return pedido.admitido; });
+        esperaNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       std::chrono::steady_clock::now() - inicio).count();
+        if (admitido) return ResultadoAdmissao::ADMITIDA;
+
+        // Desiste: sai da fila e deixa os pedidos de trás avançarem
+        fila.erase(std::find(fila.begin(), fila.end(), &pedido));
+        promover(config.maxLeitores);
+        return ResultadoAdmissao::TEMPO_ESGOTADO;
+    }
+
+    void liberar(bool escrita, const ConfigAdmissao& config) {
+        std::lock_guard<std::mutex> lock(mutex);
+        escrita ? (void)(escritor = false) : (void)leitores--;
+        promover(config.maxLeitores);
+    }
+};
+
+// ===================================
+// Contadores distribuídos
+// ===================================
+/*
+ * CONTADOR FATIADO POR THREAD:
+ * - Cada thread soma na sua fatia, que ocupa sozinha uma linha de cache;
+ *   o incremento nunca tira a linha de outro núcleo
+ * - A leitura soma todas as fatias: mais cara, mas só acontece nos
+ *   relatórios, fora do caminho quente
+ * - Com mais threads do que fatias, duas threads dividem uma fatia; o
+ *   fetch_add continua correto, só volta a haver disputa entre elas
+ */
+class ContadorDistribuido {
+private:
+    static constexpr size_t NUM_FATIAS = 64;
+
+    struct alignas(TAMANHO_LINHA_CACHE) Fatia {
+        std::atomic<long long> valor{0};
+    };
+    std::array<Fatia, NUM_FATIAS> fatias;
+
+    static size_t fatiaDaThread() {
+        static std::atomic<size_t> proxima{0};
+        thread_local size_t fatia = proxima.fetch_add(1, std::memory_order_relaxed) % NUM_FATIAS;
+        return fatia;
+    }
+
+public:
+    void adicionar(long long quantidade = 1) {
+        fatias[fatiaDaThread()].valor.fetch_add(quantidade, std::memory_order_relaxed);
+    }
+
+    long long total() const {
+        long long soma = 0;
+        for (const Fatia& f : fatias) soma += f.valor.load(std::memory_order_relaxed);
+        return soma;
+    }
+
+    void zerar() {
+        for (Fatia& f : fatias) f.valor.store(0, std::memory_order_relaxed);
+    }
+};
+
+/*
+ * OBJETO POR THREAD E POR INSTÂNCIA:
+ * Na primeira vez que uma thread usa a instância, recebe um T só dela
+ * (escrito sem atomics nem locks no caminho quente); a instância guarda
+ * todos, e de qual thread é cada um, para quem precisa percorrê-los.
+ * - Cada thread tem, por tipo T, um cache das ENTRADAS_CACHE instâncias
+ *   usadas mais recentemente: alternar entre alguns bancos ou domínios
+ *   não cria nem procura nada
+ * - Fora do cache, a thread procura o seu T na instância (com o mutex)
+ *   e só cria um na primeira vez: nunca há dois T da mesma thread
+ * O ID da instância evita que uma thread reaproveite o T de uma instância
+ * anterior que ocupava o mesmo endereço. Os T vivem até a instância ser
+ * destruída; uma thread nova que herde o ID de uma encerrada herda o seu T.
+ */
+template <typename T>
+class PorThread {
+private:
+    static constexpr size_t ENTRADAS_CACHE = 8;
+
+    const uint64_t idInstancia = proximoIdInstancia()++;
+    std::mutex mutex;
+    std::vector<std::unique_ptr<T>> objetos;
+    std::unordered_map<std::thread::id, T*> porThread;      // Protegido por mutex
+
+    static std::atomic<uint64_t>& proximoIdInstancia() {
+        static std::atomic<uint64_t> proximo{1};
+        return proximo;
+    }
+
+    T* buscarOuCriar() {
+        std::lock_guard<std::mutex> lock(mutex);
+        T*& objeto = porThread[std::this_thread::get_id()];
+        if (!objeto) {
+            objetos.push_back(std::make_unique<T>());
+            objeto = objetos.back().get();
+        }
+        return objeto;
+    }
+
+public:
+    T& local() {
+        struct Entrada {
+            uint64_t instancia = 0;
+            T* objeto = nullptr;
+        };
+        thread_local std::array<Entrada, ENTRADAS_CACHE> cache{};
+        thread_local size_t substituir = 0;
+        for (const Entrada& entrada : cache) {
+            if (entrada.instancia == idInstancia) return *entrada.objeto;
+        }
+        T* objeto = buscarOuCriar();
+        cache[substituir] = {idInstancia, objeto};
+        substituir = (substituir + 1) % ENTRADAS_CACHE;
+        return *objeto;
+    }
+
+    // Visita o objeto de cada thread (inclusive os de threads já encerradas)
+    template <typename Funcao>
+    void paraCada(Funcao&& funcao) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto& objeto : objetos) funcao(*objeto);
+    }
+};
+
+// ===================================
+// Snapshots consistentes (épocas)
+// ===================================
+/*
+ * VISÃO DE TODOS OS SALDOS NUM MESMO INSTANTE, SEM PARAR O BANCO:
+ * - Toda operação que altera saldos roda dentro de uma época: a thread
+ *   anuncia a época global no seu slot ao entrar e limpa ao sair
+ * - Tirar um snapshot é avançar a época de S para S+1 e esperar só as
+ *   escritas da época S que já estavam em andamento. Daí em diante o
+ *   estado "ao fim de S" não muda mais
+ * - Cada conta guarda uma segunda versão do saldo: na primeira escrita
+ *   de uma época nova, o saldo anterior vira a pré-imagem. O snapshot
+ *   lê a pré-imagem das contas já alteradas em S+1 e o saldo corrente
+ *   das demais, sem travar nenhuma conta
+ * - Só um snapshot por vez, então cada conta precisa de no máximo duas
+ *   versões (corrente e pré-imagem)
+ */
+class DominioEpocas {
+private:
+    /*
+     * SLOT POR THREAD:
+     * Alinhado em linha de cache para que anunciar a época não dispute
+     * memória com as outras threads. 'fluxo' acumula créditos menos
+     * débitos das escritas de cada paridade de época (auditoria).
+     */
+    struct alignas(TAMANHO_LINHA_CACHE) Slot {
+        std::atomic<uint64_t> epoca{0};                 // 0 = fora de escrita
+        std::atomic<double> fluxo[2] = {};
+    };
+
+    std::atomic<uint64_t> epocaGlobal{1};
+    PorThread<Slot> slots;
+
+    std::mutex snapshotMutex;                           // Um snapshot por vez
+    double fluxoAcumulado = 0;                          // Fluxo das épocas já fechadas
+
+    static uint64_t& epocaThread() {
+        thread_local uint64_t epoca = 0;
+        return epoca;
+    }
+
+public:
+    /*
+     * ÉPOCA DA ESCRITA EM ANDAMENTO NESTA THREAD:
+     * Lida pelas contas ao versionar o saldo (0 = escrita fora de época,
+     * que não é versionada; só acontece na carga, antes das threads)
+     */
+    static uint64_t epocaDaThread() { return epocaThread(); }
+
+    /*
+     * ESCRITA (RAII):
+     * Anuncia a época e confere se ela não avançou no meio do anúncio;
+     * se avançou, anuncia de novo (o snapshot pode não ter visto o slot)
+     */
+    class Escrita {
+    private:
+        Slot& slot;
+        uint64_t epoca;
+
+    public:
+        explicit Escrita(DominioEpocas& dominio) : slot(dominio.slots.local()) {
+            do {
+                epoca = dominio.epocaGlobal.load();
+                slot.epoca.store(epoca);
+            } while (dominio.epocaGlobal.load() != epoca);
+            epocaThread() = epoca;
+        }
+
+        ~Escrita() {
+            epocaThread() = 0;
+            slot.epoca.store(0, std::memory_order_release);
+        }
+
+        Escrita(const Escrita&) = delete;
+        Escrita& operator=(const Escrita&) = delete;
+
+        // Créditos entram positivos, débitos negativos; transferências não mudam o total
+        void registrarFluxo(double valor) {
+            std::atomic<double>& fluxo = slot.fluxo[epoca & 1];
+            fluxo.store(fluxo.load(std::memory_order_relaxed) + valor, std::memory_order_relaxed);
+        }
+    };
+
+    /*
+     * ABERTURA DO SNAPSHOT:
+     * Avança a época, espera as escritas da época fechada e fecha também
+     * o fluxo dela. Retorna a época S do snapshot; o chamador lê as
+     * contas com saldoNaEpoca(S) e depois chama fecharSnapshot.
+     */
+    uint64_t abrirSnapshot(double& fluxoAteEpoca) {
+        snapshotMutex.lock();
+        uint64_t epoca = epocaGlobal.load();
+        epocaGlobal.store(epoca + 1);
+
+        slots.paraCada([&](Slot& slot) {
+            while (true) {
+                uint64_t anunciada = slot.epoca.load(std::memory_order_acquire);
+                if (anunciada == 0 || anunciada > epoca) break;
+                std::this_thread::yield();
+            }
+        });
+        // Um slot criado depois da espera só escreve na época nova (a outra paridade)
+        slots.paraCada([&](Slot& slot) {
+            fluxoAcumulado += slot.fluxo[epoca & 1].load(std::memory_order_relaxed);
+            slot.fluxo[epoca & 1].store(0, std::memory_order_relaxed);
+        });
+        fluxoAteEpoca = fluxoAcumulado;
+        return epoca;
+    }
+
+    void fecharSnapshot() { snapshotMutex.unlock(); }
+
+    // Época em que as escritas entram agora (estável dentro de semSnapshot)
+    uint64_t getEpoca() const { return epocaGlobal.load(); }
+
+    /*
+     * MUDANÇA NO CONJUNTO DE CONTAS:
+     * Abertura e encerramento rodam com o snapshot bloqueado, então um
+     * snapshot nunca vê a conta de um lado do corte e o fluxo dela do outro
+     */
+    template <typename Funcao>
+    void semSnapshot(Funcao&& funcao) {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        funcao();
+    }
+};
+
+/*
+ * SEGUNDA VERSÃO DO SALDO DE UMA CONTA:
+ * Valor é double (ContaCorrente) ou centavos (ContaCorrenteAtomica).
+ * antesDeAlterar é chamado por quem tem a conta com exclusividade,
+ * antes de aplicar 'delta' sobre 'atual':
+ * - primeira escrita de uma época nova: guarda 'atual' como pré-imagem
+ * - escrita atrasada de uma época anterior (ex.: pedido antigo aplicado
+ *   por um combinador depois de um novo): a pré-imagem também recebe o
+ *   delta, porque essa escrita pertence ao snapshot
+ */
+template <typename Valor>
+class VersaoEpoca {
+private:
+    std::atomic<uint64_t> epoca{0};         // Época da última pré-imagem guardada
+    std::atomic<Valor> preImagem{};
+
+public:
+    void antesDeAlterar(uint64_t epocaEscrita, Valor atual, Valor delta) {
+        if (epocaEscrita == 0) return;
+        uint64_t versao = epoca.load(std::memory_order_relaxed);
+        if (versao < epocaEscrita) {
+            preImagem.store(atual, std::memory_order_relaxed);
+            epoca.store(epocaEscrita, std::memory_order_release);
+            // A época tem que ficar visível antes do saldo novo (ver ler)
+            std::atomic_thread_fence(std::memory_order_release);
+        } else if (epocaEscrita < versao) {
+            preImagem.store(preImagem.load(std::memory_order_relaxed) + delta,
+                            std::memory_order_relaxed);
+        }
+    }
+
+    // Já versionada nesta época: as próximas escritas não precisam da pré-imagem
+    bool emDia(uint64_t epocaEscrita) const {
+        return epocaEscrita == 0 || epoca.load(std::memory_order_relaxed) == epocaEscrita;
+    }
+
+    uint64_t getEpoca() const { return epoca.load(std::memory_order_relaxed); }
+
+    /*
+     * LEITURA NA ÉPOCA S (sem lock):
+     * Se o saldo lido já é de uma escrita de S+1, a segunda leitura da
+     * época (depois da barreira) vê S+1 e a pré-imagem é usada
+     */
+    template <typename LerAtual>
+    Valor ler(uint64_t epocaSnapshot, LerAtual lerAtual) const {
+        if (epoca.load(std::memory_order_acquire) > epocaSnapshot) {
+            return preImagem.load(std::memory_order_relaxed);
+        }
+        Valor valor = lerAtual();
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (epoca.load(std::memory_order_acquire) > epocaSnapshot) {
+            return preImagem.load(std::memory_order_relaxed);
+        }
+        return valor;
+    }
+};
+
+// ===================================
+// Reclamação de memória por épocas
+// ===================================
+/*
+ * LIBERAÇÃO SEGURA DO QUE É LIDO SEM LOCK:
+ * - Quem segue ponteiros compartilhados sem lock (busca no índice de
+ *   contas) fica dentro de uma Protecao: a thread anuncia no seu slot a
+ *   época global que viu ao entrar e limpa o slot ao sair
+ * - Quem desliga um objeto da estrutura não o libera na hora: aposenta
+ *   o objeto com a época corrente E. A época só avança quando todas as
+ *   threads protegidas já anunciaram a atual; quando chega a E+2, nenhuma
+ *   thread que pudesse ter visto o objeto antes do desligamento continua
+ *   protegida, e a liberação roda
+ * - Ao contrário dos snapshots, ninguém espera aqui: uma thread protegida
+ *   por muito tempo só atrasa as liberações
+ */
+class ReclamacaoEpocas {
+private:
+    struct alignas(TAMANHO_LINHA_CACHE) Slot {
+        std::atomic<uint64_t> epoca{0};                 // 0 = fora de proteção
+        int profundidade = 0;                           // Proteções aninhadas (só a dona mexe)
+    };
+
+    struct Aposentado {
+        uint64_t epoca;
+        std::function<void()> liberar;
+    };
+
+    std::atomic<uint64_t> epocaGlobal{1};
+    PorThread<Slot> slots;
+
+    std::mutex aposentadosMutex;
+    std::vector<Aposentado> aposentados;
+    std::atomic<size_t> pendentes{0};
+    std::atomic<long long> liberados{0};
+
+public:
+    ReclamacaoEpocas() = default;
+    ReclamacaoEpocas(const ReclamacaoEpocas&) = delete;
+    ReclamacaoEpocas& operator=(const ReclamacaoEpocas&) = delete;
+
+    // Sem threads protegidas: o que sobrou pode ser liberado
+    ~ReclamacaoEpocas() {
+        for (Aposentado& a : aposentados) a.liberar();
+    }
+
+    /*
+     * PROTEÇÃO (RAII):
+     * Só a mais externa anuncia a época. A barreira impede que as
+     * leituras dos ponteiros subam para antes do anúncio; uma época já
+     * velha no slot só segura o avanço (nunca libera cedo demais)
+     */
+    class Protecao {
+    private:
+        Slot& slot;
+
+    public:
+        explicit Protecao(ReclamacaoEpocas& dominio) : slot(dominio.slots.local()) {
+            if (slot.profundidade++ == 0) {
+                slot.epoca.store(dominio.epocaGlobal.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+        }
+
+        ~Protecao() {
+            if (--slot.profundidade == 0) slot.epoca.store(0, std::memory_order_release);
+        }
+
+        Protecao(const Protecao&) = delete;
+        Protecao& operator=(const Protecao&) = delete;
+    };
+
+    // Chamar depois de desligar o objeto da estrutura compartilhada
+    void aposentar(std::function<void()> liberar) {
+        std::lock_guard<std::mutex> lock(aposentadosMutex);
+        aposentados.push_back({epocaGlobal.load(), std::move(liberar)});
+        pendentes++;
+    }
+
+    /*
+     * TENTATIVA DE LIBERAÇÃO:
+     * Avança a época se todas as threads protegidas já viram a atual e
+     * roda (fora dos locks) as liberações com duas épocas de idade.
+     * Retorna quantas rodaram.
+     */
+    size_t tentarLiberar() {
+        uint64_t epoca = epocaGlobal.load();
+        bool todasViram = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        slots.paraCada([&](const Slot& slot) {
+            uint64_t anunciada = slot.epoca.load(std::memory_order_acquire);
+            if (anunciada != 0 && anunciada != epoca) todasViram = false;
+        });
+        if (todasViram) epocaGlobal.compare_exchange_strong(epoca, epoca + 1);
+
+        uint64_t atual = epocaGlobal.load();
+        std::vector<std::function<void()>> prontas;
+        {
+            std::lock_guard<std::mutex> lock(aposentadosMutex);
+            auto velhas = std::stable_partition(aposentados.begin(), aposentados.end(),
+                                                [atual](const Aposentado& a) { return a.epoca + 2 > atual; });
+            for (auto it = velhas; it != aposentados.end(); ++it) prontas.push_back(std::move(it->liberar));
+            aposentados.erase(velhas, aposentados.end());
+        }
+        for (auto& liberar : prontas) liberar();
+        pendentes.fetch_sub(prontas.size());
+        liberados.fetch_add(static_cast<long long>(prontas.size()), std::memory_order_relaxed);
+        return prontas.size();
+    }
+
+    /*
+     * DRENAGEM:
+     * Repete até não sobrar nada aposentado; chamar sem threads que
+     * fiquem protegidas indefinidamente (fim da simulação)
+     */
+    void liberarTudo() {
+        while (pendentes.load() > 0) {
+            if (tentarLiberar() == 0) std::this_thread::yield();
+        }
+    }
+
+    size_t getPendentes() const { return pendentes.load(); }
+    long long getLiberados() const { return liberados.load(); }
+    uint64_t getEpoca() const { return epocaGlobal.load(); }
+};
+
+/*
+ * AUDITORIA CONTÍNUA:
+ * Uma thread tira snapshots a cada intervaloMs (0 = um atrás do outro)
+ * enquanto a simulação roda e confere se o total do banco é o total
+ * inicial mais créditos menos débitos até aquela época
+ */
+struct ConfigAuditoria {
+    bool ativa = false;
+    int intervaloMs = 10;
+
+    std::string descricao() const {
+        if (!ativa) return "desligada";
+        return intervaloMs == 0 ? "continua" : std::to_string(intervaloMs) + "ms";
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --auditoria:
+ * "desligada", "continua" ou o intervalo em ms
+ */
+inline bool interpretarConfigAuditoria(const std::string& texto, ConfigAuditoria& config) {
+    if (texto == "desligada") {
+        config.ativa = false;
+        return true;
+    }
+    ConfigAuditoria nova;
+    nova.ativa = true;
+    if (texto == "continua") {
+        nova.intervaloMs = 0;
+    } else {
+        char sobra;
+        if (std::sscanf(texto.c_str(), "%d%c", &nova.intervaloMs, &sobra) != 1) return false;
+        if (nova.intervaloMs < 0) return false;
+    }
+    config = nova;
+    return true;
+}
+
+/*
+ * OPERAÇÕES EM MASSA (fim do dia):
+ * Uma thread repete, enquanto a simulação roda, uma passada sobre todas
+ * as contas a cada intervaloMs (0 = uma atrás da outra), dividida entre
+ * 'threads' threads:
+ * - JUROS: saldos positivos rendem 'parametro' (fração) por passada
+ * - TARIFA: debita 'parametro' reais das contas com saldo suficiente
+ * - CONCILIACAO: soma, mínimo e máximo num snapshot, conferidos com o
+ *   total esperado (consulta agregada, não altera saldos)
+ */
+enum class TipoMassa { DESLIGADA, JUROS, TARIFA, CONCILIACAO };
+
+struct ConfigMassa {
+    TipoMassa tipo = TipoMassa::DESLIGADA;
+    double parametro = 0;
+    int intervaloMs = 0;
+    unsigned threads = 2;
+
+    bool ativa() const { return tipo != TipoMassa::DESLIGADA; }
+
+    std::string descricao() const {
+        std::ostringstream texto;
+        switch (tipo) {
+            case TipoMassa::DESLIGADA: return "desligada";
+            case TipoMassa::JUROS: texto << "juros:" << parametro; break;
+            case TipoMassa::TARIFA: texto << "tarifa:" << parametro; break;
+            case TipoMassa::CONCILIACAO: texto << "conciliacao"; break;
+        }
+        texto << "/" << (intervaloMs == 0 ? std::string("continua") : std::to_string(intervaloMs) + "ms")
+              << "/" << threads << "t";
+        return texto.str();
+    }
+};
+
+/*
+ * INTERPRETAÇÃO DE --massa:
+ * "desligada" ou TIPO[:PARAMETRO][,MS[,THREADS]], com TIPO juros
+ * (padrão 0.0001), tarifa (padrão 1.50) ou conciliacao
+ */
+inline bool interpretarConfigMassa(const std::string& texto, ConfigMassa& config) {
+    if (texto == "desligada") {
+        config = ConfigMassa();
+        return true;
+    }
+    ConfigMassa nova;
+    size_t virgula = texto.find(',');
+    std::string tipo = texto.substr(0, virgula);
+    size_t doisPontos = tipo.find(':');
+    std::string nome = tipo.substr(0, doisPontos);
+    if (nome == "juros") {
+        nova.tipo = TipoMassa::JUROS;
+        nova.parametro = 0.0001;
+    } else if (nome == "tarifa") {
+        nova.tipo = TipoMassa::TARIFA;
+        nova.parametro = 1.50;
+    } else if (nome == "conciliacao") {
+        nova.tipo = TipoMassa::CONCILIACAO;
+    } else {
+        return false;
+    }
+    char sobra;
+    if (doisPontos != std::string::npos) {
+        if (nova.tipo == TipoMassa::CONCILIACAO) return false;
+        if (std::sscanf(tipo.c_str() + doisPontos + 1, "%lf%c", &nova.parametro, &sobra) != 1) return false;
+        if (nova.parametro <= 0) return false;
+    }
+    if (virgula != std::string::npos) {
+        int threads = static_cast<int>(nova.threads);
+        char separador = ',';
+        int lidos = std::sscanf(texto.c_str() + virgula + 1, "%d%c%d%c", &nova.intervaloMs, &separador,
+                                &threads, &sobra);
+        if ((lidos != 1 && lidos != 3) || separador != ',' || nova.intervaloMs < 0 || threads <= 0) return false;
+        nova.threads = static_cast<unsigned>(threads);
+    }
+    config = nova;
+    return true;
+}
+
+#endif  // BANCO_SUPORTE_HPP
@@ -0,0 +1,1255 @@
+/*
+ * DURABILIDADE
+ * Write-ahead log com group commit, armazenamento das contas (texto e
+ * binário) e checkpoint incremental
+ */
+#ifndef BANCO_WAL_HPP
+#define BANCO_WAL_HPP
+
+#include "suporte.hpp"
+
+// ===================================
+// Write-Ahead Log (WAL) com Group Commit
+// ===================================
+/*
+ * HASH FNV-1a (64 bits):
+ * Usado como checksum dos registros e para identificar o snapshot
+ * ao qual um WAL se aplica
+ */
+inline uint64_t hashFNV1a(const void* dados, size_t tamanho, uint64_t hash = 14695981039346656037ULL) {
+    const unsigned char* p = static_cast<const unsigned char*>(dados);
+    for (size_t i = 0; i < tamanho; ++i) {
+        hash ^= p[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/*
+ * E/S COMPLETA:
+ * Repete write/read até transferir tudo (EINTR e escritas parciais).
+ * Com 'posicao' >= 0 a transferência é um pwrite/pread a partir dela
+ * (o offset do arquivo não muda)
+ */
+inline bool escreverTudo(int fd, const void* dados, size_t tamanho, off_t posicao = -1) {
+    const char* p = static_cast<const char*>(dados);
+    while (tamanho > 0) {
+        ssize_t n = posicao < 0 ? ::write(fd, p, tamanho) : ::pwrite(fd, p, tamanho, posicao);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        tamanho -= static_cast<size_t>(n);
+        if (posicao >= 0) posicao += n;
+    }
+    return true;
+}
+
+inline bool lerTudo(int fd, void* dados, size_t tamanho, off_t posicao = -1) {
+    char* p = static_cast<char*>(dados);
+    while (tamanho > 0) {
+        ssize_t n = posicao < 0 ? ::read(fd, p, tamanho) : ::pread(fd, p, tamanho, posicao);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        tamanho -= static_cast<size_t>(n);
+        if (posicao >= 0) posicao += n;
+    }
+    return true;
+}
+
+/*
+ * RENAME DURÁVEL:
+ * Sincroniza o diretório de 'caminho' depois de um rename; sem isso um
+ * crash pode voltar o nome para o arquivo antigo
+ */
+inline bool sincronizarDiretorio(const std::string& caminho) {
+    size_t barra = caminho.find_last_of('/');
+    std::string diretorio = barra == std::string::npos ? "." : barra == 0 ? "/" : caminho.substr(0, barra);
+    int fd = ::open(diretorio.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fd < 0) return false;
+    bool ok = ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+}
+
+/*
+ * CONFIGURAÇÃO DO GROUP COMMIT:
+ * - loteMaximo: quantos registros cabem em um único write+fdatasync
+ * - latenciaMaxima: quanto tempo o primeiro registro de um lote pode
+ *   esperar até o lote ser gravado, mesmo que não esteja cheio
+ */
+struct ConfigWAL {
+    bool ativo = true;
+    size_t loteMaximo = 64;
+    std::chrono::microseconds latenciaMaxima{2000};
+
+    std::string descricao() const {
+        if (!ativo) return "desligado";
+        return std::to_string(loteMaximo) + ":" + std::to_string(latenciaMaxima.count()) + "us";
+    }
+};
+
+/*
+ * TEXTO -> CONFIGURAÇÃO: "desligado" ou "LOTE:LATENCIA_US" (ex: 64:2000)
+ */
+inline bool interpretarConfigWAL(const std::string& texto, ConfigWAL& config) {
+    if (texto == "desligado") {
+        config.ativo = false;
+        return true;
+    }
+    size_t sep = texto.find(':');
+    if (sep == std::string::npos) return false;
+    try {
+        long long lote = std::stoll(texto.substr(0, sep));
+        long long latencia = std::stoll(texto.substr(sep + 1));
+        if (lote < 1 || latencia < 0) return false;
+        config.ativo = true;
+        config.loteMaximo = static_cast<size_t>(lote);
+        config.latenciaMaxima = std::chrono::microseconds(latencia);
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+/*
+ * ABERTURA e ENCERRAMENTO (contas abertas e fechadas com o banco rodando):
+ * o valor é o saldo depositado na abertura ou retirado no encerramento
+ */
+enum class TipoRegistroWAL : uint8_t { CREDITO = 1, DEBITO = 2, TRANSFERENCIA = 3, ABERTURA = 4, ENCERRAMENTO = 5 };
+
+/*
+ * FORMATO BINÁRIO (little-endian, tamanho fixo):
+ * - Cabeçalho: identifica o arquivo e o snapshot (hash) ao qual ele se aplica
+ * - Registro: uma operação bem-sucedida, guardada como variação de saldo
+ *   em centavos. O LSN é reservado com as contas da operação travadas,
+ *   então, para cada conta, a ordem do log é a ordem em que ela mudou.
+ * - 'continua' marca registros de um mesmo lote atômico: na recuperação
+ *   só grupos completos são aplicados
+ * - Os LSNs seguem de um log para o seguinte. O cabeçalho diz até onde
+ *   o log já foi incorporado: lsnSnapshot ao ContaCorrente.txt e lsnBase
+ *   a um checkpoint (registros até lsnBase já saíram do arquivo)
+ * - Cada registro guarda a época da escrita, que separa o que ficou
+ *   dentro e fora do corte de um checkpoint (ver CorteWAL)
+ */
+struct CabecalhoWAL {
+    char magica[8];          // "BANCOWAL"
+    uint32_t versao;
+    uint32_t reservado;
+    uint64_t hashSnapshot;   // Hash do ContaCorrente.txt de base
+    uint64_t idLog;          // Sorteado a cada log novo; o checkpoint guarda o do seu log
+    uint64_t lsnSnapshot;    // Último LSN já incorporado ao ContaCorrente.txt
+    uint64_t lsnBase;        // LSN anterior ao primeiro registro do arquivo
+};
+
+struct RegistroWAL {
+    uint32_t magica;         // MAGICA_REGISTRO
+    uint8_t tipo;            // TipoRegistroWAL
+    uint8_t continua;        // 1 = próximo registro pertence ao mesmo lote
+    uint16_t reservado;
+    uint64_t lsn;            // Número de sequência do log
+    char conta[16];          // Conta afetada (origem, nas transferências)
+    char destino[16];        // Conta de destino (apenas transferências)
+    int64_t valorCentavos;
+    uint32_t epoca;          // Época da escrita (32 bits baixos)
+    uint32_t checksum;       // FNV-1a dos campos anteriores
+};
+
+static_assert(sizeof(RegistroWAL) == 64, "RegistroWAL deve ter 64 bytes");
+
+/*
+ * CORTE DE UM CHECKPOINT NO WAL:
+ * O checkpoint é um snapshot da época S, e o LSN é reservado dentro da
+ * escrita: os registros até lsnInicio (lido antes de a época avançar)
+ * são de épocas <= S e os depois de lsnFim (lido quando as escritas da
+ * época S já terminaram) são de épocas > S. Entre os dois, só os da
+ * época S+1 ficaram fora do checkpoint.
+ */
+struct CorteWAL {
+    uint64_t lsnInicio = 0;
+    uint64_t lsnFim = 0;
+    uint32_t epocaSeguinte = 0;   // S+1, truncada como em RegistroWAL::epoca
+
+    bool cobre(const RegistroWAL& r) const {
+        return r.lsn <= lsnInicio || (r.lsn <= lsnFim && r.epoca != epocaSeguinte);
+    }
+};
+
+/*
+ * RESULTADO DA RECUPERAÇÃO (ver WriteAheadLog::recuperar):
+ * 'existencia' guarda, das contas abertas ou encerradas no log, se a
+ * última mudança foi uma abertura (true) ou um encerramento (false)
+ */
+struct RecuperacaoWAL {
+    bool valido = false;                    // Log íntegro deste snapshot: é continuado
+    uint64_t idLog = 0;
+    uint64_t lsnSnapshot = 0;
+    uint64_t lsnBase = 0;
+    uint64_t ultimoLsn = 0;                 // Fim do último grupo completo
+    off_t tamanhoValido = 0;
+    size_t registrosAplicados = 0;
+    std::map<std::string, long long> variacoes;
+    std::map<std::string, bool> existencia;
+};
+
+class WriteAheadLog {
+public:
+    static constexpr uint32_t MAGICA_REGISTRO = 0x4C415752;   // "RWAL"
+    static constexpr uint32_t VERSAO = 2;
+
+private:
+    int fd = -1;
+    ConfigWAL config;
+    std::string caminho;
+
+    /*
+     * ESTADO DO GROUP COMMIT (protegido por 'mutex'):
+     * - pendentes: registros anexados que ainda não foram gravados
+     * - lsnDuravel: maior LSN já gravado e sincronizado com o disco
+     */
+    std::mutex mutex;
+    std::condition_variable cvCommitter;    // Acorda a thread de commit
+    std::condition_variable cvDuravel;      // Acorda quem espera durabilidade
+    std::vector<RegistroWAL> pendentes;
+    uint64_t proximoLsn = 1;
+    uint64_t lsnDuravel = 0;
+    std::atomic<uint64_t> lsnDuravelPublicado{0};   // Cópia de lsnDuravel lida sem o mutex
+    std::chrono::steady_clock::time_point inicioLote;
+    bool encerrando = false;
+
+    /*
+     * FALHA DE GRAVAÇÃO:
+     * Depois do primeiro write/fdatasync com erro o log para: nada mais
+     * é gravado (o que veio depois de uma gravação rasgada não valeria na
+     * recuperação), lsnDuravel não avança e toda espera por um LSN ainda
+     * não durável falha
+     */
+    bool erro = false;
+    std::atomic<bool> erroPublicado{false};         // Cópia de erro lida sem o mutex
+
+    void falhar(const char* mensagem) {
+        if (!erro) std::cerr << mensagem << caminho << std::endl;
+        erro = true;
+        erroPublicado.store(true, std::memory_order_release);
+        pendentes.clear();
+        cvDuravel.notify_all();
+    }
+
+    /*
+     * CABEÇALHO E RECORTE (protegidos por 'mutex'):
+     * - recortePedido: LSN até o qual um checkpoint durável já cobre o log
+     * - recortando: a thread de commit está regravando o arquivo
+     */
+    uint64_t hashSnapshot = 0;
+    uint64_t idLog = 0;
+    uint64_t lsnSnapshot = 0;
+    uint64_t lsnBase = 0;
+    uint64_t recortePedido = 0;
+    bool recortando = false;
+
+    long long commits = 0;                  // Quantidade de write+fdatasync
+    long long registrosGravados = 0;
+    long long recortes = 0;
+
+    std::thread committer;
+
+    static uint64_t checksumRegistro(const RegistroWAL& r) {
+        return hashFNV1a(&r, offsetof(RegistroWAL, checksum));
+    }
+
+    static uint64_t novoIdLog() {
+        std::random_device rd;
+        return (static_cast<uint64_t>(rd()) << 32 | rd()) ^
+               static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+
+    CabecalhoWAL cabecalho() const {
+        CabecalhoWAL cab{};
+        std::memcpy(cab.magica, "BANCOWAL", 8);
+        cab.versao = VERSAO;
+        cab.hashSnapshot = hashSnapshot;
+        cab.idLog = idLog;
+        cab.lsnSnapshot = lsnSnapshot;
+        cab.lsnBase = lsnBase;
+        return cab;
+    }
+
+    bool escreverCabecalho() {
+        CabecalhoWAL cab = cabecalho();
+        return escreverTudo(fd, &cab, sizeof(cab)) && ::fdatasync(fd) == 0;
+    }
+
+    /*
+     * RECORTE DO ARQUIVO (thread de commit, entre dois lotes):
+     * Copia os registros posteriores ao corte num temporário com o novo
+     * lsnBase e troca com rename. Um crash deixa o log antigo ou o novo,
+     * ambos íntegros. Só o que já é durável é recortado; os registros
+     * anexados enquanto isso ficam em 'pendentes' e vão para o arquivo novo.
+     */
+    void recortarArquivo(std::unique_lock<std::mutex>& lock) {
+        uint64_t corte = std::min(recortePedido, lsnDuravel);
+        recortePedido = 0;
+        if (corte <= lsnBase || erro) return;
+        uint64_t base = lsnBase;
+        std::vector<RegistroWAL> cauda(lsnDuravel - corte);
+        CabecalhoWAL cab = cabecalho();
+        cab.lsnBase = corte;
+        recortando = true;
+        lock.unlock();
+
+        // Registros contíguos: o de LSN base + 1 é o primeiro do arquivo
+        size_t bytes = cauda.size() * sizeof(RegistroWAL);
+        off_t origem = static_cast<off_t>(sizeof(CabecalhoWAL) + (corte - base) * sizeof(RegistroWAL));
+        std::string temporario = caminho + ".tmp";
+        int novo = ::open(temporario.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        bool ok = novo >= 0 && lerTudo(fd, cauda.data(), bytes, origem) &&
+                  escreverTudo(novo, &cab, sizeof(cab)) && escreverTudo(novo, cauda.data(), bytes) &&
+                  ::fdatasync(novo) == 0 && std::rename(temporario.c_str(), caminho.c_str()) == 0;
+        bool duravel = ok && sincronizarDiretorio(caminho);
+
+        lock.lock();
+        recortando = false;
+        if (ok) {
+            ::close(fd);
+            fd = novo;
+            lsnBase = corte;
+            recortes++;
+        } else if (novo >= 0) {
+            ::close(novo);
+        }
+        if (!ok) {
+            std::cerr << "Erro ao recortar WAL (mantido inteiro): " << caminho << std::endl;
+        } else if (!duravel) {
+            // Sem o rename durável, um crash pode voltar ao log antigo sem os registros novos
+            falhar("Erro ao sincronizar o diretório do WAL: ");
+        }
+        cvDuravel.notify_all();
+    }
+
+    /*
+     * THREAD DE COMMIT:
+     * 1. Espera o primeiro registro de um lote
+     * 2. Espera o lote encher OU a latência máxima vencer
+     * 3. Grava o lote inteiro com um único write e um único fdatasync
+     * 4. Publica o novo LSN durável e acorda todos os que esperavam
+     * Com erro, só espera o encerramento (ver falhar)
+     */
+    void lacoCommit() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cvCommitter.wait(lock, [&] { return encerrando || !pendentes.empty() || recortePedido > 0; });
+            if (erro) {
+                pendentes.clear();
+                recortePedido = 0;
+                if (encerrando) break;
+                continue;
+            }
+            if (recortePedido > 0) {
+                recortarArquivo(lock);
+                continue;
+            }
+            if (pendentes.empty()) break;   // Encerrando sem nada pendente
+
+            cvCommitter.wait_until(lock, inicioLote + config.latenciaMaxima, [&] {
+                return encerrando || pendentes.size() >= config.loteMaximo;
+            });
+
+            /*
+             * NO MÁXIMO loteMaximo REGISTROS POR COMMIT:
+             * O excedente já esperou o suficiente e vira o próximo lote
+             * (inicioLote fica no passado, então ele é gravado em seguida)
+             */
+            std::vector<RegistroWAL> lote;
+            if (pendentes.size() <= config.loteMaximo) {
+                lote.swap(pendentes);
+            } else {
+                auto corte = pendentes.begin() + static_cast<std::ptrdiff_t>(config.loteMaximo);
+                lote.assign(pendentes.begin(), corte);
+                pendentes.erase(pendentes.begin(), corte);
+            }
+            uint64_t ultimoLsn = lote.back().lsn;
+            lock.unlock();
+
+            bool ok = escreverTudo(fd, lote.data(), lote.size() * sizeof(RegistroWAL)) &&
+                      ::fdatasync(fd) == 0;
+
+            lock.lock();
+            if (!ok) {
+                falhar("Erro ao gravar WAL (nenhuma escrita é confirmada daqui em diante): ");
+                continue;
+            }
+            lsnDuravel = ultimoLsn;
+            lsnDuravelPublicado.store(ultimoLsn, std::memory_order_release);
+            commits++;
+            registrosGravados += static_cast<long long>(lote.size());
+            cvDuravel.notify_all();
+        }
+    }
+
+public:
+    /*
+     * ABERTURA:
+     * - anterior.valido: continua o log recuperado após 'tamanhoValido'
+     *   bytes (descarta uma eventual cauda corrompida por um crash), com
+     *   os LSNs seguindo do último grupo completo
+     * - senão: trunca o arquivo e escreve um cabeçalho para o snapshot
+     */
+    WriteAheadLog(const std::string& arquivo, const ConfigWAL& cfg,
+                  uint64_t hashBase, const RecuperacaoWAL& anterior = {})
+        : config(cfg), caminho(arquivo), hashSnapshot(hashBase) {
+        fd = ::open(arquivo.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw std::runtime_error("Não foi possível abrir o WAL: " + arquivo);
+
+        if (anterior.valido) {
+            idLog = anterior.idLog;
+            lsnSnapshot = anterior.lsnSnapshot;
+            lsnBase = anterior.lsnBase;
+            proximoLsn = anterior.ultimoLsn + 1;
+            lsnDuravel = anterior.ultimoLsn;
+            lsnDuravelPublicado.store(lsnDuravel);
+            if (::ftruncate(fd, anterior.tamanhoValido) != 0) {
+                ::close(fd);
+                throw std::runtime_error("Não foi possível truncar o WAL: " + arquivo);
+            }
+        } else {
+            idLog = novoIdLog();
+            if (::ftruncate(fd, 0) != 0 || !escreverCabecalho()) {
+                ::close(fd);
+                throw std::runtime_error("Não foi possível inicializar o WAL: " + arquivo);
+            }
+        }
+        ::lseek(fd, 0, SEEK_END);
+        committer = std::thread(&WriteAheadLog::lacoCommit, this);
+    }
+
+    ~WriteAheadLog() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            encerrando = true;
+        }
+        cvCommitter.notify_all();
+        committer.join();
+        ::close(fd);
+    }
+
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    /*
+     * CRIAÇÃO DE REGISTRO:
+     * Preenche os campos fixos; LSN e checksum são atribuídos em anexar()
+     */
+    static RegistroWAL criarRegistro(TipoRegistroWAL tipo, const std::string& conta,
+                                     const std::string& destino, long long valorCentavos) {
+        RegistroWAL r{};
+        r.magica = MAGICA_REGISTRO;
+        r.tipo = static_cast<uint8_t>(tipo);
+        std::strncpy(r.conta, conta.c_str(), sizeof(r.conta) - 1);
+        std::strncpy(r.destino, destino.c_str(), sizeof(r.destino) - 1);
+        r.valorCentavos = valorCentavos;
+        return r;
+    }
+
+    /*
+     * ANEXAÇÃO:
+     * Coloca os registros (contíguos, em ordem) no lote em formação,
+     * marcados com a época da escrita que os gerou.
+     * Retorna o LSN do último registro, usado para esperar durabilidade.
+     */
+    uint64_t anexar(RegistroWAL* registros, size_t quantidade, uint64_t epoca) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (erro) {
+            // Log parado: o LSN nunca fica durável e a espera por ele falha
+            proximoLsn += quantidade;
+            return proximoLsn - 1;
+        }
+        bool primeiroDoLote = pendentes.empty();
+        if (primeiroDoLote) inicioLote = std::chrono::steady_clock::now();
+
+        for (size_t i = 0; i < quantidade; ++i) {
+            registros[i].continua = (i + 1 < quantidade) ? 1 : 0;
+            registros[i].epoca = static_cast<uint32_t>(epoca);
+            registros[i].lsn = proximoLsn++;
+            registros[i].checksum = static_cast<uint32_t>(checksumRegistro(registros[i]));
+            pendentes.push_back(registros[i]);
+        }
+
+        if (primeiroDoLote || pendentes.size() >= config.loteMaximo) {
+            cvCommitter.notify_one();
+        }
+        return proximoLsn - 1;
+    }
+
+    /*
+     * ESPERA POR DURABILIDADE:
+     * A operação só é confirmada ao cliente depois que o seu registro
+     * foi sincronizado com o disco. Retorna false se o log falhou antes
+     * disso: a operação não pode ser confirmada
+     */
+    bool aguardarDuravel(uint64_t lsn) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cvDuravel.wait(lock, [&] { return lsnDuravel >= lsn || erro; });
+        return lsnDuravel >= lsn;
+    }
+
+    // Consultas sem bloquear (escalonador de clientes em corrotinas, Banco)
+    uint64_t getLsnDuravel() const { return lsnDuravelPublicado.load(std::memory_order_acquire); }
+    bool falhou() const { return erroPublicado.load(std::memory_order_acquire); }
+
+    /*
+     * ESPERA ADIADA (por thread):
+     * Uma thread que executa clientes em corrotinas não pode parar
+     * esperando o commit. Com 'ativa', o banco só anexa e guarda aqui o
+     * maior LSN da operação; o cliente suspende até ele ficar durável.
+     */
+    struct EsperaAdiada {
+        bool ativa = false;
+        uint64_t lsn = 0;
+    };
+
+    static EsperaAdiada& esperaAdiadaDaThread() {
+        thread_local EsperaAdiada espera;
+        return espera;
+    }
+
+    // LSN pendente da última operação desta thread (0 = nada a esperar)
+    static uint64_t retirarLsnAdiado() {
+        EsperaAdiada& espera = esperaAdiadaDaThread();
+        uint64_t lsn = espera.lsn;
+        espera.lsn = 0;
+        return lsn;
+    }
+
+    /*
+     * REINÍCIO APÓS SALVAR AS CONTAS:
+     * Chamado quando um novo snapshot foi gravado com sucesso; o log
+     * passa a se referir a esse snapshot, com um novo idLog (checkpoints
+     * do log anterior deixam de valer). Exige que não haja operações
+     * em andamento (chamado ao final da simulação).
+     */
+    void reiniciar(uint64_t hashBase) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cvDuravel.wait(lock, [&] { return (lsnDuravel + 1 >= proximoLsn && !recortando) || erro; });
+        hashSnapshot = hashBase;
+        idLog = novoIdLog();
+        lsnSnapshot = lsnBase = proximoLsn - 1;
+        recortePedido = 0;
+        if (erro) return;
+        if (::ftruncate(fd, 0) != 0 || ::lseek(fd, 0, SEEK_SET) != 0 || !escreverCabecalho()) {
+            falhar("Erro ao reiniciar WAL: ");
+        }
+    }
+
+    /*
+     * RECORTE APÓS UM CHECKPOINT:
+     * Os registros até 'lsn' estão num checkpoint durável e podem sair
+     * do log; a thread de commit regrava o arquivo entre dois lotes
+     */
+    void recortar(uint64_t lsn) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lsn <= lsnBase || lsn <= recortePedido) return;
+        recortePedido = lsn;
+        cvCommitter.notify_one();
+    }
+
+    // Último LSN reservado: os limites do corte de um checkpoint
+    uint64_t getUltimoLsn() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return proximoLsn - 1;
+    }
+
+    uint64_t getIdLog() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return idLog;
+    }
+
+    long long getRecortes() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return recortes;
+    }
+
+    long long getCommits() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return commits;
+    }
+
+    long long getRegistrosGravados() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return registrosGravados;
+    }
+
+    static bool cabecalhoValido(const CabecalhoWAL& cab, uint64_t hashBase) {
+        return std::memcmp(cab.magica, "BANCOWAL", 8) == 0 && cab.versao == VERSAO &&
+               cab.hashSnapshot == hashBase;
+    }
+
+    // Só o cabeçalho: diz de qual log um checkpoint precisa ser
+    static bool lerCabecalho(const std::string& arquivo, uint64_t hashBase, CabecalhoWAL& cab) {
+        std::ifstream in(arquivo, std::ios::binary);
+        return in.read(reinterpret_cast<char*>(&cab), sizeof(cab)) && cabecalhoValido(cab, hashBase);
+    }
+
+    /*
+     * RECUPERAÇÃO:
+     * Lê o WAL e acumula, por conta, a variação de saldo dos grupos
+     * completos e íntegros. A leitura para no primeiro registro inválido
+     * ou fora de sequência (cauda parcialmente gravada por um crash).
+     * Com 'corte', os registros já contidos no checkpoint são pulados.
+     * 'valido' fica false se o WAL não existe ou pertence a outro
+     * snapshot (nesse caso ele já foi incorporado às contas e é ignorado).
+     */
+    static RecuperacaoWAL recuperar(const std::string& arquivo, uint64_t hashBase,
+                                    const CorteWAL* corte = nullptr) {
+        RecuperacaoWAL estado;
+        std::ifstream in(arquivo, std::ios::binary);
+        CabecalhoWAL cab{};
+        if (!in.read(reinterpret_cast<char*>(&cab), sizeof(cab)) || !cabecalhoValido(cab, hashBase)) {
+            return estado;
+        }
+        estado.valido = true;
+        estado.idLog = cab.idLog;
+        estado.lsnSnapshot = cab.lsnSnapshot;
+        estado.lsnBase = cab.lsnBase;
+        estado.ultimoLsn = cab.lsnBase;
+        estado.tamanhoValido = sizeof(cab);
+
+        std::map<std::string, long long> grupo;   // Variações do lote em leitura
+        std::map<std::string, bool> existenciaGrupo;
+        size_t registrosGrupo = 0;
+        size_t aplicadosGrupo = 0;
+        RegistroWAL r{};
+        while (in.read(reinterpret_cast<char*>(&r), sizeof(r))) {
+            if (r.magica != MAGICA_REGISTRO ||
+                r.checksum != static_cast<uint32_t>(checksumRegistro(r)) ||
+                r.lsn != estado.ultimoLsn + registrosGrupo + 1) break;
+            registrosGrupo++;
+
+            if (!corte || !corte->cobre(r)) {
+                r.conta[sizeof(r.conta) - 1] = '\0';
+                r.destino[sizeof(r.destino) - 1] = '\0';
+                switch (static_cast<TipoRegistroWAL>(r.tipo)) {
+                    case TipoRegistroWAL::CREDITO: grupo[r.conta] += r.valorCentavos; break;
+                    case TipoRegistroWAL::DEBITO: grupo[r.conta] -= r.valorCentavos; break;
+                    case TipoRegistroWAL::TRANSFERENCIA:
+                        grupo[r.conta] -= r.valorCentavos;
+                        grupo[r.destino] += r.valorCentavos;
+                        break;
+                    case TipoRegistroWAL::ABERTURA:
+                        grupo[r.conta] += r.valorCentavos;
+                        existenciaGrupo[r.conta] = true;
+                        break;
+                    case TipoRegistroWAL::ENCERRAMENTO:
+                        grupo[r.conta] -= r.valorCentavos;
+                        existenciaGrupo[r.conta] = false;
+                        break;
+                }
+                aplicadosGrupo++;
+            }
+
+            if (!r.continua) {
+                for (const auto& [id, variacao] : grupo) estado.variacoes[id] += variacao;
+                for (const auto& [id, aberta] : existenciaGrupo) estado.existencia[id] = aberta;
+                estado.registrosAplicados += aplicadosGrupo;
+                estado.tamanhoValido += static_cast<off_t>(registrosGrupo * sizeof(RegistroWAL));
+                estado.ultimoLsn = r.lsn;
+                grupo.clear();
+                existenciaGrupo.clear();
+                registrosGrupo = 0;
+                aplicadosGrupo = 0;
+            }
+        }
+        return estado;
+    }
+};
+
+// ===================================
+// Armazenamento de contas (texto e binário)
+// ===================================
+/*
+ * EXECUÇÃO PARALELA SIMPLES:
+ * Cria numThreads threads, cada uma recebendo o seu índice, e espera todas
+ */
+template <typename Funcao>
+void executarEmParalelo(unsigned numThreads, Funcao&& funcao) {
+    if (numThreads <= 1) {
+        funcao(0u);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < numThreads; ++t) threads.emplace_back(funcao, t);
+    for (auto& t : threads) t.join();
+}
+
+inline unsigned threadsDisponiveis() {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+}
+
+/*
+ * HASH EM BLOCOS:
+ * FNV-1a de cada bloco de 1 MiB (calculado em paralelo) seguido do
+ * FNV-1a da sequência de hashes. Identifica um snapshot (WAL) e serve
+ * de checksum do arquivo binário sem ler o arquivo numa única thread.
+ */
+constexpr size_t BLOCO_HASH = 1 << 20;
+
+inline uint64_t hashBlocos(const char* dados, size_t tamanho, unsigned numThreads = threadsDisponiveis()) {
+    size_t numBlocos = (tamanho + BLOCO_HASH - 1) / BLOCO_HASH;
+    std::vector<uint64_t> hashes(numBlocos);
+    numThreads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(numThreads, numBlocos)));
+    executarEmParalelo(numThreads, [&](unsigned t) {
+        for (size_t b = t; b < numBlocos; b += numThreads) {
+            size_t inicio = b * BLOCO_HASH;
+            hashes[b] = hashFNV1a(dados + inicio, std::min(BLOCO_HASH, tamanho - inicio));
+        }
+    });
+    return hashFNV1a(hashes.data(), hashes.size() * sizeof(uint64_t));
+}
+
+/*
+ * ARQUIVO MAPEADO EM MEMÓRIA (somente leitura):
+ * O conteúdo é acessado diretamente nas páginas do cache do kernel,
+ * sem cópia para buffers de stream
+ */
+class ArquivoMapeado {
+private:
+    int fd = -1;
+    const char* dados = nullptr;
+    size_t tamanho = 0;
+
+public:
+    explicit ArquivoMapeado(const std::string& caminho) {
+        fd = ::open(caminho.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat info{};
+        if (::fstat(fd, &info) != 0) return;
+        tamanho = static_cast<size_t>(info.st_size);
+        if (tamanho == 0) return;
+        void* p = ::mmap(nullptr, tamanho, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            tamanho = 0;
+            return;
+        }
+        ::madvise(p, tamanho, MADV_SEQUENTIAL);
+        dados = static_cast<const char*>(p);
+    }
+
+    ~ArquivoMapeado() {
+        if (dados) ::munmap(const_cast<char*>(dados), tamanho);
+        if (fd >= 0) ::close(fd);
+    }
+
+    ArquivoMapeado(const ArquivoMapeado&) = delete;
+    ArquivoMapeado& operator=(const ArquivoMapeado&) = delete;
+
+    bool aberto() const { return fd >= 0; }
+    const char* data() const { return dados; }
+    size_t size() const { return tamanho; }
+};
+
+/*
+ * CONTA LIDA DE ARQUIVO (antes de virar um objeto Conta)
+ */
+struct ContaLida {
+    std::string id;
+    double saldo;
+};
+
+/*
+ * APLICAÇÃO DO WAL RECUPERADO:
+ * Soma as variações às contas lidas (snapshot ou checkpoint); as
+ * encerradas depois dele saem e as abertas depois dele entram
+ */
+inline void aplicarRecuperacao(std::vector<ContaLida>& contas, const RecuperacaoWAL& recuperado) {
+    std::map<std::string, bool> existencia = recuperado.existencia;
+    for (ContaLida& conta : contas) {
+        auto it = recuperado.variacoes.find(conta.id);
+        if (it != recuperado.variacoes.end()) conta.saldo += it->second / 100.0;
+        auto mudou = existencia.find(conta.id);
+        if (mudou != existencia.end() && mudou->second) existencia.erase(mudou);   // Já existe
+    }
+    contas.erase(std::remove_if(contas.begin(), contas.end(), [&](const ContaLida& conta) {
+                     auto it = existencia.find(conta.id);
+                     return it != existencia.end() && !it->second;
+                 }), contas.end());
+    for (const auto& [id, aberta] : existencia) {
+        if (!aberta) continue;
+        auto it = recuperado.variacoes.find(id);
+        contas.push_back({id, it != recuperado.variacoes.end() ? it->second / 100.0 : 0.0});
+    }
+}
+
+/*
+ * FORMATO BINÁRIO DE CONTAS:
+ * - Cabeçalho fixo com mágica, versão, tamanho do registro, quantidade
+ *   e checksum (hashBlocos dos registros)
+ * - Registros de 32 bytes: ID (até 15 caracteres + '\0') e saldo em centavos
+ * Registros de tamanho fixo permitem dividir o arquivo entre threads
+ * sem nenhum parsing.
+ */
+struct CabecalhoContasBin {
+    char magica[8];          // "BANCOBIN"
+    uint32_t versao;
+    uint32_t tamanhoRegistro;
+    uint64_t numContas;
+    uint64_t checksum;
+};
+
+struct RegistroContaBin {
+    char id[16];
+    int64_t saldoCentavos;
+    uint64_t reservado;
+};
+
+/*
+ * CABEÇALHO DE CHECKPOINT:
+ * Vem antes de um arquivo BANCOBIN completo e diz a que ponto do WAL ele
+ * corresponde. 'sequencia' cresce a cada gravação: dos dois slots, vale
+ * o íntegro de maior sequência.
+ */
+struct CabecalhoCheckpoint {
+    char magica[8];          // "BANCOCKP"
+    uint32_t versao;
+    uint32_t epocaSeguinte;  // Ver CorteWAL
+    uint64_t sequencia;
+    uint64_t idLog;          // Log (CabecalhoWAL::idLog) sobre o qual o corte vale
+    uint64_t lsnInicio;
+    uint64_t lsnFim;
+    uint64_t checksumContas; // Cópia do checksum do cabeçalho BANCOBIN seguinte
+    uint64_t checksum;       // FNV-1a dos campos anteriores
+};
+
+static_assert(sizeof(CabecalhoContasBin) == 32, "CabecalhoContasBin deve ter 32 bytes");
+static_assert(sizeof(RegistroContaBin) == 32, "RegistroContaBin deve ter 32 bytes");
+static_assert(sizeof(CabecalhoCheckpoint) == 64, "CabecalhoCheckpoint deve ter 64 bytes");
+
+class ArmazenamentoContas {
+public:
+    static constexpr uint32_t VERSAO_BINARIO = 1;
+
+    static bool ehBinario(const char* dados, size_t tamanho) {
+        return tamanho >= sizeof(CabecalhoContasBin) && std::memcmp(dados, "BANCOBIN", 8) == 0;
+    }
+
+    static bool ehCheckpoint(const char* dados, size_t tamanho) {
+        return tamanho >= sizeof(CabecalhoCheckpoint) && std::memcmp(dados, "BANCOCKP", 8) == 0;
+    }
+
+    static bool caminhoBinario(const std::string& arquivo) {
+        return arquivo.size() >= 4 && arquivo.compare(arquivo.size() - 4, 4, ".bin") == 0;
+    }
+
+    /*
+     * LEITURA DE TEXTO EM PARALELO:
+     * 1. Divide o arquivo em numThreads faixas de tamanho parecido
+     * 2. Ajusta cada fronteira para o início da próxima linha
+     * 3. Cada thread converte a sua faixa com from_chars (sem streams)
+     * 4. As faixas são concatenadas em ordem, preservando a ordem do arquivo
+     */
+    static std::vector<ContaLida> lerTexto(const char* dados, size_t tamanho, unsigned numThreads) {
+        numThreads = std::max(1u, numThreads);
+        std::vector<size_t> fronteiras(numThreads + 1, tamanho);
+        fronteiras[0] = 0;
+        for (unsigned t = 1; t < numThreads; ++t) {
+            size_t pos = std::max(fronteiras[t - 1], tamanho * t / numThreads);
+            while (pos < tamanho && pos > 0 && dados[pos - 1] != '\n') ++pos;
+            fronteiras[t] = pos;
+        }
+
+        std::vector<std::vector<ContaLida>> partes(numThreads);
+        executarEmParalelo(numThreads, [&](unsigned t) {
+            const char* p = dados + fronteiras[t];
+            const char* fim = dados + fronteiras[t + 1];
+            std::vector<ContaLida>& saida = partes[t];
+            saida.reserve(static_cast<size_t>(fim - p) / 12);
+            while (p < fim) {
+                const char* fimLinha = static_cast<const char*>(std::memchr(p, '\n', fim - p));
+                if (!fimLinha) fimLinha = fim;
+                const char* barra = static_cast<const char*>(std::memchr(p, '|', fimLinha - p));
+                if (barra) {
+                    const char* inicioNumero = barra + 1;
+                    while (inicioNumero < fimLinha && *inicioNumero == ' ') ++inicioNumero;
+                    double saldo = 0;
+                    auto [ptr, ec] = std::from_chars(inicioNumero, fimLinha, saldo);
+                    if (ec == std::errc() && ptr != inicioNumero) {
+                        saida.push_back({std::string(p, barra), saldo});
+                    }
+                }
+                p = fimLinha + 1;
+            }
+        });
+
+        size_t total = 0;
+        for (const auto& parte : partes) total += parte.size();
+        std::vector<ContaLida> resultado;
+        resultado.reserve(total);
+        for (auto& parte : partes) {
+            std::move(parte.begin(), parte.end(), std::back_inserter(resultado));
+        }
+        return resultado;
+    }
+
+    /*
+     * LEITURA DO FORMATO BINÁRIO:
+     * Valida cabeçalho, tamanho e checksum antes de confiar nos dados
+     */
+    static std::vector<ContaLida> lerBinario(const char* dados, size_t tamanho, unsigned numThreads) {
+        if (!ehBinario(dados, tamanho)) {
+            throw std::runtime_error("Arquivo binário de contas sem cabeçalho válido.");
+        }
+        CabecalhoContasBin cab;
+        std::memcpy(&cab, dados, sizeof(cab));
+        if (cab.versao != VERSAO_BINARIO || cab.tamanhoRegistro != sizeof(RegistroContaBin)) {
+            throw std::runtime_error("Versão ou tamanho de registro do arquivo binário não suportado.");
+        }
+        size_t bytesRegistros = tamanho - sizeof(CabecalhoContasBin);
+        if (cab.numContas != bytesRegistros / sizeof(RegistroContaBin) ||
+            bytesRegistros % sizeof(RegistroContaBin) != 0) {
+            throw std::runtime_error("Arquivo binário de contas truncado ou com tamanho inválido.");
+        }
+        const char* registros = dados + sizeof(CabecalhoContasBin);
+        if (hashBlocos(registros, bytesRegistros, numThreads) != cab.checksum) {
+            throw std::runtime_error("Checksum do arquivo binário de contas não confere.");
+        }
+
+        size_t n = cab.numContas;
+        std::vector<ContaLida> resultado(n);
+        numThreads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(numThreads, n)));
+        executarEmParalelo(numThreads, [&](unsigned t) {
+            size_t inicio = n * t / numThreads;
+            size_t fim = n * (t + 1) / numThreads;
+            for (size_t i = inicio; i < fim; ++i) {
+                RegistroContaBin r;
+                std::memcpy(&r, registros + i * sizeof(RegistroContaBin), sizeof(r));
+                r.id[sizeof(r.id) - 1] = '\0';
+                resultado[i].id = r.id;
+                resultado[i].saldo = static_cast<double>(r.saldoCentavos) / 100.0;
+            }
+        });
+        // Registros vazios: índices sem conta num arquivo de checkpoint
+        resultado.erase(std::remove_if(resultado.begin(), resultado.end(),
+                                       [](const ContaLida& c) { return c.id.empty(); }),
+                        resultado.end());
+        return resultado;
+    }
+
+    // Um checkpoint é lido pelas contas que carrega (o corte no WAL fica de fora)
+    static std::vector<ContaLida> ler(const char* dados, size_t tamanho, unsigned numThreads) {
+        if (ehCheckpoint(dados, tamanho)) {
+            return lerBinario(dados + sizeof(CabecalhoCheckpoint), tamanho - sizeof(CabecalhoCheckpoint),
+                              numThreads);
+        }
+        return ehBinario(dados, tamanho) ? lerBinario(dados, tamanho, numThreads)
+                                         : lerTexto(dados, tamanho, numThreads);
+    }
+
+    static std::string serializarTexto(const std::vector<ContaLida>& contas) {
+        std::string saida;
+        saida.reserve(contas.size() * 20);
+        char numero[64];
+        for (const ContaLida& c : contas) {
+            int n = std::snprintf(numero, sizeof(numero), "%.2f\n", c.saldo);
+            saida += c.id;
+            saida += '|';
+            saida.append(numero, static_cast<size_t>(n));
+        }
+        return saida;
+    }
+
+    static RegistroContaBin registroBinario(const std::string& id, double saldo) {
+        RegistroContaBin r{};
+        std::strncpy(r.id, id.c_str(), sizeof(r.id) - 1);
+        r.saldoCentavos = std::llround(saldo * 100.0);
+        return r;
+    }
+
+    static CabecalhoContasBin cabecalhoBinario(uint64_t numContas, uint64_t checksum) {
+        CabecalhoContasBin cab{};
+        std::memcpy(cab.magica, "BANCOBIN", 8);
+        cab.versao = VERSAO_BINARIO;
+        cab.tamanhoRegistro = sizeof(RegistroContaBin);
+        cab.numContas = numContas;
+        cab.checksum = checksum;
+        return cab;
+    }
+
+    static std::string serializarBinario(const std::vector<ContaLida>& contas) {
+        std::string saida(sizeof(CabecalhoContasBin) + contas.size() * sizeof(RegistroContaBin), '\0');
+        char* registros = &saida[sizeof(CabecalhoContasBin)];
+        for (size_t i = 0; i < contas.size(); ++i) {
+            RegistroContaBin r = registroBinario(contas[i].id, contas[i].saldo);
+            std::memcpy(registros + i * sizeof(r), &r, sizeof(r));
+        }
+        CabecalhoContasBin cab = cabecalhoBinario(
+            contas.size(), hashBlocos(registros, contas.size() * sizeof(RegistroContaBin)));
+        std::memcpy(&saida[0], &cab, sizeof(cab));
+        return saida;
+    }
+
+    static std::string serializar(const std::string& arquivo, const std::vector<ContaLida>& contas) {
+        return caminhoBinario(arquivo) ? serializarBinario(contas) : serializarTexto(contas);
+    }
+
+    /*
+     * GRAVAÇÃO ATÔMICA:
+     * Escreve num temporário, sincroniza com o disco e troca com rename
+     * (também sincronizado: o WAL é reiniciado logo em seguida)
+     */
+    static bool gravarAtomicamente(const std::string& arquivo, const std::string& conteudo) {
+        std::string temporario = arquivo + ".tmp";
+        int fd = ::open(temporario.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        bool ok = fd >= 0 && escreverTudo(fd, conteudo.data(), conteudo.size()) && ::fsync(fd) == 0;
+        if (fd >= 0) ::close(fd);
+        return ok && std::rename(temporario.c_str(), arquivo.c_str()) == 0 && sincronizarDiretorio(arquivo);
+    }
+};
+
+// ===================================
+// Checkpoint incremental
+// ===================================
+/*
+ * CHECKPOINT EM SEGUNDO PLANO:
+ * Uma thread do banco grava, a cada intervaloMs, só as contas alteradas
+ * num arquivo binário (formato BANCOBIN, uma conta por índice global)
+ * atualizado no lugar. São dois arquivos (ARQUIVO.0 e ARQUIVO.1) usados
+ * alternadamente, então o checkpoint anterior fica íntegro enquanto o
+ * próximo é gravado. "completo" regrava todas as contas a cada
+ * checkpoint, como referência de custo.
+ */
+struct ConfigCheckpoint {
+    bool ativo = false;
+    int intervaloMs = 100;
+    bool completo = false;
+    std::string arquivo = "checkpoint.bin";
+
+    std::string descricao() const {
+        if (!ativo) return "desligado";
+        return std::to_string(intervaloMs) + "ms" + (completo ? ":completo" : "");
+    }
+};
+
+/*
+ * TEXTO -> CONFIGURAÇÃO: "desligado" ou "MS[:completo][,ARQUIVO]"
+ */
+inline bool interpretarConfigCheckpoint(const std::string& texto, ConfigCheckpoint& config) {
+    if (texto == "desligado") {
+        config.ativo = false;
+        return true;
+    }
+    ConfigCheckpoint nova;
+    nova.ativo = true;
+    std::string intervalo = texto;
+    size_t virgula = texto.find(',');
+    if (virgula != std::string::npos) {
+        nova.arquivo = texto.substr(virgula + 1);
+        intervalo = texto.substr(0, virgula);
+        if (nova.arquivo.empty()) return false;
+    }
+    size_t sep = intervalo.find(':');
+    if (sep != std::string::npos) {
+        if (intervalo.substr(sep + 1) != "completo") return false;
+        nova.completo = true;
+        intervalo = intervalo.substr(0, sep);
+    }
+    char sobra;
+    if (std::sscanf(intervalo.c_str(), "%d%c", &nova.intervaloMs, &sobra) != 1) return false;
+    if (nova.intervaloMs < 1) return false;
+    config = nova;
+    return true;
+}
+
+/*
+ * SLOT DE CHECKPOINT (atualizado no lugar):
+ * - Guarda em memória uma cópia dos registros e o hash de cada bloco
+ *   de BLOCO_HASH bytes, então o checksum do cabeçalho é refeito só
+ *   com os blocos que mudaram, sem reler o arquivo
+ * - atualizar() só marca o registro se os bytes mudaram (crédito seguido
+ *   de débito do mesmo valor não gera escrita); o banco atualiza os dois
+ *   slots, e cada um acumula o que mudou desde a sua última gravação
+ * - gravar() junta num único pwrite os registros separados por menos
+ *   de uma página (o kernel grava páginas inteiras de qualquer forma),
+ *   grava os cabeçalhos por último e faz um fdatasync
+ * Um crash no meio da gravação deixa o checksum sem conferir: o slot é
+ * recusado na leitura e vale o outro.
+ */
+class ArquivoCheckpoint {
+private:
+    int fd = -1;
+    std::string registros;                  // Cópia do conteúdo, sem os cabeçalhos
+    std::vector<uint64_t> hashes;           // hashFNV1a de cada bloco (ver hashBlocos)
+    std::vector<size_t> pendentes;          // Registros alterados desde a última gravação
+    bool cabecalhoPendente = true;
+    bool reescrever = true;                 // Conteúdo do disco desconhecido: grava tudo
+    uint64_t sequencia = 0;                 // Do cabeçalho no disco (0 = nenhum íntegro)
+
+    static constexpr size_t PAGINA = 4096;
+    static constexpr size_t INICIO_REGISTROS = sizeof(CabecalhoCheckpoint) + sizeof(CabecalhoContasBin);
+
+    static uint64_t checksumCabecalho(const CabecalhoCheckpoint& cab) {
+        return hashFNV1a(&cab, offsetof(CabecalhoCheckpoint, checksum));
+    }
+
+public:
+    static constexpr uint32_t VERSAO = 1;
+
+    ArquivoCheckpoint() = default;
+    ArquivoCheckpoint(const ArquivoCheckpoint&) = delete;
+    ArquivoCheckpoint& operator=(const ArquivoCheckpoint&) = delete;
+    ~ArquivoCheckpoint() { fechar(); }
+
+    static std::string caminhoSlot(const std::string& arquivo, size_t slot) {
+        return arquivo + "." + std::to_string(slot);
+    }
+
+    /*
+     * CABEÇALHOS DE UM SLOT:
+     * Confere o cabeçalho de checkpoint e se o BANCOBIN seguinte é o
+     * mesmo que ele registrou (o checksum dos registros é conferido por
+     * ArmazenamentoContas::lerBinario)
+     */
+    static bool lerCabecalho(const char* dados, size_t tamanho, CabecalhoCheckpoint& cab) {
+        if (!ArmazenamentoContas::ehCheckpoint(dados, tamanho) || tamanho < INICIO_REGISTROS) return false;
+        std::memcpy(&cab, dados, sizeof(cab));
+        CabecalhoContasBin contas;
+        std::memcpy(&contas, dados + sizeof(cab), sizeof(contas));
+        return cab.versao == VERSAO && cab.checksum == checksumCabecalho(cab) &&
+               contas.checksum == cab.checksumContas;
+    }
+
+    /*
+     * CHECKPOINT MAIS NOVO DE UM LOG:
+     * Dos dois slots, o íntegro de maior sequência gravado sobre o log
+     * 'idLog'. Retorna false se nenhum serve.
+     */
+    static bool lerMaisNovo(const std::string& arquivo, uint64_t idLog, unsigned numThreads,
+                            CabecalhoCheckpoint& cab, std::vector<ContaLida>& contas) {
+        bool achou = false;
+        for (size_t slot = 0; slot < 2; ++slot) {
+            ArquivoMapeado mapa(caminhoSlot(arquivo, slot));
+            CabecalhoCheckpoint lido;
+            if (!mapa.aberto() || !lerCabecalho(mapa.data(), mapa.size(), lido) || lido.idLog != idLog ||
+                (achou && lido.sequencia <= cab.sequencia)) {
+                continue;
+            }
+            try {
+                contas = ArmazenamentoContas::lerBinario(mapa.data() + sizeof(lido),
+                                                         mapa.size() - sizeof(lido), numThreads);
+            } catch (const std::runtime_error&) {
+                continue;                   // Registros gravados pela metade
+            }
+            cab = lido;
+            achou = true;
+        }
+        return achou;
+    }
+
+    // Sem truncar: até a primeira gravação, o slot pode ser o único checkpoint íntegro
+    bool abrir(const std::string& caminho) {
+        fechar();
+        fd = ::open(caminho.c_str(), O_RDWR | O_CREAT, 0644);
+        registros.clear();
+        hashes.clear();
+        pendentes.clear();
+        cabecalhoPendente = true;
+        reescrever = true;
+        sequencia = 0;
+        char cabecalhos[INICIO_REGISTROS];
+        CabecalhoCheckpoint cab;
+        if (fd >= 0 && lerTudo(fd, cabecalhos, sizeof(cabecalhos), 0) &&
+            lerCabecalho(cabecalhos, sizeof(cabecalhos), cab)) {
+            sequencia = cab.sequencia;
+        }
+        return fd >= 0;
+    }
+
+    void fechar() {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+
+    bool aberto() const { return fd >= 0; }
+    size_t getPendentes() const { return reescrever ? registros.size() / sizeof(RegistroContaBin) : pendentes.size(); }
+    uint64_t getSequencia() const { return sequencia; }
+
+    // Novos índices começam vazios (registro zerado, ignorado na leitura)
+    void redimensionar(size_t numRegistros) {
+        size_t tamanho = numRegistros * sizeof(RegistroContaBin);
+        if (tamanho == registros.size()) return;
+        registros.resize(tamanho, '\0');
+        hashes.assign((tamanho + BLOCO_HASH - 1) / BLOCO_HASH, 0);
+        for (size_t b = 0; b < hashes.size(); ++b) {
+            size_t inicio = b * BLOCO_HASH;
+            hashes[b] = hashFNV1a(registros.data() + inicio, std::min(BLOCO_HASH, tamanho - inicio));
+        }
+        cabecalhoPendente = true;
+    }
+
+    void atualizar(size_t indice, const RegistroContaBin& registro, bool forcar) {
+        char* destino = &registros[indice * sizeof(RegistroContaBin)];
+        if (!forcar && std::memcmp(destino, &registro, sizeof(registro)) == 0) return;
+        std::memcpy(destino, &registro, sizeof(registro));
+        pendentes.push_back(indice);
+    }
+
+    /*
+     * GRAVAÇÃO DOS PENDENTES:
+     * 'cab' traz a sequência e o corte no WAL; os demais campos são
+     * preenchidos aqui. Retorna false em erro de E/S (o slot é regravado
+     * inteiro na próxima vez); 'bytes' recebe o total escrito, 0 se não
+     * havia nada a gravar (o slot fica como estava).
+     */
+    bool gravar(CabecalhoCheckpoint cab, long long& bytes) {
+        bytes = 0;
+        const size_t TAM = sizeof(RegistroContaBin);
+        if (reescrever) {
+            pendentes.resize(registros.size() / TAM);
+            std::iota(pendentes.begin(), pendentes.end(), size_t{0});
+            cabecalhoPendente = true;
+        }
+        if (pendentes.empty() && !cabecalhoPendente) return true;
+        std::sort(pendentes.begin(), pendentes.end());
+        pendentes.erase(std::unique(pendentes.begin(), pendentes.end()), pendentes.end());
+        bool ok = true;
+        size_t blocoAnterior = hashes.size();
+        for (size_t i = 0; ok && i < pendentes.size();) {
+            size_t fim = i + 1;
+            while (fim < pendentes.size() && (pendentes[fim] - pendentes[fim - 1]) * TAM <= PAGINA) ++fim;
+            size_t inicio = pendentes[i] * TAM;
+            size_t tamanho = (pendentes[fim - 1] + 1) * TAM - inicio;
+            ok = escreverTudo(fd, registros.data() + inicio, tamanho,
+                              static_cast<off_t>(INICIO_REGISTROS + inicio));
+            bytes += static_cast<long long>(tamanho);
+            for (size_t b = inicio / BLOCO_HASH; b <= (inicio + tamanho - 1) / BLOCO_HASH; ++b) {
+                if (b == blocoAnterior) continue;
+                size_t base = b * BLOCO_HASH;
+                hashes[b] = hashFNV1a(registros.data() + base,
+                                      std::min(BLOCO_HASH, registros.size() - base));
+                blocoAnterior = b;
+            }
+            i = fim;
+        }
+        pendentes.clear();
+
+        char cabecalhos[INICIO_REGISTROS];
+        CabecalhoContasBin contas = ArmazenamentoContas::cabecalhoBinario(
+            registros.size() / TAM, hashFNV1a(hashes.data(), hashes.size() * sizeof(uint64_t)));
+        std::memcpy(cab.magica, "BANCOCKP", 8);
+        cab.versao = VERSAO;
+        cab.checksumContas = contas.checksum;
+        cab.checksum = checksumCabecalho(cab);
+        std::memcpy(cabecalhos, &cab, sizeof(cab));
+        std::memcpy(cabecalhos + sizeof(cab), &contas, sizeof(contas));
+
+        off_t tamanhoArquivo = static_cast<off_t>(INICIO_REGISTROS + registros.size());
+        if (ok && cabecalhoPendente) ok = ::ftruncate(fd, tamanhoArquivo) == 0;
+        ok = ok && escreverTudo(fd, cabecalhos, sizeof(cabecalhos), 0);
+        bytes += sizeof(cabecalhos);
+        ok = ok && ::fdatasync(fd) == 0;
+        cabecalhoPendente = !ok;
+        reescrever = !ok;                   // Não se sabe o que chegou ao disco
+        if (ok) sequencia = cab.sequencia;
+        return ok;
+    }
+};
+
+#endif  // BANCO_WAL_HPP